@@ -178,6 +178,18 @@
 	#define AE_ENABLE_OPENGL 1
 #endif
 
+//------------------------------------------------------------------------------
+// AE_ENABLE_SIMD define
+//------------------------------------------------------------------------------
+//! Define as 0 before including aether.h to disable SSE2 and NEON intrinsics.
+//! Batched geometry queries and ae::Matrix4, ae::Vec4 and ae::Quaternion
+//! operations fall back to equivalent scalar code paths, which can be useful
+//! when debugging or comparing results across platforms.
+//------------------------------------------------------------------------------
+#ifndef AE_ENABLE_SIMD
+	#define AE_ENABLE_SIMD 1
+#endif
+
 //------------------------------------------------------------------------------
 // AE_OPENGL_CUSTOM_HEADER define
 //------------------------------------------------------------------------------
@@ -282,6 +294,7 @@
 //------------------------------------------------------------------------------
 #include <algorithm>
 #include <array>
+#include <atomic>
 #include <cassert>
 #include <cerrno> // strtoll/strtoull error checking
 #include <chrono>
@@ -332,6 +345,19 @@
 		#include <pmmintrin.h>
 	#endif
 #endif
+#if AE_ENABLE_SIMD && ( defined(__SSE2__) || defined(_M_X64) || ( defined(_M_IX86_FP) && _M_IX86_FP >= 2 ) )
+	#define _AE_SIMD_SSE2_ 1
+	#include <emmintrin.h>
+#elif AE_ENABLE_SIMD && ( defined(__ARM_NEON__) || defined(__ARM_NEON) )
+	#define _AE_SIMD_NEON_ 1
+	#include <arm_neon.h>
+#endif
+#ifndef _AE_SIMD_SSE2_
+	#define _AE_SIMD_SSE2_ 0
+#endif
+#ifndef _AE_SIMD_NEON_
+	#define _AE_SIMD_NEON_ 0
+#endif
 
 namespace ae {
 
@@ -761,6 +787,59 @@ private:
 	T m_max = T();
 };
 
+//------------------------------------------------------------------------------
+// ae::RandomGenerator class
+//------------------------------------------------------------------------------
+//! A fast generator for producing large amounts of random values, eg. for
+//! particles, procedural placement, or sampling. Internally this runs four
+//! interleaved xoshiro128** streams, which are stepped together with SSE2 or
+//! NEON when available (see AE_ENABLE_SIMD). The Fill functions produce exactly
+//! the same values as calling the matching Get function \p count times, so the
+//! sequence only depends on the seed and the order of calls. Use Jump() to
+//! create non-overlapping generators for other threads. Not thread safe.
+//------------------------------------------------------------------------------
+struct Vec3;
+class RandomGenerator
+{
+public:
+	RandomGenerator( uint64_t seed = 0 );
+	//! Resets the generator to the start of the sequence for \p seed
+	void Seed( uint64_t seed );
+	//! Skips ahead 2^66 values. Copies of a generator that are each jumped a
+	//! different number of times will never produce overlapping sequences:
+	//! \code
+	//! ae::RandomGenerator threadGenerators[ 4 ];
+	//! for( uint32_t i = 0; i < 4; i++ ) { threadGenerators[ i ] = generator; generator.Jump(); }
+	//! \endcode
+	void Jump();
+
+	//! Returns a uniformly distributed value in the range [0, 2^32)
+	inline uint32_t GetUint32();
+	//! Returns a uniformly distributed value in the range [0, 1)
+	inline float Get01();
+	//! Returns a value in the range [\p minInclusive, \p maxExclusive), or
+	//! \p minInclusive if the range is empty
+	int32_t Get( int32_t minInclusive, int32_t maxExclusive );
+	//! Returns a value in the range [\p min, \p max)
+	float Get( float min, float max );
+	//! Returns a uniformly distributed point on the unit sphere
+	ae::Vec3 GetUnitVec3();
+
+	void FillUint32( uint32_t* out, uint32_t count );
+	void Fill01( float* out, uint32_t count );
+	void Fill( int32_t* out, uint32_t count, int32_t minInclusive, int32_t maxExclusive );
+	void Fill( float* out, uint32_t count, float min, float max );
+	void FillUnitVec3( ae::Vec3* out, uint32_t count );
+
+private:
+	void m_Step( uint32_t result[ 4 ] );
+	//! Four xoshiro128** states, with each word stored across four lanes
+	uint32_t m_state[ 4 ][ 4 ];
+	//! Results of the last step not returned yet, from m_block[ m_blockIndex ]
+	uint32_t m_block[ 4 ];
+	uint32_t m_blockIndex = 4;
+};
+
 //------------------------------------------------------------------------------
 // Vector math utilities
 //------------------------------------------------------------------------------
@@ -1282,6 +1361,13 @@ public:
 
 	bool Raycast( Vec3 source, Vec3 ray, bool ccw, bool cw, Vec3* hitOut = nullptr, Vec3* normalOut = nullptr, float* distanceOut = nullptr ) const;
 	bool SphereCast( Vec3 source, Vec3 ray, float radius, bool ccw, bool cw, Vec3* hitOut = nullptr, Vec3* normalOut = nullptr, float* distanceOut = nullptr ) const;
+	//! Sweeps a capsule with the segment \p p0 to \p p1 and \p radius along
+	//! \p ray. A zero length segment sweeps a sphere. \p hitOut is the first
+	//! point of contact on the triangle and \p normalOut points from it towards
+	//! the capsule. If the capsule starts overlapping the triangle the hit is
+	//! at a distance of 0. \p ccw and \p cw select which side of the triangle
+	//! can be hit, based on the side of the contact normal.
+	bool CapsuleCast( Vec3 p0, Vec3 p1, Vec3 ray, float radius, bool ccw, bool cw, Vec3* hitOut = nullptr, Vec3* normalOut = nullptr, float* distanceOut = nullptr ) const;
 	Vec3 ClosestPoint( Vec3 p ) const;
 	Vec3 CounterClockwiseNormal() const;
 	Vec3 ClockwiseNormal() const;
@@ -1417,7 +1503,45 @@ public:
 	explicit Frustum( ae::Matrix4 worldToProjection );
 	bool Intersects( const ae::Sphere& sphere ) const;
 	bool Intersects( ae::Vec3 point ) const;
+	//! Conservative test, returns true if \p aabb is not fully outside any of
+	//! the frustum planes. Boxes near the frustum corners may return true even
+	//! when they are not visible.
+	bool Intersects( const class AABB& aabb ) const;
+	//! Conservative test, returns true if \p obb is not fully outside any of
+	//! the frustum planes.
+	bool Intersects( const class OBB& obb ) const;
 	ae::Plane GetPlane( ae::Frustum::Plane plane ) const;
+
+	//! Structure-of-arrays boxes for CullAABBs(). Each array holds \p count values.
+	struct AABBArrays
+	{
+		const float* minX = nullptr;
+		const float* minY = nullptr;
+		const float* minZ = nullptr;
+		const float* maxX = nullptr;
+		const float* maxY = nullptr;
+		const float* maxZ = nullptr;
+		uint32_t count = 0;
+	};
+	//! Structure-of-arrays spheres for CullSpheres(). Each array holds \p count values.
+	struct SphereArrays
+	{
+		const float* centerX = nullptr;
+		const float* centerY = nullptr;
+		const float* centerZ = nullptr;
+		const float* radius = nullptr;
+		uint32_t count = 0;
+	};
+	//! Tests four boxes at a time with the same conservative test as
+	//! Intersects( AABB ). If \p visibleBitsOut is provided, bit ( i % 32 ) of
+	//! \p visibleBitsOut[ i / 32 ] is set when box i is visible and cleared
+	//! otherwise, so it must hold ( count + 31 ) / 32 values. If
+	//! \p visibleIndicesOut is provided the indices of visible boxes are written
+	//! to it in increasing order, so it must hold \p count values. Returns the
+	//! number of visible boxes.
+	uint32_t CullAABBs( const AABBArrays& aabbs, uint32_t* visibleBitsOut, uint32_t* visibleIndicesOut = nullptr ) const;
+	//! Same as CullAABBs() but for spheres, matching Intersects( Sphere ).
+	uint32_t CullSpheres( const SphereArrays& spheres, uint32_t* visibleBitsOut, uint32_t* visibleIndicesOut = nullptr ) const;
 	
 private:
 	ae::Plane m_planes[ 6 ];
@@ -1527,8 +1651,310 @@ private:
 	Vec3 m_halfSize;
 };
 
+//------------------------------------------------------------------------------
+// ae::TransformPoints, ae::TransformNormals, and ae::TransformAABBs
+//------------------------------------------------------------------------------
+//! Batched transforms of \p count elements read from \p in every \p inStride
+//! bytes and written to \p out every \p outStride bytes. \p in and \p out may
+//! be the same array if their strides match. Elements are processed four at a
+//! time with SSE2 or NEON when available (see AE_ENABLE_SIMD). By default all
+//! work is done on the calling thread. Large arrays (tens of thousands of
+//! elements) can be split across up to \p threadCount threads, or 0 for
+//! ae::GetMaxConcurrentThreads(), which are started and joined for each call.
+//------------------------------------------------------------------------------
+//! Transforms points as ( x, y, z, 1 ), matching ae::Matrix4::TransformPoint3x4().
+void TransformPoints( const Matrix4& transform, const float* in, uint32_t inStride, float* out, uint32_t outStride, uint32_t count, uint32_t threadCount = 1 );
+//! Transforms normals by the inverse transpose of \p transform and normalizes
+//! them. Normals too short to normalize are set to zero, like
+//! ae::Vec3::SafeNormalizeCopy().
+void TransformNormals( const Matrix4& transform, const float* in, uint32_t inStride, float* out, uint32_t outStride, uint32_t count, uint32_t threadCount = 1 );
+//! Sets each output to the aabb that tightly fits its input aabb transformed by
+//! the affine \p transform. Empty aabbs stay empty.
+void TransformAABBs( const Matrix4& transform, const AABB* in, uint32_t inStride, AABB* out, uint32_t outStride, uint32_t count, uint32_t threadCount = 1 );
+
+//------------------------------------------------------------------------------
+// ae::GradientNoise, ae::SimplexNoise, and ae::FractalNoise
+//------------------------------------------------------------------------------
+//! Coherent noise functions returning values in approximately [-1, 1]. The
+//! lattice is hashed with integer math and the implementation disables fused
+//! multiply-add contraction with pragmas, so a given position and \p seed
+//! produce the same value on every platform. This doesn't hold if the whole
+//! build opts into looser float math, eg. -ffast-math, clang's
+//! -ffp-contract=fast, or MSVC's /fp:fast. The batched overloads evaluate
+//! \p count positions four at a time with SSE2 or NEON when available (see
+//! AE_ENABLE_SIMD), and return results identical to the single position
+//! overloads, which evaluate one position without batching.
+//------------------------------------------------------------------------------
+//! Perlin style gradient noise. Values are zero at integer coordinates.
+float GradientNoise( ae::Vec2 p, uint32_t seed = 0 );
+float GradientNoise( ae::Vec3 p, uint32_t seed = 0 );
+float GradientNoise( ae::Vec4 p, uint32_t seed = 0 );
+void GradientNoise( const ae::Vec2* p, float* out, uint32_t count, uint32_t seed = 0 );
+void GradientNoise( const ae::Vec3* p, float* out, uint32_t count, uint32_t seed = 0 );
+void GradientNoise( const ae::Vec4* p, float* out, uint32_t count, uint32_t seed = 0 );
+//! Simplex noise. Cheaper than ae::GradientNoise() in higher dimensions and
+//! without its axis aligned artifacts.
+float SimplexNoise( ae::Vec2 p, uint32_t seed = 0 );
+float SimplexNoise( ae::Vec3 p, uint32_t seed = 0 );
+float SimplexNoise( ae::Vec4 p, uint32_t seed = 0 );
+void SimplexNoise( const ae::Vec2* p, float* out, uint32_t count, uint32_t seed = 0 );
+void SimplexNoise( const ae::Vec3* p, float* out, uint32_t count, uint32_t seed = 0 );
+void SimplexNoise( const ae::Vec4* p, float* out, uint32_t count, uint32_t seed = 0 );
+
+enum class NoiseType { Gradient, Simplex };
+struct FractalNoiseParams
+{
+	ae::NoiseType type = ae::NoiseType::Simplex;
+	//! The number of layers of noise summed together
+	uint32_t octaves = 4;
+	//! The frequency of the first octave
+	float frequency = 1.0f;
+	//! The frequency multiplier applied after each octave
+	float lacunarity = 2.0f;
+	//! The amplitude multiplier applied after each octave
+	float gain = 0.5f;
+	//! Each octave uses a different seed derived from this value
+	uint32_t seed = 0;
+};
+//! Fractal Brownian motion. Sums \p params.octaves layers of noise and divides
+//! by the total amplitude, so results stay in approximately [-1, 1].
+float FractalNoise( ae::Vec2 p, const ae::FractalNoiseParams& params = {} );
+float FractalNoise( ae::Vec3 p, const ae::FractalNoiseParams& params = {} );
+float FractalNoise( ae::Vec4 p, const ae::FractalNoiseParams& params = {} );
+void FractalNoise( const ae::Vec2* p, float* out, uint32_t count, const ae::FractalNoiseParams& params = {} );
+void FractalNoise( const ae::Vec3* p, float* out, uint32_t count, const ae::FractalNoiseParams& params = {} );
+void FractalNoise( const ae::Vec4* p, float* out, uint32_t count, const ae::FractalNoiseParams& params = {} );
+
 //! @} End Math defgroup
 
+//------------------------------------------------------------------------------
+// Internal ae::_Float4 struct
+//------------------------------------------------------------------------------
+//! Four floats processed in parallel with SSE2, NEON, or scalar code depending
+//! on the platform and AE_ENABLE_SIMD. Comparisons return lane masks (all bits
+//! set or clear) that can be combined with & | and passed to Select().
+//------------------------------------------------------------------------------
+struct _Float4
+{
+#if _AE_SIMD_SSE2_
+	__m128 v;
+	static _Float4 Set( float f ) { return { _mm_set1_ps( f ) }; }
+	static _Float4 Load( const float* p ) { return { _mm_loadu_ps( p ) }; }
+	static _Float4 FromBytes( const uint8_t* p )
+	{
+		int32_t i;
+		memcpy( &i, p, 4 );
+		const __m128i zero = _mm_setzero_si128();
+		const __m128i b = _mm_unpacklo_epi16( _mm_unpacklo_epi8( _mm_cvtsi32_si128( i ), zero ), zero );
+		return { _mm_cvtepi32_ps( b ) };
+	}
+	void Store( float* p ) const { _mm_storeu_ps( p, v ); }
+	_Float4 operator + ( _Float4 o ) const { return { _mm_add_ps( v, o.v ) }; }
+	_Float4 operator - ( _Float4 o ) const { return { _mm_sub_ps( v, o.v ) }; }
+	_Float4 operator * ( _Float4 o ) const { return { _mm_mul_ps( v, o.v ) }; }
+	_Float4 operator / ( _Float4 o ) const { return { _mm_div_ps( v, o.v ) }; }
+	_Float4 operator & ( _Float4 o ) const { return { _mm_and_ps( v, o.v ) }; }
+	_Float4 operator | ( _Float4 o ) const { return { _mm_or_ps( v, o.v ) }; }
+	_Float4 operator < ( _Float4 o ) const { return { _mm_cmplt_ps( v, o.v ) }; }
+	_Float4 operator <= ( _Float4 o ) const { return { _mm_cmple_ps( v, o.v ) }; }
+	_Float4 operator > ( _Float4 o ) const { return { _mm_cmpgt_ps( v, o.v ) }; }
+	_Float4 operator >= ( _Float4 o ) const { return { _mm_cmpge_ps( v, o.v ) }; }
+	static _Float4 Min( _Float4 a, _Float4 b ) { return { _mm_min_ps( a.v, b.v ) }; }
+	static _Float4 Max( _Float4 a, _Float4 b ) { return { _mm_max_ps( a.v, b.v ) }; }
+	//! Returns \p a where \p mask is set and \p b otherwise
+	static _Float4 Select( _Float4 mask, _Float4 a, _Float4 b ) { return { _mm_or_ps( _mm_and_ps( mask.v, a.v ), _mm_andnot_ps( mask.v, b.v ) ) }; }
+	//! Returns one bit per lane, set if the lane's sign bit is set
+	uint32_t GetMask() const { return (uint32_t)_mm_movemask_ps( v ); }
+	static _Float4 Sqrt( _Float4 a ) { return { _mm_sqrt_ps( a.v ) }; }
+	//! Returns ( a[ X ], a[ Y ], b[ Z ], b[ W ] )
+	template< int X, int Y, int Z, int W >
+	static _Float4 Shuffle( _Float4 a, _Float4 b ) { return { _mm_shuffle_ps( a.v, b.v, _MM_SHUFFLE( W, Z, Y, X ) ) }; }
+	//! Transposes the 4x4 matrix with rows \p r0 to \p r3 in place
+	static void Transpose( _Float4& r0, _Float4& r1, _Float4& r2, _Float4& r3 ) { _MM_TRANSPOSE4_PS( r0.v, r1.v, r2.v, r3.v ); }
+#elif _AE_SIMD_NEON_
+	float32x4_t v;
+	static _Float4 Set( float f ) { return { vdupq_n_f32( f ) }; }
+	static _Float4 Load( const float* p ) { return { vld1q_f32( p ) }; }
+	static _Float4 FromBytes( const uint8_t* p )
+	{
+		uint32_t u;
+		memcpy( &u, p, 4 );
+		const uint16x8_t b = vmovl_u8( vreinterpret_u8_u32( vdup_n_u32( u ) ) );
+		return { vcvtq_f32_u32( vmovl_u16( vget_low_u16( b ) ) ) };
+	}
+	void Store( float* p ) const { vst1q_f32( p, v ); }
+	_Float4 operator + ( _Float4 o ) const { return { vaddq_f32( v, o.v ) }; }
+	_Float4 operator - ( _Float4 o ) const { return { vsubq_f32( v, o.v ) }; }
+	_Float4 operator * ( _Float4 o ) const { return { vmulq_f32( v, o.v ) }; }
+#if defined(__aarch64__)
+	_Float4 operator / ( _Float4 o ) const { return { vdivq_f32( v, o.v ) }; }
+#else
+	_Float4 operator / ( _Float4 o ) const
+	{
+		float a[ 4 ], b[ 4 ];
+		vst1q_f32( a, v );
+		vst1q_f32( b, o.v );
+		for( uint32_t i = 0; i < 4; i++ ) { a[ i ] /= b[ i ]; }
+		return { vld1q_f32( a ) };
+	}
+#endif
+	_Float4 operator & ( _Float4 o ) const { return { vreinterpretq_f32_u32( vandq_u32( vreinterpretq_u32_f32( v ), vreinterpretq_u32_f32( o.v ) ) ) }; }
+	_Float4 operator | ( _Float4 o ) const { return { vreinterpretq_f32_u32( vorrq_u32( vreinterpretq_u32_f32( v ), vreinterpretq_u32_f32( o.v ) ) ) }; }
+	_Float4 operator < ( _Float4 o ) const { return { vreinterpretq_f32_u32( vcltq_f32( v, o.v ) ) }; }
+	_Float4 operator <= ( _Float4 o ) const { return { vreinterpretq_f32_u32( vcleq_f32( v, o.v ) ) }; }
+	_Float4 operator > ( _Float4 o ) const { return { vreinterpretq_f32_u32( vcgtq_f32( v, o.v ) ) }; }
+	_Float4 operator >= ( _Float4 o ) const { return { vreinterpretq_f32_u32( vcgeq_f32( v, o.v ) ) }; }
+	static _Float4 Min( _Float4 a, _Float4 b ) { return { vminq_f32( a.v, b.v ) }; }
+	static _Float4 Max( _Float4 a, _Float4 b ) { return { vmaxq_f32( a.v, b.v ) }; }
+	static _Float4 Select( _Float4 mask, _Float4 a, _Float4 b ) { return { vbslq_f32( vreinterpretq_u32_f32( mask.v ), a.v, b.v ) }; }
+	uint32_t GetMask() const
+	{
+		const uint32x4_t bits = vshrq_n_u32( vreinterpretq_u32_f32( v ), 31 );
+		return vgetq_lane_u32( bits, 0 ) | ( vgetq_lane_u32( bits, 1 ) << 1 ) | ( vgetq_lane_u32( bits, 2 ) << 2 ) | ( vgetq_lane_u32( bits, 3 ) << 3 );
+	}
+#if defined(__aarch64__)
+	static _Float4 Sqrt( _Float4 a ) { return { vsqrtq_f32( a.v ) }; }
+#else
+	static _Float4 Sqrt( _Float4 a )
+	{
+		float f[ 4 ];
+		vst1q_f32( f, a.v );
+		for( uint32_t i = 0; i < 4; i++ ) { f[ i ] = std::sqrt( f[ i ] ); }
+		return { vld1q_f32( f ) };
+	}
+#endif
+	template< int X, int Y, int Z, int W >
+	static _Float4 Shuffle( _Float4 a, _Float4 b )
+	{
+		float32x4_t r = vdupq_n_f32( vgetq_lane_f32( a.v, X ) );
+		r = vsetq_lane_f32( vgetq_lane_f32( a.v, Y ), r, 1 );
+		r = vsetq_lane_f32( vgetq_lane_f32( b.v, Z ), r, 2 );
+		return { vsetq_lane_f32( vgetq_lane_f32( b.v, W ), r, 3 ) };
+	}
+	static void Transpose( _Float4& r0, _Float4& r1, _Float4& r2, _Float4& r3 )
+	{
+		const float32x4x2_t t0 = vtrnq_f32( r0.v, r1.v );
+		const float32x4x2_t t1 = vtrnq_f32( r2.v, r3.v );
+		r0.v = vcombine_f32( vget_low_f32( t0.val[ 0 ] ), vget_low_f32( t1.val[ 0 ] ) );
+		r1.v = vcombine_f32( vget_low_f32( t0.val[ 1 ] ), vget_low_f32( t1.val[ 1 ] ) );
+		r2.v = vcombine_f32( vget_high_f32( t0.val[ 0 ] ), vget_high_f32( t1.val[ 0 ] ) );
+		r3.v = vcombine_f32( vget_high_f32( t0.val[ 1 ] ), vget_high_f32( t1.val[ 1 ] ) );
+	}
+#else
+	float v[ 4 ];
+	static _Float4 Set( float f ) { return { { f, f, f, f } }; }
+	static _Float4 Load( const float* p ) { return { { p[ 0 ], p[ 1 ], p[ 2 ], p[ 3 ] } }; }
+	static _Float4 FromBytes( const uint8_t* p ) { return { { (float)p[ 0 ], (float)p[ 1 ], (float)p[ 2 ], (float)p[ 3 ] } }; }
+	void Store( float* p ) const { for( uint32_t i = 0; i < 4; i++ ) { p[ i ] = v[ i ]; } }
+	_Float4 operator + ( _Float4 o ) const { return m_Op( o, []( float a, float b ) { return a + b; } ); }
+	_Float4 operator - ( _Float4 o ) const { return m_Op( o, []( float a, float b ) { return a - b; } ); }
+	_Float4 operator * ( _Float4 o ) const { return m_Op( o, []( float a, float b ) { return a * b; } ); }
+	_Float4 operator / ( _Float4 o ) const { return m_Op( o, []( float a, float b ) { return a / b; } ); }
+	_Float4 operator & ( _Float4 o ) const { return m_BitOp( o, []( uint32_t a, uint32_t b ) { return a & b; } ); }
+	_Float4 operator | ( _Float4 o ) const { return m_BitOp( o, []( uint32_t a, uint32_t b ) { return a | b; } ); }
+	_Float4 operator < ( _Float4 o ) const { return m_Cmp( o, []( float a, float b ) { return a < b; } ); }
+	_Float4 operator <= ( _Float4 o ) const { return m_Cmp( o, []( float a, float b ) { return a <= b; } ); }
+	_Float4 operator > ( _Float4 o ) const { return m_Cmp( o, []( float a, float b ) { return a > b; } ); }
+	_Float4 operator >= ( _Float4 o ) const { return m_Cmp( o, []( float a, float b ) { return a >= b; } ); }
+	// Matches SSE, which returns the second operand if either is NaN
+	static _Float4 Min( _Float4 a, _Float4 b ) { return a.m_Op( b, []( float x, float y ) { return ( x < y ) ? x : y; } ); }
+	static _Float4 Max( _Float4 a, _Float4 b ) { return a.m_Op( b, []( float x, float y ) { return ( x > y ) ? x : y; } ); }
+	static _Float4 Select( _Float4 mask, _Float4 a, _Float4 b )
+	{
+		_Float4 r;
+		for( uint32_t i = 0; i < 4; i++ ) { r.v[ i ] = m_GetBits( mask.v[ i ] ) ? a.v[ i ] : b.v[ i ]; }
+		return r;
+	}
+	uint32_t GetMask() const
+	{
+		uint32_t r = 0;
+		for( uint32_t i = 0; i < 4; i++ ) { r |= ( m_GetBits( v[ i ] ) >> 31 ) << i; }
+		return r;
+	}
+	static _Float4 Sqrt( _Float4 a ) { return { { std::sqrt( a.v[ 0 ] ), std::sqrt( a.v[ 1 ] ), std::sqrt( a.v[ 2 ] ), std::sqrt( a.v[ 3 ] ) } }; }
+	template< int X, int Y, int Z, int W >
+	static _Float4 Shuffle( _Float4 a, _Float4 b ) { return { { a.v[ X ], a.v[ Y ], b.v[ Z ], b.v[ W ] } }; }
+	static void Transpose( _Float4& r0, _Float4& r1, _Float4& r2, _Float4& r3 )
+	{
+		std::swap( r0.v[ 1 ], r1.v[ 0 ] );
+		std::swap( r0.v[ 2 ], r2.v[ 0 ] );
+		std::swap( r0.v[ 3 ], r3.v[ 0 ] );
+		std::swap( r1.v[ 2 ], r2.v[ 1 ] );
+		std::swap( r1.v[ 3 ], r3.v[ 1 ] );
+		std::swap( r2.v[ 3 ], r3.v[ 2 ] );
+	}
+private:
+	static uint32_t m_GetBits( float f ) { uint32_t u; memcpy( &u, &f, 4 ); return u; }
+	static float m_SetBits( uint32_t u ) { float f; memcpy( &f, &u, 4 ); return f; }
+	template< typename Fn > _Float4 m_Op( _Float4 o, Fn fn ) const { _Float4 r; for( uint32_t i = 0; i < 4; i++ ) { r.v[ i ] = fn( v[ i ], o.v[ i ] ); } return r; }
+	template< typename Fn > _Float4 m_BitOp( _Float4 o, Fn fn ) const { _Float4 r; for( uint32_t i = 0; i < 4; i++ ) { r.v[ i ] = m_SetBits( fn( m_GetBits( v[ i ] ), m_GetBits( o.v[ i ] ) ) ); } return r; }
+	template< typename Fn > _Float4 m_Cmp( _Float4 o, Fn fn ) const { _Float4 r; for( uint32_t i = 0; i < 4; i++ ) { r.v[ i ] = m_SetBits( fn( v[ i ], o.v[ i ] ) ? ~0u : 0u ); } return r; }
+public:
+#endif
+	float operator[]( uint32_t idx ) const { float f[ 4 ]; Store( f ); return f[ idx ]; }
+	static _Float4 Set( float x, float y, float z, float w ) { const float f[ 4 ] = { x, y, z, w }; return Load( f ); }
+	//! Returns ( v[ X ], v[ Y ], v[ Z ], v[ W ] )
+	template< int X, int Y, int Z, int W >
+	_Float4 Swizzle() const { return Shuffle< X, Y, Z, W >( *this, *this ); }
+};
+
+//------------------------------------------------------------------------------
+// Internal ae::_Uint4 struct
+//------------------------------------------------------------------------------
+//! Four uint32_t's processed in parallel, the integer counterpart of
+//! ae::_Float4. Arithmetic wraps.
+//------------------------------------------------------------------------------
+struct _Uint4
+{
+#if _AE_SIMD_SSE2_
+	__m128i v;
+	static _Uint4 Load( const uint32_t* p ) { return { _mm_loadu_si128( (const __m128i*)p ) }; }
+	void Store( uint32_t* p ) const { _mm_storeu_si128( (__m128i*)p, v ); }
+	_Uint4 operator + ( _Uint4 o ) const { return { _mm_add_epi32( v, o.v ) }; }
+	_Uint4 operator ^ ( _Uint4 o ) const { return { _mm_xor_si128( v, o.v ) }; }
+	_Uint4 operator | ( _Uint4 o ) const { return { _mm_or_si128( v, o.v ) }; }
+	template< int N > _Uint4 ShiftLeft() const { return { _mm_slli_epi32( v, N ) }; }
+	template< int N > _Uint4 ShiftRight() const { return { _mm_srli_epi32( v, N ) }; }
+	//! Converts each lane to float, which is exact for values below 2^24
+	_Float4 ToFloat() const { return { _mm_cvtepi32_ps( v ) }; }
+#elif _AE_SIMD_NEON_
+	uint32x4_t v;
+	static _Uint4 Load( const uint32_t* p ) { return { vld1q_u32( p ) }; }
+	void Store( uint32_t* p ) const { vst1q_u32( p, v ); }
+	_Uint4 operator + ( _Uint4 o ) const { return { vaddq_u32( v, o.v ) }; }
+	_Uint4 operator ^ ( _Uint4 o ) const { return { veorq_u32( v, o.v ) }; }
+	_Uint4 operator | ( _Uint4 o ) const { return { vorrq_u32( v, o.v ) }; }
+	template< int N > _Uint4 ShiftLeft() const { return { vshlq_n_u32( v, N ) }; }
+	template< int N > _Uint4 ShiftRight() const { return { vshrq_n_u32( v, N ) }; }
+	_Float4 ToFloat() const { return { vcvtq_f32_u32( v ) }; }
+#else
+	uint32_t v[ 4 ];
+	static _Uint4 Load( const uint32_t* p ) { return { { p[ 0 ], p[ 1 ], p[ 2 ], p[ 3 ] } }; }
+	void Store( uint32_t* p ) const { for( uint32_t i = 0; i < 4; i++ ) { p[ i ] = v[ i ]; } }
+	_Uint4 operator + ( _Uint4 o ) const { return { { v[ 0 ] + o.v[ 0 ], v[ 1 ] + o.v[ 1 ], v[ 2 ] + o.v[ 2 ], v[ 3 ] + o.v[ 3 ] } }; }
+	_Uint4 operator ^ ( _Uint4 o ) const { return { { v[ 0 ] ^ o.v[ 0 ], v[ 1 ] ^ o.v[ 1 ], v[ 2 ] ^ o.v[ 2 ], v[ 3 ] ^ o.v[ 3 ] } }; }
+	_Uint4 operator | ( _Uint4 o ) const { return { { v[ 0 ] | o.v[ 0 ], v[ 1 ] | o.v[ 1 ], v[ 2 ] | o.v[ 2 ], v[ 3 ] | o.v[ 3 ] } }; }
+	template< int N > _Uint4 ShiftLeft() const { return { { v[ 0 ] << N, v[ 1 ] << N, v[ 2 ] << N, v[ 3 ] << N } }; }
+	template< int N > _Uint4 ShiftRight() const { return { { v[ 0 ] >> N, v[ 1 ] >> N, v[ 2 ] >> N, v[ 3 ] >> N } }; }
+	_Float4 ToFloat() const { return _Float4::Set( (float)v[ 0 ], (float)v[ 1 ], (float)v[ 2 ], (float)v[ 3 ] ); }
+#endif
+	template< int N > _Uint4 RotateLeft() const { return ShiftLeft< N >() | ShiftRight< 32 - N >(); }
+};
+
+//------------------------------------------------------------------------------
+// Internal ae::_Vec3x4 struct
+//------------------------------------------------------------------------------
+//! Four ae::Vec3's in structure-of-arrays layout, used with ae::_Float4.
+//------------------------------------------------------------------------------
+struct _Vec3x4
+{
+	static _Vec3x4 Set( ae::Vec3 p ) { return { _Float4::Set( p.x ), _Float4::Set( p.y ), _Float4::Set( p.z ) }; }
+	_Vec3x4 operator - ( const _Vec3x4& o ) const { return { x - o.x, y - o.y, z - o.z }; }
+	_Float4 Dot( const _Vec3x4& o ) const { return x * o.x + y * o.y + z * o.z; }
+	_Vec3x4 Cross( const _Vec3x4& o ) const { return { y * o.z - z * o.y, z * o.x - x * o.z, x * o.y - y * o.x }; }
+	_Float4 x, y, z;
+};
+
 //------------------------------------------------------------------------------
 // ae::Color struct
 //------------------------------------------------------------------------------
@@ -3252,6 +3678,8 @@ inline std::ostream& operator<<( std::ostream& os, RectInt r )
 	return os << r.x << " " << r.y << " " << r.w << " " << r.h;
 }
 
+class BinaryStream;
+class BinaryWriter;
 //------------------------------------------------------------------------------
 // ae::BVHNode struct
 //------------------------------------------------------------------------------
@@ -3280,6 +3708,19 @@ struct BVHLeaf
 	uint32_t count;
 };
 
+//------------------------------------------------------------------------------
+// ae::BVHNearest struct
+//------------------------------------------------------------------------------
+//! Result element of ae::BVH::QueryNearest(). \p data points to an element of
+//! the data provided to ae::BVH::Build() or ae::BVH::SetLeaf().
+//------------------------------------------------------------------------------
+template< typename T >
+struct BVHNearest
+{
+	const T* data = nullptr;
+	float distance = INFINITY;
+};
+
 //------------------------------------------------------------------------------
 // ae::BVH class
 //------------------------------------------------------------------------------
@@ -3315,6 +3756,14 @@ public:
 	std::pair< int32_t, int32_t > AddNodes( int32_t parentIdx, const ae::AABB& leftAABB, const ae::AABB& rightAABB );
 	//! Sets the leaf data of the node at \p nodeIdx
 	void SetLeaf( int32_t nodeIdx, T* data, uint32_t count );
+	//! Recalculates the aabb of the node at \p nodeIdx from its leaf data and
+	//! children, then updates its ancestors to match. Call this after elements
+	//! of a leaf have moved instead of rebuilding the whole tree. The tree
+	//! structure is not changed, so queries become less efficient as elements
+	//! move far from where they were built. \p aabbFn is the same as in
+	//! ae::BVH::Build().
+	template< typename AABBFn >
+	void Refit( int32_t nodeIdx, AABBFn aabbFn );
 	//! Resets BVH to state directly after construction. Does not affect node limit.
 	void Clear();
 	
@@ -3335,6 +3784,67 @@ public:
 	uint32_t GetAvailable() const { return m_limit ? m_limit - ae::Max( 1u, m_nodes.Length() ): 0; }
 	//! Returns the max number of nodes, or 0 if no limit was specified
 	uint32_t GetLimit() const { return m_limit; }
+	//! Returns the number of nodes, including the root
+	uint32_t GetNodeCount() const { return m_nodes.Length(); }
+	//! Returns the number of leaves
+	uint32_t GetLeafCount() const { return m_leaves.Length(); }
+
+	//! Non-recursively visits nodes depth-first, left child before right.
+	//! \p nodeFn should have the signature bool()( const ae::BVHNode& node ) and
+	//! return true if the node's leaf and children should be visited. \p leafFn
+	//! should have the signature bool()( const ae::BVHLeaf< T >& leaf ) and can
+	//! return false to stop the traversal. Returns false if stopped early.
+	template< typename NodeFn, typename LeafFn >
+	bool Traverse( NodeFn nodeFn, LeafFn leafFn ) const;
+	//! Calls \p leafFn for each leaf with a node aabb overlapping \p aabb. See
+	//! ae::BVH::Traverse() for the \p leafFn signature.
+	template< typename LeafFn >
+	bool QueryAABB( const ae::AABB& aabb, LeafFn leafFn ) const;
+	//! Calls \p leafFn for each leaf with a node aabb that is at least partially
+	//! inside \p frustum. See ae::BVH::Traverse() for the \p leafFn signature.
+	template< typename LeafFn >
+	bool QueryFrustum( const ae::Frustum& frustum, LeafFn leafFn ) const;
+	//! Calls \p leafFn for each leaf with a node aabb overlapping \p sphere. See
+	//! ae::BVH::Traverse() for the \p leafFn signature.
+	template< typename LeafFn >
+	bool QuerySphere( const ae::Sphere& sphere, LeafFn leafFn ) const;
+	//! Appends the leaves with node aabbs overlapping \p aabb to \p leavesOut.
+	//! The query stops early if \p leavesOut has a fixed size and is full.
+	template< uint32_t M >
+	void QueryAABB( const ae::AABB& aabb, ae::Array< const BVHLeaf< T >*, M >* leavesOut ) const;
+	//! Appends the leaves with node aabbs at least partially inside \p frustum
+	//! to \p leavesOut. The query stops early if \p leavesOut has a fixed size
+	//! and is full.
+	template< uint32_t M >
+	void QueryFrustum( const ae::Frustum& frustum, ae::Array< const BVHLeaf< T >*, M >* leavesOut ) const;
+	//! Appends the leaves with node aabbs overlapping \p sphere to \p leavesOut.
+	//! The query stops early if \p leavesOut has a fixed size and is full.
+	template< uint32_t M >
+	void QuerySphere( const ae::Sphere& sphere, ae::Array< const BVHLeaf< T >*, M >* leavesOut ) const;
+	//! Finds the \p k elements closest to \p point. \p nearestOut is cleared and
+	//! then filled with the results sorted from nearest to farthest. \p distanceFn
+	//! should have the signature float()( const T& elem ) and return the distance
+	//! from \p point to \p elem. Nodes are visited nearest first and are skipped
+	//! entirely when their aabb is farther than the current k-th result, so the
+	//! returned distances must never be less than the distance to the aabb
+	//! used to build the node. Elements farther than \p maxDistance are ignored.
+	template< typename DistanceFn, uint32_t M >
+	void QueryNearest( ae::Vec3 point, uint32_t k, DistanceFn distanceFn, ae::Array< BVHNearest< T >, M >* nearestOut, float maxDistance = INFINITY ) const;
+
+	//! Writes all nodes and leaves to \p stream so they can be loaded without
+	//! calling Build(). ae::BVHLeaf::data is stored as an element offset from
+	//! \p data, which should be the data given to Build(). Nodes are written
+	//! with the in-memory layout of the current platform.
+	void Serialize( ae::BinaryWriter* stream, const T* data ) const;
+	//! Reads nodes and leaves written by the function above, or writes them if
+	//! \p stream is a writer. ae::BVHLeaf::data is restored relative to \p data.
+	//! The stream is invalidated and this ae::BVH is cleared if the data is
+	//! malformed, exceeds the node limit, or references elements past \p count.
+	void Serialize( ae::BinaryStream* stream, T* data, uint32_t count );
+
+	//! The maximum number of pending nodes during ae::BVH::Traverse(). This
+	//! limits the depth of the tree that can be traversed.
+	static constexpr uint32_t kTraversalStackSize = 256;
 
 private:
 	template< typename AABBFn >
@@ -3344,6 +3854,74 @@ private:
 	ae::Array< BVHLeaf< T >, (N + 1)/2 > m_leaves;
 };
 
+//------------------------------------------------------------------------------
+// ae::QuantizedBVHNode struct
+//------------------------------------------------------------------------------
+//! A node with up to four children whose bounds are stored as 8 bit offsets
+//! from the node's own bounds. See ae::QuantizedBVH.
+//------------------------------------------------------------------------------
+struct QuantizedBVHNode
+{
+	//! Set in ae::QuantizedBVHNode::children for leaf children, the remaining
+	//! bits are the leaf index
+	static constexpr uint16_t kLeafBit = 0x8000;
+	//! Value of ae::QuantizedBVHNode::children for unused children
+	static constexpr uint16_t kEmpty = 0xFFFF;
+	float origin[ 3 ]; //!< Min corner of the node
+	float scale[ 3 ]; //!< Size of one quantization step on each axis
+	uint8_t childMin[ 3 ][ 4 ]; //!< [axis][child] Rounded down
+	uint8_t childMax[ 3 ][ 4 ]; //!< [axis][child] Rounded up
+	uint16_t children[ 4 ];
+};
+
+//------------------------------------------------------------------------------
+// ae::QuantizedBVH class
+//------------------------------------------------------------------------------
+//! A compact four-wide version of an ae::BVH. Four levels of binary nodes are
+//! collapsed into each ae::QuantizedBVHNode, with child bounds conservatively
+//! quantized relative to the node. Each 56 byte node replaces up to three
+//! 48 byte ae::BVHNode's. A single ray is tested against all four child bounds
+//! at once with SSE2 or NEON when available (see AE_ENABLE_SIMD). Leaves
+//! reference the same data as the ae::BVH it was built from.
+//------------------------------------------------------------------------------
+template< typename T, uint32_t N = 0 >
+class QuantizedBVH
+{
+public:
+	QuantizedBVH() = default; //!< Static (N > 0)
+	QuantizedBVH( const ae::Tag& allocTag ); //!< Dynamic (N == 0)
+
+	//! Builds from \p bvh, which can be destroyed afterwards as long as the
+	//! data referenced by its leaves is still valid.
+	void Build( const ae::BVH< T, N >& bvh );
+	void Clear();
+
+	//! Visits the leaves intersected by the segment \p source + \p ray * t for
+	//! t in [0, \p maxT] nearest first. \p leafFn should have the signature
+	//! float()( const ae::BVHLeaf< T >& leaf, float maxT ) and return the new
+	//! maxT (ie. the t of the farthest hit that should still be reported), or a
+	//! negative value to stop the traversal.
+	template< typename LeafFn >
+	void Raycast( ae::Vec3 source, ae::Vec3 ray, LeafFn leafFn, float maxT = 1.0f ) const;
+
+	//! Returns the root node or null if not built
+	const QuantizedBVHNode* GetRoot() const { return m_nodes.Length() ? &m_nodes[ 0 ] : nullptr; }
+	uint32_t GetNodeCount() const { return m_nodes.Length(); }
+	const BVHLeaf< T >& GetLeaf( int32_t leafIdx ) const { return m_leaves[ leafIdx ]; }
+	//! Returns the number of bytes used by nodes and leaves
+	uint32_t GetMemoryUsage() const { return m_nodes.Length() * sizeof(QuantizedBVHNode) + m_leaves.Length() * sizeof(BVHLeaf< T >); }
+
+	//! See ae::BVH::Serialize()
+	void Serialize( ae::BinaryWriter* stream, const T* data ) const;
+	//! See ae::BVH::Serialize()
+	void Serialize( ae::BinaryStream* stream, T* data, uint32_t count );
+
+private:
+	uint16_t m_Build( const ae::BVH< T, N >& bvh, int32_t bvhNodeIdx );
+	ae::Array< QuantizedBVHNode, N > m_nodes;
+	ae::Array< BVHLeaf< T >, (N + 1)/2 > m_leaves;
+};
+
 //------------------------------------------------------------------------------
 // Log utilities
 //------------------------------------------------------------------------------
@@ -5470,6 +6048,23 @@ RaycastResult Raycast( const Sphere& sphere, const RaycastParams& params, Raycas
 RaycastResult Raycast( const Plane& plane, const RaycastParams& params, RaycastResult prevResult = {} );
 RaycastResult Raycast( const AABB& aabb, const RaycastParams& params, RaycastResult prevResult = {} );
 RaycastResult Raycast( const OBB& obb, const RaycastParams& params, RaycastResult prevResult = {} );
+//! Hit visitor versions of the above. Instead of accumulating hits into a
+//! RaycastResult, \p hitFn is called for each hit so that any number of hits
+//! can be handled without copying results. \p hitFn should have the signature
+//! bool()( const ae::RaycastResult::Hit& hit ) and can return false to stop.
+//! RaycastParams::maxHits is ignored. Returns false if stopped early.
+template< typename Fn > bool RaycastEach( const Triangle& tri, const RaycastParams& params, Fn hitFn, const TriangleRaycastParams& triParams = {} );
+template< typename Fn > bool RaycastEach( const Sphere& sphere, const RaycastParams& params, Fn hitFn );
+template< typename Fn > bool RaycastEach( const Plane& plane, const RaycastParams& params, Fn hitFn );
+template< typename Fn > bool RaycastEach( const AABB& aabb, const RaycastParams& params, Fn hitFn );
+template< typename Fn > bool RaycastEach( const OBB& obb, const RaycastParams& params, Fn hitFn );
+//! Internal, sets \p hitOut and returns true if the ray described by \p params
+//! hits the given shape
+bool _GetRaycastHit( const Triangle& tri, const RaycastParams& params, const TriangleRaycastParams& triParams, RaycastResult::Hit* hitOut );
+bool _GetRaycastHit( const Sphere& sphere, const RaycastParams& params, RaycastResult::Hit* hitOut );
+bool _GetRaycastHit( const Plane& plane, const RaycastParams& params, RaycastResult::Hit* hitOut );
+bool _GetRaycastHit( const AABB& aabb, const RaycastParams& params, RaycastResult::Hit* hitOut );
+bool _GetRaycastHit( const OBB& obb, const RaycastParams& params, RaycastResult::Hit* hitOut );
 
 //------------------------------------------------------------------------------
 // ae::CollisionMeshPushOutParams
@@ -5509,6 +6104,67 @@ struct PushOutInfo
 	static void Accumulate( const PushOutParams& params, const PushOutInfo& prev, PushOutInfo* next );
 };
 
+//------------------------------------------------------------------------------
+// ae::SweepParams
+//------------------------------------------------------------------------------
+//! A sphere, or a capsule when \p capsuleOffset is non-zero, moving along
+//! \p sweep. The capsule's segment starts at \p source and ends at \p source +
+//! \p capsuleOffset.
+//------------------------------------------------------------------------------
+struct SweepParams
+{
+	ae::Vec3 source = ae::Vec3( 0.0f );
+	ae::Vec3 capsuleOffset = ae::Vec3( 0.0f );
+	float radius = 0.5f;
+	ae::Vec3 sweep = ae::Vec3( 0.0f, 0.0f, -1.0f );
+	ae::Any< 32, 16 > userData;
+};
+
+//------------------------------------------------------------------------------
+// ae::SweepResult
+//------------------------------------------------------------------------------
+//! The first contact of an ae::SweepParams shape. Moving the shape by
+//! SweepParams::sweep * \p t places it exactly in contact with \p position.
+//------------------------------------------------------------------------------
+struct SweepResult
+{
+	bool hit = false;
+	float t = 1.0f; //!< Time of impact in [0,1], 0 if initially overlapping
+	float distance = 0.0f; //!< Distance travelled before impact
+	ae::Vec3 position = ae::Vec3( 0.0f ); //!< Contact point on the collision surface
+	ae::Vec3 normal = ae::Vec3( 0.0f ); //!< Points from \p position towards the shape
+	ae::Any< 32, 16 > userData;
+	CollisionExtra extra = {}; // @TODO: Cleanup. This is CollisionMesh specific.
+};
+
+//------------------------------------------------------------------------------
+// ae::CollisionMeshSweepParams
+//------------------------------------------------------------------------------
+struct CollisionMeshSweepParams
+{
+	ae::Matrix4 transform = ae::Matrix4::Identity();
+	bool hitCounterclockwise = true;
+	bool hitClockwise = false;
+	ae::DebugLines* debug = nullptr; // Draw collision results
+	ae::Color debugColor = ae::Color::Red();
+};
+
+//------------------------------------------------------------------------------
+// ae::CollisionMeshClosestPoint
+//------------------------------------------------------------------------------
+//! Result of ae::CollisionMesh::GetClosestPoint() and
+//! ae::CollisionMesh::QueryNearest(). All values are in the space of the
+//! collision mesh vertices.
+//------------------------------------------------------------------------------
+struct CollisionMeshClosestPoint
+{
+	ae::Vec3 position = ae::Vec3( 0.0f );
+	ae::Vec3 normal = ae::Vec3( 0.0f ); //!< Counterclockwise triangle normal
+	float distance = INFINITY;
+	uint32_t triIdx = 0; //!< See ae::CollisionMesh::GetTriangle()
+	CollisionExtra extra = {};
+};
+
 //------------------------------------------------------------------------------
 // ae::CollisionMesh class
 //------------------------------------------------------------------------------
@@ -5545,13 +6201,78 @@ public:
 	//! Returns true if  BuildBVH() should be called. Returns false if BuildBVH()
 	//! will early out.
 	bool RequiresBVHRebuild() const { return m_requiresRebuild; }
+	//! When enabled BuildBVH() also creates an ae::QuantizedBVH which is then
+	//! used by Raycast(). This uses less memory per node and visits nodes
+	//! nearest first, skipping nodes beyond the farthest hit once
+	//! RaycastParams::maxHits have been found. Disabled by default.
+	void SetQuantizedBVHEnabled( bool enabled );
+	bool GetQuantizedBVHEnabled() const { return m_quantizedBVHEnabled; }
 	//! Resets CollisionMesh to its original empty state, except reserved buffer
 	//! sizes are maintained.
 	void Clear();
 
 	RaycastResult Raycast( const RaycastParams& params, const CollisionMeshRaycastParams& meshParams = {}, RaycastResult prevResult = {} ) const;
+	//! Calls \p hitFn for every triangle hit by the ray instead of keeping the
+	//! closest RaycastParams::maxHits, so there is no limit on the number of
+	//! hits and nothing is copied between calls. Hits are visited in traversal
+	//! order, not sorted by distance. \p hitFn should have the signature
+	//! bool()( const ae::RaycastResult::Hit& hit ) and can return false to stop
+	//! the query. Returns false if stopped early.
+	template< typename Fn > bool RaycastEach( const RaycastParams& params, Fn hitFn, const CollisionMeshRaycastParams& meshParams = {} ) const;
+	//! Casts \p count rays against the mesh. Rays are grouped into packets of
+	//! four that traverse the bvh together, with the aabb and triangle tests
+	//! using SSE2 or NEON when available (see AE_ENABLE_SIMD). This is most
+	//! efficient when consecutive rays are coherent, ie. they have similar
+	//! sources and directions. Each element of \p resultsOut receives the hits
+	//! of the corresponding element of \p params. Like the prevResult parameter
+	//! of Raycast(), existing hits in \p resultsOut are kept and sorted with
+	//! new hits, so multiple meshes can be cast against in sequence.
+	void RaycastBatch( const RaycastParams* params, uint32_t count, RaycastResult* resultsOut, const CollisionMeshRaycastParams& meshParams = {} ) const;
 	PushOutInfo PushOut( const PushOutParams& params, const CollisionMeshPushOutParams& meshParams = {}, const PushOutInfo& prevInfo = {} ) const;
-	// @TODO: GetClosestPoint()
+	//! Moves a sphere or capsule along SweepParams::sweep and returns its first
+	//! contact with the mesh, so fast moving objects can't tunnel through
+	//! it. The sweep is done in world space, so non-uniform scale in
+	//! CollisionMeshSweepParams::transform is supported. Pass the result of a
+	//! previous call as \p prevResult to sweep against multiple meshes, only a
+	//! contact earlier than \p prevResult will replace it.
+	SweepResult Sweep( const SweepParams& params, const CollisionMeshSweepParams& meshParams = {}, SweepResult prevResult = {} ) const;
+	//! Finds the closest point on the surface of the mesh to \p point. Returns
+	//! false if the mesh is empty or no triangle is within \p maxDistance. All
+	//! values are in the space of the mesh vertices (after any transform given
+	//! to AddIndexed()). BuildBVH() must be called first.
+	bool GetClosestPoint( ae::Vec3 point, CollisionMeshClosestPoint* resultOut, float maxDistance = INFINITY ) const;
+	//! Finds the \p k triangles closest to \p point. \p nearestOut is cleared and
+	//! then filled with the results sorted from nearest to farthest.
+	template< uint32_t N >
+	void QueryNearest( ae::Vec3 point, uint32_t k, ae::Array< CollisionMeshClosestPoint, N >* nearestOut, float maxDistance = INFINITY ) const;
+
+	//! Calls \p fn for each triangle whose bounds overlap \p aabb. \p fn should
+	//! have the signature bool()( uint32_t triIdx ) and can return false to stop
+	//! the query. See GetTriangle() and GetTriangleExtra().
+	template< typename Fn > void QueryAABB( const ae::AABB& aabb, Fn fn ) const;
+	//! Calls \p fn for each triangle whose bounds are at least partially inside
+	//! \p frustum. See QueryAABB() for the \p fn signature.
+	template< typename Fn > void QueryFrustum( const ae::Frustum& frustum, Fn fn ) const;
+	//! Calls \p fn for each triangle that touches \p sphere. See QueryAABB() for
+	//! the \p fn signature.
+	template< typename Fn > void QuerySphere( const ae::Sphere& sphere, Fn fn ) const;
+	//! Appends the index of each triangle whose bounds overlap \p aabb to
+	//! \p trisOut. The query stops early if \p trisOut has a fixed size and is full.
+	template< uint32_t N > void QueryAABB( const ae::AABB& aabb, ae::Array< uint32_t, N >* trisOut ) const;
+	//! Appends the index of each triangle whose bounds are at least partially
+	//! inside \p frustum to \p trisOut. The query stops early if \p trisOut has
+	//! a fixed size and is full.
+	template< uint32_t N > void QueryFrustum( const ae::Frustum& frustum, ae::Array< uint32_t, N >* trisOut ) const;
+	//! Appends the index of each triangle that touches \p sphere to \p trisOut.
+	//! The query stops early if \p trisOut has a fixed size and is full.
+	template< uint32_t N > void QuerySphere( const ae::Sphere& sphere, ae::Array< uint32_t, N >* trisOut ) const;
+
+	//! Returns the triangle at \p triIdx. Triangles are reordered by BuildBVH(),
+	//! so indices match GetIndices() but not necessarily the order of submission.
+	ae::Triangle GetTriangle( uint32_t triIdx ) const;
+	//! Returns the CollisionExtra of the first vertex of the triangle at \p triIdx
+	CollisionExtra GetTriangleExtra( uint32_t triIdx ) const { return m_collisionExtras[ m_tris[ triIdx ].idx[ 0 ] ]; }
+	uint32_t GetTriangleCount() const { return m_tris.Length(); }
 	ae::AABB GetAABB() const { return m_bvh.GetAABB(); }
 	
 	const ae::Vec3* GetVertices() const { return m_positions.Data(); }
@@ -5559,16 +6280,154 @@ public:
 	uint32_t GetVertexCount() const { return m_positions.Length(); }
 	uint32_t GetIndexCount() const { return m_tris.Length() * 3; }
 
+	//! Writes the mesh, including its bvh, to \p stream so it can be loaded
+	//! later without calling AddIndexed() or BuildBVH(). BuildBVH() must be
+	//! called first. The data is versioned, and is stored with the in-memory
+	//! layout of the current platform so that each array is loaded with a
+	//! single memcpy. Data written on platforms with a different layout or
+	//! CollisionExtra type will fail to load.
+	void Serialize( ae::BinaryWriter* stream ) const;
+	//! Replaces the contents of this mesh with data written by the function
+	//! above, or writes the mesh if \p stream is a writer. The ae::BinaryReader
+	//! can read directly from a memory mapped file. BuildBVH() does not need
+	//! to be called afterwards. If the data is from a different version or
+	//! platform, is malformed, or does not fit in a static mesh, the stream is
+	//! invalidated and the mesh is cleared.
+	void Serialize( ae::BinaryStream* stream );
+
 private:
 	// @TODO: Support user data returned with raycast results
 	struct BVHTri { uint32_t idx[ 3 ]; };
+	static constexpr uint32_t kSerializeMagic = 0x4d436561; // "aeCM"
+	static constexpr uint32_t kSerializeVersion = 1;
+	static ae::AABB m_GetAABB( const ae::Vec3* verts, const BVHTri& tri );
 	const ae::Tag m_tag;
 	ae::AABB m_aabb;
 	bool m_requiresRebuild = false;
+	bool m_quantizedBVHEnabled = false;
 	ae::Array< ae::Vec3, VertMax > m_positions;
 	ae::Array< CollisionExtra, VertMax > m_collisionExtras;
 	ae::Array< BVHTri, TriMax > m_tris;
 	ae::BVH< BVHTri, BVHMax > m_bvh;
+	ae::QuantizedBVH< BVHTri, BVHMax > m_quantizedBVH;
+};
+
+//------------------------------------------------------------------------------
+// ae::BroadphasePair struct
+//------------------------------------------------------------------------------
+//! Two overlapping ae::Broadphase proxies, where \p proxy0 < \p proxy1.
+//------------------------------------------------------------------------------
+struct BroadphasePair
+{
+	uint32_t proxy0;
+	uint32_t proxy1;
+	//! Unique for each pair and stable for as long as both proxies exist
+	uint64_t GetId() const { return ( (uint64_t)proxy0 << 32 ) | proxy1; }
+	bool operator == ( const BroadphasePair& o ) const { return proxy0 == o.proxy0 && proxy1 == o.proxy1; }
+};
+
+//------------------------------------------------------------------------------
+// ae::BroadphaseType
+//------------------------------------------------------------------------------
+enum class BroadphaseType
+{
+	//! Endpoints along each axis are kept sorted between frames, and pairs
+	//! only begin or end where endpoints swap, so updates are nearly linear
+	//! when proxies move coherently. Works well for any distribution of proxy
+	//! sizes.
+	SweepAndPrune,
+	//! Proxies are binned into a uniform grid of cubes keyed by ae::Int3.
+	//! Works best when most proxies are smaller than the cell size. Proxies
+	//! covering more than 64 cells, or with infinite or NaN bounds, are tested
+	//! against every other proxy instead.
+	SpatialHash,
+};
+
+//------------------------------------------------------------------------------
+// ae::Broadphase class
+//------------------------------------------------------------------------------
+//! Finds overlapping pairs of aabbs (proxies) for many dynamic shapes, which
+//! can then be passed to narrowphase tests. Call Update() for moved proxies
+//! and then UpdatePairs() once per frame. Each backend produces the same pairs.
+//------------------------------------------------------------------------------
+class Broadphase
+{
+public:
+	//! \p cellSize is only used by ae::BroadphaseType::SpatialHash, and should
+	//! be roughly the size of a typical proxy.
+	Broadphase( const ae::Tag& tag, ae::BroadphaseType type, float cellSize = 4.0f );
+
+	//! Returns a proxy id which stays valid until Remove() is called. The ids
+	//! of removed proxies are reused after the following UpdatePairs().
+	uint32_t Add( const ae::AABB& aabb, void* userData = nullptr );
+	void Update( uint32_t proxy, const ae::AABB& aabb );
+	//! Pairs with \p proxy are included in GetEndPairs() after the next
+	//! UpdatePairs().
+	void Remove( uint32_t proxy );
+	//! Removes all proxies and pairs without generating end events
+	void Clear();
+
+	//! Finds all overlapping pairs, and the pairs that began or ended since
+	//! the previous call
+	void UpdatePairs();
+	//! All overlapping pairs, sorted by ae::BroadphasePair::GetId()
+	const ae::Array< BroadphasePair >& GetPairs() const { return m_pairs; }
+	//! Pairs that started overlapping during the last UpdatePairs()
+	const ae::Array< BroadphasePair >& GetBeginPairs() const { return m_beginPairs; }
+	//! Pairs that stopped overlapping, or that included a removed proxy,
+	//! during the last UpdatePairs()
+	const ae::Array< BroadphasePair >& GetEndPairs() const { return m_endPairs; }
+
+	ae::AABB GetAABB( uint32_t proxy ) const;
+	void* GetUserData( uint32_t proxy ) const;
+	uint32_t GetProxyCount() const { return m_proxies.Length() - m_freeProxies.Length() - m_removedProxies.Length(); }
+	ae::BroadphaseType GetType() const { return m_type; }
+
+private:
+	struct Proxy
+	{
+		ae::AABB aabb;
+		void* userData = nullptr;
+		bool active = false;
+		bool inEndpoints = false;
+		bool overflow = false;
+	};
+	struct Endpoint
+	{
+		float value;
+		uint32_t proxy;
+		bool isMax;
+		bool operator < ( const Endpoint& o ) const { return value < o.value || ( value == o.value && !isMax && o.isMax ); }
+	};
+	struct CellEntry
+	{
+		uint32_t proxy;
+		int32_t next;
+	};
+	void m_UpdateSweepAndPrune();
+	void m_FindPairsSpatialHash();
+	void m_AddPair( uint32_t p0, uint32_t p1 );
+	const ae::BroadphaseType m_type;
+	const float m_cellSize;
+	ae::Array< Proxy > m_proxies;
+	ae::Array< uint32_t > m_freeProxies;
+	ae::Array< uint32_t > m_removedProxies; //!< Freed after the next UpdatePairs()
+	ae::Array< BroadphasePair > m_pairs;
+	ae::Array< BroadphasePair > m_prevPairs;
+	ae::Array< BroadphasePair > m_beginPairs;
+	ae::Array< BroadphasePair > m_endPairs;
+	// Sweep and prune
+	ae::Array< Endpoint > m_endpoints[ 3 ]; //!< Sorted on each axis
+	ae::Array< Endpoint > m_newEndpoints;
+	ae::Array< Endpoint > m_mergedEndpoints;
+	ae::Array< uint32_t > m_active;
+	ae::Array< uint32_t > m_activeNew;
+	ae::Array< uint32_t > m_activeIndices;
+	// Spatial hash
+	ae::Map< ae::Int3, int32_t > m_cells;
+	ae::Array< CellEntry > m_cellEntries;
+	ae::Array< ae::Int3 > m_minCells;
+	ae::Array< uint32_t > m_overflowProxies;
 };
 
 //------------------------------------------------------------------------------
@@ -5842,6 +6701,9 @@ public:
 		//! Setting this to true will flip the winding order of all triangles
 		//! loaded from the OBJ file.
 		bool flipWinding = false;
+		//! Setting this to true reorders the loaded triangles and vertices for
+		//! rendering with ae::OptimizeVertexCache() and ae::GetVertexFetchRemap()
+		bool optimize = false;
 	};
 	//! Helper struct to load OBJ files directly into an ae::VertexArray
 	struct VertexDataParams
@@ -6400,6 +7262,7 @@ struct IsosurfaceStatus
 	uint64_t indexCount = 0; //!< The max number of indices to generate or 0 for no limit.
 	uint64_t sampleRawCount = 0; //!< The number of samples done against IsosurfaceParams::samplefn
 	uint64_t sampleCacheCount = 0; //!< The number of samples against the cache instead of IsosurfaceParams::samplefn
+	uint64_t sampleCallCount = 0; //!< The number of calls to IsosurfaceParams::sampleFn and IsosurfaceParams::sampleBatchFn combined
 	uint64_t sampleBrickMissCount = 0; //! The number of raw samples that were done for 'empty' bricks
 	uint64_t sampleBrickCount = 0; //!< The number of raw samples that were done for all bricks
 	uint64_t voxelCheckCount = 0; //!< The number of voxels processed
@@ -6407,22 +7270,35 @@ struct IsosurfaceStatus
 	uint64_t voxelWorkingSize = 0; //!< The number of "duals" stored for work on edges
 	uint64_t voxelSearchProgress = 0; //!< The number of voxels of the input bounds searched so far
 	uint64_t voxelAABBSize = 0; //!< The total number of voxels that could have been processed given the input bounds
+	static constexpr uint32_t kMaxThreads = 32;
+	uint32_t threadCount = 0; //!< The number of threads generating the mesh, see IsosurfaceParams::threadCount
+	double threadTime[ kMaxThreads ] = {}; //!< The time each thread spent working in seconds, updated as each stage completes
 };
 using IsosurfaceSampleFn = ae::IsosurfaceValue(*)( const void* userData, ae::Vec3 position );
+using IsosurfaceSampleBatchFn = void(*)( const void* userData, const ae::Vec3* positions, ae::IsosurfaceValue* valuesOut, uint32_t count );
 using IsosurfaceStatusFn = bool(*)( const void* userData, const ae::IsosurfaceStatus& status );
+using IsosurfaceLodFn = uint32_t(*)( const void* userData, ae::AABB region );
 struct IsosurfaceParams
 {
 	//! This function defines the SDF that the generation process attempts
 	//! to construct a mesh from. See ae::IsosurfaceValue for more information.
 	//! \p userData will be provided to this callback.
 	IsosurfaceSampleFn sampleFn = nullptr;
+	//! Optional: The same as \p sampleFn, but evaluates \p count positions at
+	//! once, writing one ae::IsosurfaceValue per position to \p valuesOut. When
+	//! set this is used for filling the internal brick map and for sampling
+	//! normals, so it can be implemented with SIMD and avoids the cost of an
+	//! indirect call per sample. Remaining single samples use \p sampleFn if
+	//! it's set, otherwise this is called with a \p count of 1. At least one
+	//! of \p sampleFn or \p sampleBatchFn must be set.
+	IsosurfaceSampleBatchFn sampleBatchFn = nullptr;
 	//! Optional: If set, this will be called intermittently throughout the
 	//! generation process with up to date timings and counts. A false return
 	//! value will cause generation to abort immediately, causing generation
 	//! to fail gracefully. \p userData will be provided to this callback.
 	IsosurfaceStatusFn statusFn = nullptr;
-	//! This opaque user data value will be provided to both \p sampleFn and
-	//! \p statusFn on each call.
+	//! This opaque user data value will be provided to \p sampleFn,
+	//! \p sampleBatchFn, and \p statusFn on each call.
 	const void* userData = nullptr;
 	
 	//! The bounds for sampling the sdf function and mesh generation
@@ -6443,9 +7319,43 @@ struct IsosurfaceParams
 	//! generation will be slower. The vertex count and triangle indices will be
 	//! nearly identical.
 	bool dualContouring = false;
+	//! The number of threads to generate with, or 0 for ae::GetMaxConcurrentThreads().
+	//! With more than one thread \p sampleFn and \p sampleBatchFn must be safe
+	//! to call from multiple threads at once, while \p statusFn is still only
+	//! called from the thread calling ae::IsosurfaceExtractor::Generate(). The
+	//! mesh is the same as when generated with a single thread, except for the
+	//! order of the vertices and triangles.
+	uint32_t threadCount = 1;
+	//! Keeps the internal brick map and voxels after generation, so that
+	//! ae::IsosurfaceExtractor::Update() can regenerate parts of the mesh. The
+	//! indices are grouped into a stable range per brick, and any space left
+	//! over in these ranges is filled with degenerate triangles.
+	bool incremental = false;
+
+	//! Optional: Enables multi-resolution generation when set. The bounds are
+	//! split into cubes of \p lodRegionSize voxels, and this is called with
+	//! the bounds of each to get its level of detail. Each level doubles the
+	//! voxel size of a region, up to a single voxel per region. Seams are
+	//! generated between regions using the voxel size of the finer side. The
+	//! mesh covers every region overlapping \p aabb, so \p aabb should be a
+	//! multiple of \p lodRegionSize to avoid generating outside of it. This
+	//! can't be combined with \p incremental, and \p brickMap and \p errors
+	//! are not populated. \p userData will be provided to this callback.
+	IsosurfaceLodFn lodFn = nullptr;
+	//! Optional: Enables multi-resolution generation when set and \p lodFn is
+	//! not. Regions within \p lodDistance of this point are generated at full
+	//! resolution, and the level of detail decreases each time the distance
+	//! doubles.
+	std::optional< ae::Vec3 > lodFocus;
+	//! The distance from \p lodFocus where the level of detail first decreases
+	float lodDistance = 32.0f;
+	//! The size of each multi-resolution region in voxels. Must be a power of two.
+	uint32_t lodRegionSize = 32;
 
 	//! Optional: If set this will be populated with the internal octree used
 	//! for accelerating mesh generation, by minimizing calls to \p sampleFn.
+	//! With multi-resolution generation this is populated with the regions
+	//! instead, see \p lodFn.
 	ae::Array< ae::AABB >* octree = nullptr;
 	//! Optional: If set this will be populated with the internal brick map used
 	//! for accelerating mesh generation, by minimizing calls to \p sampleFn.
@@ -6482,6 +7392,19 @@ struct IsosurfaceExtractor
 	//! same instance can be significantly faster, see ae::IsosurfaceExtractor::Reserve()
 	//! for more info.
 	bool Generate( const ae::IsosurfaceParams& params );
+	//! Regenerates the parts of the mesh from the previous call to
+	//! ae::IsosurfaceExtractor::Generate() that are within \p dirtyAABBs, which
+	//! should cover everywhere the SDF surface has changed since. This requires
+	//! ae::IsosurfaceParams::incremental, and the sample function and user data
+	//! from the original params must still be valid. Only the bricks around
+	//! \p dirtyAABBs are resampled, and their triangles are rewritten in place
+	//! within their index ranges when they fit. Vertex indices of unchanged
+	//! voxels are kept, so triangles of other bricks are left untouched.
+	//! ae::IsosurfaceParams::statusFn is not called. Returns false and clears
+	//! the mesh if ae::IsosurfaceParams::maxVerts or
+	//! ae::IsosurfaceParams::maxIndices are exceeded, or if there is no previous
+	//! mesh to update.
+	bool Update( const ae::AABB* dirtyAABBs, uint32_t dirtyCount );
 	//! Clears all results from ae::IsosurfaceExtractor::Generate(), including
 	//! from ae::IsosurfaceStatus. Note that buffer sizes will be maintained even
 	//! if this is called.
@@ -6542,11 +7465,36 @@ private:
 		float errorMargin;
 		float samples[ kBrickMapSizePlus ][ kBrickMapSizePlus ][ kBrickMapSizePlus ];
 	};
+	//! The range of indices owned by a brick when ae::IsosurfaceParams::incremental
+	//! is set. Each quad belongs to the brick of the voxel that generated it.
+	struct BrickMesh
+	{
+		uint32_t indexBegin = 0;
+		uint32_t indexCount = 0;
+		uint32_t indexCapacity = 0;
+	};
+	//! An octree node processed by one of the threads in m_GenerateParallel(),
+	//! and the range of that thread's indices it generated
+	struct Task
+	{
+		ae::Int3 center;
+		uint32_t halfSize;
+		uint32_t thread = 0;
+		uint32_t indexBegin = 0;
+		uint32_t indexEnd = 0;
+	};
 	bool m_GenerateVerts( ae::Int3 center, uint32_t halfSize );
+	bool m_GenerateParallel( ae::Int3 center, uint32_t halfSize, uint32_t threadCount );
+	bool m_GenerateLod();
 	bool m_DoVoxel( int32_t x, int32_t y, int32_t z );
+	void m_GenerateVertex( IsosurfaceVertex* vertex, const ae::Map< Index, Voxel >& voxels );
 	inline IsosurfaceValue m_DualSample( ae::Int3 pos, bool cache = true );
 	inline IsosurfaceValue m_Sample( ae::Vec3 pos );
+	void m_SampleBatch( const ae::Vec3* pos, IsosurfaceValue* valuesOut, uint32_t count );
 	bool m_UpdateStatus();
+	void m_InitializeIncremental();
+	void m_UpdateRegion( ae::Int3 minInclusive, ae::Int3 maxInclusive );
+	void m_CompactIndices();
 	IsosurfaceParams m_params;
 	bool m_cancel = false;
 	ae::Int3 m_minInclusive = ae::Int3( 0 );
@@ -6557,8 +7505,177 @@ private:
 	IsosurfaceStatus m_statusPrev;
 	ae::Map< Index, Voxel > m_voxels;
 	ae::Map< Index, Brick > m_brickMap;
+	// m_GenerateParallel() state
+	ae::Array< Task >* m_tasks = nullptr; //!< When set m_GenerateVerts() appends nodes of m_taskHalfSize here instead of processing them
+	uint32_t m_taskHalfSize = 0;
+	std::atomic< uint64_t >* m_threadProgress = nullptr; //!< Set on worker threads to report progress to the main thread
+	const std::atomic< bool >* m_threadCancel = nullptr; //!< Set on worker threads to be notified of cancellation
+	// Update() state
+	bool m_incrementalReady = false;
+	ae::Int3 m_rootCenter = ae::Int3( 0 );
+	uint32_t m_rootHalfSize = 0;
+	ae::Map< Index, BrickMesh > m_brickMeshes;
+	ae::Array< Index > m_vertexVoxels; //!< The voxel each vertex belongs to
+	ae::Array< uint32_t > m_vertexRefs; //!< The number of indices referencing each vertex
+	ae::Array< IsosurfaceIndex > m_freeVertices;
+	uint32_t m_indexWaste = 0; //!< The number of indices left behind by relocated bricks
 };
 
+//------------------------------------------------------------------------------
+// ae::MeshSimplifier class
+//------------------------------------------------------------------------------
+//! Reduces the number of triangles of an indexed mesh by repeatedly collapsing
+//! the edge that changes the shape the least, as measured by quadric error
+//! metrics. Useful for creating collision meshes and lower levels of detail
+//! from ae::IsosurfaceExtractor, ae::OBJLoader, or terrain meshes.
+//------------------------------------------------------------------------------
+class MeshSimplifier
+{
+public:
+	static constexpr uint32_t kMaxAttributes = 16;
+	static constexpr uint32_t kMaxThreads = 32;
+	//! Parameters to ae::MeshSimplifier::Simplify()
+	struct Params
+	{
+		const float* vertexPositions = nullptr;
+		uint32_t vertexPositionStride = 0;
+		//! Optional: \p vertexAttributeCount floats per vertex (eg. normals or
+		//! texture coordinates), which are interpolated along collapsed edges.
+		//! The squared difference of the attributes of a collapsed edge, scaled
+		//! by \p attributeWeight, is added to its squared error so that edges
+		//! with very different attributes are collapsed last.
+		const float* vertexAttributes = nullptr;
+		uint32_t vertexAttributeStride = 0;
+		uint32_t vertexAttributeCount = 0;
+		float attributeWeight = 1.0f;
+		uint32_t vertexCount = 0;
+
+		const void* indices = nullptr;
+		uint32_t indexCount = 0;
+		uint32_t indexSize = 0;
+
+		//! Simplification stops once there are no more than this many triangles
+		uint32_t targetTriangleCount = 0;
+		//! Simplification stops before any collapse that would move the surface
+		//! more than approximately this distance
+		float maxError = INFINITY;
+		//! Keeps edges used by only one triangle (ie. holes and the outline of
+		//! open meshes) in place, only allowing collapses along straight edges
+		bool preserveBoundaries = true;
+		//! The number of threads to simplify with, or 0 for ae::GetMaxConcurrentThreads(),
+		//! up to ae::MeshSimplifier::kMaxThreads. The mesh is split into spatial
+		//! clusters which are simplified independently, before finishing with
+		//! the whole mesh on the calling thread.
+		uint32_t threadCount = 1;
+	};
+
+	MeshSimplifier( ae::Tag tag );
+	//! Simplifies the given mesh, writing the result to ae::MeshSimplifier::positions,
+	//! ae::MeshSimplifier::attributes, and ae::MeshSimplifier::indices. Returns
+	//! false if no more edges could be collapsed before reaching either
+	//! ae::MeshSimplifier::Params::targetTriangleCount or
+	//! ae::MeshSimplifier::Params::maxError, in which case the result is as
+	//! simplified as possible.
+	bool Simplify( const Params& params );
+	//! Returns the largest error of any collapse from the previous call to
+	//! ae::MeshSimplifier::Simplify(), see ae::MeshSimplifier::Params::maxError
+	float GetError() const { return m_error; }
+	//! Helper function to load the simplified mesh directly into an ae::CollisionMesh
+	template< uint32_t V, uint32_t T, uint32_t B >
+	void InitializeCollisionMesh( ae::CollisionMesh< V, T, B >* mesh ) const;
+
+	ae::Array< ae::Vec3 > positions;
+	//! ae::MeshSimplifier::Params::vertexAttributeCount floats per vertex
+	ae::Array< float > attributes;
+	ae::Array< uint32_t > indices;
+
+private:
+	//! Symmetric 4x4 matrix of the sum of squared distances to a set of planes
+	struct Quadric
+	{
+		void AddPlane( ae::Vec3 normal, float d, double weight );
+		void operator+=( const Quadric& other );
+		double Evaluate( ae::Vec3 p ) const;
+		double q[ 10 ] = {};
+		double area = 0.0; //!< Normalizes the error to a distance
+	};
+	struct Collapse
+	{
+		float error;
+		uint32_t remove;
+		uint32_t keep;
+		uint32_t removeVersion;
+		uint32_t keepVersion;
+	};
+	static constexpr uint32_t kAllClusters = ~0u;
+	static constexpr uint8_t kVertexRemoved = ( 1 << 0 );
+	static constexpr uint8_t kVertexBoundary = ( 1 << 1 );
+	static constexpr uint8_t kVertexClusterBorder = ( 1 << 2 );
+	bool m_CanCollapse( uint32_t v, uint32_t cluster ) const;
+	void m_GetTriangles( uint32_t v, ae::Array< uint32_t >* trisOut );
+	float m_GetError( uint32_t remove, uint32_t keep, ae::Vec3* positionOut, float* tOut ) const;
+	uint32_t m_Collapse( uint32_t remove, uint32_t keep, ae::Vec3 position, float t, ae::Array< uint32_t >* scratch );
+	void m_PushCollapses( uint32_t v, uint32_t cluster, bool allNeighbors, ae::Array< Collapse >* heap, ae::Array< uint32_t >* scratch );
+	uint32_t m_Simplify( uint32_t cluster, const uint32_t* verts, uint32_t vertCount, uint32_t removeCount, float* errorOut, bool* errorLimitOut );
+	Params m_params;
+	float m_error = 0.0f;
+	ae::Array< ae::Vec3 > m_positions;
+	ae::Array< float > m_attributes;
+	ae::Array< Quadric > m_quadrics;
+	ae::Array< uint32_t > m_tris; //!< Three vertices per triangle
+	ae::Array< uint8_t > m_triAlive;
+	ae::Array< uint32_t > m_cornerNext; //!< Linked lists of the triangle corners of each vertex
+	ae::Array< uint32_t > m_vertexHead;
+	ae::Array< uint32_t > m_vertexTail;
+	ae::Array< uint32_t > m_vertexVersion; //!< Incremented when a vertex changes to invalidate queued collapses
+	ae::Array< uint32_t > m_vertexCluster;
+	ae::Array< uint8_t > m_vertexFlags;
+};
+
+//------------------------------------------------------------------------------
+// ae::WeldVertices, ae::OptimizeVertexCache, ae::OptimizeOverdraw, and ae::GetVertexFetchRemap
+//------------------------------------------------------------------------------
+//! Mesh processing utilities for meshes loaded with ae::OBJLoader or generated
+//! with ae::IsosurfaceExtractor etc. These work with plain arrays of positions
+//! and 16 or 32 bit indices (\p indexSize of 2 or 4), and don't require a
+//! graphics context. A typical order is ae::WeldVertices(),
+//! ae::OptimizeVertexCache(), ae::OptimizeOverdraw(), and then
+//! ae::GetVertexFetchRemap(). Each step writes a remap table that is applied
+//! with ae::RemapVertices() and ae::RemapIndices().
+//------------------------------------------------------------------------------
+//! Finds vertices with positions within \p tolerance of an earlier vertex and
+//! writes the new index of each of the \p vertexCount vertices to \p remapOut.
+//! When \p attributes is set each of the \p attributeCount floats must also be
+//! within \p tolerance for vertices to be welded. Unique vertices keep their
+//! relative order. Returns the number of unique vertices.
+uint32_t WeldVertices( const float* positions, uint32_t positionStride, uint32_t vertexCount, float tolerance, uint32_t* remapOut, const float* attributes = nullptr, uint32_t attributeStride = 0, uint32_t attributeCount = 0 );
+//! Copies each of the \p vertexCount vertices of \p vertexSize bytes to index
+//! remap[ i ] of \p verticesOut. Vertices with a remap of ~0 are skipped. When
+//! multiple vertices share an index the last one is kept. \p vertices and
+//! \p verticesOut may be the same array.
+void RemapVertices( const void* vertices, uint32_t vertexSize, uint32_t vertexCount, const uint32_t* remap, void* verticesOut );
+//! Replaces each of the \p indexCount indices with remap[ index ]
+void RemapIndices( void* indices, uint32_t indexCount, uint32_t indexSize, const uint32_t* remap );
+//! Reorders triangles so that vertices are reused while still in the
+//! post-transform vertex cache of \p cacheSize entries, using 'Tipsify' from
+//! 'Fast Triangle Reordering for Vertex Locality and Reduced Overdraw' (Sander
+//! et al. 2007). Triangle winding is preserved.
+void OptimizeVertexCache( void* indices, uint32_t indexCount, uint32_t indexSize, uint32_t vertexCount, uint32_t cacheSize = 16 );
+//! Reorders runs of triangles from ae::OptimizeVertexCache() (split where the
+//! simulated vertex cache of \p cacheSize entries is flushed) so that runs
+//! facing away from the center of the mesh are drawn first. This is view
+//! independent, and reduces overdraw of convex-ish meshes from any direction
+//! while keeping vertex cache efficiency.
+void OptimizeOverdraw( void* indices, uint32_t indexCount, uint32_t indexSize, const float* positions, uint32_t positionStride, uint32_t vertexCount, uint32_t cacheSize = 16 );
+//! Writes a remap to \p remapOut that orders the \p vertexCount vertices by
+//! their first use in \p indices to improve memory locality of vertex fetches.
+//! Unused vertices are remapped to ~0. Returns the number of used vertices.
+uint32_t GetVertexFetchRemap( const void* indices, uint32_t indexCount, uint32_t indexSize, uint32_t vertexCount, uint32_t* remapOut );
+//! Returns the average number of vertex cache misses per triangle with a FIFO
+//! cache of \p cacheSize entries, between 0.5 (ideal for large regular grids)
+//! and 3
+float GetVertexCacheMissRatio( const void* indices, uint32_t indexCount, uint32_t indexSize, uint32_t vertexCount, uint32_t cacheSize = 16 );
+
 //! \defgroup Meta
 //! @{
 // clang-format off
@@ -8547,6 +9664,25 @@ inline float Random( float min, float max, uint64_t* seed )
 	return min + ( ( r / (float)ae::MaxValue< uint32_t >() ) * ( max - min ) );
 }
 
+//------------------------------------------------------------------------------
+// RandomGenerator member functions
+//------------------------------------------------------------------------------
+inline uint32_t RandomGenerator::GetUint32()
+{
+	if( m_blockIndex == 4 )
+	{
+		m_Step( m_block );
+		m_blockIndex = 0;
+	}
+	return m_block[ m_blockIndex++ ];
+}
+
+inline float RandomGenerator::Get01()
+{
+	// The top 24 bits fit exactly in a float's mantissa
+	return (float)( GetUint32() >> 8 ) * ( 1.0f / 16777216.0f );
+}
+
 //------------------------------------------------------------------------------
 // RandomValue member functions
 //------------------------------------------------------------------------------
@@ -13344,6 +14480,33 @@ void BVH< T, N >::SetLeaf( int32_t nodeIdx, T* data, uint32_t count )
 	// @TODO: Return leaf?
 }
 
+template< typename T, uint32_t N >
+template< typename AABBFn >
+void BVH< T, N >::Refit( int32_t nodeIdx, AABBFn aabbFn )
+{
+	while( nodeIdx >= 0 )
+	{
+		BVHNode* node = &m_nodes[ nodeIdx ];
+		ae::AABB aabb;
+		if( node->leafIdx >= 0 )
+		{
+			const BVHLeaf< T >& leaf = m_leaves[ node->leafIdx ];
+			for( uint32_t i = 0; i < leaf.count; i++ )
+			{
+				aabb.Expand( ae::AABB( aabbFn( leaf.data[ i ] ) ) );
+			}
+		}
+		if( node->leftIdx >= 0 ) { aabb.Expand( m_nodes[ node->leftIdx ].aabb ); }
+		if( node->rightIdx >= 0 ) { aabb.Expand( m_nodes[ node->rightIdx ].aabb ); }
+		if( node->aabb == aabb )
+		{
+			break; // Ancestors are already correct
+		}
+		node->aabb = aabb;
+		nodeIdx = node->parentIdx;
+	}
+}
+
 template< typename T, uint32_t N >
 void BVH< T, N >::Clear()
 {
@@ -13381,6 +14544,547 @@ ae::AABB BVH< T, N >::GetAABB() const
 	return GetRoot()->aabb;
 }
 
+template< typename T, uint32_t N >
+template< typename NodeFn, typename LeafFn >
+bool BVH< T, N >::Traverse( NodeFn nodeFn, LeafFn leafFn ) const
+{
+	if( !m_nodes.Length() )
+	{
+		return true;
+	}
+	int16_t stack[ kTraversalStackSize ];
+	uint32_t stackSize = 0;
+	stack[ stackSize++ ] = 0;
+	while( stackSize )
+	{
+		const BVHNode& node = m_nodes[ stack[ --stackSize ] ];
+		if( !nodeFn( node ) )
+		{
+			continue;
+		}
+		if( node.leafIdx >= 0 && !leafFn( m_leaves[ node.leafIdx ] ) )
+		{
+			return false;
+		}
+		AE_ASSERT_MSG( stackSize + 2 <= kTraversalStackSize, "ae::BVH is too deep to traverse" );
+		// Push right first so the left child is visited first
+		if( node.rightIdx >= 0 ) { stack[ stackSize++ ] = node.rightIdx; }
+		if( node.leftIdx >= 0 ) { stack[ stackSize++ ] = node.leftIdx; }
+	}
+	return true;
+}
+
+template< typename T, uint32_t N >
+template< typename LeafFn >
+bool BVH< T, N >::QueryAABB( const ae::AABB& aabb, LeafFn leafFn ) const
+{
+	return Traverse( [&aabb]( const BVHNode& node ) { return node.aabb.Intersect( aabb ); }, leafFn );
+}
+
+template< typename T, uint32_t N >
+template< typename LeafFn >
+bool BVH< T, N >::QueryFrustum( const ae::Frustum& frustum, LeafFn leafFn ) const
+{
+	return Traverse( [&frustum]( const BVHNode& node ) { return frustum.Intersects( node.aabb ); }, leafFn );
+}
+
+template< typename T, uint32_t N >
+template< typename LeafFn >
+bool BVH< T, N >::QuerySphere( const ae::Sphere& sphere, LeafFn leafFn ) const
+{
+	return Traverse( [&sphere]( const BVHNode& node ) { return node.aabb.GetSignedDistanceFromSurface( sphere.center ) <= sphere.radius; }, leafFn );
+}
+
+template< typename T, uint32_t N >
+template< uint32_t M >
+void BVH< T, N >::QueryAABB( const ae::AABB& aabb, ae::Array< const BVHLeaf< T >*, M >* leavesOut ) const
+{
+	QueryAABB( aabb, [leavesOut]( const BVHLeaf< T >& leaf )
+	{
+		leavesOut->Append( &leaf );
+		return !M || leavesOut->Length() < M;
+	} );
+}
+
+template< typename T, uint32_t N >
+template< uint32_t M >
+void BVH< T, N >::QueryFrustum( const ae::Frustum& frustum, ae::Array< const BVHLeaf< T >*, M >* leavesOut ) const
+{
+	QueryFrustum( frustum, [leavesOut]( const BVHLeaf< T >& leaf )
+	{
+		leavesOut->Append( &leaf );
+		return !M || leavesOut->Length() < M;
+	} );
+}
+
+template< typename T, uint32_t N >
+template< uint32_t M >
+void BVH< T, N >::QuerySphere( const ae::Sphere& sphere, ae::Array< const BVHLeaf< T >*, M >* leavesOut ) const
+{
+	QuerySphere( sphere, [leavesOut]( const BVHLeaf< T >& leaf )
+	{
+		leavesOut->Append( &leaf );
+		return !M || leavesOut->Length() < M;
+	} );
+}
+
+template< typename T, uint32_t N >
+template< typename DistanceFn, uint32_t M >
+void BVH< T, N >::QueryNearest( ae::Vec3 point, uint32_t k, DistanceFn distanceFn, ae::Array< BVHNearest< T >, M >* nearestOut, float maxDistance ) const
+{
+	AE_ASSERT( nearestOut );
+	AE_ASSERT_MSG( !M || k <= M, "Requested # nearest elements but the result array only holds #", k, M );
+	nearestOut->Clear();
+	if( !k || !m_nodes.Length() )
+	{
+		return;
+	}
+	auto getNodeDistance = [point]( const BVHNode& node )
+	{
+		return ae::Max( 0.0f, node.aabb.GetSignedDistanceFromSurface( point ) );
+	};
+	auto getSearchDistance = [&]()
+	{
+		return ( nearestOut->Length() < k ) ? maxDistance : (*nearestOut)[ nearestOut->Length() - 1 ].distance;
+	};
+
+	struct StackEntry { int16_t nodeIdx; float distance; };
+	StackEntry stack[ kTraversalStackSize ];
+	uint32_t stackSize = 0;
+	stack[ stackSize++ ] = { 0, getNodeDistance( m_nodes[ 0 ] ) };
+	while( stackSize )
+	{
+		const StackEntry entry = stack[ --stackSize ];
+		if( entry.distance > getSearchDistance() )
+		{
+			continue; // Results were found closer than this node since it was pushed
+		}
+		const BVHNode& node = m_nodes[ entry.nodeIdx ];
+		if( node.leafIdx >= 0 )
+		{
+			const BVHLeaf< T >& leaf = m_leaves[ node.leafIdx ];
+			for( uint32_t i = 0; i < leaf.count; i++ )
+			{
+				const float distance = distanceFn( leaf.data[ i ] );
+				if( distance > getSearchDistance() || ( nearestOut->Length() == k && distance == getSearchDistance() ) )
+				{
+					continue;
+				}
+				// Insertion sort, k is expected to be small
+				if( nearestOut->Length() == k )
+				{
+					nearestOut->Remove( k - 1 );
+				}
+				int32_t insertIdx = nearestOut->Length();
+				while( insertIdx > 0 && (*nearestOut)[ insertIdx - 1 ].distance > distance )
+				{
+					insertIdx--;
+				}
+				nearestOut->Insert( insertIdx, { &leaf.data[ i ], distance } );
+			}
+		}
+		AE_ASSERT_MSG( stackSize + 2 <= kTraversalStackSize, "ae::BVH is too deep to traverse" );
+		const BVHNode* left = GetNode( node.leftIdx );
+		const BVHNode* right = GetNode( node.rightIdx );
+		const float leftDistance = left ? getNodeDistance( *left ) : INFINITY;
+		const float rightDistance = right ? getNodeDistance( *right ) : INFINITY;
+		const float searchDistance = getSearchDistance();
+		// Push the farther child first so the nearer child is visited first
+		if( leftDistance <= rightDistance )
+		{
+			if( right && rightDistance <= searchDistance ) { stack[ stackSize++ ] = { node.rightIdx, rightDistance }; }
+			if( left && leftDistance <= searchDistance ) { stack[ stackSize++ ] = { node.leftIdx, leftDistance }; }
+		}
+		else
+		{
+			if( left && leftDistance <= searchDistance ) { stack[ stackSize++ ] = { node.leftIdx, leftDistance }; }
+			if( right && rightDistance <= searchDistance ) { stack[ stackSize++ ] = { node.rightIdx, rightDistance }; }
+		}
+	}
+}
+
+template< typename T, uint32_t N >
+void BVH< T, N >::Serialize( ae::BinaryWriter* stream, const T* data ) const
+{
+	stream->SerializeUInt32( (uint32_t)sizeof(BVHNode) );
+	stream->SerializeUInt32( m_nodes.Length() );
+	stream->SerializeUInt32( m_leaves.Length() );
+	for( const BVHNode& node : m_nodes )
+	{
+		// Zero padding so output is deterministic
+		BVHNode temp;
+		memset( (void*)&temp, 0, sizeof(temp) );
+		ae::Vec3 min = node.aabb.GetMin();
+		ae::Vec3 max = node.aabb.GetMax();
+		min.pad = 0.0f;
+		max.pad = 0.0f;
+		temp.aabb = ae::AABB( min, max );
+		temp.parentIdx = node.parentIdx;
+		temp.leftIdx = node.leftIdx;
+		temp.rightIdx = node.rightIdx;
+		temp.leafIdx = node.leafIdx;
+		stream->SerializeRaw( &temp, sizeof(temp) );
+	}
+	for( const BVHLeaf< T >& leaf : m_leaves )
+	{
+		stream->SerializeUInt32( (uint32_t)( leaf.data - data ) );
+		stream->SerializeUInt32( leaf.count );
+	}
+}
+
+template< typename T, uint32_t N >
+void BVH< T, N >::Serialize( ae::BinaryStream* stream, T* data, uint32_t count )
+{
+	if( ae::BinaryWriter* writer = stream->AsWriter() )
+	{
+		Serialize( writer, data );
+		return;
+	}
+	Clear();
+	uint32_t nodeSize = 0;
+	uint32_t nodeCount = 0;
+	uint32_t leafCount = 0;
+	stream->SerializeUInt32( nodeSize );
+	stream->SerializeUInt32( nodeCount );
+	stream->SerializeUInt32( leafCount );
+	if( !stream->IsValid()
+		|| nodeSize != sizeof(BVHNode)
+		|| ( m_limit && nodeCount > m_limit )
+		|| nodeCount > INT16_MAX
+		|| leafCount > ( nodeCount + 1 ) / 2
+		|| stream->GetRemainingBytes() < nodeCount * sizeof(BVHNode) + leafCount * sizeof(uint32_t) * 2 )
+	{
+		stream->Invalidate();
+		return;
+	}
+	m_nodes.Append( {}, nodeCount );
+	stream->SerializeRaw( m_nodes.Data(), nodeCount * sizeof(BVHNode) );
+	for( uint32_t i = 0; i < leafCount; i++ )
+	{
+		uint32_t offset = 0;
+		uint32_t leafSize = 0;
+		stream->SerializeUInt32( offset );
+		stream->SerializeUInt32( leafSize );
+		if( offset > count || leafSize > count - offset )
+		{
+			stream->Invalidate();
+			break;
+		}
+		m_leaves.Append( { data + offset, leafSize } );
+	}
+	// Children always follow their parent, which guarantees traversal terminates
+	for( uint32_t i = 0; i < nodeCount && stream->IsValid(); i++ )
+	{
+		const BVHNode& node = m_nodes[ i ];
+		if( node.parentIdx >= (int32_t)i
+			|| ( node.leftIdx >= 0 && ( node.leftIdx <= (int32_t)i || node.leftIdx >= (int32_t)nodeCount ) )
+			|| ( node.rightIdx >= 0 && ( node.rightIdx <= (int32_t)i || node.rightIdx >= (int32_t)nodeCount ) )
+			|| node.leafIdx >= (int32_t)leafCount )
+		{
+			stream->Invalidate();
+		}
+	}
+	if( !stream->IsValid() )
+	{
+		Clear();
+	}
+}
+
+//------------------------------------------------------------------------------
+// ae::QuantizedBVH member functions
+//------------------------------------------------------------------------------
+template< typename T, uint32_t N >
+QuantizedBVH< T, N >::QuantizedBVH( const ae::Tag& allocTag ) :
+	m_nodes( allocTag ),
+	m_leaves( allocTag )
+{}
+
+template< typename T, uint32_t N >
+void QuantizedBVH< T, N >::Build( const ae::BVH< T, N >& bvh )
+{
+	Clear();
+	for( uint32_t i = 0; i < bvh.GetLeafCount(); i++ )
+	{
+		m_leaves.Append( bvh.GetLeaf( i ) );
+	}
+	if( bvh.GetRoot() )
+	{
+		m_Build( bvh, 0 );
+	}
+}
+
+template< typename T, uint32_t N >
+void QuantizedBVH< T, N >::Clear()
+{
+	m_nodes.Clear();
+	m_leaves.Clear();
+}
+
+template< typename T, uint32_t N >
+uint16_t QuantizedBVH< T, N >::m_Build( const ae::BVH< T, N >& bvh, int32_t bvhNodeIdx )
+{
+	const BVHNode* bvhNode = bvh.GetNode( bvhNodeIdx );
+	const bool hasChildren = ( bvhNode->leftIdx >= 0 );
+	AE_ASSERT_MSG( !hasChildren || bvhNode->leafIdx < 0, "ae::QuantizedBVH does not support nodes with both a leaf and children" );
+
+	// Collapse up to four levels of the binary tree, always opening the child
+	// with the largest surface area
+	int32_t slots[ 4 ];
+	uint32_t slotCount = 0;
+	if( hasChildren )
+	{
+		slots[ slotCount++ ] = bvhNode->leftIdx;
+		if( bvhNode->rightIdx >= 0 ) { slots[ slotCount++ ] = bvhNode->rightIdx; }
+	}
+	else
+	{
+		slots[ slotCount++ ] = bvhNodeIdx; // Root leaf
+	}
+	while( slotCount < 4 )
+	{
+		int32_t openIdx = -1;
+		float openArea = -1.0f;
+		for( uint32_t i = 0; i < slotCount; i++ )
+		{
+			const BVHNode* slotNode = bvh.GetNode( slots[ i ] );
+			if( slotNode->leftIdx < 0 ) { continue; }
+			const ae::Vec3 s = slotNode->aabb.GetHalfSize();
+			const float area = s.x * s.y + s.y * s.z + s.z * s.x;
+			if( area > openArea ) { openArea = area; openIdx = i; }
+		}
+		if( openIdx < 0 ) { break; }
+		const BVHNode* openNode = bvh.GetNode( slots[ openIdx ] );
+		AE_ASSERT_MSG( openNode->leafIdx < 0, "ae::QuantizedBVH does not support nodes with both a leaf and children" );
+		slots[ openIdx ] = openNode->leftIdx;
+		if( openNode->rightIdx >= 0 ) { slots[ slotCount++ ] = openNode->rightIdx; }
+	}
+
+	ae::AABB bounds;
+	for( uint32_t i = 0; i < slotCount; i++ )
+	{
+		bounds.Expand( bvh.GetNode( slots[ i ] )->aabb );
+	}
+	const ae::Vec3 boundsMin = bounds.GetMin();
+	const ae::Vec3 boundsMax = bounds.GetMax();
+
+	const uint32_t nodeIdx = m_nodes.Length();
+	AE_ASSERT_MSG( nodeIdx < QuantizedBVHNode::kLeafBit, "ae::QuantizedBVH has too many nodes" );
+	QuantizedBVHNode node;
+	for( uint32_t axis = 0; axis < 3; axis++ )
+	{
+		// Slightly larger than the extent so the max corner rounds up to at most 255
+		node.origin[ axis ] = boundsMin[ axis ];
+		node.scale[ axis ] = ( boundsMax[ axis ] - boundsMin[ axis ] ) * ( 1.0001f / 255.0f );
+		for( uint32_t i = 0; i < 4; i++ )
+		{
+			node.childMin[ axis ][ i ] = 255;
+			node.childMax[ axis ][ i ] = 0;
+		}
+	}
+	for( uint32_t i = 0; i < 4; i++ )
+	{
+		node.children[ i ] = QuantizedBVHNode::kEmpty;
+	}
+	m_nodes.Append( node );
+
+	for( uint32_t i = 0; i < slotCount; i++ )
+	{
+		const BVHNode* slotNode = bvh.GetNode( slots[ i ] );
+		uint16_t child;
+		if( slotNode->leftIdx >= 0 )
+		{
+			child = m_Build( bvh, slots[ i ] );
+		}
+		else if( slotNode->leafIdx >= 0 )
+		{
+			child = QuantizedBVHNode::kLeafBit | (uint16_t)slotNode->leafIdx;
+		}
+		else
+		{
+			continue; // Empty node
+		}
+
+		// Round outwards so quantized bounds always contain the original bounds
+		QuantizedBVHNode* qnode = &m_nodes[ nodeIdx ]; // m_Build() may reallocate
+		qnode->children[ i ] = child;
+		const ae::Vec3 childMin = slotNode->aabb.GetMin();
+		const ae::Vec3 childMax = slotNode->aabb.GetMax();
+		for( uint32_t axis = 0; axis < 3; axis++ )
+		{
+			const float origin = qnode->origin[ axis ];
+			const float scale = qnode->scale[ axis ];
+			int32_t qmin = 0;
+			int32_t qmax = 0;
+			if( scale > 0.0f )
+			{
+				qmin = ae::Clip( (int32_t)ae::Floor( ( childMin[ axis ] - origin ) / scale ), 0, 255 );
+				qmax = ae::Clip( (int32_t)ae::Ceil( ( childMax[ axis ] - origin ) / scale ), 0, 255 );
+				while( qmin > 0 && origin + qmin * scale > childMin[ axis ] ) { qmin--; }
+				while( qmax < 255 && origin + qmax * scale < childMax[ axis ] ) { qmax++; }
+			}
+			qnode->childMin[ axis ][ i ] = (uint8_t)qmin;
+			qnode->childMax[ axis ][ i ] = (uint8_t)qmax;
+		}
+	}
+	return (uint16_t)nodeIdx;
+}
+
+template< typename T, uint32_t N >
+template< typename LeafFn >
+void QuantizedBVH< T, N >::Raycast( ae::Vec3 source, ae::Vec3 ray, LeafFn leafFn, float maxT ) const
+{
+	if( !m_nodes.Length() || maxT < 0.0f )
+	{
+		return;
+	}
+
+	float invDir[ 3 ];
+	for( uint32_t axis = 0; axis < 3; axis++ )
+	{
+		const float d = ray[ axis ];
+		invDir[ axis ] = 1.0f / ( ( ae::Abs( d ) < 1e-30f ) ? ( ( d < 0.0f ) ? -1e-30f : 1e-30f ) : d );
+	}
+
+	struct Pending
+	{
+		uint16_t child;
+		float t;
+	};
+	Pending stack[ ae::BVH< T, N >::kTraversalStackSize ];
+	uint32_t stackSize = 0;
+	stack[ stackSize++ ] = { 0, 0.0f };
+	while( stackSize )
+	{
+		const Pending pending = stack[ --stackSize ];
+		if( pending.t > maxT )
+		{
+			continue;
+		}
+		if( pending.child & QuantizedBVHNode::kLeafBit )
+		{
+			maxT = leafFn( m_leaves[ pending.child & ~QuantizedBVHNode::kLeafBit ], maxT );
+			if( maxT < 0.0f )
+			{
+				return;
+			}
+			continue;
+		}
+
+		// Slab test against all four children at once
+		const QuantizedBVHNode& node = m_nodes[ pending.child ];
+		_Float4 tNear = _Float4::Set( 0.0f );
+		_Float4 tFar = _Float4::Set( maxT );
+		for( uint32_t axis = 0; axis < 3; axis++ )
+		{
+			const _Float4 step = _Float4::Set( node.scale[ axis ] * invDir[ axis ] );
+			const _Float4 offset = _Float4::Set( ( node.origin[ axis ] - source[ axis ] ) * invDir[ axis ] );
+			const _Float4 t0 = _Float4::FromBytes( node.childMin[ axis ] ) * step + offset;
+			const _Float4 t1 = _Float4::FromBytes( node.childMax[ axis ] ) * step + offset;
+			tNear = _Float4::Max( tNear, _Float4::Min( t0, t1 ) );
+			tFar = _Float4::Min( tFar, _Float4::Max( t0, t1 ) );
+		}
+		const uint32_t hitMask = ( tNear <= tFar ).GetMask();
+		if( !hitMask )
+		{
+			continue;
+		}
+
+		// Push farthest first so the nearest child is visited next
+		float tNears[ 4 ];
+		tNear.Store( tNears );
+		Pending hits[ 4 ];
+		uint32_t hitCount = 0;
+		for( uint32_t i = 0; i < 4; i++ )
+		{
+			if( ( hitMask & ( 1 << i ) ) && node.children[ i ] != QuantizedBVHNode::kEmpty )
+			{
+				uint32_t j = hitCount++;
+				for( ; j > 0 && hits[ j - 1 ].t < tNears[ i ]; j-- ) { hits[ j ] = hits[ j - 1 ]; }
+				hits[ j ] = { node.children[ i ], tNears[ i ] };
+			}
+		}
+		AE_ASSERT_MSG( stackSize + hitCount <= countof(stack), "ae::QuantizedBVH is too deep to traverse" );
+		for( uint32_t i = 0; i < hitCount; i++ )
+		{
+			stack[ stackSize++ ] = hits[ i ];
+		}
+	}
+}
+
+template< typename T, uint32_t N >
+void QuantizedBVH< T, N >::Serialize( ae::BinaryWriter* stream, const T* data ) const
+{
+	stream->SerializeUInt32( (uint32_t)sizeof(QuantizedBVHNode) );
+	stream->SerializeUInt32( m_nodes.Length() );
+	stream->SerializeUInt32( m_leaves.Length() );
+	stream->SerializeRaw( m_nodes.Data(), m_nodes.Length() * sizeof(QuantizedBVHNode) );
+	for( const BVHLeaf< T >& leaf : m_leaves )
+	{
+		stream->SerializeUInt32( (uint32_t)( leaf.data - data ) );
+		stream->SerializeUInt32( leaf.count );
+	}
+}
+
+template< typename T, uint32_t N >
+void QuantizedBVH< T, N >::Serialize( ae::BinaryStream* stream, T* data, uint32_t count )
+{
+	if( ae::BinaryWriter* writer = stream->AsWriter() )
+	{
+		Serialize( writer, data );
+		return;
+	}
+	Clear();
+	uint32_t nodeSize = 0;
+	uint32_t nodeCount = 0;
+	uint32_t leafCount = 0;
+	stream->SerializeUInt32( nodeSize );
+	stream->SerializeUInt32( nodeCount );
+	stream->SerializeUInt32( leafCount );
+	if( !stream->IsValid()
+		|| nodeSize != sizeof(QuantizedBVHNode)
+		|| ( N && ( nodeCount > N || leafCount > ( N + 1 ) / 2 ) )
+		|| nodeCount >= QuantizedBVHNode::kLeafBit
+		|| leafCount > QuantizedBVHNode::kLeafBit
+		|| stream->GetRemainingBytes() < nodeCount * sizeof(QuantizedBVHNode) + leafCount * sizeof(uint32_t) * 2 )
+	{
+		stream->Invalidate();
+		return;
+	}
+	m_nodes.Append( {}, nodeCount );
+	stream->SerializeRaw( m_nodes.Data(), nodeCount * sizeof(QuantizedBVHNode) );
+	for( uint32_t i = 0; i < leafCount; i++ )
+	{
+		uint32_t offset = 0;
+		uint32_t leafSize = 0;
+		stream->SerializeUInt32( offset );
+		stream->SerializeUInt32( leafSize );
+		if( offset > count || leafSize > count - offset )
+		{
+			stream->Invalidate();
+			break;
+		}
+		m_leaves.Append( { data + offset, leafSize } );
+	}
+	// Children always follow their parent, which guarantees traversal terminates
+	for( uint32_t i = 0; i < nodeCount && stream->IsValid(); i++ )
+	{
+		for( uint16_t child : m_nodes[ i ].children )
+		{
+			if( child == QuantizedBVHNode::kEmpty ) { continue; }
+			const bool isLeaf = ( child & QuantizedBVHNode::kLeafBit );
+			const uint32_t idx = ( child & ~QuantizedBVHNode::kLeafBit );
+			if( isLeaf ? ( idx >= leafCount ) : ( idx <= i || idx >= nodeCount ) )
+			{
+				stream->Invalidate();
+			}
+		}
+	}
+	if( !stream->IsValid() )
+	{
+		Clear();
+	}
+}
+
 //------------------------------------------------------------------------------
 // HotLoader member functions
 //------------------------------------------------------------------------------
@@ -13393,6 +15097,44 @@ decltype(auto) HotLoader::CallFn( const char* name, Args... args )
 	return fn( args... );
 }
 
+//------------------------------------------------------------------------------
+// ae::RaycastEach free functions
+//------------------------------------------------------------------------------
+template< typename Fn >
+bool RaycastEach( const Triangle& tri, const RaycastParams& params, Fn hitFn, const TriangleRaycastParams& triParams )
+{
+	RaycastResult::Hit hit;
+	return !_GetRaycastHit( tri, params, triParams, &hit ) || hitFn( hit );
+}
+
+template< typename Fn >
+bool RaycastEach( const Sphere& sphere, const RaycastParams& params, Fn hitFn )
+{
+	RaycastResult::Hit hit;
+	return !_GetRaycastHit( sphere, params, &hit ) || hitFn( hit );
+}
+
+template< typename Fn >
+bool RaycastEach( const Plane& plane, const RaycastParams& params, Fn hitFn )
+{
+	RaycastResult::Hit hit;
+	return !_GetRaycastHit( plane, params, &hit ) || hitFn( hit );
+}
+
+template< typename Fn >
+bool RaycastEach( const AABB& aabb, const RaycastParams& params, Fn hitFn )
+{
+	RaycastResult::Hit hit;
+	return !_GetRaycastHit( aabb, params, &hit ) || hitFn( hit );
+}
+
+template< typename Fn >
+bool RaycastEach( const OBB& obb, const RaycastParams& params, Fn hitFn )
+{
+	RaycastResult::Hit hit;
+	return !_GetRaycastHit( obb, params, &hit ) || hitFn( hit );
+}
+
 //------------------------------------------------------------------------------
 // ae::CollisionMesh member functions
 //------------------------------------------------------------------------------
@@ -13408,7 +15150,8 @@ CollisionMesh< V, T, B >::CollisionMesh( ae::Tag tag ) :
 	m_positions( tag ),
 	m_collisionExtras( tag ),
 	m_tris( tag ),
-	m_bvh( tag )
+	m_bvh( tag ),
+	m_quantizedBVH( tag )
 {}
 
 template< uint32_t V, uint32_t T, uint32_t B >
@@ -13421,6 +15164,7 @@ void CollisionMesh< V, T, B >::Reserve( uint32_t vertCount, uint32_t triCount, u
 		m_collisionExtras.Reserve( vertCount );
 		m_tris.Reserve( triCount );
 		m_bvh = std::move( ae::BVH< BVHTri, B >( m_tag, bvhNodeCount ) ); // Clear bvh because pointers into m_tris could be invalid after Reserve()
+		m_quantizedBVH.Clear();
 		m_requiresRebuild = true;
 	}
 }
@@ -13447,15 +15191,17 @@ void CollisionMesh< V, T, B >::AddIndexed( const AddIndexedParams& params )
 	m_collisionExtras.Reserve( initialVertexCount + params.vertexCount );
 	for( uint32_t i = 0; i < params.vertexCount; i++ )
 	{
-		ae::Vec3 pos( (const float*)( (const uint8_t*)params.vertexPositions + params.vertexPositionStride * i ) );
-		CollisionExtra extra = params.vertexExtras ? *(const CollisionExtra*)( (const uint8_t*)params.vertexExtras + params.vertexExtraStride * i ) : CollisionExtra();
-		if( !identityTransform )
-		{
-			pos = ( params.transform * ae::Vec4( pos, 1.0f ) ).GetXYZ();
-		}
-		m_aabb.Expand( pos ); // Expand root aabb before calling m_BuildBVH() for the first partition
-		m_positions.Append( pos );
-		m_collisionExtras.Append( extra );
+		m_positions.Append( ae::Vec3( (const float*)( (const uint8_t*)params.vertexPositions + params.vertexPositionStride * i ) ) );
+		m_collisionExtras.Append( params.vertexExtras ? *(const CollisionExtra*)( (const uint8_t*)params.vertexExtras + params.vertexExtraStride * i ) : CollisionExtra() );
+	}
+	ae::Vec3* positions = &m_positions[ initialVertexCount ];
+	if( !identityTransform )
+	{
+		ae::TransformPoints( params.transform, positions->data, sizeof(ae::Vec3), positions->data, sizeof(ae::Vec3), params.vertexCount );
+	}
+	for( uint32_t i = 0; i < params.vertexCount; i++ )
+	{
+		m_aabb.Expand( positions[ i ] ); // Expand root aabb before calling m_BuildBVH() for the first partition
 	}
 	
 	m_tris.Reserve( m_tris.Length() + triCount );
@@ -13506,19 +15252,33 @@ void CollisionMesh< V, T, B >::BuildBVH()
 		AE_DEBUG_ASSERT( m_positions.Length() );
 		AE_DEBUG_ASSERT( m_tris.Length() );
 		const ae::Vec3* verts = m_positions.begin();
-		auto aabbFn = [verts]( BVHTri tri )
-		{
-			ae::AABB aabb;
-			aabb.Expand( verts[ tri.idx[ 0 ] ] );
-			aabb.Expand( verts[ tri.idx[ 1 ] ] );
-			aabb.Expand( verts[ tri.idx[ 2 ] ] );
-			return aabb;
-		};
+		auto aabbFn = [verts]( BVHTri tri ) { return m_GetAABB( verts, tri ); };
 		m_bvh.Build( m_tris.begin(), m_tris.Length(), aabbFn, 32 );
+		if( m_quantizedBVHEnabled )
+		{
+			m_quantizedBVH.Build( m_bvh );
+		}
+		else
+		{
+			m_quantizedBVH.Clear();
+		}
 		m_requiresRebuild = false;
 	}
 }
 
+template< uint32_t V, uint32_t T, uint32_t B >
+void CollisionMesh< V, T, B >::SetQuantizedBVHEnabled( bool enabled )
+{
+	if( m_quantizedBVHEnabled != enabled )
+	{
+		m_quantizedBVHEnabled = enabled;
+		if( m_tris.Length() )
+		{
+			m_requiresRebuild = true;
+		}
+	}
+}
+
 template< uint32_t V, uint32_t T, uint32_t B >
 void CollisionMesh< V, T, B >::Clear()
 {
@@ -13528,6 +15288,7 @@ void CollisionMesh< V, T, B >::Clear()
 	m_collisionExtras.Clear();
 	m_tris.Clear();
 	m_bvh.Clear();
+	m_quantizedBVH.Clear();
 }
 
 template< uint32_t V, uint32_t T, uint32_t B >
@@ -13567,6 +15328,55 @@ RaycastResult CollisionMesh< V, T, B >::Raycast( const RaycastParams& params, co
 	const bool ccw = meshParams.hitCounterclockwise;
 	const bool cw = meshParams.hitClockwise;
 
+	auto leafFn = [&]( const BVHLeaf< BVHTri >& leaf )
+	{
+		for( uint32_t i = 0; i < leaf.count; i++ )
+		{
+			ae::Vec3 p, n;
+			const uint32_t idx0 = leaf.data[ i ].idx[ 0 ];
+			ae::Vec3 a = m_positions[ idx0 ];
+			ae::Vec3 b = m_positions[ leaf.data[ i ].idx[ 1 ] ];
+			ae::Vec3 c = m_positions[ leaf.data[ i ].idx[ 2 ] ];
+			if( Triangle( a, b, c ).Raycast( source, ray, ccw, cw, &p, &n, nullptr ) )
+			{
+				RaycastResult::Hit hit;
+				hit.position = ae::Vec3( meshParams.transform * ae::Vec4( p, 1.0f ) ); // Undo local space transforms
+				hit.normal = ae::Vec3( normalTransform * ae::Vec4( n, 0.0f ) ).SafeNormalizeCopy(); // SafeNormalizeCopy
+				hit.distance = ( hit.position - params.source ).Length(); // Calculate here because transform might not have uniform scale
+				hit.userData = params.userData;
+				hit.extra = m_collisionExtras[ idx0 ];
+				result.Accumulate( params, hit );
+				if( ae::DebugLines* debug = meshParams.debug )
+				{
+					debug->AddCircle( hit.position, hit.normal, 0.25f, meshParams.debugColor, 8 );
+					debug->AddLine( hit.position, hit.position + hit.normal, meshParams.debugColor );
+				}
+			}
+		}
+	};
+
+	if( m_quantizedBVH.GetRoot() )
+	{
+		// Nodes are visited nearest first, so once max hits have been recorded
+		// anything beyond the farthest hit can be skipped
+		const uint32_t maxHits = ae::Min( params.maxHits, decltype(result.hits)::Capacity() );
+		const float rayLength = params.ray.Length();
+		auto getMaxT = [&]()
+		{
+			if( result.hits.Length() >= maxHits && rayLength > 0.0f )
+			{
+				return result.hits.Last().distance / rayLength; // Only closer hits can be accumulated
+			}
+			return 1.0f;
+		};
+		m_quantizedBVH.Raycast( source, ray, [&]( const BVHLeaf< BVHTri >& leaf, float )
+		{
+			leafFn( leaf );
+			return getMaxT();
+		}, getMaxT() );
+		return result;
+	}
+
 	auto bvhFn = [&]( auto&& bvhFn, const ae::BVH< BVHTri, B >* bvh, const BVHNode* current ) -> void
 	{
 		if( !current->aabb.Raycast( source, ray ) )
@@ -13580,29 +15390,7 @@ RaycastResult CollisionMesh< V, T, B >::Raycast( const RaycastParams& params, co
 		}
 		if( const BVHLeaf< BVHTri >* leaf = bvh->TryGetLeaf( current->leafIdx ) )
 		{
-			for( uint32_t i = 0; i < leaf->count; i++ )
-			{
-				ae::Vec3 p, n;
-				const uint32_t idx0 = leaf->data[ i ].idx[ 0 ];
-				ae::Vec3 a = m_positions[ idx0 ];
-				ae::Vec3 b = m_positions[ leaf->data[ i ].idx[ 1 ] ];
-				ae::Vec3 c = m_positions[ leaf->data[ i ].idx[ 2 ] ];
-				if( Triangle( a, b, c ).Raycast( source, ray, ccw, cw, &p, &n, nullptr ) )
-				{
-					RaycastResult::Hit hit;
-					hit.position = ae::Vec3( meshParams.transform * ae::Vec4( p, 1.0f ) ); // Undo local space transforms
-					hit.normal = ae::Vec3( normalTransform * ae::Vec4( n, 0.0f ) ).SafeNormalizeCopy(); // SafeNormalizeCopy
-					hit.distance = ( hit.position - params.source ).Length(); // Calculate here because transform might not have uniform scale
-					hit.userData = params.userData;
-					hit.extra = m_collisionExtras[ idx0 ];
-					result.Accumulate( params, hit );
-					if( ae::DebugLines* debug = meshParams.debug )
-					{
-						debug->AddCircle( hit.position, hit.normal, 0.25f, meshParams.debugColor, 8 );
-						debug->AddLine( hit.position, hit.position + hit.normal, meshParams.debugColor );
-					}
-				}
-			}
+			leafFn( *leaf );
 		}
 		// @TODO: Depth-first here is not ideal. See Real-time Collision Detection: 6.3.1 Descent Rules
 		// Improving this will require early out when max hits have been recorded
@@ -13620,6 +15408,521 @@ RaycastResult CollisionMesh< V, T, B >::Raycast( const RaycastParams& params, co
 	return result;
 }
 
+template< uint32_t V, uint32_t T, uint32_t B >
+template< typename Fn >
+bool CollisionMesh< V, T, B >::RaycastEach( const RaycastParams& params, Fn hitFn, const CollisionMeshRaycastParams& meshParams ) const
+{
+	if( !m_bvh.GetRoot() )
+	{
+		return true;
+	}
+	const ae::Matrix4 invTransform = meshParams.transform.GetInverse();
+	const ae::Matrix4 normalTransform = invTransform.GetTranspose();
+	const ae::Vec3 source( invTransform * ae::Vec4( params.source, 1.0f ) );
+	const ae::Vec3 rayEnd( invTransform * ae::Vec4( params.source + params.ray, 1.0f ) );
+	const ae::Vec3 ray = rayEnd - source;
+	const bool ccw = meshParams.hitCounterclockwise;
+	const bool cw = meshParams.hitClockwise;
+
+	// Returns false once hitFn stops the query
+	auto leafFn = [&]( const BVHLeaf< BVHTri >& leaf ) -> bool
+	{
+		for( uint32_t i = 0; i < leaf.count; i++ )
+		{
+			ae::Vec3 p, n;
+			const uint32_t idx0 = leaf.data[ i ].idx[ 0 ];
+			ae::Vec3 a = m_positions[ idx0 ];
+			ae::Vec3 b = m_positions[ leaf.data[ i ].idx[ 1 ] ];
+			ae::Vec3 c = m_positions[ leaf.data[ i ].idx[ 2 ] ];
+			if( Triangle( a, b, c ).Raycast( source, ray, ccw, cw, &p, &n, nullptr ) )
+			{
+				RaycastResult::Hit hit;
+				hit.position = ae::Vec3( meshParams.transform * ae::Vec4( p, 1.0f ) );
+				hit.normal = ae::Vec3( normalTransform * ae::Vec4( n, 0.0f ) ).SafeNormalizeCopy();
+				hit.distance = ( hit.position - params.source ).Length();
+				hit.userData = params.userData;
+				hit.extra = m_collisionExtras[ idx0 ];
+				if( ae::DebugLines* debug = meshParams.debug )
+				{
+					debug->AddCircle( hit.position, hit.normal, 0.25f, meshParams.debugColor, 8 );
+					debug->AddLine( hit.position, hit.position + hit.normal, meshParams.debugColor );
+				}
+				if( !hitFn( hit ) )
+				{
+					return false;
+				}
+			}
+		}
+		return true;
+	};
+
+	if( m_quantizedBVH.GetRoot() )
+	{
+		bool finished = true;
+		m_quantizedBVH.Raycast( source, ray, [&]( const BVHLeaf< BVHTri >& leaf, float maxT )
+		{
+			finished = leafFn( leaf );
+			return finished ? maxT : -1.0f;
+		} );
+		return finished;
+	}
+	return m_bvh.Traverse( [&]( const BVHNode& node ) { return node.aabb.Raycast( source, ray ); }, leafFn );
+}
+
+template< uint32_t V, uint32_t T, uint32_t B >
+SweepResult CollisionMesh< V, T, B >::Sweep( const SweepParams& params, const CollisionMeshSweepParams& meshParams, SweepResult result ) const
+{
+	if( !m_bvh.GetRoot() || ( result.hit && result.t <= 0.0f ) )
+	{
+		return result;
+	}
+	const bool hasIdentityTransform = ( meshParams.transform == ae::Matrix4::Identity() );
+	const ae::Matrix4 invTransform = meshParams.transform.GetInverse();
+	const ae::Vec3 p0 = params.source;
+	const ae::Vec3 p1 = params.source + params.capsuleOffset;
+	const float sweepLength = params.sweep.Length();
+
+	// World space bounds of the shape over [0, t], in mesh space for culling
+	auto getSweptAABB = [&]( float t )
+	{
+		ae::AABB aabb( ae::Sphere( p0, params.radius ) );
+		aabb.Expand( ae::AABB( ae::Sphere( p1, params.radius ) ) );
+		const ae::Vec3 sweep = params.sweep * t;
+		aabb.Expand( ae::AABB( aabb.GetMin() + sweep, aabb.GetMax() + sweep ) );
+		if( hasIdentityTransform )
+		{
+			return aabb;
+		}
+		const ae::Vec3 min = aabb.GetMin();
+		const ae::Vec3 max = aabb.GetMax();
+		ae::AABB localAABB;
+		for( uint32_t i = 0; i < 8; i++ )
+		{
+			const ae::Vec3 corner( ( i & 1 ) ? max.x : min.x, ( i & 2 ) ? max.y : min.y, ( i & 4 ) ? max.z : min.z );
+			localAABB.Expand( ae::Vec3( invTransform * ae::Vec4( corner, 1.0f ) ) );
+		}
+		return localAABB;
+	};
+	float bestT = result.hit ? result.t : 1.0f;
+	ae::AABB sweptAABB = getSweptAABB( bestT );
+	if( !sweptAABB.Intersect( m_aabb ) )
+	{
+		return result;
+	}
+
+	m_bvh.Traverse( [&]( const BVHNode& node )
+	{
+		if( !node.aabb.Intersect( sweptAABB ) )
+		{
+			return false;
+		}
+		if( meshParams.debug )
+		{
+			meshParams.debug->AddOBB( ae::OBB( meshParams.transform * node.aabb.GetTransform() ), meshParams.debugColor );
+		}
+		return true;
+	},
+	[&]( const BVHLeaf< BVHTri >& leaf )
+	{
+		for( uint32_t i = 0; i < leaf.count; i++ )
+		{
+			const uint32_t idx0 = leaf.data[ i ].idx[ 0 ];
+			ae::Vec3 a = m_positions[ idx0 ];
+			ae::Vec3 b = m_positions[ leaf.data[ i ].idx[ 1 ] ];
+			ae::Vec3 c = m_positions[ leaf.data[ i ].idx[ 2 ] ];
+			if( !hasIdentityTransform )
+			{
+				a = ae::Vec3( meshParams.transform * ae::Vec4( a, 1.0f ) );
+				b = ae::Vec3( meshParams.transform * ae::Vec4( b, 1.0f ) );
+				c = ae::Vec3( meshParams.transform * ae::Vec4( c, 1.0f ) );
+			}
+			ae::Vec3 p, n;
+			float distance;
+			if( ae::Triangle( a, b, c ).CapsuleCast( p0, p1, params.sweep, params.radius, meshParams.hitCounterclockwise, meshParams.hitClockwise, &p, &n, &distance ) )
+			{
+				const float t = ( sweepLength > 0.0f ) ? distance / sweepLength : 0.0f;
+				if( t < bestT || !result.hit )
+				{
+					bestT = t;
+					sweptAABB = getSweptAABB( bestT );
+					result.hit = true;
+					result.t = t;
+					result.distance = distance;
+					result.position = p;
+					result.normal = n;
+					result.userData = params.userData;
+					result.extra = m_collisionExtras[ idx0 ];
+				}
+			}
+		}
+		return true;
+	} );
+
+	ae::DebugLines* debug = meshParams.debug;
+	if( debug && result.hit )
+	{
+		debug->AddCircle( result.position, result.normal, 0.25f, meshParams.debugColor, 8 );
+		debug->AddLine( result.position, result.position + result.normal, meshParams.debugColor );
+	}
+	return result;
+}
+
+template< uint32_t V, uint32_t T, uint32_t B >
+bool CollisionMesh< V, T, B >::GetClosestPoint( ae::Vec3 point, CollisionMeshClosestPoint* resultOut, float maxDistance ) const
+{
+	ae::Array< CollisionMeshClosestPoint, 1 > nearest;
+	QueryNearest( point, 1, &nearest, maxDistance );
+	if( nearest.Length() )
+	{
+		if( resultOut )
+		{
+			*resultOut = nearest[ 0 ];
+		}
+		return true;
+	}
+	return false;
+}
+
+template< uint32_t V, uint32_t T, uint32_t B >
+template< uint32_t N >
+void CollisionMesh< V, T, B >::QueryNearest( ae::Vec3 point, uint32_t k, ae::Array< CollisionMeshClosestPoint, N >* nearestOut, float maxDistance ) const
+{
+	AE_ASSERT( nearestOut );
+	nearestOut->Clear();
+	const ae::Vec3* verts = m_positions.Data();
+	auto distanceFn = [verts, point]( const BVHTri& tri )
+	{
+		const ae::Triangle triangle( verts[ tri.idx[ 0 ] ], verts[ tri.idx[ 1 ] ], verts[ tri.idx[ 2 ] ] );
+		return ( triangle.ClosestPoint( point ) - point ).Length();
+	};
+	auto appendResults = [&]( const auto& nearestTris )
+	{
+		for( const BVHNearest< BVHTri >& nearestTri : nearestTris )
+		{
+			const uint32_t triIdx = (uint32_t)( nearestTri.data - m_tris.Data() );
+			const ae::Triangle triangle = GetTriangle( triIdx );
+			CollisionMeshClosestPoint& result = nearestOut->Append( {} );
+			result.position = triangle.ClosestPoint( point );
+			result.normal = triangle.CounterClockwiseNormal();
+			result.distance = nearestTri.distance;
+			result.triIdx = triIdx;
+			result.extra = GetTriangleExtra( triIdx );
+		}
+	};
+	if constexpr( N > 0 )
+	{
+		ae::Array< BVHNearest< BVHTri >, N > nearestTris;
+		m_bvh.QueryNearest( point, k, distanceFn, &nearestTris, maxDistance );
+		appendResults( nearestTris );
+	}
+	else
+	{
+		ae::Array< BVHNearest< BVHTri > > nearestTris = nearestOut->Tag();
+		m_bvh.QueryNearest( point, k, distanceFn, &nearestTris, maxDistance );
+		appendResults( nearestTris );
+	}
+}
+
+template< uint32_t V, uint32_t T, uint32_t B >
+template< typename Fn >
+void CollisionMesh< V, T, B >::QueryAABB( const ae::AABB& aabb, Fn fn ) const
+{
+	const ae::Vec3* verts = m_positions.Data();
+	const BVHTri* tris = m_tris.Data();
+	m_bvh.QueryAABB( aabb, [&]( const BVHLeaf< BVHTri >& leaf )
+	{
+		for( uint32_t i = 0; i < leaf.count; i++ )
+		{
+			if( m_GetAABB( verts, leaf.data[ i ] ).Intersect( aabb ) && !fn( (uint32_t)( &leaf.data[ i ] - tris ) ) )
+			{
+				return false;
+			}
+		}
+		return true;
+	} );
+}
+
+template< uint32_t V, uint32_t T, uint32_t B >
+template< typename Fn >
+void CollisionMesh< V, T, B >::QueryFrustum( const ae::Frustum& frustum, Fn fn ) const
+{
+	const ae::Vec3* verts = m_positions.Data();
+	const BVHTri* tris = m_tris.Data();
+	m_bvh.QueryFrustum( frustum, [&]( const BVHLeaf< BVHTri >& leaf )
+	{
+		for( uint32_t i = 0; i < leaf.count; i++ )
+		{
+			if( frustum.Intersects( m_GetAABB( verts, leaf.data[ i ] ) ) && !fn( (uint32_t)( &leaf.data[ i ] - tris ) ) )
+			{
+				return false;
+			}
+		}
+		return true;
+	} );
+}
+
+template< uint32_t V, uint32_t T, uint32_t B >
+template< typename Fn >
+void CollisionMesh< V, T, B >::QuerySphere( const ae::Sphere& sphere, Fn fn ) const
+{
+	const ae::Vec3* verts = m_positions.Data();
+	const BVHTri* tris = m_tris.Data();
+	const float radiusSq = sphere.radius * sphere.radius;
+	m_bvh.QuerySphere( sphere, [&]( const BVHLeaf< BVHTri >& leaf )
+	{
+		for( uint32_t i = 0; i < leaf.count; i++ )
+		{
+			const BVHTri& tri = leaf.data[ i ];
+			const ae::Triangle triangle( verts[ tri.idx[ 0 ] ], verts[ tri.idx[ 1 ] ], verts[ tri.idx[ 2 ] ] );
+			if( ( triangle.ClosestPoint( sphere.center ) - sphere.center ).LengthSquared() <= radiusSq
+				&& !fn( (uint32_t)( &tri - tris ) ) )
+			{
+				return false;
+			}
+		}
+		return true;
+	} );
+}
+
+template< uint32_t V, uint32_t T, uint32_t B >
+template< uint32_t N >
+void CollisionMesh< V, T, B >::QueryAABB( const ae::AABB& aabb, ae::Array< uint32_t, N >* trisOut ) const
+{
+	QueryAABB( aabb, [trisOut]( uint32_t triIdx )
+	{
+		trisOut->Append( triIdx );
+		return !N || trisOut->Length() < N;
+	} );
+}
+
+template< uint32_t V, uint32_t T, uint32_t B >
+template< uint32_t N >
+void CollisionMesh< V, T, B >::QueryFrustum( const ae::Frustum& frustum, ae::Array< uint32_t, N >* trisOut ) const
+{
+	QueryFrustum( frustum, [trisOut]( uint32_t triIdx )
+	{
+		trisOut->Append( triIdx );
+		return !N || trisOut->Length() < N;
+	} );
+}
+
+template< uint32_t V, uint32_t T, uint32_t B >
+template< uint32_t N >
+void CollisionMesh< V, T, B >::QuerySphere( const ae::Sphere& sphere, ae::Array< uint32_t, N >* trisOut ) const
+{
+	QuerySphere( sphere, [trisOut]( uint32_t triIdx )
+	{
+		trisOut->Append( triIdx );
+		return !N || trisOut->Length() < N;
+	} );
+}
+
+template< uint32_t V, uint32_t T, uint32_t B >
+ae::Triangle CollisionMesh< V, T, B >::GetTriangle( uint32_t triIdx ) const
+{
+	const BVHTri& tri = m_tris[ triIdx ];
+	return ae::Triangle( m_positions[ tri.idx[ 0 ] ], m_positions[ tri.idx[ 1 ] ], m_positions[ tri.idx[ 2 ] ] );
+}
+
+template< uint32_t V, uint32_t T, uint32_t B >
+ae::AABB CollisionMesh< V, T, B >::m_GetAABB( const ae::Vec3* verts, const BVHTri& tri )
+{
+	ae::AABB aabb;
+	aabb.Expand( verts[ tri.idx[ 0 ] ] );
+	aabb.Expand( verts[ tri.idx[ 1 ] ] );
+	aabb.Expand( verts[ tri.idx[ 2 ] ] );
+	return aabb;
+}
+
+template< uint32_t V, uint32_t T, uint32_t B >
+void CollisionMesh< V, T, B >::RaycastBatch( const RaycastParams* params, uint32_t count, RaycastResult* resultsOut, const CollisionMeshRaycastParams& meshParams ) const
+{
+	if( !count || !m_bvh.GetRoot() )
+	{
+		return;
+	}
+	AE_ASSERT( params && resultsOut );
+
+	// Sphere/OBB in world space for the per ray early out, see Raycast()
+	const ae::Vec3 aabbMin = ( meshParams.transform * ae::Vec4( m_aabb.GetMin(), 1.0f ) ).GetXYZ();
+	const ae::Vec3 aabbMax = ( meshParams.transform * ae::Vec4( m_aabb.GetMax(), 1.0f ) ).GetXYZ();
+	const ae::Sphere sphere( ( aabbMin + aabbMax ) * 0.5f, ( aabbMax - aabbMin ).Length() * 0.5f );
+	const ae::OBB obb( meshParams.transform * m_aabb.GetTransform() );
+	bool debugOBB = false;
+
+	const ae::Matrix4 invTransform = meshParams.transform.GetInverse();
+	const ae::Matrix4 normalTransform = invTransform.GetTranspose();
+	const _Float4 zero = _Float4::Set( 0.0f );
+	const _Float4 one = _Float4::Set( 1.0f );
+	const _Float4 epsilon = _Float4::Set( 1e-8f ); // Matches ae::Triangle::Raycast()
+	const _Float4 negEpsilon = _Float4::Set( -1e-8f );
+	const bool ccw = meshParams.hitCounterclockwise;
+	const bool cw = meshParams.hitClockwise;
+
+	for( uint32_t packetStart = 0; packetStart < count; packetStart += 4 )
+	{
+		const uint32_t packetCount = ae::Min( 4u, count - packetStart );
+		const RaycastParams* packetParams = params + packetStart;
+		RaycastResult* packetResults = resultsOut + packetStart;
+
+		// Local space rays in structure-of-arrays layout. Inactive lanes get a
+		// negative max t so they never pass the aabb or triangle tests.
+		ae::Vec3 sources[ 4 ];
+		ae::Vec3 rays[ 4 ];
+		float rayLengths[ 4 ];
+		float s[ 3 ][ 4 ];
+		float r[ 3 ][ 4 ];
+		float invR[ 3 ][ 4 ];
+		float tMax[ 4 ];
+		uint32_t activeMask = 0;
+		auto getMaxT = [&]( uint32_t i )
+		{
+			const RaycastResult& result = packetResults[ i ];
+			const uint32_t maxHits = ae::Min( packetParams[ i ].maxHits, decltype(result.hits)::Capacity() );
+			if( result.hits.Length() >= maxHits && rayLengths[ i ] > 0.0f )
+			{
+				return result.hits.Last().distance / rayLengths[ i ]; // Only closer hits can be accumulated
+			}
+			return 1.0f;
+		};
+		for( uint32_t i = 0; i < 4; i++ )
+		{
+			if( i < packetCount
+				&& packetParams[ i ].maxHits
+				&& !packetResults[ i ].EarlyOut( packetParams[ i ], sphere )
+				&& !packetResults[ i ].EarlyOut( packetParams[ i ], obb ) )
+			{
+				const RaycastParams& rayParams = packetParams[ i ];
+				sources[ i ] = ae::Vec3( invTransform * ae::Vec4( rayParams.source, 1.0f ) );
+				rays[ i ] = ae::Vec3( invTransform * ae::Vec4( rayParams.source + rayParams.ray, 1.0f ) ) - sources[ i ];
+				rayLengths[ i ] = rayParams.ray.Length();
+				tMax[ i ] = getMaxT( i );
+				activeMask |= ( 1 << i );
+			}
+			else
+			{
+				sources[ i ] = ae::Vec3( 0.0f );
+				rays[ i ] = ae::Vec3( 0.0f, 0.0f, 1.0f );
+				rayLengths[ i ] = 0.0f;
+				tMax[ i ] = -1.0f;
+			}
+			for( uint32_t j = 0; j < 3; j++ )
+			{
+				s[ j ][ i ] = sources[ i ][ j ];
+				r[ j ][ i ] = rays[ i ][ j ];
+				// Avoid inf * 0 = NaN in slab tests for axis aligned rays
+				const float d = ( ae::Abs( rays[ i ][ j ] ) < 1e-30f ) ? 1e-30f : rays[ i ][ j ];
+				invR[ j ][ i ] = 1.0f / d;
+			}
+		}
+		if( !activeMask )
+		{
+			continue;
+		}
+		if( meshParams.debug && !debugOBB )
+		{
+			meshParams.debug->AddOBB( obb, meshParams.debugColor ); // A ray intersects obb
+			debugOBB = true;
+		}
+		const _Vec3x4 source4 = { _Float4::Load( s[ 0 ] ), _Float4::Load( s[ 1 ] ), _Float4::Load( s[ 2 ] ) };
+		const _Vec3x4 ray4 = { _Float4::Load( r[ 0 ] ), _Float4::Load( r[ 1 ] ), _Float4::Load( r[ 2 ] ) };
+		const _Vec3x4 invRay4 = { _Float4::Load( invR[ 0 ] ), _Float4::Load( invR[ 1 ] ), _Float4::Load( invR[ 2 ] ) };
+		_Float4 tMax4 = _Float4::Load( tMax );
+
+		auto slabTest = [&]( const ae::AABB& aabb ) -> uint32_t
+		{
+			const _Vec3x4 t0 = _Vec3x4::Set( aabb.GetMin() ) - source4;
+			const _Vec3x4 t1 = _Vec3x4::Set( aabb.GetMax() ) - source4;
+			const _Float4 t0x = t0.x * invRay4.x, t1x = t1.x * invRay4.x;
+			const _Float4 t0y = t0.y * invRay4.y, t1y = t1.y * invRay4.y;
+			const _Float4 t0z = t0.z * invRay4.z, t1z = t1.z * invRay4.z;
+			const _Float4 tNear = _Float4::Max( _Float4::Max( _Float4::Min( t0x, t1x ), _Float4::Min( t0y, t1y ) ), _Float4::Max( _Float4::Min( t0z, t1z ), zero ) );
+			const _Float4 tFar = _Float4::Min( _Float4::Min( _Float4::Max( t0x, t1x ), _Float4::Max( t0y, t1y ) ), _Float4::Min( _Float4::Max( t0z, t1z ), tMax4 ) );
+			return ( tNear <= tFar ).GetMask();
+		};
+
+		auto triangleTest = [&]( const BVHTri& tri )
+		{
+			// Möller–Trumbore ray-triangle intersection, see ae::Triangle::Raycast()
+			const ae::Vec3 a = m_positions[ tri.idx[ 0 ] ];
+			const ae::Vec3 edge1 = m_positions[ tri.idx[ 1 ] ] - a;
+			const ae::Vec3 edge2 = m_positions[ tri.idx[ 2 ] ] - a;
+			const _Vec3x4 e1 = _Vec3x4::Set( edge1 );
+			const _Vec3x4 e2 = _Vec3x4::Set( edge2 );
+			const _Vec3x4 h = ray4.Cross( e2 );
+			const _Float4 det = e1.Dot( h );
+			_Float4 valid = ( ccw ? ( det > epsilon ) : zero ) | ( cw ? ( det < negEpsilon ) : zero );
+			if( !valid.GetMask() )
+			{
+				return;
+			}
+			const _Float4 invDet = one / det;
+			const _Vec3x4 sa = source4 - _Vec3x4::Set( a );
+			const _Float4 u = sa.Dot( h ) * invDet;
+			const _Vec3x4 q = sa.Cross( e1 );
+			const _Float4 v = ray4.Dot( q ) * invDet;
+			const _Float4 t = e2.Dot( q ) * invDet;
+			valid = valid & ( u >= zero ) & ( u <= one ) & ( v >= zero ) & ( ( u + v ) <= one ) & ( t >= zero ) & ( t <= tMax4 );
+			uint32_t hitMask = valid.GetMask();
+			if( !hitMask )
+			{
+				return;
+			}
+
+			float tHit[ 4 ];
+			t.Store( tHit );
+			const ae::Vec3 triNormal = edge1.Cross( edge2 ).SafeNormalizeCopy();
+			const CollisionExtra extra = m_collisionExtras[ tri.idx[ 0 ] ];
+			for( uint32_t i = 0; i < 4; i++ )
+			{
+				if( !( hitMask & ( 1 << i ) ) )
+				{
+					continue;
+				}
+				const RaycastParams& rayParams = packetParams[ i ];
+				const ae::Vec3 p = sources[ i ] + rays[ i ] * tHit[ i ];
+				const ae::Vec3 n = ( rays[ i ].Dot( triNormal ) > 0.0f ) ? -triNormal : triNormal;
+				RaycastResult::Hit hit;
+				hit.position = ae::Vec3( meshParams.transform * ae::Vec4( p, 1.0f ) );
+				hit.normal = ae::Vec3( normalTransform * ae::Vec4( n, 0.0f ) ).SafeNormalizeCopy();
+				hit.distance = ( hit.position - rayParams.source ).Length();
+				hit.userData = rayParams.userData;
+				hit.extra = extra;
+				packetResults[ i ].Accumulate( rayParams, hit );
+				tMax[ i ] = getMaxT( i );
+				if( ae::DebugLines* debug = meshParams.debug )
+				{
+					debug->AddCircle( hit.position, hit.normal, 0.25f, meshParams.debugColor, 8 );
+					debug->AddLine( hit.position, hit.position + hit.normal, meshParams.debugColor );
+				}
+			}
+			tMax4 = _Float4::Load( tMax );
+		};
+
+		const BVHNode* stack[ ae::BVH< BVHTri, B >::kTraversalStackSize ];
+		uint32_t stackSize = 0;
+		stack[ stackSize++ ] = m_bvh.GetRoot();
+		while( stackSize )
+		{
+			const BVHNode* node = stack[ --stackSize ];
+			if( !slabTest( node->aabb ) )
+			{
+				continue;
+			}
+			if( const BVHLeaf< BVHTri >* leaf = m_bvh.TryGetLeaf( node->leafIdx ) )
+			{
+				for( uint32_t i = 0; i < leaf->count; i++ )
+				{
+					triangleTest( leaf->data[ i ] );
+				}
+			}
+			AE_ASSERT_MSG( stackSize + 2 <= countof( stack ), "ae::BVH is too deep to traverse" );
+			if( const BVHNode* right = m_bvh.GetNode( node->rightIdx ) ) { stack[ stackSize++ ] = right; }
+			if( const BVHNode* left = m_bvh.GetNode( node->leftIdx ) ) { stack[ stackSize++ ] = left; }
+		}
+	}
+}
+
 template< uint32_t V, uint32_t T, uint32_t B >
 PushOutInfo CollisionMesh< V, T, B >::PushOut( const PushOutParams& params, const CollisionMeshPushOutParams& meshParams, const PushOutInfo& prevInfo ) const
 {
@@ -13763,6 +16066,106 @@ PushOutInfo CollisionMesh< V, T, B >::PushOut( const PushOutParams& params, cons
 	}
 }
 
+template< uint32_t V, uint32_t T, uint32_t B >
+void CollisionMesh< V, T, B >::Serialize( ae::BinaryWriter* stream ) const
+{
+	AE_ASSERT_MSG( !m_requiresRebuild, "BuildBVH() must be called before serializing an ae::CollisionMesh" );
+	stream->SerializeUInt32( kSerializeMagic );
+	stream->SerializeUInt32( kSerializeVersion );
+	stream->SerializeUInt32( (uint32_t)sizeof(ae::Vec3) );
+	stream->SerializeUInt32( (uint32_t)sizeof(CollisionExtra) );
+	const ae::Vec3 aabbMin = m_aabb.GetMin();
+	const ae::Vec3 aabbMax = m_aabb.GetMax();
+	for( uint32_t i = 0; i < 3; i++ ) { stream->SerializeFloat( aabbMin[ i ] ); }
+	for( uint32_t i = 0; i < 3; i++ ) { stream->SerializeFloat( aabbMax[ i ] ); }
+	stream->SerializeUInt32( m_positions.Length() );
+	stream->SerializeUInt32( m_tris.Length() );
+	stream->SerializeBool( m_quantizedBVHEnabled );
+	for( ae::Vec3 p : m_positions )
+	{
+		p.pad = 0.0f; // Deterministic output
+		stream->SerializeRaw( &p, sizeof(p) );
+	}
+	stream->SerializeRaw( m_collisionExtras.Data(), m_collisionExtras.Length() * sizeof(CollisionExtra) );
+	stream->SerializeRaw( m_tris.Data(), m_tris.Length() * sizeof(BVHTri) );
+	m_bvh.Serialize( stream, m_tris.Data() );
+	if( m_quantizedBVHEnabled )
+	{
+		m_quantizedBVH.Serialize( stream, m_tris.Data() );
+	}
+}
+
+template< uint32_t V, uint32_t T, uint32_t B >
+void CollisionMesh< V, T, B >::Serialize( ae::BinaryStream* stream )
+{
+	if( ae::BinaryWriter* writer = stream->AsWriter() )
+	{
+		const CollisionMesh* self = this;
+		self->Serialize( writer );
+		return;
+	}
+	Clear();
+	uint32_t magic = 0;
+	uint32_t version = 0;
+	uint32_t vec3Size = 0;
+	uint32_t extraSize = 0;
+	ae::Vec3 aabbMin, aabbMax;
+	uint32_t vertCount = 0;
+	uint32_t triCount = 0;
+	bool quantized = false;
+	stream->SerializeUInt32( magic );
+	stream->SerializeUInt32( version );
+	stream->SerializeUInt32( vec3Size );
+	stream->SerializeUInt32( extraSize );
+	for( uint32_t i = 0; i < 3; i++ ) { stream->SerializeFloat( aabbMin[ i ] ); }
+	for( uint32_t i = 0; i < 3; i++ ) { stream->SerializeFloat( aabbMax[ i ] ); }
+	stream->SerializeUInt32( vertCount );
+	stream->SerializeUInt32( triCount );
+	stream->SerializeBool( quantized );
+	if( !stream->IsValid()
+		|| magic != kSerializeMagic
+		|| version != kSerializeVersion
+		|| vec3Size != sizeof(ae::Vec3)
+		|| extraSize != sizeof(CollisionExtra)
+		|| ( V && vertCount > V )
+		|| ( T && triCount > T )
+		|| stream->GetRemainingBytes() < (uint64_t)vertCount * ( sizeof(ae::Vec3) + sizeof(CollisionExtra) ) + (uint64_t)triCount * sizeof(BVHTri) )
+	{
+		stream->Invalidate();
+		return;
+	}
+
+	m_positions.Append( {}, vertCount );
+	m_collisionExtras.Append( {}, vertCount );
+	m_tris.Append( {}, triCount );
+	stream->SerializeRaw( m_positions.Data(), vertCount * sizeof(ae::Vec3) );
+	stream->SerializeRaw( m_collisionExtras.Data(), vertCount * sizeof(CollisionExtra) );
+	stream->SerializeRaw( m_tris.Data(), triCount * sizeof(BVHTri) );
+	for( const BVHTri& tri : m_tris )
+	{
+		if( tri.idx[ 0 ] >= vertCount || tri.idx[ 1 ] >= vertCount || tri.idx[ 2 ] >= vertCount )
+		{
+			stream->Invalidate();
+			break;
+		}
+	}
+	m_bvh.Serialize( stream, m_tris.Data(), m_tris.Length() );
+	if( quantized )
+	{
+		m_quantizedBVH.Serialize( stream, m_tris.Data(), m_tris.Length() );
+	}
+
+	if( stream->IsValid() )
+	{
+		m_aabb = ae::AABB( aabbMin, aabbMax );
+		m_quantizedBVHEnabled = quantized;
+	}
+	else
+	{
+		Clear();
+	}
+}
+
 //------------------------------------------------------------------------------
 // ae::AStar implementation
 //------------------------------------------------------------------------------
@@ -13947,6 +16350,33 @@ void OBJLoader::InitializeCollisionMesh( ae::CollisionMesh< V, T, B >* mesh )
 	mesh->BuildBVH();
 }
 
+//------------------------------------------------------------------------------
+// ae::MeshSimplifier member functions
+//------------------------------------------------------------------------------
+template< uint32_t V, uint32_t T, uint32_t B >
+void MeshSimplifier::InitializeCollisionMesh( ae::CollisionMesh< V, T, B >* mesh ) const
+{
+	if( !mesh )
+	{
+		return;
+	}
+
+	mesh->Clear();
+	if( indices.Length() )
+	{
+		mesh->AddIndexed(
+			ae::Matrix4::Identity(),
+			positions[ 0 ].data,
+			positions.Length(),
+			sizeof( ae::Vec3 ),
+			indices.Data(),
+			indices.Length(),
+			sizeof( uint32_t )
+		);
+	}
+	mesh->BuildBVH();
+}
+
 //------------------------------------------------------------------------------
 // ae::VertexArray member functions
 //------------------------------------------------------------------------------
@@ -16103,6 +18533,239 @@ void RandomSeed()
 	_randomSeed = r();
 }
 
+//------------------------------------------------------------------------------
+// ae::RandomGenerator member functions
+//------------------------------------------------------------------------------
+//! Advances a single xoshiro128** state \p s by one step
+static void _XoshiroStep( uint32_t s[ 4 ] )
+{
+	const uint32_t t = s[ 1 ] << 9;
+	s[ 2 ] ^= s[ 0 ];
+	s[ 3 ] ^= s[ 1 ];
+	s[ 1 ] ^= s[ 2 ];
+	s[ 0 ] ^= s[ 3 ];
+	s[ 2 ] ^= t;
+	s[ 3 ] = ( s[ 3 ] << 11 ) | ( s[ 3 ] >> 21 );
+}
+
+//! Advances \p s by 2^64 steps (Blackman and Vigna 2018)
+static void _XoshiroJump( uint32_t s[ 4 ] )
+{
+	static const uint32_t kJump[ 4 ] = { 0x8764000bu, 0xf542d2d3u, 0x6fa035c3u, 0x77f2db5bu };
+	uint32_t result[ 4 ] = {};
+	for( uint32_t i = 0; i < 4; i++ )
+	{
+		for( uint32_t b = 0; b < 32; b++ )
+		{
+			if( kJump[ i ] & ( 1u << b ) )
+			{
+				for( uint32_t j = 0; j < 4; j++ )
+				{
+					result[ j ] ^= s[ j ];
+				}
+			}
+			_XoshiroStep( s );
+		}
+	}
+	memcpy( s, result, sizeof(result) );
+}
+
+RandomGenerator::RandomGenerator( uint64_t seed )
+{
+	Seed( seed );
+}
+
+void RandomGenerator::Seed( uint64_t seed )
+{
+	// Expand the seed with splitmix so similar seeds give unrelated states,
+	// then start each lane 2^64 steps after the previous one
+	uint32_t s[ 4 ];
+	for( uint32_t i = 0; i < 4; i++ )
+	{
+		uint64_t z = ( seed += UINT64_C( 0x9E3779B97F4A7C15 ) );
+		z = ( z ^ ( z >> 30 ) ) * UINT64_C( 0xBF58476D1CE4E5B9 );
+		z = ( z ^ ( z >> 27 ) ) * UINT64_C( 0x94D049BB133111EB );
+		s[ i ] = (uint32_t)( ( z ^ ( z >> 31 ) ) >> 32 );
+	}
+	if( !( s[ 0 ] | s[ 1 ] | s[ 2 ] | s[ 3 ] ) )
+	{
+		s[ 0 ] = 1; // The all zero state only produces zeros
+	}
+	for( uint32_t lane = 0; lane < 4; lane++ )
+	{
+		for( uint32_t i = 0; i < 4; i++ )
+		{
+			m_state[ i ][ lane ] = s[ i ];
+		}
+		_XoshiroJump( s );
+	}
+	m_blockIndex = 4;
+}
+
+void RandomGenerator::Jump()
+{
+	for( uint32_t lane = 0; lane < 4; lane++ )
+	{
+		uint32_t s[ 4 ] = { m_state[ 0 ][ lane ], m_state[ 1 ][ lane ], m_state[ 2 ][ lane ], m_state[ 3 ][ lane ] };
+		for( uint32_t i = 0; i < 4; i++ )
+		{
+			_XoshiroJump( s );
+		}
+		for( uint32_t i = 0; i < 4; i++ )
+		{
+			m_state[ i ][ lane ] = s[ i ];
+		}
+	}
+	m_blockIndex = 4;
+}
+
+void RandomGenerator::m_Step( uint32_t result[ 4 ] )
+{
+	_Uint4 s0 = _Uint4::Load( m_state[ 0 ] );
+	_Uint4 s1 = _Uint4::Load( m_state[ 1 ] );
+	_Uint4 s2 = _Uint4::Load( m_state[ 2 ] );
+	_Uint4 s3 = _Uint4::Load( m_state[ 3 ] );
+	// rotl( s1 * 5, 7 ) * 9, with the multiplies done as shifts and adds
+	const _Uint4 r = ( s1.ShiftLeft< 2 >() + s1 ).RotateLeft< 7 >();
+	( r.ShiftLeft< 3 >() + r ).Store( result );
+	const _Uint4 t = s1.ShiftLeft< 9 >();
+	s2 = s2 ^ s0;
+	s3 = s3 ^ s1;
+	s1 = s1 ^ s2;
+	s0 = s0 ^ s3;
+	s2 = s2 ^ t;
+	s3 = s3.RotateLeft< 11 >();
+	s0.Store( m_state[ 0 ] );
+	s1.Store( m_state[ 1 ] );
+	s2.Store( m_state[ 2 ] );
+	s3.Store( m_state[ 3 ] );
+}
+
+int32_t RandomGenerator::Get( int32_t minInclusive, int32_t maxExclusive )
+{
+	// Before check so random call count is not based on params
+	const uint32_t r = GetUint32();
+	if( minInclusive >= maxExclusive )
+	{
+		return minInclusive;
+	}
+	// Multiply and shift instead of modulo (Lemire 2019)
+	const uint64_t range = (uint64_t)( (int64_t)maxExclusive - (int64_t)minInclusive );
+	return (int32_t)( (int64_t)minInclusive + (int64_t)( ( r * range ) >> 32 ) );
+}
+
+float RandomGenerator::Get( float min, float max )
+{
+	return min + Get01() * ( max - min );
+}
+
+ae::Vec3 RandomGenerator::GetUnitVec3()
+{
+	// Uniform height and angle around a cylinder projects uniformly onto a sphere
+	const float z = 1.0f - Get01() * 2.0f;
+	const float angle = Get01() * ae::TwoPi;
+	const float r = std::sqrt( ae::Max( 0.0f, 1.0f - z * z ) );
+	return ae::Vec3( r * std::cos( angle ), r * std::sin( angle ), z );
+}
+
+void RandomGenerator::FillUint32( uint32_t* out, uint32_t count )
+{
+	uint32_t i = 0;
+	for( ; i < count && m_blockIndex != 4; i++ )
+	{
+		out[ i ] = GetUint32();
+	}
+	for( ; i + 4 <= count; i += 4 )
+	{
+		m_Step( out + i );
+	}
+	for( ; i < count; i++ )
+	{
+		out[ i ] = GetUint32();
+	}
+}
+
+void RandomGenerator::Fill01( float* out, uint32_t count )
+{
+	Fill( out, count, 0.0f, 1.0f );
+}
+
+void RandomGenerator::Fill( int32_t* out, uint32_t count, int32_t minInclusive, int32_t maxExclusive )
+{
+	FillUint32( (uint32_t*)out, count );
+	if( minInclusive >= maxExclusive )
+	{
+		for( uint32_t i = 0; i < count; i++ )
+		{
+			out[ i ] = minInclusive;
+		}
+		return;
+	}
+	const uint64_t range = (uint64_t)( (int64_t)maxExclusive - (int64_t)minInclusive );
+	for( uint32_t i = 0; i < count; i++ )
+	{
+		out[ i ] = (int32_t)( (int64_t)minInclusive + (int64_t)( ( (uint32_t)out[ i ] * range ) >> 32 ) );
+	}
+}
+
+void RandomGenerator::Fill( float* out, uint32_t count, float min, float max )
+{
+	uint32_t i = 0;
+	for( ; i < count && m_blockIndex != 4; i++ )
+	{
+		out[ i ] = Get( min, max );
+	}
+	const _Float4 scale = _Float4::Set( 1.0f / 16777216.0f );
+	const _Float4 minimum = _Float4::Set( min );
+	const _Float4 range = _Float4::Set( max - min );
+	uint32_t bits[ 4 ];
+	for( ; i + 4 <= count; i += 4 )
+	{
+		m_Step( bits );
+		// Same operation order as Get( min, max ) so results match exactly
+		( minimum + ( _Uint4::Load( bits ).ShiftRight< 8 >().ToFloat() * scale ) * range ).Store( out + i );
+	}
+	for( ; i < count; i++ )
+	{
+		out[ i ] = Get( min, max );
+	}
+}
+
+void RandomGenerator::FillUnitVec3( ae::Vec3* out, uint32_t count )
+{
+	uint32_t i = 0;
+	for( ; i < count && m_blockIndex != 4; i++ )
+	{
+		out[ i ] = GetUnitVec3();
+	}
+	const _Float4 scale = _Float4::Set( 1.0f / 16777216.0f );
+	const _Float4 one = _Float4::Set( 1.0f );
+	const _Float4 two = _Float4::Set( 2.0f );
+	const _Float4 zero = _Float4::Set( 0.0f );
+	uint32_t bits[ 8 ];
+	float z[ 4 ], angle[ 4 ], r[ 4 ];
+	for( ; i + 4 <= count; i += 4 )
+	{
+		// Two steps give four ( height, angle ) pairs in the order GetUnitVec3() reads them
+		m_Step( bits );
+		m_Step( bits + 4 );
+		const _Float4 a = _Uint4::Load( bits ).ShiftRight< 8 >().ToFloat() * scale;
+		const _Float4 b = _Uint4::Load( bits + 4 ).ShiftRight< 8 >().ToFloat() * scale;
+		const _Float4 height = one - _Float4::Shuffle< 0, 2, 0, 2 >( a, b ) * two;
+		( _Float4::Shuffle< 1, 3, 1, 3 >( a, b ) * _Float4::Set( ae::TwoPi ) ).Store( angle );
+		height.Store( z );
+		_Float4::Sqrt( _Float4::Max( zero, one - height * height ) ).Store( r );
+		for( uint32_t j = 0; j < 4; j++ )
+		{
+			out[ i + j ] = ae::Vec3( r[ j ] * std::cos( angle[ j ] ), r[ j ] * std::sin( angle[ j ] ), z[ j ] );
+		}
+	}
+	for( ; i < count; i++ )
+	{
+		out[ i ] = GetUnitVec3();
+	}
+}
+
 //------------------------------------------------------------------------------
 // ae::Vec2 functions
 //------------------------------------------------------------------------------
@@ -16486,6 +19149,17 @@ Matrix4& Matrix4::SetScale( float s )
 
 Matrix4& Matrix4::SetTranspose()
 {
+#if _AE_SIMD_SSE2_ || _AE_SIMD_NEON_
+	_Float4 c0 = _Float4::Load( data );
+	_Float4 c1 = _Float4::Load( data + 4 );
+	_Float4 c2 = _Float4::Load( data + 8 );
+	_Float4 c3 = _Float4::Load( data + 12 );
+	_Float4::Transpose( c0, c1, c2, c3 );
+	c0.Store( data );
+	c1.Store( data + 4 );
+	c2.Store( data + 8 );
+	c3.Store( data + 12 );
+#else
 	for( uint32_t i = 0; i < 4; i++ )
 	{
 		for( uint32_t j = i + 1; j < 4; j++ )
@@ -16493,6 +19167,7 @@ Matrix4& Matrix4::SetTranspose()
 			std::swap( data[ i * 4 + j ], data[ j * 4 + i ] );
 		}
 	}
+#endif
 	return *this;
 }
 
@@ -16644,10 +19319,78 @@ Matrix4 Matrix4::GetTranspose() const
 	return r;
 }
 
+#if _AE_SIMD_SSE2_ || _AE_SIMD_NEON_
+// 2x2 matrix helpers for Matrix4::GetInverse(), each _Float4 is a row major
+// 2x2 matrix ( m00, m01, m10, m11 )
+static _Float4 _Mat2Mul( _Float4 a, _Float4 b )
+{
+	return a * b.Swizzle< 0, 3, 0, 3 >() + a.Swizzle< 1, 0, 3, 2 >() * b.Swizzle< 2, 1, 2, 1 >();
+}
+// Adjugate of a multiplied by b
+static _Float4 _Mat2AdjMul( _Float4 a, _Float4 b )
+{
+	return a.Swizzle< 3, 3, 0, 0 >() * b - a.Swizzle< 1, 1, 2, 2 >() * b.Swizzle< 2, 3, 0, 1 >();
+}
+// a multiplied by the adjugate of b
+static _Float4 _Mat2MulAdj( _Float4 a, _Float4 b )
+{
+	return a * b.Swizzle< 3, 0, 3, 0 >() - a.Swizzle< 1, 0, 3, 2 >() * b.Swizzle< 2, 1, 2, 1 >();
+}
+#endif
+
 // clang-format off
 Matrix4 Matrix4::GetInverse() const
 {
 	Matrix4 r;
+#if _AE_SIMD_SSE2_ || _AE_SIMD_NEON_
+	// Blockwise inversion of the 2x2 sub matrices. Columns are treated as rows,
+	// which inverts the transpose, so the output rows are the inverse's columns.
+	const _Float4 c0 = _Float4::Load( data );
+	const _Float4 c1 = _Float4::Load( data + 4 );
+	const _Float4 c2 = _Float4::Load( data + 8 );
+	const _Float4 c3 = _Float4::Load( data + 12 );
+	const _Float4 a = _Float4::Shuffle< 0, 1, 0, 1 >( c0, c1 );
+	const _Float4 b = _Float4::Shuffle< 2, 3, 2, 3 >( c0, c1 );
+	const _Float4 c = _Float4::Shuffle< 0, 1, 0, 1 >( c2, c3 );
+	const _Float4 d = _Float4::Shuffle< 2, 3, 2, 3 >( c2, c3 );
+	// Determinants of the sub matrices ( |A|, |B|, |C|, |D| )
+	const _Float4 detSub = _Float4::Shuffle< 0, 2, 0, 2 >( c0, c2 ) * _Float4::Shuffle< 1, 3, 1, 3 >( c1, c3 )
+		- _Float4::Shuffle< 1, 3, 1, 3 >( c0, c2 ) * _Float4::Shuffle< 0, 2, 0, 2 >( c1, c3 );
+	const _Float4 detA = detSub.Swizzle< 0, 0, 0, 0 >();
+	const _Float4 detB = detSub.Swizzle< 1, 1, 1, 1 >();
+	const _Float4 detC = detSub.Swizzle< 2, 2, 2, 2 >();
+	const _Float4 detD = detSub.Swizzle< 3, 3, 3, 3 >();
+	const _Float4 dc = _Mat2AdjMul( d, c );
+	const _Float4 ab = _Mat2AdjMul( a, b );
+	// Adjugates of the inverse's sub matrices
+	_Float4 x = detD * a - _Mat2Mul( b, dc );
+	_Float4 w = detA * d - _Mat2Mul( c, ab );
+	_Float4 y = detB * c - _Mat2MulAdj( d, ab );
+	_Float4 z = detC * b - _Mat2MulAdj( a, dc );
+	// |M| = |A||D| + |B||C| - tr( ( A#B )( D#C ) )
+	_Float4 tr = ab * dc.Swizzle< 0, 2, 1, 3 >();
+	tr = tr + tr.Swizzle< 1, 0, 3, 2 >();
+	tr = tr + tr.Swizzle< 2, 3, 0, 1 >();
+	const _Float4 det = detA * detD + detB * detC - tr;
+#if _AE_DEBUG_
+	AE_ASSERT_MSG( det[ 0 ] == det[ 0 ], "Non-invertible matrix '#'", *this );
+	AE_ASSERT_MSG( det[ 0 ], "Non-invertible matrix '#'", *this );
+#endif
+	// Adding zero turns the -0 produced by the negative lanes into +0, so
+	// inverting matrices like identity gives bitwise equal results
+	const _Float4 invDet = _Float4::Set( 1.0f, -1.0f, -1.0f, 1.0f ) / det;
+	const _Float4 zero = _Float4::Set( 0.0f );
+	x = x * invDet + zero;
+	y = y * invDet + zero;
+	z = z * invDet + zero;
+	w = w * invDet + zero;
+	// Undo the adjugate while writing the sub matrices back out
+	_Float4::Shuffle< 3, 1, 3, 1 >( x, y ).Store( r.data );
+	_Float4::Shuffle< 2, 0, 2, 0 >( x, y ).Store( r.data + 4 );
+	_Float4::Shuffle< 3, 1, 3, 1 >( z, w ).Store( r.data + 8 );
+	_Float4::Shuffle< 2, 0, 2, 0 >( z, w ).Store( r.data + 12 );
+	return r;
+#else
 
 	r.data[0] = data[5]  * data[10] * data[15] -
 		data[5]  * data[11] * data[14] -
@@ -16773,6 +19516,7 @@ Matrix4 Matrix4::GetInverse() const
 	}
 	
 	return r;
+#endif
 }
 // clang-format on
 
@@ -16808,6 +19552,19 @@ Vec4 Matrix4::GetRow( uint32_t row ) const
 Matrix4 Matrix4::operator*(const Matrix4& m) const
 {
 	Matrix4 r;
+#if _AE_SIMD_SSE2_ || _AE_SIMD_NEON_
+	// Each result column is a combination of this matrix's columns, summed in
+	// the same order as the scalar version
+	const _Float4 c0 = _Float4::Load( data );
+	const _Float4 c1 = _Float4::Load( data + 4 );
+	const _Float4 c2 = _Float4::Load( data + 8 );
+	const _Float4 c3 = _Float4::Load( data + 12 );
+	for( uint32_t i = 0; i < 4; i++ )
+	{
+		const float* col = m.data + i * 4;
+		( c0 * _Float4::Set( col[ 0 ] ) + c1 * _Float4::Set( col[ 1 ] ) + c2 * _Float4::Set( col[ 2 ] ) + c3 * _Float4::Set( col[ 3 ] ) ).Store( r.data + i * 4 );
+	}
+#else
 	r.data[0]=(m.data[0]*data[0])+(m.data[1]*data[4])+(m.data[2]*data[8])+(m.data[3]*data[12]);
 	r.data[1]=(m.data[0]*data[1])+(m.data[1]*data[5])+(m.data[2]*data[9])+(m.data[3]*data[13]);
 	r.data[2]=(m.data[0]*data[2])+(m.data[1]*data[6])+(m.data[2]*data[10])+(m.data[3]*data[14]);
@@ -16824,6 +19581,7 @@ Matrix4 Matrix4::operator*(const Matrix4& m) const
 	r.data[13]=(m.data[12]*data[1])+(m.data[13]*data[5])+(m.data[14]*data[9])+(m.data[15]*data[13]);
 	r.data[14]=(m.data[12]*data[2])+(m.data[13]*data[6])+(m.data[14]*data[10])+(m.data[15]*data[14]);
 	r.data[15]=(m.data[12]*data[3])+(m.data[13]*data[7])+(m.data[14]*data[11])+(m.data[15]*data[15]);
+#endif
 	return r;
 }
 
@@ -16834,11 +19592,20 @@ void Matrix4::operator*=(const Matrix4& m)
 
 Vec4 Matrix4::operator*(const Vec4& v) const
 {
+#if _AE_SIMD_SSE2_ || _AE_SIMD_NEON_
+	Vec4 r;
+	( _Float4::Load( data ) * _Float4::Set( v.x )
+		+ _Float4::Load( data + 4 ) * _Float4::Set( v.y )
+		+ _Float4::Load( data + 8 ) * _Float4::Set( v.z )
+		+ _Float4::Load( data + 12 ) * _Float4::Set( v.w ) ).Store( r.data );
+	return r;
+#else
 	return Vec4(
 		v.x*data[0] + v.y*data[4] + v.z*data[8] + v.w*data[12],
 		v.x*data[1] + v.y*data[5] + v.z*data[9] + v.w*data[13],
 		v.x*data[2] + v.y*data[6] + v.z*data[10] + v.w*data[14],
 		v.x*data[3] + v.y*data[7] + v.z*data[11] + v.w*data[15]);
+#endif
 }
 
 ae::Vec3 Matrix4::TransformPoint3x4( ae::Vec3 v ) const
@@ -16962,6 +19729,18 @@ Quaternion::Quaternion( Vec3 axis, float angle )
 
 void Quaternion::Normalize()
 {
+#if _AE_SIMD_SSE2_ || _AE_SIMD_NEON_
+	// Lanes are ( i, j, k, r ), summed in the same order as the scalar version
+	const _Float4 q = _Float4::Load( data );
+	const _Float4 sq = q * q;
+	const _Float4 magnitudeSq = sq.Swizzle< 3, 3, 3, 3 >() + sq.Swizzle< 0, 0, 0, 0 >() + sq.Swizzle< 1, 1, 1, 1 >() + sq.Swizzle< 2, 2, 2, 2 >();
+	if( magnitudeSq[ 0 ] == 0.0f )
+	{
+		r = 1;
+		return;
+	}
+	( q * ( _Float4::Set( 1.0f ) / _Float4::Sqrt( magnitudeSq ) ) ).Store( data );
+#else
 	float invMagnitude = r * r + i * i + j * j + k * k;
 
 	if( invMagnitude == 0.0f )
@@ -16975,6 +19754,7 @@ void Quaternion::Normalize()
 	i *= invMagnitude;
 	j *= invMagnitude;
 	k *= invMagnitude;
+#endif
 }
 
 Quaternion Quaternion::NormalizeCopy() const
@@ -16997,12 +19777,25 @@ bool Quaternion::operator!=( const Quaternion& q ) const
 Quaternion& Quaternion::operator*= ( const Quaternion& q )
 {
 	//http://www.mathworks.com/help/aeroblks/quaternionmultiplication.html
+#if _AE_SIMD_SSE2_ || _AE_SIMD_NEON_
+	// Lanes are ( i, j, k, r ), each term matches a column of the scalar version
+	const _Float4 a = _Float4::Load( data );
+	const _Float4 b = _Float4::Load( q.data );
+	const _Float4 signs = _Float4::Set( 1.0f, 1.0f, 1.0f, -1.0f );
+	const _Float4 t0 = a.Swizzle< 3, 3, 3, 3 >() * b;
+	const _Float4 t1 = a.Swizzle< 0, 1, 2, 0 >() * b.Swizzle< 3, 3, 3, 0 >() * signs;
+	const _Float4 t2 = a.Swizzle< 1, 2, 0, 1 >() * b.Swizzle< 2, 0, 1, 1 >() * signs;
+	const _Float4 t3 = a.Swizzle< 2, 0, 1, 2 >() * b.Swizzle< 1, 2, 0, 2 >();
+	( t0 + t1 + t2 - t3 ).Store( data );
+	return *this;
+#else
 	Quaternion copy = *this;
 	r = copy.r * q.r - copy.i * q.i - copy.j * q.j - copy.k * q.k;
 	i = copy.r * q.i + copy.i * q.r + copy.j * q.k - copy.k * q.j;
 	j = copy.r * q.j + copy.j * q.r + copy.k * q.i - copy.i * q.k;
 	k = copy.r * q.k + copy.k * q.r + copy.i * q.j - copy.j * q.i;
 	return *this;
+#endif
 }
 
 Quaternion Quaternion::operator* ( const Quaternion& q ) const
@@ -17605,6 +20398,165 @@ bool Frustum::Intersects( const ae::Sphere& sphere ) const
 	return true;
 }
 
+bool Frustum::Intersects( const ae::AABB& aabb ) const
+{
+	const ae::Vec3 center = aabb.GetCenter();
+	const ae::Vec3 halfSize = aabb.GetHalfSize();
+	for( uint32_t i = 0; i < countof(m_planes); i++ )
+	{
+		// Projected radius of the aabb onto the plane normal
+		const float r = halfSize.Dot( ae::Abs( m_planes[ i ].GetNormal() ) );
+		if( m_planes[ i ].GetSignedDistance( center ) - r > 0.0f )
+		{
+			return false;
+		}
+	}
+	return true;
+}
+
+bool Frustum::Intersects( const ae::OBB& obb ) const
+{
+	const ae::Vec3 center = obb.GetCenter();
+	const ae::Vec3 halfSize = obb.GetHalfSize();
+	for( uint32_t i = 0; i < countof(m_planes); i++ )
+	{
+		// Projected radius of the obb onto the plane normal
+		const ae::Vec3 normal = m_planes[ i ].GetNormal();
+		const float r = halfSize.x * ae::Abs( normal.Dot( obb.GetAxis( 0 ) ) )
+			+ halfSize.y * ae::Abs( normal.Dot( obb.GetAxis( 1 ) ) )
+			+ halfSize.z * ae::Abs( normal.Dot( obb.GetAxis( 2 ) ) );
+		if( m_planes[ i ].GetSignedDistance( center ) - r > 0.0f )
+		{
+			return false;
+		}
+	}
+	return true;
+}
+
+//! Loads four values starting at \p p[ i ], padding with zeros past \p count
+static _Float4 _LoadPadded4( const float* p, uint32_t i, uint32_t count )
+{
+	if( count - i >= 4 )
+	{
+		return _Float4::Load( p + i );
+	}
+	float padded[ 4 ] = { 0.0f, 0.0f, 0.0f, 0.0f };
+	for( uint32_t j = 0; i + j < count; j++ )
+	{
+		padded[ j ] = p[ i + j ];
+	}
+	return _Float4::Load( padded );
+}
+
+//! Calls \p getVisibleMask( i ) for each group of four objects starting at i,
+//! which returns one bit per visible lane, and writes the results to the
+//! optional bit array and index list.
+template< typename Fn >
+static uint32_t _FrustumCull( uint32_t count, uint32_t* visibleBitsOut, uint32_t* visibleIndicesOut, Fn getVisibleMask )
+{
+	if( visibleBitsOut )
+	{
+		memset( visibleBitsOut, 0, ( ( count + 31 ) / 32 ) * sizeof(*visibleBitsOut) );
+	}
+	uint32_t visibleCount = 0;
+	for( uint32_t i = 0; i < count; i += 4 )
+	{
+		uint32_t mask = getVisibleMask( i );
+		if( count - i < 4 )
+		{
+			mask &= ( 1u << ( count - i ) ) - 1;
+		}
+		if( visibleBitsOut )
+		{
+			visibleBitsOut[ i / 32 ] |= mask << ( i % 32 );
+		}
+		for( uint32_t lane = 0; lane < 4; lane++ )
+		{
+			if( mask & ( 1u << lane ) )
+			{
+				if( visibleIndicesOut )
+				{
+					visibleIndicesOut[ visibleCount ] = i + lane;
+				}
+				visibleCount++;
+			}
+		}
+	}
+	return visibleCount;
+}
+
+uint32_t Frustum::CullAABBs( const AABBArrays& aabbs, uint32_t* visibleBitsOut, uint32_t* visibleIndicesOut ) const
+{
+	_Float4 nx[ countof(m_planes) ], ny[ countof(m_planes) ], nz[ countof(m_planes) ];
+	_Float4 ax[ countof(m_planes) ], ay[ countof(m_planes) ], az[ countof(m_planes) ], w[ countof(m_planes) ];
+	for( uint32_t i = 0; i < countof(m_planes); i++ )
+	{
+		const ae::Vec4 plane( m_planes[ i ] );
+		nx[ i ] = _Float4::Set( plane.x );
+		ny[ i ] = _Float4::Set( plane.y );
+		nz[ i ] = _Float4::Set( plane.z );
+		ax[ i ] = _Float4::Set( ae::Abs( plane.x ) );
+		ay[ i ] = _Float4::Set( ae::Abs( plane.y ) );
+		az[ i ] = _Float4::Set( ae::Abs( plane.z ) );
+		w[ i ] = _Float4::Set( plane.w );
+	}
+	const _Float4 half = _Float4::Set( 0.5f );
+	const _Float4 zero = _Float4::Set( 0.0f );
+	const uint32_t count = aabbs.count;
+	return _FrustumCull( count, visibleBitsOut, visibleIndicesOut, [&]( uint32_t i )
+	{
+		const _Float4 minX = _LoadPadded4( aabbs.minX, i, count );
+		const _Float4 minY = _LoadPadded4( aabbs.minY, i, count );
+		const _Float4 minZ = _LoadPadded4( aabbs.minZ, i, count );
+		const _Float4 maxX = _LoadPadded4( aabbs.maxX, i, count );
+		const _Float4 maxY = _LoadPadded4( aabbs.maxY, i, count );
+		const _Float4 maxZ = _LoadPadded4( aabbs.maxZ, i, count );
+		const _Float4 cx = ( minX + maxX ) * half;
+		const _Float4 cy = ( minY + maxY ) * half;
+		const _Float4 cz = ( minZ + maxZ ) * half;
+		const _Float4 hx = ( maxX - minX ) * half;
+		const _Float4 hy = ( maxY - minY ) * half;
+		const _Float4 hz = ( maxZ - minZ ) * half;
+		_Float4 outside = zero;
+		for( uint32_t p = 0; p < countof(m_planes); p++ )
+		{
+			const _Float4 distance = cx * nx[ p ] + cy * ny[ p ] + cz * nz[ p ] - w[ p ];
+			const _Float4 r = hx * ax[ p ] + hy * ay[ p ] + hz * az[ p ];
+			outside = outside | ( distance - r > zero );
+		}
+		return ~outside.GetMask() & 0xF;
+	} );
+}
+
+uint32_t Frustum::CullSpheres( const SphereArrays& spheres, uint32_t* visibleBitsOut, uint32_t* visibleIndicesOut ) const
+{
+	_Float4 nx[ countof(m_planes) ], ny[ countof(m_planes) ], nz[ countof(m_planes) ], w[ countof(m_planes) ];
+	for( uint32_t i = 0; i < countof(m_planes); i++ )
+	{
+		const ae::Vec4 plane( m_planes[ i ] );
+		nx[ i ] = _Float4::Set( plane.x );
+		ny[ i ] = _Float4::Set( plane.y );
+		nz[ i ] = _Float4::Set( plane.z );
+		w[ i ] = _Float4::Set( plane.w );
+	}
+	const _Float4 zero = _Float4::Set( 0.0f );
+	const uint32_t count = spheres.count;
+	return _FrustumCull( count, visibleBitsOut, visibleIndicesOut, [&]( uint32_t i )
+	{
+		const _Float4 cx = _LoadPadded4( spheres.centerX, i, count );
+		const _Float4 cy = _LoadPadded4( spheres.centerY, i, count );
+		const _Float4 cz = _LoadPadded4( spheres.centerZ, i, count );
+		const _Float4 r = _LoadPadded4( spheres.radius, i, count );
+		_Float4 outside = zero;
+		for( uint32_t p = 0; p < countof(m_planes); p++ )
+		{
+			const _Float4 distance = cx * nx[ p ] + cy * ny[ p ] + cz * nz[ p ] - w[ p ];
+			outside = outside | ( ( distance > zero ) & ( distance - r > zero ) );
+		}
+		return ~outside.GetMask() & 0xF;
+	} );
+}
+
 Plane Frustum::GetPlane( ae::Frustum::Plane plane ) const
 {
 	return m_planes[ (int)plane ];
@@ -18022,6 +20974,489 @@ AABB OBB::GetAABB() const
 	return result;
 }
 
+//------------------------------------------------------------------------------
+// ae::TransformPoints, ae::TransformNormals, and ae::TransformAABBs
+//------------------------------------------------------------------------------
+static const uint32_t _kTransformMaxThreads = 32;
+static const uint32_t _kTransformMinPerThread = 32768;
+
+//! Calls \p fn( begin, end ) over [0, \p count), splitting the range across up
+//! to \p maxThreads threads (0 for all cores) when each thread would get at
+//! least _kTransformMinPerThread elements
+template< typename Fn >
+static void _TransformParallel( uint32_t count, uint32_t maxThreads, Fn fn )
+{
+	std::thread threads[ _kTransformMaxThreads - 1 ];
+	maxThreads = ae::Clip( maxThreads ? maxThreads : ae::GetMaxConcurrentThreads(), 1u, _kTransformMaxThreads );
+	const uint32_t threadCount = ae::Min( maxThreads, count / _kTransformMinPerThread );
+	if( threadCount <= 1 )
+	{
+		fn( 0, count );
+		return;
+	}
+	// Keep ranges a multiple of four so only the last one has a scalar tail
+	const uint32_t perThread = ( ( count + threadCount - 1 ) / threadCount + 3 ) & ~3u;
+	for( uint32_t i = 1; i < threadCount; i++ )
+	{
+		const uint32_t begin = ae::Min( i * perThread, count );
+		const uint32_t end = ae::Min( begin + perThread, count );
+		threads[ i - 1 ] = std::thread( [ &fn, begin, end ]() { fn( begin, end ); } );
+	}
+	fn( 0, ae::Min( perThread, count ) );
+	for( uint32_t i = 1; i < threadCount; i++ )
+	{
+		threads[ i - 1 ].join();
+	}
+}
+
+void TransformPoints( const Matrix4& transform, const float* in, uint32_t inStride, float* out, uint32_t outStride, uint32_t count, uint32_t threadCount )
+{
+	AE_ASSERT_MSG( inStride >= sizeof(float) * 3 && outStride >= sizeof(float) * 3, "Invalid point strides # #", inStride, outStride );
+	_Float4 m[ 12 ];
+	for( uint32_t i = 0; i < 12; i++ )
+	{
+		m[ i ] = _Float4::Set( transform.data[ ( i / 3 ) * 4 + ( i % 3 ) ] );
+	}
+	_TransformParallel( count, threadCount, [&]( uint32_t begin, uint32_t end )
+	{
+		uint32_t i = begin;
+		for( ; i + 4 <= end; i += 4 )
+		{
+			// Gather four points into x, y, and z lanes
+			float x[ 4 ], y[ 4 ], z[ 4 ];
+			for( uint32_t j = 0; j < 4; j++ )
+			{
+				const float* p = (const float*)( (const uint8_t*)in + ( i + j ) * (size_t)inStride );
+				x[ j ] = p[ 0 ];
+				y[ j ] = p[ 1 ];
+				z[ j ] = p[ 2 ];
+			}
+			const _Float4 px = _Float4::Load( x );
+			const _Float4 py = _Float4::Load( y );
+			const _Float4 pz = _Float4::Load( z );
+			( px * m[ 0 ] + py * m[ 3 ] + pz * m[ 6 ] + m[ 9 ] ).Store( x );
+			( px * m[ 1 ] + py * m[ 4 ] + pz * m[ 7 ] + m[ 10 ] ).Store( y );
+			( px * m[ 2 ] + py * m[ 5 ] + pz * m[ 8 ] + m[ 11 ] ).Store( z );
+			for( uint32_t j = 0; j < 4; j++ )
+			{
+				float* p = (float*)( (uint8_t*)out + ( i + j ) * (size_t)outStride );
+				p[ 0 ] = x[ j ];
+				p[ 1 ] = y[ j ];
+				p[ 2 ] = z[ j ];
+			}
+		}
+		for( ; i < end; i++ )
+		{
+			const ae::Vec3 r = transform.TransformPoint3x4( ae::Vec3( (const float*)( (const uint8_t*)in + i * (size_t)inStride ) ) );
+			float* p = (float*)( (uint8_t*)out + i * (size_t)outStride );
+			p[ 0 ] = r.x;
+			p[ 1 ] = r.y;
+			p[ 2 ] = r.z;
+		}
+	} );
+}
+
+void TransformNormals( const Matrix4& transform, const float* in, uint32_t inStride, float* out, uint32_t outStride, uint32_t count, uint32_t threadCount )
+{
+	AE_ASSERT_MSG( inStride >= sizeof(float) * 3 && outStride >= sizeof(float) * 3, "Invalid normal strides # #", inStride, outStride );
+	const ae::Matrix4 normalTransform = transform.GetNormalMatrix();
+	_Float4 m[ 9 ];
+	for( uint32_t i = 0; i < 9; i++ )
+	{
+		m[ i ] = _Float4::Set( normalTransform.data[ ( i / 3 ) * 4 + ( i % 3 ) ] );
+	}
+	const _Float4 epsilon = _Float4::Set( 0.000001f ); // Matches ae::Vec3::SafeNormalize()
+	const _Float4 zero = _Float4::Set( 0.0f );
+	_TransformParallel( count, threadCount, [&]( uint32_t begin, uint32_t end )
+	{
+		uint32_t i = begin;
+		for( ; i + 4 <= end; i += 4 )
+		{
+			float x[ 4 ], y[ 4 ], z[ 4 ];
+			for( uint32_t j = 0; j < 4; j++ )
+			{
+				const float* p = (const float*)( (const uint8_t*)in + ( i + j ) * (size_t)inStride );
+				x[ j ] = p[ 0 ];
+				y[ j ] = p[ 1 ];
+				z[ j ] = p[ 2 ];
+			}
+			const _Float4 px = _Float4::Load( x );
+			const _Float4 py = _Float4::Load( y );
+			const _Float4 pz = _Float4::Load( z );
+			const _Float4 nx = px * m[ 0 ] + py * m[ 3 ] + pz * m[ 6 ];
+			const _Float4 ny = px * m[ 1 ] + py * m[ 4 ] + pz * m[ 7 ];
+			const _Float4 nz = px * m[ 2 ] + py * m[ 5 ] + pz * m[ 8 ];
+			const _Float4 length = _Float4::Sqrt( nx * nx + ny * ny + nz * nz );
+			const _Float4 valid = ( length >= epsilon );
+			_Float4::Select( valid, nx / length, zero ).Store( x );
+			_Float4::Select( valid, ny / length, zero ).Store( y );
+			_Float4::Select( valid, nz / length, zero ).Store( z );
+			for( uint32_t j = 0; j < 4; j++ )
+			{
+				float* p = (float*)( (uint8_t*)out + ( i + j ) * (size_t)outStride );
+				p[ 0 ] = x[ j ];
+				p[ 1 ] = y[ j ];
+				p[ 2 ] = z[ j ];
+			}
+		}
+		for( ; i < end; i++ )
+		{
+			const ae::Vec3 n( (const float*)( (const uint8_t*)in + i * (size_t)inStride ) );
+			const ae::Vec3 r = normalTransform.TransformVector3x4( n ).SafeNormalizeCopy();
+			float* p = (float*)( (uint8_t*)out + i * (size_t)outStride );
+			p[ 0 ] = r.x;
+			p[ 1 ] = r.y;
+			p[ 2 ] = r.z;
+		}
+	} );
+}
+
+void TransformAABBs( const Matrix4& transform, const AABB* in, uint32_t inStride, AABB* out, uint32_t outStride, uint32_t count, uint32_t threadCount )
+{
+	AE_ASSERT_MSG( inStride >= sizeof(AABB) && outStride >= sizeof(AABB), "Invalid aabb strides # #", inStride, outStride );
+	// The transformed center is offset by the half size projected onto the
+	// absolute value of each axis (Arvo, Graphics Gems 1990)
+	_Float4 axes[ 4 ], absAxes[ 3 ];
+	for( uint32_t i = 0; i < 4; i++ )
+	{
+		axes[ i ] = _Float4::Load( transform.data + i * 4 );
+	}
+	const _Float4 zero = _Float4::Set( 0.0f );
+	for( uint32_t i = 0; i < 3; i++ )
+	{
+		absAxes[ i ] = _Float4::Max( axes[ i ], zero - axes[ i ] );
+	}
+	_TransformParallel( count, threadCount, [&]( uint32_t begin, uint32_t end )
+	{
+		for( uint32_t i = begin; i < end; i++ )
+		{
+			const ae::AABB& aabb = *(const ae::AABB*)( (const uint8_t*)in + i * (size_t)inStride );
+			ae::AABB& result = *(ae::AABB*)( (uint8_t*)out + i * (size_t)outStride );
+			const ae::Vec3 min = aabb.GetMin();
+			const ae::Vec3 max = aabb.GetMax();
+			if( !( min.x <= max.x && min.y <= max.y && min.z <= max.z ) )
+			{
+				result = ae::AABB();
+				continue;
+			}
+			const ae::Vec3 c = ( min + max ) * 0.5f;
+			const ae::Vec3 h = ( max - min ) * 0.5f;
+			const _Float4 center = axes[ 0 ] * _Float4::Set( c.x ) + axes[ 1 ] * _Float4::Set( c.y ) + axes[ 2 ] * _Float4::Set( c.z ) + axes[ 3 ];
+			const _Float4 halfSize = absAxes[ 0 ] * _Float4::Set( h.x ) + absAxes[ 1 ] * _Float4::Set( h.y ) + absAxes[ 2 ] * _Float4::Set( h.z );
+			ae::Vec4 resultMin, resultMax;
+			( center - halfSize ).Store( resultMin.data );
+			( center + halfSize ).Store( resultMax.data );
+			result = ae::AABB( resultMin.GetXYZ(), resultMax.GetXYZ() );
+		}
+	} );
+}
+
+//------------------------------------------------------------------------------
+// ae::GradientNoise, ae::SimplexNoise, and ae::FractalNoise
+//------------------------------------------------------------------------------
+// Multiplies and adds must not be fused so that noise values don't depend on
+// the compiler or instruction set. MSVC only fuses with /fp:contract or /fp:fast.
+#if defined(__clang__)
+#pragma float_control( push )
+#pragma clang fp contract( off )
+#elif defined(__GNUC__)
+#pragma GCC push_options
+#pragma GCC optimize( "fp-contract=off" )
+#endif
+
+template< uint32_t D >
+static uint32_t _NoiseHash( const int32_t* cell, uint32_t seed )
+{
+	static const uint32_t kPrimes[ 4 ] = { 0x8da6b343u, 0xd8163841u, 0xcb1ab31fu, 0x165667b1u };
+	uint32_t h = seed * 0x9e3779b9u;
+	for( uint32_t a = 0; a < D; a++ )
+	{
+		h ^= (uint32_t)cell[ a ] * kPrimes[ a ];
+	}
+	h ^= h >> 16;
+	h *= 0x7feb352du;
+	h ^= h >> 15;
+	h *= 0x846ca68bu;
+	h ^= h >> 16;
+	return h;
+}
+
+//! Returns one of a small set of gradients with \p D components
+template< uint32_t D >
+static const float* _NoiseGradient( uint32_t hash )
+{
+	static const float kDiag = 0.70710678f;
+	static const float kGradients2[ 8 ][ 2 ] =
+	{
+		{ 1.0f, 0.0f }, { -1.0f, 0.0f }, { 0.0f, 1.0f }, { 0.0f, -1.0f },
+		{ kDiag, kDiag }, { -kDiag, kDiag }, { kDiag, -kDiag }, { -kDiag, -kDiag }
+	};
+	// Cube edge midpoints, padded to 16 (Perlin 2002)
+	static const float kGradients3[ 16 ][ 3 ] =
+	{
+		{ 1.0f, 1.0f, 0.0f }, { -1.0f, 1.0f, 0.0f }, { 1.0f, -1.0f, 0.0f }, { -1.0f, -1.0f, 0.0f },
+		{ 1.0f, 0.0f, 1.0f }, { -1.0f, 0.0f, 1.0f }, { 1.0f, 0.0f, -1.0f }, { -1.0f, 0.0f, -1.0f },
+		{ 0.0f, 1.0f, 1.0f }, { 0.0f, -1.0f, 1.0f }, { 0.0f, 1.0f, -1.0f }, { 0.0f, -1.0f, -1.0f },
+		{ 1.0f, 1.0f, 0.0f }, { -1.0f, 1.0f, 0.0f }, { 0.0f, -1.0f, 1.0f }, { 0.0f, -1.0f, -1.0f }
+	};
+	// Tesseract edge midpoints
+	static const float kGradients4[ 32 ][ 4 ] =
+	{
+		{ 0.0f, 1.0f, 1.0f, 1.0f }, { 0.0f, 1.0f, 1.0f, -1.0f }, { 0.0f, 1.0f, -1.0f, 1.0f }, { 0.0f, 1.0f, -1.0f, -1.0f },
+		{ 0.0f, -1.0f, 1.0f, 1.0f }, { 0.0f, -1.0f, 1.0f, -1.0f }, { 0.0f, -1.0f, -1.0f, 1.0f }, { 0.0f, -1.0f, -1.0f, -1.0f },
+		{ 1.0f, 0.0f, 1.0f, 1.0f }, { 1.0f, 0.0f, 1.0f, -1.0f }, { 1.0f, 0.0f, -1.0f, 1.0f }, { 1.0f, 0.0f, -1.0f, -1.0f },
+		{ -1.0f, 0.0f, 1.0f, 1.0f }, { -1.0f, 0.0f, 1.0f, -1.0f }, { -1.0f, 0.0f, -1.0f, 1.0f }, { -1.0f, 0.0f, -1.0f, -1.0f },
+		{ 1.0f, 1.0f, 0.0f, 1.0f }, { 1.0f, 1.0f, 0.0f, -1.0f }, { 1.0f, -1.0f, 0.0f, 1.0f }, { 1.0f, -1.0f, 0.0f, -1.0f },
+		{ -1.0f, 1.0f, 0.0f, 1.0f }, { -1.0f, 1.0f, 0.0f, -1.0f }, { -1.0f, -1.0f, 0.0f, 1.0f }, { -1.0f, -1.0f, 0.0f, -1.0f },
+		{ 1.0f, 1.0f, 1.0f, 0.0f }, { 1.0f, 1.0f, -1.0f, 0.0f }, { 1.0f, -1.0f, 1.0f, 0.0f }, { 1.0f, -1.0f, -1.0f, 0.0f },
+		{ -1.0f, 1.0f, 1.0f, 0.0f }, { -1.0f, 1.0f, -1.0f, 0.0f }, { -1.0f, -1.0f, 1.0f, 0.0f }, { -1.0f, -1.0f, -1.0f, 0.0f }
+	};
+	switch( D )
+	{
+		case 2: return kGradients2[ hash & 7 ];
+		case 3: return kGradients3[ hash & 15 ];
+		default: return kGradients4[ hash & 31 ];
+	}
+}
+
+//! Scalar stand in for _Float4, so single positions don't pay for four lanes
+struct _NoiseFloat1
+{
+	float v;
+	static _NoiseFloat1 Set( float f ) { return { f }; }
+	static _NoiseFloat1 Load( const float* p ) { return { *p }; }
+	void Store( float* p ) const { *p = v; }
+	_NoiseFloat1 operator + ( _NoiseFloat1 o ) const { return { v + o.v }; }
+	_NoiseFloat1 operator - ( _NoiseFloat1 o ) const { return { v - o.v }; }
+	_NoiseFloat1 operator * ( _NoiseFloat1 o ) const { return { v * o.v }; }
+	_NoiseFloat1 operator / ( _NoiseFloat1 o ) const { return { v / o.v }; }
+	// Matches _Float4, which returns the second operand if either is NaN
+	static _NoiseFloat1 Max( _NoiseFloat1 a, _NoiseFloat1 b ) { return { ( a.v > b.v ) ? a.v : b.v }; }
+};
+
+//! Evaluates gradient noise at \p N positions with \p F holding N lanes, stored
+//! as one lane per position
+template< uint32_t D, typename F, uint32_t N >
+static F _GradientNoise( const float p[][ N ], uint32_t seed )
+{
+	// Scales the largest possible value of each dimension to roughly 1
+	static const float kScale[ 5 ] = { 0.0f, 0.0f, 1.4142f, 0.96f, 0.866f };
+	int32_t cell[ D ][ N ];
+	F f[ D ], u[ D ];
+	const F one = F::Set( 1.0f );
+	for( uint32_t a = 0; a < D; a++ )
+	{
+		float frac[ N ];
+		for( uint32_t j = 0; j < N; j++ )
+		{
+			const float fl = std::floor( p[ a ][ j ] );
+			cell[ a ][ j ] = (int32_t)fl;
+			frac[ j ] = p[ a ][ j ] - fl;
+		}
+		f[ a ] = F::Load( frac );
+		// Quintic fade curve 6t^5 - 15t^4 + 10t^3
+		u[ a ] = f[ a ] * f[ a ] * f[ a ] * ( f[ a ] * ( f[ a ] * F::Set( 6.0f ) - F::Set( 15.0f ) ) + F::Set( 10.0f ) );
+	}
+	F values[ 1 << D ];
+	for( uint32_t c = 0; c < ( 1u << D ); c++ )
+	{
+		float gradient[ D ][ N ];
+		for( uint32_t j = 0; j < N; j++ )
+		{
+			int32_t corner[ D ];
+			for( uint32_t a = 0; a < D; a++ )
+			{
+				corner[ a ] = cell[ a ][ j ] + (int32_t)( ( c >> a ) & 1 );
+			}
+			const float* g = _NoiseGradient< D >( _NoiseHash< D >( corner, seed ) );
+			for( uint32_t a = 0; a < D; a++ )
+			{
+				gradient[ a ][ j ] = g[ a ];
+			}
+		}
+		F dot = F::Load( gradient[ 0 ] ) * ( ( c & 1 ) ? f[ 0 ] - one : f[ 0 ] );
+		for( uint32_t a = 1; a < D; a++ )
+		{
+			dot = dot + F::Load( gradient[ a ] ) * ( ( ( c >> a ) & 1 ) ? f[ a ] - one : f[ a ] );
+		}
+		values[ c ] = dot;
+	}
+	// Interpolate along each axis, halving the number of values each time
+	for( uint32_t a = 0; a < D; a++ )
+	{
+		for( uint32_t c = 0; c < ( 1u << ( D - a - 1 ) ); c++ )
+		{
+			values[ c ] = values[ c * 2 ] + ( values[ c * 2 + 1 ] - values[ c * 2 ] ) * u[ a ];
+		}
+	}
+	return values[ 0 ] * F::Set( kScale[ D ] );
+}
+
+//! Evaluates simplex noise at \p N positions with \p F holding N lanes, stored
+//! as one lane per position
+template< uint32_t D, typename F, uint32_t N >
+static F _SimplexNoise( const float p[][ N ], uint32_t seed )
+{
+	// Skew factors are ( sqrt( D + 1 ) - 1 ) / D and ( 1 - 1 / sqrt( D + 1 ) ) / D
+	static const float kSkew[ 5 ] = { 0.0f, 0.0f, 0.36602540f, 0.33333333f, 0.30901699f };
+	static const float kUnskew[ 5 ] = { 0.0f, 0.0f, 0.21132487f, 0.16666667f, 0.13819660f };
+	// Scales the largest possible value of each dimension to roughly 1
+	static const float kScale[ 5 ] = { 0.0f, 0.0f, 99.2f, 76.5f, 62.4f };
+	// Offsets from each of the D + 1 simplex corners, and their gradients
+	float offset[ D + 1 ][ D ][ N ];
+	float gradient[ D + 1 ][ D ][ N ];
+	for( uint32_t j = 0; j < N; j++ )
+	{
+		float skew = 0.0f;
+		for( uint32_t a = 0; a < D; a++ )
+		{
+			skew += p[ a ][ j ];
+		}
+		skew *= kSkew[ D ];
+		int32_t cell[ D ];
+		int32_t cellSum = 0;
+		for( uint32_t a = 0; a < D; a++ )
+		{
+			cell[ a ] = (int32_t)std::floor( p[ a ][ j ] + skew );
+			cellSum += cell[ a ];
+		}
+		const float unskew = (float)cellSum * kUnskew[ D ];
+		float d0[ D ];
+		for( uint32_t a = 0; a < D; a++ )
+		{
+			d0[ a ] = p[ a ][ j ] - ( (float)cell[ a ] - unskew );
+		}
+		// Step along axes from largest to smallest offset to find the simplex
+		uint32_t rank[ D ] = {};
+		for( uint32_t a = 0; a < D; a++ )
+		{
+			for( uint32_t b = a + 1; b < D; b++ )
+			{
+				( d0[ a ] > d0[ b ] ) ? rank[ a ]++ : rank[ b ]++;
+			}
+		}
+		for( uint32_t k = 0; k <= D; k++ )
+		{
+			int32_t corner[ D ];
+			for( uint32_t a = 0; a < D; a++ )
+			{
+				const int32_t step = ( rank[ a ] + k >= D ) ? 1 : 0;
+				corner[ a ] = cell[ a ] + step;
+				offset[ k ][ a ][ j ] = d0[ a ] - (float)step + (float)k * kUnskew[ D ];
+			}
+			const float* g = _NoiseGradient< D >( _NoiseHash< D >( corner, seed ) );
+			for( uint32_t a = 0; a < D; a++ )
+			{
+				gradient[ k ][ a ][ j ] = g[ a ];
+			}
+		}
+	}
+	const F zero = F::Set( 0.0f );
+	F result = zero;
+	for( uint32_t k = 0; k <= D; k++ )
+	{
+		F t = F::Set( 0.5f );
+		F dot = zero;
+		for( uint32_t a = 0; a < D; a++ )
+		{
+			const F d = F::Load( offset[ k ][ a ] );
+			t = t - d * d;
+			dot = dot + F::Load( gradient[ k ][ a ] ) * d;
+		}
+		t = F::Max( t, zero );
+		t = t * t;
+		result = result + t * t * dot;
+	}
+	return result * F::Set( kScale[ D ] );
+}
+
+//! Calls \p fn( lanes, out ) with positions in blocks of four, one lane per
+//! position. Unused lanes of the last block are zero.
+template< uint32_t D, typename V, typename Fn >
+static void _NoiseBatch( const V* p, float* out, uint32_t count, Fn fn )
+{
+	float lanes[ D ][ 4 ];
+	float result[ 4 ];
+	for( uint32_t i = 0; i < count; i += 4 )
+	{
+		const uint32_t n = ae::Min( 4u, count - i );
+		for( uint32_t j = 0; j < 4; j++ )
+		{
+			for( uint32_t a = 0; a < D; a++ )
+			{
+				lanes[ a ][ j ] = ( j < n ) ? p[ i + j ].data[ a ] : 0.0f;
+			}
+		}
+		fn( (const float(*)[ 4 ])lanes, result );
+		for( uint32_t j = 0; j < n; j++ )
+		{
+			out[ i + j ] = result[ j ];
+		}
+	}
+}
+
+template< uint32_t D, typename F, uint32_t N >
+static F _FractalNoise( const float p[][ N ], const ae::FractalNoiseParams& params )
+{
+	F position[ D ];
+	for( uint32_t a = 0; a < D; a++ )
+	{
+		position[ a ] = F::Load( p[ a ] ) * F::Set( params.frequency );
+	}
+	F sum = F::Set( 0.0f );
+	float amplitude = 1.0f;
+	float totalAmplitude = 0.0f;
+	for( uint32_t i = 0; i < params.octaves; i++ )
+	{
+		float octave[ D ][ N ];
+		for( uint32_t a = 0; a < D; a++ )
+		{
+			position[ a ].Store( octave[ a ] );
+			position[ a ] = position[ a ] * F::Set( params.lacunarity );
+		}
+		const uint32_t seed = params.seed + i * 0x68e31da4u;
+		const F n = ( params.type == ae::NoiseType::Gradient ) ? _GradientNoise< D, F, N >( octave, seed ) : _SimplexNoise< D, F, N >( octave, seed );
+		sum = sum + n * F::Set( amplitude );
+		totalAmplitude += amplitude;
+		amplitude *= params.gain;
+	}
+	return sum / F::Set( totalAmplitude );
+}
+
+// clang-format off
+#define _AE_NOISE_FUNCTIONS( _Vec, _D )\
+float GradientNoise( _Vec p, uint32_t seed ) { return _GradientNoise< _D, _NoiseFloat1, 1 >( (const float(*)[ 1 ])p.data, seed ).v; }\
+float SimplexNoise( _Vec p, uint32_t seed ) { return _SimplexNoise< _D, _NoiseFloat1, 1 >( (const float(*)[ 1 ])p.data, seed ).v; }\
+float FractalNoise( _Vec p, const ae::FractalNoiseParams& params )\
+{\
+	AE_ASSERT( params.octaves );\
+	return _FractalNoise< _D, _NoiseFloat1, 1 >( (const float(*)[ 1 ])p.data, params ).v;\
+}\
+void GradientNoise( const _Vec* p, float* out, uint32_t count, uint32_t seed )\
+{\
+	_NoiseBatch< _D >( p, out, count, [ seed ]( const float lanes[][ 4 ], float* result ) { _GradientNoise< _D, _Float4, 4 >( lanes, seed ).Store( result ); } );\
+}\
+void SimplexNoise( const _Vec* p, float* out, uint32_t count, uint32_t seed )\
+{\
+	_NoiseBatch< _D >( p, out, count, [ seed ]( const float lanes[][ 4 ], float* result ) { _SimplexNoise< _D, _Float4, 4 >( lanes, seed ).Store( result ); } );\
+}\
+void FractalNoise( const _Vec* p, float* out, uint32_t count, const ae::FractalNoiseParams& params )\
+{\
+	AE_ASSERT( params.octaves );\
+	_NoiseBatch< _D >( p, out, count, [ &params ]( const float lanes[][ 4 ], float* result ) { _FractalNoise< _D, _Float4, 4 >( lanes, params ).Store( result ); } );\
+}
+_AE_NOISE_FUNCTIONS( ae::Vec2, 2 )
+_AE_NOISE_FUNCTIONS( ae::Vec3, 3 )
+_AE_NOISE_FUNCTIONS( ae::Vec4, 4 )
+#undef _AE_NOISE_FUNCTIONS
+// clang-format on
+
+#if defined(__clang__)
+#pragma float_control( pop )
+#elif defined(__GNUC__)
+#pragma GCC pop_options
+#endif
+
 //------------------------------------------------------------------------------
 // ae::Triangle member functions @TODO: move
 //------------------------------------------------------------------------------
@@ -18304,6 +21739,236 @@ bool Triangle::SphereCast( Vec3 source, Vec3 ray, float radius, bool ccw, bool c
 	return true;
 }
 
+//! Closest points between segments p0-p1 and q0-q1. See Real-time Collision
+//! Detection: 5.1.9 Closest Points of Two Line Segments.
+static float _GetSegmentSegmentClosestPoints( ae::Vec3 p0, ae::Vec3 p1, ae::Vec3 q0, ae::Vec3 q1, ae::Vec3* pOut, ae::Vec3* qOut )
+{
+	const float epsilon = 1e-12f;
+	const ae::Vec3 d1 = p1 - p0;
+	const ae::Vec3 d2 = q1 - q0;
+	const ae::Vec3 r = p0 - q0;
+	const float a = d1.Dot( d1 );
+	const float e = d2.Dot( d2 );
+	const float f = d2.Dot( r );
+	float s = 0.0f;
+	float t = 0.0f;
+	if( a <= epsilon && e <= epsilon )
+	{
+		// Both segments are points
+	}
+	else if( a <= epsilon )
+	{
+		t = ae::Clip01( f / e );
+	}
+	else
+	{
+		const float c = d1.Dot( r );
+		if( e <= epsilon )
+		{
+			s = ae::Clip01( -c / a );
+		}
+		else
+		{
+			const float b = d1.Dot( d2 );
+			const float denom = a * e - b * b;
+			s = ( denom > epsilon ) ? ae::Clip01( ( b * f - c * e ) / denom ) : 0.0f;
+			t = ( b * s + f ) / e;
+			if( t < 0.0f )
+			{
+				t = 0.0f;
+				s = ae::Clip01( -c / a );
+			}
+			else if( t > 1.0f )
+			{
+				t = 1.0f;
+				s = ae::Clip01( ( b - c ) / a );
+			}
+		}
+	}
+	*pOut = p0 + d1 * s;
+	*qOut = q0 + d2 * t;
+	return ( *pOut - *qOut ).Length();
+}
+
+//! Closest points between segment p0-p1 and \p tri
+static float _GetSegmentTriangleClosestPoints( ae::Vec3 p0, ae::Vec3 p1, const ae::Triangle& tri, ae::Vec3* segOut, ae::Vec3* triOut )
+{
+	ae::Vec3 hit;
+	if( tri.Raycast( p0, p1 - p0, true, true, &hit ) )
+	{
+		*segOut = hit;
+		*triOut = hit;
+		return 0.0f;
+	}
+	*segOut = p0;
+	*triOut = tri.ClosestPoint( p0 );
+	float best = ( *segOut - *triOut ).Length();
+	auto check = [&]( ae::Vec3 s, ae::Vec3 t, float distance )
+	{
+		if( distance < best )
+		{
+			best = distance;
+			*segOut = s;
+			*triOut = t;
+		}
+	};
+	const ae::Vec3 closest1 = tri.ClosestPoint( p1 );
+	check( p1, closest1, ( p1 - closest1 ).Length() );
+	for( uint32_t i = 0; i < 3; i++ )
+	{
+		ae::Vec3 s, t;
+		const float distance = _GetSegmentSegmentClosestPoints( p0, p1, tri.vertices[ i ], tri.vertices[ ( i + 1 ) % 3 ], &s, &t );
+		check( s, t, distance );
+	}
+	return best;
+}
+
+bool Triangle::CapsuleCast( Vec3 p0, Vec3 p1, Vec3 ray, float radius, bool ccw, bool cw, Vec3* hitOut, Vec3* normalOut, float* distanceOut ) const
+{
+	if( !ccw && !cw )
+	{
+		return false;
+	}
+	const ae::Vec3 triNormal = CounterClockwiseNormal();
+	if( triNormal.LengthSquared() < 0.5f )
+	{
+		return false; // Degenerate triangle
+	}
+
+	const float tolerance = ae::Max( radius * 1e-4f, 1e-6f );
+	auto getDistance = [&]( float t, ae::Vec3* triPointOut, ae::Vec3* contactNormalOut )
+	{
+		const ae::Vec3 offset = ray * t;
+		ae::Vec3 segPoint;
+		const float distance = _GetSegmentTriangleClosestPoints( p0 + offset, p1 + offset, *this, &segPoint, triPointOut );
+		if( distance > 1e-6f )
+		{
+			*contactNormalOut = ( segPoint - *triPointOut ) / distance;
+		}
+		else
+		{
+			// Segment touches the triangle, use the side the segment center is on
+			const ae::Vec3 center = ( p0 + p1 ) * 0.5f + offset;
+			*contactNormalOut = ( triNormal.Dot( center - vertices[ 0 ] ) >= 0.0f ) ? triNormal : -triNormal;
+		}
+		return distance;
+	};
+	auto hitFn = [&]( float t, ae::Vec3 triPoint, ae::Vec3 normal )
+	{
+		const float nDot = triNormal.Dot( normal );
+		if( ( !cw && nDot < 0.0f ) || ( !ccw && nDot > 0.0f ) )
+		{
+			return false;
+		}
+		if( hitOut )
+		{
+			*hitOut = triPoint;
+		}
+		if( normalOut )
+		{
+			*normalOut = normal;
+		}
+		if( distanceOut )
+		{
+			*distanceOut = ray.Length() * t;
+		}
+		return true;
+	};
+
+	// Newton's method stalls or steps past the minimum distance when the
+	// capsule grazes the triangle, ie. the closest approach is within the
+	// tolerance but the rate of approach goes to zero. Bracket the minimum
+	// between 'lo' and 'hi' instead and bisect for the first time of impact.
+	auto grazeFn = [&]( float lo, float distLo, float rateLo, float hi )
+	{
+		if( hi <= lo || rateLo >= 0.0f )
+		{
+			return false; // Distance only increases after 'lo'
+		}
+		ae::Vec3 triPoint, normal;
+		const float distHi = getDistance( hi, &triPoint, &normal );
+		const float rateHi = normal.Dot( ray );
+		float closestT = hi;
+		if( rateHi > 0.0f )
+		{
+			// The distance is convex so it's above both tangents. Skip the
+			// search when the tangents cross outside of the tolerance.
+			const float cross = ( distHi - distLo - rateHi * hi + rateLo * lo ) / ( rateLo - rateHi );
+			if( distLo + rateLo * ( cross - lo ) - radius > tolerance )
+			{
+				return false;
+			}
+			// Golden section search for the minimum
+			const float kInvPhi = 0.618034f;
+			float a = lo;
+			float b = hi;
+			for( uint32_t i = 0; i < 32 && b - a > 1e-6f; i++ )
+			{
+				const float t0 = b - ( b - a ) * kInvPhi;
+				const float t1 = a + ( b - a ) * kInvPhi;
+				if( getDistance( t0, &triPoint, &normal ) < getDistance( t1, &triPoint, &normal ) )
+				{
+					b = t1;
+				}
+				else
+				{
+					a = t0;
+				}
+			}
+			closestT = ( a + b ) * 0.5f;
+		}
+		if( getDistance( closestT, &triPoint, &normal ) - radius > tolerance )
+		{
+			return false;
+		}
+		for( uint32_t i = 0; i < 32 && closestT - lo > 1e-7f; i++ )
+		{
+			const float mid = ( lo + closestT ) * 0.5f;
+			if( getDistance( mid, &triPoint, &normal ) - radius <= tolerance )
+			{
+				closestT = mid;
+			}
+			else
+			{
+				lo = mid;
+			}
+		}
+		getDistance( closestT, &triPoint, &normal );
+		return hitFn( closestT, triPoint, normal );
+	};
+
+	// The distance between the moving segment and the triangle is convex in t
+	// and differentiable while positive, so Newton's method started at t=0
+	// approaches the first time of impact from below without overshooting.
+	float t = 0.0f;
+	float prevT = 0.0f, prevDistance = 0.0f, prevRate = 0.0f;
+	for( uint32_t i = 0; i < 64; i++ )
+	{
+		ae::Vec3 triPoint, normal;
+		const float distance = getDistance( t, &triPoint, &normal );
+		if( distance - radius <= tolerance )
+		{
+			return hitFn( t, triPoint, normal );
+		}
+		const float rate = normal.Dot( ray ); // Derivative of distance with respect to t
+		if( rate > -1e-8f )
+		{
+			// Moving apart, the minimum was passed since the previous step
+			return i ? grazeFn( prevT, prevDistance, prevRate, ( rate > 0.0f ) ? t : 1.0f ) : false;
+		}
+		const float next = t + ( radius - distance ) / rate;
+		if( next > 1.0f )
+		{
+			return grazeFn( t, distance, rate, 1.0f );
+		}
+		prevT = t;
+		prevDistance = distance;
+		prevRate = rate;
+		t = next;
+	}
+	return false;
+}
+
 ae::Vec3 Triangle::ClosestPoint( ae::Vec3 p ) const
 {
 	const ae::Vec3 ab = vertices[ 1 ] - vertices[ 0 ];
@@ -29853,16 +33518,81 @@ void RaycastResult::Accumulate( const RaycastParams& params, const RaycastResult
 //------------------------------------------------------------------------------
 // ae::Raycast free functions
 //------------------------------------------------------------------------------
-RaycastResult Raycast( const Triangle& tri, const RaycastParams& params, const TriangleRaycastParams& triParams, RaycastResult result )
+bool _GetRaycastHit( const Triangle& tri, const RaycastParams& params, const TriangleRaycastParams& triParams, RaycastResult::Hit* hitOut )
 {
 	ae::Vec3 p, n;
-	if( tri.Raycast( params.source, params.ray, triParams.hitCounterclockwise, triParams.hitClockwise, &p, &n, nullptr ) )
+	if( !tri.Raycast( params.source, params.ray, triParams.hitCounterclockwise, triParams.hitClockwise, &p, &n, nullptr ) )
+	{
+		return false;
+	}
+	hitOut->position = p;
+	hitOut->normal = n;
+	hitOut->distance = ( p - params.source ).Length();
+	hitOut->userData = params.userData;
+	return true;
+}
+
+bool _GetRaycastHit( const Sphere& sphere, const RaycastParams& params, RaycastResult::Hit* hitOut )
+{
+	ae::Vec3 p, n;
+	if( !sphere.Raycast( params.source, params.ray, &p, &n, nullptr ) )
+	{
+		return false;
+	}
+	hitOut->position = p;
+	hitOut->normal = n;
+	hitOut->distance = ( p - params.source ).Length();
+	hitOut->userData = params.userData;
+	return true;
+}
+
+bool _GetRaycastHit( const Plane& plane, const RaycastParams& params, RaycastResult::Hit* hitOut )
+{
+	ae::Vec3 p;
+	if( !plane.Raycast( params.source, params.ray, &p, nullptr ) )
+	{
+		return false;
+	}
+	hitOut->position = p;
+	hitOut->normal = plane.GetNormal();
+	hitOut->distance = ( p - params.source ).Length();
+	hitOut->userData = params.userData;
+	return true;
+}
+
+bool _GetRaycastHit( const AABB& aabb, const RaycastParams& params, RaycastResult::Hit* hitOut )
+{
+	ae::Vec3 p, n;
+	if( !aabb.Raycast( params.source, params.ray, &p, &n, nullptr ) )
+	{
+		return false;
+	}
+	hitOut->position = p;
+	hitOut->normal = n;
+	hitOut->distance = ( p - params.source ).Length();
+	hitOut->userData = params.userData;
+	return true;
+}
+
+bool _GetRaycastHit( const OBB& obb, const RaycastParams& params, RaycastResult::Hit* hitOut )
+{
+	ae::Vec3 p, n;
+	if( !obb.Raycast( params.source, params.ray, &p, &n, nullptr ) )
+	{
+		return false;
+	}
+	hitOut->position = p;
+	hitOut->normal = n;
+	hitOut->distance = ( p - params.source ).Length();
+	hitOut->userData = params.userData;
+	return true;
+}
+
+RaycastResult Raycast( const Triangle& tri, const RaycastParams& params, const TriangleRaycastParams& triParams, RaycastResult result )
+{
+	RaycastResult::Hit hit;
+	if( _GetRaycastHit( tri, params, triParams, &hit ) )
 	{
-		RaycastResult::Hit hit;
-		hit.position = p;
-		hit.normal = n;
-		hit.distance = ( p - params.source ).Length();
-		hit.userData = params.userData;
 		result.Accumulate( params, hit );
 	}
 	return result;
@@ -29870,14 +33600,9 @@ RaycastResult Raycast( const Triangle& tri, const RaycastParams& params, const T
 
 RaycastResult Raycast( const Sphere& sphere, const RaycastParams& params, RaycastResult result )
 {
-	ae::Vec3 p, n;
-	if( sphere.Raycast( params.source, params.ray, &p, &n, nullptr ) )
+	RaycastResult::Hit hit;
+	if( _GetRaycastHit( sphere, params, &hit ) )
 	{
-		RaycastResult::Hit hit;
-		hit.position = p;
-		hit.normal = n;
-		hit.distance = ( p - params.source ).Length();
-		hit.userData = params.userData;
 		result.Accumulate( params, hit );
 	}
 	return result;
@@ -29885,14 +33610,9 @@ RaycastResult Raycast( const Sphere& sphere, const RaycastParams& params, Raycas
 
 RaycastResult Raycast( const Plane& plane, const RaycastParams& params, RaycastResult result )
 {
-	ae::Vec3 p;
-	if( plane.Raycast( params.source, params.ray, &p, nullptr ) )
+	RaycastResult::Hit hit;
+	if( _GetRaycastHit( plane, params, &hit ) )
 	{
-		RaycastResult::Hit hit;
-		hit.position = p;
-		hit.normal = plane.GetNormal();
-		hit.distance = ( p - params.source ).Length();
-		hit.userData = params.userData;
 		result.Accumulate( params, hit );
 	}
 	return result;
@@ -29900,14 +33620,9 @@ RaycastResult Raycast( const Plane& plane, const RaycastParams& params, RaycastR
 
 RaycastResult Raycast( const AABB& aabb, const RaycastParams& params, RaycastResult result )
 {
-	ae::Vec3 p, n;
-	if( aabb.Raycast( params.source, params.ray, &p, &n, nullptr ) )
+	RaycastResult::Hit hit;
+	if( _GetRaycastHit( aabb, params, &hit ) )
 	{
-		RaycastResult::Hit hit;
-		hit.position = p;
-		hit.normal = n;
-		hit.distance = ( p - params.source ).Length();
-		hit.userData = params.userData;
 		result.Accumulate( params, hit );
 	}
 	return result;
@@ -29915,14 +33630,9 @@ RaycastResult Raycast( const AABB& aabb, const RaycastParams& params, RaycastRes
 
 RaycastResult Raycast( const OBB& obb, const RaycastParams& params, RaycastResult result )
 {
-	ae::Vec3 p, n;
-	if( obb.Raycast( params.source, params.ray, &p, &n, nullptr ) )
+	RaycastResult::Hit hit;
+	if( _GetRaycastHit( obb, params, &hit ) )
 	{
-		RaycastResult::Hit hit;
-		hit.position = p;
-		hit.normal = n;
-		hit.distance = ( p - params.source ).Length();
-		hit.userData = params.userData;
 		result.Accumulate( params, hit );
 	}
 	return result;
@@ -29953,6 +33663,450 @@ void PushOutInfo::Accumulate( const PushOutParams& params, const PushOutInfo& pr
 	}
 }
 
+//------------------------------------------------------------------------------
+// ae::Broadphase member functions
+//------------------------------------------------------------------------------
+Broadphase::Broadphase( const ae::Tag& tag, ae::BroadphaseType type, float cellSize ) :
+	m_type( type ),
+	m_cellSize( cellSize ),
+	m_proxies( tag ),
+	m_freeProxies( tag ),
+	m_removedProxies( tag ),
+	m_pairs( tag ),
+	m_prevPairs( tag ),
+	m_beginPairs( tag ),
+	m_endPairs( tag ),
+	m_endpoints{ tag, tag, tag },
+	m_newEndpoints( tag ),
+	m_mergedEndpoints( tag ),
+	m_active( tag ),
+	m_activeNew( tag ),
+	m_activeIndices( tag ),
+	m_cells( tag ),
+	m_cellEntries( tag ),
+	m_minCells( tag ),
+	m_overflowProxies( tag )
+{
+	AE_ASSERT_MSG( cellSize > 0.0f, "Invalid ae::Broadphase cell size: #", cellSize );
+}
+
+uint32_t Broadphase::Add( const ae::AABB& aabb, void* userData )
+{
+	uint32_t proxy;
+	if( m_freeProxies.Length() )
+	{
+		proxy = m_freeProxies[ m_freeProxies.Length() - 1 ];
+		m_freeProxies.Remove( m_freeProxies.Length() - 1 );
+	}
+	else
+	{
+		proxy = m_proxies.Length();
+		m_proxies.Append( {} );
+	}
+	Proxy& p = m_proxies[ proxy ];
+	p.aabb = aabb;
+	p.userData = userData;
+	p.active = true;
+	p.inEndpoints = false;
+	return proxy;
+}
+
+void Broadphase::Update( uint32_t proxy, const ae::AABB& aabb )
+{
+	AE_ASSERT_MSG( proxy < m_proxies.Length() && m_proxies[ proxy ].active, "Invalid ae::Broadphase proxy: #", proxy );
+	m_proxies[ proxy ].aabb = aabb;
+}
+
+void Broadphase::Remove( uint32_t proxy )
+{
+	AE_ASSERT_MSG( proxy < m_proxies.Length() && m_proxies[ proxy ].active, "Invalid ae::Broadphase proxy: #", proxy );
+	m_proxies[ proxy ].active = false;
+	m_proxies[ proxy ].userData = nullptr;
+	m_removedProxies.Append( proxy );
+}
+
+void Broadphase::Clear()
+{
+	m_proxies.Clear();
+	m_freeProxies.Clear();
+	m_removedProxies.Clear();
+	m_pairs.Clear();
+	m_prevPairs.Clear();
+	m_beginPairs.Clear();
+	m_endPairs.Clear();
+	for( ae::Array< Endpoint >& endpoints : m_endpoints )
+	{
+		endpoints.Clear();
+	}
+	m_newEndpoints.Clear();
+	m_mergedEndpoints.Clear();
+	m_active.Clear();
+	m_activeNew.Clear();
+	m_activeIndices.Clear();
+	m_cells.Clear();
+	m_cellEntries.Clear();
+	m_minCells.Clear();
+	m_overflowProxies.Clear();
+}
+
+ae::AABB Broadphase::GetAABB( uint32_t proxy ) const
+{
+	AE_ASSERT_MSG( proxy < m_proxies.Length() && m_proxies[ proxy ].active, "Invalid ae::Broadphase proxy: #", proxy );
+	return m_proxies[ proxy ].aabb;
+}
+
+void* Broadphase::GetUserData( uint32_t proxy ) const
+{
+	AE_ASSERT_MSG( proxy < m_proxies.Length() && m_proxies[ proxy ].active, "Invalid ae::Broadphase proxy: #", proxy );
+	return m_proxies[ proxy ].userData;
+}
+
+void Broadphase::UpdatePairs()
+{
+	m_beginPairs.Clear();
+	m_endPairs.Clear();
+	if( m_type == ae::BroadphaseType::SweepAndPrune )
+	{
+		m_UpdateSweepAndPrune();
+	}
+	else
+	{
+		std::swap( m_prevPairs, m_pairs );
+		m_pairs.Clear();
+		m_FindPairsSpatialHash();
+		std::sort( m_pairs.begin(), m_pairs.end(), []( const BroadphasePair& a, const BroadphasePair& b ) { return a.GetId() < b.GetId(); } );
+
+		// Both lists are sorted, so begin and end events are found with one merge
+		uint32_t i = 0;
+		uint32_t j = 0;
+		while( i < m_pairs.Length() || j < m_prevPairs.Length() )
+		{
+			if( j == m_prevPairs.Length() || ( i < m_pairs.Length() && m_pairs[ i ].GetId() < m_prevPairs[ j ].GetId() ) )
+			{
+				m_beginPairs.Append( m_pairs[ i++ ] );
+			}
+			else if( i == m_pairs.Length() || m_prevPairs[ j ].GetId() < m_pairs[ i ].GetId() )
+			{
+				m_endPairs.Append( m_prevPairs[ j++ ] );
+			}
+			else
+			{
+				i++;
+				j++;
+			}
+		}
+	}
+
+	// Removed ids can only be reused once their end events have been reported
+	for( uint32_t proxy : m_removedProxies )
+	{
+		m_freeProxies.Append( proxy );
+	}
+	m_removedProxies.Clear();
+}
+
+void Broadphase::m_AddPair( uint32_t p0, uint32_t p1 )
+{
+	m_pairs.Append( ( p0 < p1 ) ? BroadphasePair{ p0, p1 } : BroadphasePair{ p1, p0 } );
+}
+
+void Broadphase::m_UpdateSweepAndPrune()
+{
+	auto getId = []( const BroadphasePair& a, const BroadphasePair& b ) { return a.GetId() < b.GetId(); };
+	auto getPair = []( uint32_t p0, uint32_t p1 ) { return ( p0 < p1 ) ? BroadphasePair{ p0, p1 } : BroadphasePair{ p1, p0 }; };
+
+	// Remove the endpoints and pairs of removed proxies
+	if( m_removedProxies.Length() )
+	{
+		for( ae::Array< Endpoint >& endpoints : m_endpoints )
+		{
+			uint32_t count = 0;
+			for( uint32_t i = 0; i < endpoints.Length(); i++ )
+			{
+				if( m_proxies[ endpoints[ i ].proxy ].active )
+				{
+					endpoints[ count++ ] = endpoints[ i ];
+				}
+			}
+			while( endpoints.Length() > count )
+			{
+				endpoints.Remove( endpoints.Length() - 1 );
+			}
+		}
+		for( uint32_t proxy : m_removedProxies )
+		{
+			m_proxies[ proxy ].inEndpoints = false;
+		}
+		for( const BroadphasePair& pair : m_pairs )
+		{
+			if( !m_proxies[ pair.proxy0 ].active || !m_proxies[ pair.proxy1 ].active )
+			{
+				m_endPairs.Append( pair );
+			}
+		}
+	}
+
+	// Refresh endpoint values in place and re-sort each axis. Insertion sort
+	// is close to linear when proxies move coherently, and every pair of
+	// endpoints that changes order is swapped exactly once. A min moving past
+	// a max starts an overlap on that axis and a max moving past a min ends it.
+	for( uint32_t axis = 0; axis < 3; axis++ )
+	{
+		ae::Array< Endpoint >& endpoints = m_endpoints[ axis ];
+		for( Endpoint& e : endpoints )
+		{
+			const ae::AABB& aabb = m_proxies[ e.proxy ].aabb;
+			e.value = e.isMax ? aabb.GetMax()[ axis ] : aabb.GetMin()[ axis ];
+		}
+		for( uint32_t i = 1; i < endpoints.Length(); i++ )
+		{
+			const Endpoint e = endpoints[ i ];
+			uint32_t j = i;
+			for( ; j > 0 && e < endpoints[ j - 1 ]; j-- )
+			{
+				const Endpoint& other = endpoints[ j - 1 ];
+				if( e.isMax != other.isMax && e.proxy != other.proxy )
+				{
+					if( e.isMax )
+					{
+						m_endPairs.Append( getPair( e.proxy, other.proxy ) );
+					}
+					else if( m_proxies[ e.proxy ].aabb.Intersect( m_proxies[ other.proxy ].aabb ) )
+					{
+						m_beginPairs.Append( getPair( e.proxy, other.proxy ) );
+					}
+				}
+				endpoints[ j ] = other;
+			}
+			endpoints[ j ] = e;
+		}
+	}
+
+	// Merge the endpoints of new proxies into each axis, then find their pairs
+	// with a single sweep along x
+	bool hasNew = false;
+	for( uint32_t axis = 0; axis < 3; axis++ )
+	{
+		m_newEndpoints.Clear();
+		for( uint32_t i = 0; i < m_proxies.Length(); i++ )
+		{
+			const Proxy& proxy = m_proxies[ i ];
+			if( proxy.active && !proxy.inEndpoints )
+			{
+				m_newEndpoints.Append( { proxy.aabb.GetMin()[ axis ], i, false } );
+				m_newEndpoints.Append( { proxy.aabb.GetMax()[ axis ], i, true } );
+			}
+		}
+		if( !m_newEndpoints.Length() )
+		{
+			break;
+		}
+		hasNew = true;
+		std::sort( m_newEndpoints.begin(), m_newEndpoints.end() );
+		ae::Array< Endpoint >& endpoints = m_endpoints[ axis ];
+		m_mergedEndpoints.Clear();
+		m_mergedEndpoints.Reserve( endpoints.Length() + m_newEndpoints.Length() );
+		uint32_t j = 0;
+		for( const Endpoint& e : endpoints )
+		{
+			while( j < m_newEndpoints.Length() && m_newEndpoints[ j ] < e )
+			{
+				m_mergedEndpoints.Append( m_newEndpoints[ j++ ] );
+			}
+			m_mergedEndpoints.Append( e );
+		}
+		while( j < m_newEndpoints.Length() )
+		{
+			m_mergedEndpoints.Append( m_newEndpoints[ j++ ] );
+		}
+		std::swap( endpoints, m_mergedEndpoints );
+	}
+	if( hasNew )
+	{
+		m_active.Clear();
+		m_activeNew.Clear();
+		m_activeIndices.Clear();
+		m_activeIndices.Append( 0, m_proxies.Length() );
+		for( const Endpoint& e : m_endpoints[ 0 ] )
+		{
+			const bool isNew = !m_proxies[ e.proxy ].inEndpoints;
+			ae::Array< uint32_t >& active = isNew ? m_activeNew : m_active;
+			if( e.isMax )
+			{
+				const uint32_t idx = m_activeIndices[ e.proxy ];
+				const uint32_t last = active[ active.Length() - 1 ];
+				active[ idx ] = last;
+				m_activeIndices[ last ] = idx;
+				active.Remove( active.Length() - 1 );
+				continue;
+			}
+			const ae::AABB& aabb = m_proxies[ e.proxy ].aabb;
+			for( uint32_t other : m_activeNew )
+			{
+				if( aabb.Intersect( m_proxies[ other ].aabb ) )
+				{
+					m_beginPairs.Append( getPair( e.proxy, other ) );
+				}
+			}
+			if( isNew )
+			{
+				for( uint32_t other : m_active )
+				{
+					if( aabb.Intersect( m_proxies[ other ].aabb ) )
+					{
+						m_beginPairs.Append( getPair( e.proxy, other ) );
+					}
+				}
+			}
+			m_activeIndices[ e.proxy ] = active.Length();
+			active.Append( e.proxy );
+		}
+		for( Proxy& proxy : m_proxies )
+		{
+			proxy.inEndpoints |= proxy.active;
+		}
+	}
+
+	// A pair can begin or end on more than one axis in the same update, and
+	// a begin is only valid for pairs that weren't overlapping before
+	auto sortUnique = [&]( ae::Array< BroadphasePair >& pairs, bool wasOverlapping )
+	{
+		std::sort( pairs.begin(), pairs.end(), getId );
+		uint32_t count = 0;
+		for( uint32_t i = 0; i < pairs.Length(); i++ )
+		{
+			if( ( !count || !( pairs[ i ] == pairs[ count - 1 ] ) )
+				&& std::binary_search( m_pairs.begin(), m_pairs.end(), pairs[ i ], getId ) == wasOverlapping )
+			{
+				pairs[ count++ ] = pairs[ i ];
+			}
+		}
+		while( pairs.Length() > count )
+		{
+			pairs.Remove( pairs.Length() - 1 );
+		}
+	};
+	sortUnique( m_beginPairs, false );
+	sortUnique( m_endPairs, true );
+	if( !m_beginPairs.Length() && !m_endPairs.Length() )
+	{
+		return;
+	}
+
+	// Apply the (sorted) changes to the sorted pair list
+	std::swap( m_prevPairs, m_pairs );
+	m_pairs.Clear();
+	m_pairs.Reserve( m_prevPairs.Length() + m_beginPairs.Length() - m_endPairs.Length() );
+	uint32_t b = 0;
+	uint32_t e = 0;
+	for( const BroadphasePair& pair : m_prevPairs )
+	{
+		while( b < m_beginPairs.Length() && m_beginPairs[ b ].GetId() < pair.GetId() )
+		{
+			m_pairs.Append( m_beginPairs[ b++ ] );
+		}
+		if( e < m_endPairs.Length() && m_endPairs[ e ] == pair )
+		{
+			e++;
+			continue;
+		}
+		m_pairs.Append( pair );
+	}
+	while( b < m_beginPairs.Length() )
+	{
+		m_pairs.Append( m_beginPairs[ b++ ] );
+	}
+}
+
+void Broadphase::m_FindPairsSpatialHash()
+{
+	const int32_t kMaxProxyCells = 64;
+	const float kMaxCellCoord = 1e9f; // Keeps cell coordinates well within int32_t
+	m_cells.Clear();
+	m_cellEntries.Clear();
+	m_minCells.Clear();
+	m_minCells.Reserve( m_proxies.Length() );
+	m_overflowProxies.Clear();
+	const float invCellSize = 1.0f / m_cellSize;
+	for( uint32_t i = 0; i < m_proxies.Length(); i++ )
+	{
+		Proxy& proxy = m_proxies[ i ];
+		proxy.overflow = false;
+		const ae::Vec3 min = proxy.aabb.GetMin() * invCellSize;
+		const ae::Vec3 max = proxy.aabb.GetMax() * invCellSize;
+		// @NOTE: Written so that NaN fails the test too
+		const bool inRange = ( ae::Abs( min.x ) < kMaxCellCoord && ae::Abs( min.y ) < kMaxCellCoord && ae::Abs( min.z ) < kMaxCellCoord
+			&& ae::Abs( max.x ) < kMaxCellCoord && ae::Abs( max.y ) < kMaxCellCoord && ae::Abs( max.z ) < kMaxCellCoord );
+		const ae::Int3 minCell = inRange ? min.FloorCopy() : ae::Int3( 0 );
+		const ae::Int3 maxCell = inRange ? max.FloorCopy() : ae::Int3( 0 );
+		m_minCells.Append( minCell );
+		if( !proxy.active )
+		{
+			continue;
+		}
+		const ae::Int3 cellCount = maxCell - minCell + ae::Int3( 1 );
+		if( !inRange
+			|| cellCount.x > kMaxProxyCells || cellCount.y > kMaxProxyCells || cellCount.z > kMaxProxyCells
+			|| cellCount.x * cellCount.y * cellCount.z > kMaxProxyCells )
+		{
+			proxy.overflow = true;
+			m_overflowProxies.Append( i );
+			continue;
+		}
+		for( int32_t z = minCell.z; z <= maxCell.z; z++ )
+		for( int32_t y = minCell.y; y <= maxCell.y; y++ )
+		for( int32_t x = minCell.x; x <= maxCell.x; x++ )
+		{
+			const ae::Int3 cell( x, y, z );
+			int32_t* head = m_cells.TryGet( cell );
+			if( !head )
+			{
+				head = &m_cells.Set( cell, -1 );
+			}
+			m_cellEntries.Append( { i, *head } );
+			*head = (int32_t)m_cellEntries.Length() - 1;
+		}
+	}
+
+	for( uint32_t c = 0; c < m_cells.Length(); c++ )
+	{
+		const ae::Int3 cell = m_cells.GetKey( c );
+		for( int32_t e0 = m_cells.GetValue( c ); e0 >= 0; e0 = m_cellEntries[ e0 ].next )
+		{
+			const uint32_t p0 = m_cellEntries[ e0 ].proxy;
+			for( int32_t e1 = m_cellEntries[ e0 ].next; e1 >= 0; e1 = m_cellEntries[ e1 ].next )
+			{
+				const uint32_t p1 = m_cellEntries[ e1 ].proxy;
+				// Only report each pair from the first cell the two proxies share
+				const ae::Int3 minCell0 = m_minCells[ p0 ];
+				const ae::Int3 minCell1 = m_minCells[ p1 ];
+				if( ae::Max( minCell0.x, minCell1.x ) == cell.x
+					&& ae::Max( minCell0.y, minCell1.y ) == cell.y
+					&& ae::Max( minCell0.z, minCell1.z ) == cell.z
+					&& m_proxies[ p0 ].aabb.Intersect( m_proxies[ p1 ].aabb ) )
+				{
+					m_AddPair( p0, p1 );
+				}
+			}
+		}
+	}
+
+	// Oversized proxies aren't in any cells, so test them against everything
+	for( uint32_t p0 : m_overflowProxies )
+	{
+		const ae::AABB& aabb = m_proxies[ p0 ].aabb;
+		for( uint32_t p1 = 0; p1 < m_proxies.Length(); p1++ )
+		{
+			const Proxy& other = m_proxies[ p1 ];
+			// Pairs of oversized proxies are only tested once
+			if( other.active && p1 != p0 && !( other.overflow && p1 < p0 ) && aabb.Intersect( other.aabb ) )
+			{
+				m_AddPair( p0, p1 );
+			}
+		}
+	}
+}
+
 //------------------------------------------------------------------------------
 // ae::Keyframe member functions
 //------------------------------------------------------------------------------
@@ -30928,6 +35082,16 @@ bool OBJLoader::Load( ae::OBJLoader::InitializeParams params )
 		
 		currentFaceIdx += f;
 	}
+
+	if( params.optimize )
+	{
+		ae::OptimizeVertexCache( indices.Data(), indices.Length(), sizeof( Index ), vertices.Length() );
+		ae::Array< uint32_t > remap( allocTag, 0, vertices.Length() );
+		const uint32_t vertexCount = ae::GetVertexFetchRemap( indices.Data(), indices.Length(), sizeof( Index ), vertices.Length(), remap.Data() );
+		ae::RemapVertices( vertices.Data(), sizeof( Vertex ), vertices.Length(), remap.Data(), vertices.Data() );
+		ae::RemapIndices( indices.Data(), indices.Length(), sizeof( Index ), remap.Data() );
+		vertices.Remove( vertexCount, vertices.Length() - vertexCount );
+	}
 	
 	return true;
 }
@@ -32428,7 +36592,11 @@ IsosurfaceExtractor::IsosurfaceExtractor( ae::Tag tag ) :
 	vertices( tag ),
 	indices( tag ),
 	m_voxels( tag ),
-	m_brickMap( tag )
+	m_brickMap( tag ),
+	m_brickMeshes( tag ),
+	m_vertexVoxels( tag ),
+	m_vertexRefs( tag ),
+	m_freeVertices( tag )
 {
 	Reset();
 }
@@ -32452,22 +36620,64 @@ void IsosurfaceExtractor::Reset()
 	m_statusPrev = {};
 	m_voxels.Clear();
 	m_brickMap.Clear();
+	m_incrementalReady = false;
+	m_brickMeshes.Clear();
+	m_vertexVoxels.Clear();
+	m_vertexRefs.Clear();
+	m_freeVertices.Clear();
+	m_indexWaste = 0;
+}
+
+//! Samples the user SDF directly with IsosurfaceParams::sampleBatchFn when
+//! available, falling back to one IsosurfaceParams::sampleFn call per position
+static void _IsosurfaceSampleRaw( const IsosurfaceParams& params, IsosurfaceStatus* status, const ae::Vec3* pos, IsosurfaceValue* valuesOut, uint32_t count )
+{
+	status->sampleRawCount += count;
+	if( params.sampleBatchFn && ( count > 1 || !params.sampleFn ) )
+	{
+		status->sampleCallCount++;
+		params.sampleBatchFn( params.userData, pos, valuesOut, count );
+	}
+	else
+	{
+		status->sampleCallCount += count;
+		for( uint32_t i = 0; i < count; i++ )
+		{
+			valuesOut[ i ] = params.sampleFn( params.userData, pos[ i ] );
+		}
+	}
 }
 
 void IsosurfaceExtractor::Brick::Initialize( IsosurfaceExtractor::Index index, const IsosurfaceParams& params, IsosurfaceStatus* status )
 {
+	constexpr uint32_t sampleCount = kBrickMapSizePlus * kBrickMapSizePlus * kBrickMapSizePlus;
+	ae::Vec3 samplePos[ sampleCount ];
+	IsosurfaceValue sampleValues[ sampleCount ];
+	const ae::Int3 corner = ae::Int3( index ) * kBrickMapSize;
+	uint32_t sampleIdx = 0;
+	for( uint32_t x = 0; x < kBrickMapSizePlus; x++ )
+	{
+		for( uint32_t y = 0; y < kBrickMapSizePlus; y++ )
+		{
+			for( uint32_t z = 0; z < kBrickMapSizePlus; z++ )
+			{
+				samplePos[ sampleIdx++ ] = ae::Vec3( corner + ae::Int3( x, y, z ) );
+			}
+		}
+	}
+	_IsosurfaceSampleRaw( params, status, samplePos, sampleValues, sampleCount );
+
 	bool miss = true;
 	errorMargin = 0.0f;
-	const ae::Int3 corner = ae::Int3( index ) * kBrickMapSize;
-	for( ae::Int3 iter( 0 ); iter.x < kBrickMapSizePlus; iter.x++ )
+	sampleIdx = 0;
+	for( uint32_t x = 0; x < kBrickMapSizePlus; x++ )
 	{
-		for( iter.y = 0; iter.y < kBrickMapSizePlus; iter.y++ )
+		for( uint32_t y = 0; y < kBrickMapSizePlus; y++ )
 		{
-			for( iter.z = 0; iter.z < kBrickMapSizePlus; iter.z++ )
+			for( uint32_t z = 0; z < kBrickMapSizePlus; z++ )
 			{
-				const ae::Vec3 samplePos = ae::Vec3( corner + iter );
-				const IsosurfaceValue sample = params.sampleFn( params.userData, samplePos );
-				samples[ iter.x ][ iter.y ][ iter.z ] = sample.distance;
+				const IsosurfaceValue& sample = sampleValues[ sampleIdx++ ];
+				samples[ x ][ y ][ z ] = sample.distance;
 				errorMargin = ae::Max( errorMargin, sample.distanceErrorMargin );
 				if( std::signbit( samples[ 0 ][ 0 ][ 0 ] ) != std::signbit( sample.distance ) )
 				{
@@ -32476,12 +36686,10 @@ void IsosurfaceExtractor::Brick::Initialize( IsosurfaceExtractor::Index index, c
 			}
 		}
 	}
-	constexpr uint32_t samples = kBrickMapSizePlus * kBrickMapSizePlus * kBrickMapSizePlus;
-	status->sampleRawCount += samples;
-	status->sampleBrickCount += samples;
+	status->sampleBrickCount += sampleCount;
 	if( miss )
 	{
-		status->sampleBrickMissCount += samples;
+		status->sampleBrickMissCount += sampleCount;
 	}
 	if( params.brickMap )
 	{
@@ -32527,6 +36735,11 @@ IsosurfaceValue IsosurfaceExtractor::Brick::Sample( ae::Int3 p ) const
 bool IsosurfaceExtractor::m_GenerateVerts( ae::Int3 center, uint32_t halfSize )
 {
 	AE_DEBUG_ASSERT( halfSize % 2 == 0 || halfSize == 1 );
+	if( m_tasks && halfSize == m_taskHalfSize )
+	{
+		m_tasks->Append( { center, halfSize } );
+		return true;
+	}
 
 	AE_DEBUG_IF( m_params.debugPos.has_value() )
 	{
@@ -32739,16 +36952,23 @@ bool IsosurfaceExtractor::m_DoVoxel( int32_t x, int32_t y, int32_t z )
 			// Calculate gradient at edge intersection
 			if( m_params.dualContouring )
 			{
+				// Sample the center and both sides of each axis at once
 				const ae::Vec3 p( ae::Vec3( voxelPos ) + edgeOffset01 );
-				const ae::Vec3 pv( m_Sample( p ).distance );
+				ae::Vec3 normalPos[ 7 ] = { p, p, p, p, p, p, p };
+				IsosurfaceValue normalValues[ 7 ];
+				for( int32_t i = 0; i < 3; i++ )
+				{
+					normalPos[ 1 + i ][ i ] += m_params.normalSampleOffset;
+					normalPos[ 4 + i ][ i ] -= m_params.normalSampleOffset;
+				}
+				m_SampleBatch( normalPos, normalValues, 7 );
+				const ae::Vec3 pv( normalValues[ 0 ].distance );
 				AE_DEBUG_IF( m_params.errors && pv != pv ) { m_params.errors->Append( p ); }
 
 				ae::Vec3 normal0;
 				for( int32_t i = 0; i < 3; i++ )
 				{
-					ae::Vec3 nt = p;
-					nt[ i ] += m_params.normalSampleOffset;
-					normal0[ i ] = m_Sample( nt ).distance;
+					normal0[ i ] = normalValues[ 1 + i ].distance;
 				}
 				// This should be close to 0 because it's really close to the
 				// surface but not close enough to ignore.
@@ -32760,9 +36980,7 @@ bool IsosurfaceExtractor::m_DoVoxel( int32_t x, int32_t y, int32_t z )
 				ae::Vec3 normal1;
 				for( int32_t i = 0; i < 3; i++ )
 				{
-					ae::Vec3 nt = p;
-					nt[ i ] -= m_params.normalSampleOffset;
-					normal1[ i ] = m_Sample( nt ).distance;
+					normal1[ i ] = normalValues[ 4 + i ].distance;
 				}
 				// This should be close to 0 because it's really close to the
 				// surface but not close enough to ignore.
@@ -32884,8 +37102,8 @@ IsosurfaceValue IsosurfaceExtractor::m_DualSample( ae::Int3 pos, bool cache )
 	}
 	else
 	{
-		m_status.sampleRawCount++;
-		v = m_params.sampleFn( m_params.userData, ae::Vec3( pos ) );
+		const ae::Vec3 samplePos( pos );
+		_IsosurfaceSampleRaw( m_params, &m_status, &samplePos, &v, 1 );
 		if( cache )
 		{
 			Brick* newBrick = &m_brickMap.Set( brickIndex, {} );
@@ -32905,39 +37123,77 @@ IsosurfaceValue IsosurfaceExtractor::m_DualSample( ae::Int3 pos, bool cache )
 IsosurfaceValue IsosurfaceExtractor::m_Sample( ae::Vec3 pos )
 {
 	IsosurfaceValue v;
-	const auto[ brickIndex, localIndex ] = Brick::MakeIndex( pos );
-	const Brick* brick = [&, &i = brickIndex]()
+	m_SampleBatch( &pos, &v, 1 );
+	return v;
+}
+
+void IsosurfaceExtractor::m_SampleBatch( const ae::Vec3* pos, IsosurfaceValue* valuesOut, uint32_t count )
+{
+	// Positions that can't be answered by the brick cache are gathered so
+	// that they can be sampled with a single call
+	constexpr uint32_t kMaxRaw = 8;
+	ae::Vec3 rawPos[ kMaxRaw ];
+	IsosurfaceValue rawValues[ kMaxRaw ];
+	uint32_t rawIdx[ kMaxRaw ];
+	uint32_t rawCount = 0;
+	for( uint32_t i = 0; i < count; i++ )
 	{
-		Brick* b = m_brickMap.TryGet( i );
-		if( !b )
+		const auto[ brickIndex, localIndex ] = Brick::MakeIndex( pos[ i ] );
+		const Brick* brick = [&, &bi = brickIndex]()
+		{
+			Brick* b = m_brickMap.TryGet( bi );
+			if( !b )
+			{
+				b = &m_brickMap.Set( bi, {} );
+				b->Initialize( bi, m_params, &m_status );
+			}
+			return b;
+		}();
+		if( brick->errorMargin > 1.0f )
 		{
-			b = &m_brickMap.Set( i, {} );
-			b->Initialize( i, m_params, &m_status );
+			m_status.sampleCacheCount++;
+			valuesOut[ i ] = brick->Sample( localIndex );
 		}
-		return b;
-	}();
-	if( brick->errorMargin > 1.0f )
+		else
+		{
+			if( rawCount == kMaxRaw )
+			{
+				_IsosurfaceSampleRaw( m_params, &m_status, rawPos, rawValues, rawCount );
+				for( uint32_t j = 0; j < rawCount; j++ ) { valuesOut[ rawIdx[ j ] ] = rawValues[ j ]; }
+				rawCount = 0;
+			}
+			rawPos[ rawCount ] = pos[ i ];
+			rawIdx[ rawCount ] = i;
+			rawCount++;
+		}
+	}
+	if( rawCount )
 	{
-		m_status.sampleCacheCount++;
-		v = brick->Sample( localIndex );
+		_IsosurfaceSampleRaw( m_params, &m_status, rawPos, rawValues, rawCount );
+		for( uint32_t j = 0; j < rawCount; j++ ) { valuesOut[ rawIdx[ j ] ] = rawValues[ j ]; }
 	}
-	else
+	for( uint32_t i = 0; i < count; i++ )
 	{
-		m_status.sampleRawCount++;
-		v = m_params.sampleFn( m_params.userData, pos );
+		// This nudge is needed to prevent the SDF from ever being exactly on
+		// the voxel grid boundaries (imagine a plane at the origin with a
+		// normal facing along a cardinal axis, do the vertices belong to the
+		// voxels on the front or back of the plane?). Without this nudge, any
+		// vertices exactly on the grid boundary would be skipped resulting in
+		// holes in the mesh.
+		if( valuesOut[ i ].distance == 0.0f ) { valuesOut[ i ].distance += 0.0001f; }
 	}
-	// This nudge is needed to prevent the SDF from ever being exactly on
-	// the voxel grid boundaries (imagine a plane at the origin with a
-	// normal facing along a cardinal axis, do the vertices belong to the
-	// voxels on the front or back of the plane?). Without this nudge, any
-	// vertices exactly on the grid boundary would be skipped resulting in
-	// holes in the mesh.
-	if( v.distance == 0.0f ) { v.distance += 0.0001f; }
-	return v;
 }
 
 bool IsosurfaceExtractor::m_UpdateStatus()
 {
+	if( m_threadProgress )
+	{
+		// Worker threads only share their progress, m_GenerateParallel()
+		// calls statusFn from the main thread
+		m_threadProgress->store( m_status.voxelSearchProgress, std::memory_order_relaxed );
+		m_cancel = m_cancel || m_threadCancel->load( std::memory_order_relaxed );
+		return !m_cancel;
+	}
 	if( m_params.statusFn )
 	{
 		m_status.voxelProgress01 = ( m_status.voxelSearchProgress / (float)m_status.voxelAABBSize );
@@ -32962,8 +37218,889 @@ bool IsosurfaceExtractor::m_UpdateStatus()
 	return !m_cancel;
 }
 
+void IsosurfaceExtractor::m_GenerateVertex( IsosurfaceVertex* vertex, const ae::Map< Index, Voxel >& voxels )
+{
+	const ae::Int3 sdfMin = m_params.aabb.GetMin().FloorCopy();
+	const ae::Int3 sdfMax = m_params.aabb.GetMax().CeilCopy();
+	const int32_t x = ae::Floor( vertex->position.x );
+	const int32_t y = ae::Floor( vertex->position.y );
+	const int32_t z = ae::Floor( vertex->position.z );
+	if( x < sdfMin.x && y < sdfMin.y && z < sdfMin.z ){ return; }
+	if( x > sdfMax.x && y > sdfMax.y && z > sdfMax.z ){ return; }
+
+	int32_t ec = 0;
+	ae::Vec3 p[ 12 ];
+	ae::Vec3 n[ 12 ];
+	Voxel te = voxels.Get( { x + 1, y + 1, z + 1 }, {} );
+	if( te.edgeBits & EDGE_TOP_FRONT_BIT )
+	{
+		p[ ec ] = te.edgePos[ 0 ];
+		n[ ec ] = te.edgeNormal[ 0 ];
+		ec++;
+	}
+	if( te.edgeBits & EDGE_TOP_RIGHT_BIT )
+	{
+		p[ ec ] = te.edgePos[ 1 ];
+		n[ ec ] = te.edgeNormal[ 1 ];
+		ec++;
+	}
+	if( te.edgeBits & EDGE_SIDE_FRONTRIGHT_BIT )
+	{
+		p[ ec ] = te.edgePos[ 2 ];
+		n[ ec ] = te.edgeNormal[ 2 ];
+		ec++;
+	}
+	te = voxels.Get( { x, y + 1, z + 1 }, {} );
+	if( te.edgeBits & EDGE_TOP_RIGHT_BIT )
+	{
+		p[ ec ] = te.edgePos[ 1 ];
+		p[ ec ].x -= 1.0f;
+		n[ ec ] = te.edgeNormal[ 1 ];
+		ec++;
+	}
+	if( te.edgeBits & EDGE_SIDE_FRONTRIGHT_BIT )
+	{
+		p[ ec ] = te.edgePos[ 2 ];
+		p[ ec ].x -= 1.0f;
+		n[ ec ] = te.edgeNormal[ 2 ];
+		ec++;
+	}
+	te = voxels.Get( { x + 1, y, z + 1 }, {} );
+	if( te.edgeBits & EDGE_TOP_FRONT_BIT )
+	{
+		p[ ec ] = te.edgePos[ 0 ];
+		p[ ec ].y -= 1.0f;
+		n[ ec ] = te.edgeNormal[ 0 ];
+		ec++;
+	}
+	if( te.edgeBits & EDGE_SIDE_FRONTRIGHT_BIT )
+	{
+		p[ ec ] = te.edgePos[ 2 ];
+		p[ ec ].y -= 1.0f;
+		n[ ec ] = te.edgeNormal[ 2 ];
+		ec++;
+	}
+	te = voxels.Get( { x, y, z + 1 }, {} );
+	if( te.edgeBits & EDGE_SIDE_FRONTRIGHT_BIT )
+	{
+		p[ ec ] = te.edgePos[ 2 ];
+		p[ ec ].x -= 1.0f;
+		p[ ec ].y -= 1.0f;
+		n[ ec ] = te.edgeNormal[ 2 ];
+		ec++;
+	}
+	te = voxels.Get( { x, y + 1, z }, {} );
+	if( te.edgeBits & EDGE_TOP_RIGHT_BIT )
+	{
+		p[ ec ] = te.edgePos[ 1 ];
+		p[ ec ].x -= 1.0f;
+		p[ ec ].z -= 1.0f;
+		n[ ec ] = te.edgeNormal[ 1 ];
+		ec++;
+	}
+	te = voxels.Get( { x + 1, y, z }, {} );
+	if( te.edgeBits & EDGE_TOP_FRONT_BIT )
+	{
+		p[ ec ] = te.edgePos[ 0 ];
+		p[ ec ].y -= 1.0f;
+		p[ ec ].z -= 1.0f;
+		n[ ec ] = te.edgeNormal[ 0 ];
+		ec++;
+	}
+	te = voxels.Get( { x + 1, y + 1, z }, {} );
+	if( te.edgeBits & EDGE_TOP_FRONT_BIT )
+	{
+		p[ ec ] = te.edgePos[ 0 ];
+		p[ ec ].z -= 1.0f;
+		n[ ec ] = te.edgeNormal[ 0 ];
+		ec++;
+	}
+	if( te.edgeBits & EDGE_TOP_RIGHT_BIT )
+	{
+		p[ ec ] = te.edgePos[ 1 ];
+		p[ ec ].z -= 1.0f;
+		n[ ec ] = te.edgeNormal[ 1 ];
+		ec++;
+	}
+
+	// Validation
+	AE_DEBUG_ASSERT( ec != 0 );
+	for( int32_t j = 0; j < ec; j++ )
+	{
+		AE_DEBUG_ASSERT( p[ j ] == p[ j ] );
+		AE_DEBUG_ASSERT( p[ j ].x >= 0.0f && p[ j ].x <= 1.0f );
+		AE_DEBUG_ASSERT( p[ j ].y >= 0.0f && p[ j ].y <= 1.0f );
+		AE_DEBUG_ASSERT( p[ j ].z >= 0.0f && p[ j ].z <= 1.0f );
+		AE_DEBUG_ASSERT( n[ j ] == n[ j ] );
+	}
+
+	ae::Vec3 position;
+	if( m_params.dualContouring )
+	{
+		// Get intersection of edge planes for vertex positioning
+		{
+#if defined(__SSE3__)
+			__m128 c128 = _mm_setzero_ps();
+			for( uint32_t i = 0; i < ec; i++ )
+			{
+				__m128 p128 = _mm_load_ps( (float*)( p + i ) );
+				c128 = _mm_add_ps( c128, p128 );
+			}
+			__m128 div = _mm_set1_ps( 1.0f / ec );
+			c128 = _mm_mul_ps( c128, div );
+
+			for( uint32_t i = 0; i < 10; i++ )
+			{
+				for( uint32_t j = 0; j < ec; j++ )
+				{
+					__m128 p128 = _mm_load_ps( (float*)( p + j ) );
+					p128 = _mm_sub_ps( p128, c128 );
+					__m128 n128 = _mm_load_ps( (float*)( n + j ) );
+
+					__m128 d = _mm_mul_ps( p128, n128 );
+					d = _mm_hadd_ps( d, d );
+					d = _mm_hadd_ps( d, d );
+
+					__m128 s = _mm_set1_ps( 0.5f );
+					s = _mm_mul_ps( s, n128 );
+					s = _mm_mul_ps( s, d );
+					c128 = _mm_add_ps( c128, s );
+				}
+			}
+			_mm_store_ps( (float*)&position, c128 );
+#elif defined(__ARM_NEON__) || defined(__ARM_NEON)
+			float32x4_t c128 = vdupq_n_f32( 0.0f );
+			for( uint32_t i = 0; i < ec; i++ )
+			{
+				const float32x4_t p128 = vld1q_f32( (float*)( p + i ) );
+				c128 = vaddq_f32( c128, p128 );
+			}
+			float32x4_t div = vdupq_n_f32( 1.0f / ec );
+			c128 = vmulq_f32( c128, div );
+
+			for( uint32_t i = 0; i < 10; i++ )
+			{
+				for( uint32_t j = 0; j < ec; j++ )
+				{
+					float32x4_t p128 = vld1q_f32( (float*)( p + j ) );
+					p128 = vsubq_f32( p128, c128 );
+					const float32x4_t n128 = vld1q_f32( (float*)( n + j ) );
+
+					// Dot product (p128 . n128)
+					const float32x4_t d = vmulq_f32( p128, n128 );
+					const float32x2_t d_low = vget_low_f32( d );
+					const float32x2_t d_high = vget_high_f32( d );
+					const float32x2_t sum = vpadd_f32( d_low, d_high );
+					const float32_t dot = vget_lane_f32( sum, 0 ) + vget_lane_f32( sum, 1 );
+
+					const float32x4_t s = vmulq_n_f32( n128, 0.5f * dot );
+					c128 = vaddq_f32( c128, s );
+				}
+			}
+			vst1q_f32( (float*)&position, c128 );
+#else
+			position = ae::Vec3( 0.0f );
+			for( uint32_t i = 0; i < ec; i++ )
+			{
+				position += p[ i ];
+			}
+			position /= ec;
+			for( uint32_t i = 0; i < 10; i++ )
+			{
+				for( uint32_t j = 0; j < ec; j++ )
+				{
+					float d = n[ j ].Dot( p[ j ] - position );
+					position += n[ j ] * ( d * 0.5f );
+				}
+			}
+#endif
+			AE_DEBUG_ASSERT( position.x == position.x && position.y == position.y && position.z == position.z );
+			// @NOTE: Bias towards average of intersection points. This solves some intersecting triangles on sharp edges.
+			// Based on notes here: https://www.boristhebrave.com/2018/04/15/dual-contouring-tutorial/
+			ae::Vec3 averagePos( 0.0f );
+			for( int32_t i = 0; i < ec; i++ )
+			{
+				averagePos += p[ i ];
+			}
+			averagePos /= (float)ec;
+			position = ae::Lerp( position, averagePos, 0.1f ); // @TODO: This bias should be removed or be adjustable
+		}
+
+		// Use the average edge normals for the vertex normal
+		vertex->normal = ae::Vec3( 0.0f );
+		for( int32_t j = 0; j < ec; j++ )
+		{
+			vertex->normal += n[ j ];
+		}
+		vertex->normal.SafeNormalize();
+	}
+	else
+	{
+		position = ae::Vec3( 0.0f );
+		for( int32_t i = 0; i < ec; i++ )
+		{
+			position += p[ i ];
+		}
+		position /= (float)ec;
+
+		// Calculate the normal from the 8 dual corner samples
+		const float cornerSamples[ 8 ] =
+		{
+			m_DualSample( ae::Int3( x, y, z ) ).distance, // 0, left, back, bottom
+			m_DualSample( ae::Int3( x + 1, y, z ) ).distance, // 1, right, back, bottom
+			m_DualSample( ae::Int3( x, y + 1, z ) ).distance, // 2, left, front, bottom
+			m_DualSample( ae::Int3( x + 1, y + 1, z ) ).distance, // 3, right, front, bottom
+			m_DualSample( ae::Int3( x, y, z + 1 ) ).distance, // 4, left, back, top
+			m_DualSample( ae::Int3( x + 1, y, z + 1 ) ).distance, // 5, right, back, top
+			m_DualSample( ae::Int3( x, y + 1, z + 1 ) ).distance, // 6, left, front, top
+			m_DualSample( ae::Int3( x + 1, y + 1, z + 1 ) ).distance // 7, right, front, top
+		};
+		vertex->normal = ae::Vec3( 0.0f );
+		vertex->normal.x += ( cornerSamples[ 1 ] - cornerSamples[ 0 ] ); // back, bottom
+		vertex->normal.x += ( cornerSamples[ 3 ] - cornerSamples[ 2 ] ); // front, bottom
+		vertex->normal.x += ( cornerSamples[ 5 ] - cornerSamples[ 4 ] ); // back, top
+		vertex->normal.x += ( cornerSamples[ 7 ] - cornerSamples[ 6 ] ); // front, top
+		vertex->normal.y += ( cornerSamples[ 2 ] - cornerSamples[ 0 ] ); // left, bottom
+		vertex->normal.y += ( cornerSamples[ 3 ] - cornerSamples[ 1 ] ); // right, bottom
+		vertex->normal.y += ( cornerSamples[ 6 ] - cornerSamples[ 4 ] ); // left, top
+		vertex->normal.y += ( cornerSamples[ 7 ] - cornerSamples[ 5 ] ); // right, top
+		vertex->normal.z += ( cornerSamples[ 4 ] - cornerSamples[ 0 ] ); // left, back
+		vertex->normal.z += ( cornerSamples[ 5 ] - cornerSamples[ 1 ] ); // right, back
+		vertex->normal.z += ( cornerSamples[ 6 ] - cornerSamples[ 2 ] ); // left, front
+		vertex->normal.z += ( cornerSamples[ 7 ] - cornerSamples[ 3 ] ); // right, front
+		vertex->normal.SafeNormalize();
+	}
+	// @NOTE: Do not clamp position values to voxel boundary. It's valid for a vertex to be placed
+	// outside of the voxel is was generated from. This happens when a voxel has all corners inside
+	// or outside of the sdf boundary, while also still having intersections (normally two per edge)
+	// on one or more edges of the voxel.
+	position.x = x + position.x;
+	position.y = y + position.y;
+	position.z = z + position.z;
+	vertex->position = ae::Vec4( position, 1.0f );
+}
+
+//! Per thread state for IsosurfaceExtractor::m_GenerateParallel()
+struct _IsosurfaceThread
+{
+	_IsosurfaceThread( ae::Tag tag ) : extractor( tag ), octree( tag ), errors( tag ) {}
+	ae::IsosurfaceExtractor extractor;
+	ae::Array< ae::AABB > octree;
+	ae::Array< ae::Vec3 > errors;
+	std::thread thread;
+	std::atomic< uint64_t > progress = { 0 };
+	uint32_t index = 0;
+	double time = 0.0;
+	bool success = true;
+};
+
+bool IsosurfaceExtractor::m_GenerateParallel( ae::Int3 center, uint32_t halfSize, uint32_t threadCount )
+{
+	const ae::Tag tag = vertices.Tag();
+	// Split the octree into enough nodes to balance the work between threads.
+	// The octree is traversed in Morton order, so voxels only ever reference
+	// vertices of voxels from the same or earlier nodes, which lets each
+	// thread keep its own voxel map while processing nodes in order.
+	uint32_t taskHalfSize = halfSize;
+	while( taskHalfSize > kBrickMapSize && ( halfSize / taskHalfSize ) * ( halfSize / taskHalfSize ) * ( halfSize / taskHalfSize ) < threadCount * 16 )
+	{
+		taskHalfSize /= 2;
+	}
+	ae::Array< Task > tasks = tag;
+	m_tasks = &tasks;
+	m_taskHalfSize = taskHalfSize;
+	const bool collected = m_GenerateVerts( center, halfSize );
+	m_tasks = nullptr;
+	if( !collected )
+	{
+		return false;
+	}
+	const IsosurfaceStatus baseStatus = m_status;
+	m_status.threadCount = threadCount;
+
+	std::atomic< bool > cancel = { false };
+	_IsosurfaceThread* threads[ IsosurfaceStatus::kMaxThreads ];
+	for( uint32_t i = 0; i < threadCount; i++ )
+	{
+		_IsosurfaceThread* thread = ae::New< _IsosurfaceThread >( tag, tag );
+		IsosurfaceExtractor* extractor = &thread->extractor;
+		extractor->m_params = m_params;
+		extractor->m_params.statusFn = nullptr;
+		extractor->m_params.octree = m_params.octree ? &thread->octree : nullptr;
+		extractor->m_params.brickMap = nullptr; // Merged below, threads may sample the same bricks
+		extractor->m_params.errors = m_params.errors ? &thread->errors : nullptr;
+		extractor->m_minInclusive = m_minInclusive;
+		extractor->m_maxInclusive = m_maxInclusive;
+		extractor->m_threadProgress = &thread->progress;
+		extractor->m_threadCancel = &cancel;
+		thread->index = i;
+		threads[ i ] = thread;
+	}
+	// Runs fn( thread ) on each thread, calling statusFn with progressFn( sum of
+	// thread progress ) from this thread while waiting
+	auto runThreads = [&]( auto fn, auto progressFn ) -> bool
+	{
+		std::atomic< uint32_t > runningCount = { threadCount };
+		for( uint32_t i = 0; i < threadCount; i++ )
+		{
+			threads[ i ]->progress = 0;
+			threads[ i ]->thread = std::thread( [ &fn, &runningCount, thread = threads[ i ] ]()
+			{
+				const double start = ae::GetTime();
+				fn( thread );
+				thread->time += ae::GetTime() - start;
+				runningCount--;
+			} );
+		}
+		while( m_params.statusFn && runningCount )
+		{
+			uint64_t progress = 0;
+			for( uint32_t i = 0; i < threadCount; i++ )
+			{
+				progress += threads[ i ]->progress.load( std::memory_order_relaxed );
+			}
+			progressFn( progress );
+			if( !m_UpdateStatus() )
+			{
+				cancel = true;
+			}
+			std::this_thread::sleep_for( std::chrono::milliseconds( 1 ) );
+		}
+		bool success = !cancel;
+		for( uint32_t i = 0; i < threadCount; i++ )
+		{
+			threads[ i ]->thread.join();
+			m_status.threadTime[ i ] = threads[ i ]->time;
+			success = success && threads[ i ]->success;
+		}
+		return success;
+	};
+	auto sumStatus = [&]()
+	{
+		uint64_t IsosurfaceStatus::* const counts[] =
+		{
+			&IsosurfaceStatus::sampleRawCount,
+			&IsosurfaceStatus::sampleCallCount,
+			&IsosurfaceStatus::sampleCacheCount,
+			&IsosurfaceStatus::sampleBrickMissCount,
+			&IsosurfaceStatus::sampleBrickCount,
+			&IsosurfaceStatus::voxelCheckCount,
+			&IsosurfaceStatus::voxelMissCount,
+			&IsosurfaceStatus::voxelSearchProgress
+		};
+		for( auto count : counts )
+		{
+			m_status.*count = baseStatus.*count;
+			for( uint32_t i = 0; i < threadCount; i++ )
+			{
+				m_status.*count += threads[ i ]->extractor.m_status.*count;
+			}
+		}
+	};
+
+	// Find surface voxels, with each thread taking the next node in order
+	std::atomic< uint32_t > nextTask = { 0 };
+	bool success = runThreads( [&]( _IsosurfaceThread* thread )
+	{
+		IsosurfaceExtractor* extractor = &thread->extractor;
+		for( uint32_t i = nextTask++; i < tasks.Length(); i = nextTask++ )
+		{
+			Task& task = tasks[ i ];
+			task.thread = thread->index;
+			task.indexBegin = extractor->indices.Length();
+			if( !extractor->m_GenerateVerts( task.center, task.halfSize ) )
+			{
+				thread->success = false;
+				cancel = true;
+				return;
+			}
+			task.indexEnd = extractor->indices.Length();
+		}
+	}, [&]( uint64_t progress )
+	{
+		m_status.voxelSearchProgress = baseStatus.voxelSearchProgress + progress;
+	} );
+	sumStatus();
+
+	if( success )
+	{
+		// Merge voxel edges, which are each generated by exactly one thread
+		for( uint32_t i = 0; i < threadCount; i++ )
+		{
+			const ae::Map< Index, Voxel >& voxels = threads[ i ]->extractor.m_voxels;
+			for( uint32_t j = 0; j < voxels.Length(); j++ )
+			{
+				if( voxels.GetValue( j ).edgeBits )
+				{
+					Voxel voxel = voxels.GetValue( j );
+					voxel.index = kInvalidIsosurfaceIndex;
+					m_voxels.Set( voxels.GetKey( j ), voxel );
+				}
+			}
+		}
+		// Merge triangles in node order. Threads create their own copies of
+		// vertices shared with other nodes, which are combined here by voxel.
+		for( const Task& task : tasks )
+		{
+			const IsosurfaceExtractor& extractor = threads[ task.thread ]->extractor;
+			for( uint32_t i = task.indexBegin; i < task.indexEnd; i++ )
+			{
+				const IsosurfaceVertex& vertex = extractor.vertices[ extractor.indices[ i ] ];
+				const Index key( ae::Floor( vertex.position.x ), ae::Floor( vertex.position.y ), ae::Floor( vertex.position.z ) );
+				Voxel* voxel = m_voxels.TryGet( key );
+				voxel = voxel ? voxel : &m_voxels.Set( key, {} );
+				if( voxel->index == kInvalidIsosurfaceIndex )
+				{
+					voxel->index = (IsosurfaceIndex)vertices.Length();
+					vertices.Append( vertex );
+				}
+				indices.Append( voxel->index );
+			}
+		}
+		for( uint32_t i = 0; i < threadCount; i++ )
+		{
+			if( m_params.octree ) { m_params.octree->AppendArray( threads[ i ]->octree.Data(), threads[ i ]->octree.Length() ); }
+			if( m_params.errors ) { m_params.errors->AppendArray( threads[ i ]->errors.Data(), threads[ i ]->errors.Length() ); }
+		}
+		m_status.vertexCount = vertices.Length();
+		m_status.indexCount = indices.Length();
+		m_status.voxelWorkingSize = m_voxels.Length();
+		success = ( indices.Length() && vertices.Length() <= m_params.maxVerts && indices.Length() <= m_params.maxIndices && m_UpdateStatus() );
+	}
+
+	if( success )
+	{
+		// Position vertices, with each thread taking the next batch
+		m_startMeshTime = ae::GetTime();
+		const uint32_t batchSize = 256;
+		std::atomic< uint32_t > nextVertex = { 0 };
+		success = runThreads( [&]( _IsosurfaceThread* thread )
+		{
+			for( uint32_t begin = nextVertex.fetch_add( batchSize ); begin < vertices.Length() && !cancel; begin = nextVertex.fetch_add( batchSize ) )
+			{
+				const uint32_t end = ae::Min( begin + batchSize, vertices.Length() );
+				for( uint32_t i = begin; i < end; i++ )
+				{
+					thread->extractor.m_GenerateVertex( &vertices[ i ], m_voxels );
+				}
+				thread->progress.fetch_add( end - begin, std::memory_order_relaxed );
+			}
+		}, [&]( uint64_t progress )
+		{
+			m_status.meshProgress01 = progress / (float)vertices.Length();
+		} );
+		sumStatus();
+	}
+
+	if( m_params.brickMap )
+	{
+		ae::Map< Index, bool > bricks = tag;
+		for( uint32_t i = 0; i < threadCount; i++ )
+		{
+			const ae::Map< Index, Brick >& brickMap = threads[ i ]->extractor.m_brickMap;
+			for( uint32_t j = 0; j < brickMap.Length(); j++ )
+			{
+				const Index index = brickMap.GetKey( j );
+				if( !bricks.TryGet( index ) )
+				{
+					bricks.Set( index, true );
+					const ae::Int3 corner = ae::Int3( index ) * kBrickMapSize;
+					m_params.brickMap->Append( ae::AABB( ae::Vec3( corner ), ae::Vec3( corner + ae::Int3( kBrickMapSize ) ) ) );
+				}
+			}
+		}
+	}
+	for( uint32_t i = 0; i < threadCount; i++ )
+	{
+		ae::Delete( threads[ i ] );
+	}
+	if( !success )
+	{
+		return false;
+	}
+	m_status.meshProgress01 = 1.0f;
+	return m_UpdateStatus();
+}
+
+//! Samples IsosurfaceExtractor::m_GenerateLod() regions with larger voxels
+struct _IsosurfaceLodSampler
+{
+	static IsosurfaceValue Sample( const void* userData, ae::Vec3 p )
+	{
+		const _IsosurfaceLodSampler* sampler = (const _IsosurfaceLodSampler*)userData;
+		const IsosurfaceParams* params = sampler->params;
+		p *= sampler->voxelSize;
+		IsosurfaceValue value;
+		if( params->sampleFn )
+		{
+			value = params->sampleFn( params->userData, p );
+		}
+		else
+		{
+			params->sampleBatchFn( params->userData, &p, &value, 1 );
+		}
+		return sampler->Scale( value );
+	}
+	static void SampleBatch( const void* userData, const ae::Vec3* p, IsosurfaceValue* valuesOut, uint32_t count )
+	{
+		const _IsosurfaceLodSampler* sampler = (const _IsosurfaceLodSampler*)userData;
+		ae::Vec3 scaled[ 64 ];
+		for( uint32_t begin = 0; begin < count; begin += countof( scaled ) )
+		{
+			const uint32_t batchCount = ae::Min( count - begin, countof( scaled ) );
+			for( uint32_t i = 0; i < batchCount; i++ )
+			{
+				scaled[ i ] = p[ begin + i ] * sampler->voxelSize;
+			}
+			sampler->params->sampleBatchFn( sampler->params->userData, scaled, valuesOut + begin, batchCount );
+			for( uint32_t i = 0; i < batchCount; i++ )
+			{
+				valuesOut[ begin + i ] = sampler->Scale( valuesOut[ begin + i ] );
+			}
+		}
+	}
+	IsosurfaceValue Scale( IsosurfaceValue v ) const
+	{
+		return { v.distance / voxelSize, v.distanceErrorMargin / voxelSize };
+	}
+	const IsosurfaceParams* params;
+	float voxelSize;
+};
+
+bool IsosurfaceExtractor::m_GenerateLod()
+{
+	const ae::Tag tag = vertices.Tag();
+	const int32_t regionSize = m_params.lodRegionSize;
+	AE_ASSERT_MSG( regionSize > 0 && ( regionSize & ( regionSize - 1 ) ) == 0, "IsosurfaceParams::lodRegionSize must be a power of two" );
+	uint32_t maxLevel = 0;
+	while( ( 1 << ( maxLevel + 1 ) ) <= regionSize ) { maxLevel++; }
+	const ae::Int3 regionBegin(
+		ae::Floor( m_minInclusive.x, regionSize ),
+		ae::Floor( m_minInclusive.y, regionSize ),
+		ae::Floor( m_minInclusive.z, regionSize ) );
+	// The last voxel of each axis is only needed for its edges, see m_DoVoxel()
+	const ae::Int3 regionCount = ae::Int3(
+		ae::Floor( ae::Max( m_maxInclusive.x - 1, m_minInclusive.x ), regionSize ),
+		ae::Floor( ae::Max( m_maxInclusive.y - 1, m_minInclusive.y ), regionSize ),
+		ae::Floor( ae::Max( m_maxInclusive.z - 1, m_minInclusive.z ), regionSize ) ) - regionBegin + ae::Int3( 1 );
+
+	// Choose the level of each region
+	ae::Array< uint8_t > levels( tag, 0, regionCount.x * regionCount.y * regionCount.z );
+	auto getRegionIdx = [&]( ae::Int3 r ) -> int32_t
+	{
+		if( r.x < 0 || r.y < 0 || r.z < 0 || r.x >= regionCount.x || r.y >= regionCount.y || r.z >= regionCount.z )
+		{
+			return -1;
+		}
+		return r.x + regionCount.x * ( r.y + regionCount.y * r.z );
+	};
+	auto getRegionAABB = [&]( ae::Int3 r )
+	{
+		const ae::Int3 min = ( regionBegin + r ) * regionSize;
+		return ae::AABB( ae::Vec3( min ), ae::Vec3( min + ae::Int3( regionSize ) ) );
+	};
+	for( int32_t z = 0; z < regionCount.z; z++ )
+	for( int32_t y = 0; y < regionCount.y; y++ )
+	for( int32_t x = 0; x < regionCount.x; x++ )
+	{
+		const ae::AABB aabb = getRegionAABB( { x, y, z } );
+		uint32_t level = 0;
+		if( m_params.lodFn )
+		{
+			level = m_params.lodFn( m_params.userData, aabb );
+		}
+		else
+		{
+			bool inside = false;
+			const ae::Vec3 closest = aabb.GetClosestPointOnSurface( m_params.lodFocus.value(), &inside );
+			const float distance = inside ? 0.0f : ( closest - m_params.lodFocus.value() ).Length();
+			for( float d = m_params.lodDistance; distance >= d && level < maxLevel; d *= 2.0f ) { level++; }
+		}
+		levels[ getRegionIdx( { x, y, z } ) ] = ae::Min( level, maxLevel );
+		if( m_params.octree )
+		{
+			m_params.octree->Append( aabb );
+		}
+	}
+	// Returns the minimum corner of the voxel containing \p p in its region,
+	// and the size of the voxel. This identifies voxels across all regions.
+	auto getVoxel = [&]( ae::Vec3 p, int32_t* voxelSizeOut ) -> std::optional< Index >
+	{
+		const ae::Int3 voxel = p.FloorCopy();
+		const int32_t regionIdx = getRegionIdx( ae::Int3(
+			ae::Floor( voxel.x, regionSize ),
+			ae::Floor( voxel.y, regionSize ),
+			ae::Floor( voxel.z, regionSize ) ) - regionBegin );
+		if( regionIdx < 0 )
+		{
+			return std::nullopt;
+		}
+		const int32_t voxelSize = ( 1 << levels[ regionIdx ] );
+		*voxelSizeOut = voxelSize;
+		return Index(
+			ae::Floor( voxel.x, voxelSize ) * voxelSize,
+			ae::Floor( voxel.y, voxelSize ) * voxelSize,
+			ae::Floor( voxel.z, voxelSize ) * voxelSize );
+	};
+
+	// Generate each region with a separate extractor, scaling the SDF so that
+	// the extractor always works with voxels of size one. Each extractor
+	// generates one voxel beyond its region so that the vertices on the
+	// region boundary are complete, and only quads entirely within the region
+	// are kept. The remaining quads are generated as seams below.
+	ae::Map< Index, IsosurfaceVertex > regionVertices = tag;
+	ae::Map< Index, IsosurfaceIndex > regionIndices = tag;
+	auto getIndex = [&]( Index voxel ) -> IsosurfaceIndex
+	{
+		if( const IsosurfaceIndex* index = regionIndices.TryGet( voxel ) )
+		{
+			return *index;
+		}
+		const IsosurfaceVertex* vertex = regionVertices.TryGet( voxel );
+		if( !vertex )
+		{
+			return kInvalidIsosurfaceIndex;
+		}
+		const IsosurfaceIndex index = vertices.Length();
+		vertices.Append( *vertex );
+		regionIndices.Set( voxel, index );
+		return index;
+	};
+	m_status.voxelAABBSize = (uint64_t)regionCount.x * regionCount.y * regionCount.z * regionSize * regionSize * regionSize;
+	IsosurfaceExtractor* extractor = ae::New< IsosurfaceExtractor >( tag, tag );
+	ae::Array< Index > extractorVoxels = tag;
+	for( int32_t z = 0; z < regionCount.z; z++ )
+	for( int32_t y = 0; y < regionCount.y; y++ )
+	for( int32_t x = 0; x < regionCount.x; x++ )
+	{
+		const ae::Int3 r( x, y, z );
+		const int32_t voxelSize = ( 1 << levels[ getRegionIdx( r ) ] );
+		const ae::Int3 minVoxel = ( regionBegin + r ) * ( regionSize / voxelSize );
+		const ae::Int3 maxVoxel = minVoxel + ae::Int3( regionSize / voxelSize - 1 );
+		_IsosurfaceLodSampler sampler;
+		sampler.params = &m_params;
+		sampler.voxelSize = (float)voxelSize;
+		IsosurfaceParams params = m_params;
+		params.sampleFn = &_IsosurfaceLodSampler::Sample;
+		params.sampleBatchFn = m_params.sampleBatchFn ? &_IsosurfaceLodSampler::SampleBatch : nullptr;
+		params.statusFn = nullptr;
+		params.userData = &sampler;
+		params.aabb = ae::AABB( ae::Vec3( minVoxel - ae::Int3( 1 ) ), ae::Vec3( maxVoxel + ae::Int3( 1 ) ) );
+		params.maxVerts = 0;
+		params.maxIndices = 0;
+		params.normalSampleOffset = m_params.normalSampleOffset / voxelSize;
+		params.threadCount = 1;
+		params.lodFn = nullptr;
+		params.lodFocus = std::nullopt;
+		params.octree = nullptr;
+		params.brickMap = nullptr;
+		params.errors = nullptr;
+		if( extractor->Generate( params ) )
+		{
+			extractorVoxels.Clear();
+			extractorVoxels.Append( Index( 0, 0, 0 ), extractor->vertices.Length() );
+			for( uint32_t i = 0; i < extractor->m_voxels.Length(); i++ )
+			{
+				const IsosurfaceIndex index = extractor->m_voxels.GetValue( i ).index;
+				if( index != kInvalidIsosurfaceIndex )
+				{
+					const Index voxel = extractor->m_voxels.GetKey( i );
+					extractorVoxels[ index ] = voxel;
+					if( minVoxel.x <= voxel.x && voxel.x <= maxVoxel.x &&
+						minVoxel.y <= voxel.y && voxel.y <= maxVoxel.y &&
+						minVoxel.z <= voxel.z && voxel.z <= maxVoxel.z )
+					{
+						IsosurfaceVertex vertex = extractor->vertices[ index ];
+						vertex.position = ae::Vec4( vertex.position.GetXYZ() * (float)voxelSize, 1.0f );
+						regionVertices.Set( Index( voxel.x * voxelSize, voxel.y * voxelSize, voxel.z * voxelSize ), vertex );
+					}
+				}
+			}
+			for( uint32_t i = 0; i < extractor->indices.Length(); i += 6 )
+			{
+				bool inside = true;
+				for( uint32_t j = 0; j < 6 && inside; j++ )
+				{
+					const Index voxel = extractorVoxels[ extractor->indices[ i + j ] ];
+					inside = ( minVoxel.x <= voxel.x && voxel.x <= maxVoxel.x &&
+						minVoxel.y <= voxel.y && voxel.y <= maxVoxel.y &&
+						minVoxel.z <= voxel.z && voxel.z <= maxVoxel.z );
+				}
+				for( uint32_t j = 0; j < 6 && inside; j++ )
+				{
+					const Index voxel = extractorVoxels[ extractor->indices[ i + j ] ];
+					indices.Append( getIndex( Index( voxel.x * voxelSize, voxel.y * voxelSize, voxel.z * voxelSize ) ) );
+				}
+			}
+		}
+		const IsosurfaceStatus& status = extractor->GetStatus();
+		m_status.sampleRawCount += status.sampleRawCount;
+		m_status.sampleCallCount += status.sampleCallCount;
+		m_status.sampleCacheCount += status.sampleCacheCount;
+		m_status.sampleBrickMissCount += status.sampleBrickMissCount;
+		m_status.sampleBrickCount += status.sampleBrickCount;
+		m_status.voxelCheckCount += status.voxelCheckCount;
+		m_status.voxelMissCount += status.voxelMissCount;
+		m_status.voxelSearchProgress += (uint64_t)regionSize * regionSize * regionSize;
+		if( !m_UpdateStatus() || vertices.Length() > m_params.maxVerts || indices.Length() > m_params.maxIndices )
+		{
+			ae::Delete( extractor );
+			return false;
+		}
+	}
+	ae::Delete( extractor );
+	m_startMeshTime = ae::GetTime();
+
+	// Generate seams on the minimum face of each region. Every edge within
+	// each face is checked at the voxel size of the finer region, and its quad
+	// is made from the vertices of the voxels around it in either region.
+	// Edges on the border of a face touch up to four regions, and each border
+	// is only processed by the face with the lower axis to avoid duplicates.
+	auto sample = [&]( ae::Vec3 p ) -> float
+	{
+		IsosurfaceValue v;
+		_IsosurfaceSampleRaw( m_params, &m_status, &p, &v, 1 );
+		if( v.distance == 0.0f ) { v.distance += 0.0001f; } // See m_DualSample()
+		return v.distance;
+	};
+	auto addSeamVertex = [&]( Index voxel, ae::Vec3 edge0, ae::Vec3 edge1, float value0, float value1 ) -> IsosurfaceIndex
+	{
+		// The coarser region didn't find the surface in this voxel, so place
+		// a vertex on the edge being stitched
+		IsosurfaceVertex vertex;
+		const ae::Vec3 p = ae::Lerp( edge0, edge1, value0 / ( value0 - value1 ) );
+		for( int32_t i = 0; i < 3; i++ )
+		{
+			ae::Vec3 offset( 0.0f );
+			offset[ i ] = m_params.normalSampleOffset;
+			vertex.normal[ i ] = sample( p + offset ) - sample( p - offset );
+		}
+		vertex.normal.SafeNormalize();
+		vertex.position = ae::Vec4( p, 1.0f );
+		regionVertices.Set( voxel, vertex );
+		return getIndex( voxel );
+	};
+	for( int32_t z = 0; z < regionCount.z; z++ )
+	for( int32_t y = 0; y < regionCount.y; y++ )
+	for( int32_t x = 0; x < regionCount.x; x++ )
+	{
+		const ae::Int3 r( x, y, z );
+		const ae::Int3 regionCorner = ( regionBegin + r ) * regionSize;
+		for( int32_t faceAxis = 0; faceAxis < 3; faceAxis++ )
+		{
+			ae::Int3 neighbor = r;
+			neighbor[ faceAxis ]--;
+			if( getRegionIdx( neighbor ) < 0 )
+			{
+				continue;
+			}
+			for( int32_t edgeAxis = 0; edgeAxis < 3; edgeAxis++ )
+			{
+				if( edgeAxis == faceAxis )
+				{
+					continue;
+				}
+				const int32_t lineAxis = 3 - faceAxis - edgeAxis;
+				const ae::Int3* offsets;
+				switch( edgeAxis )
+				{
+					case 0: offsets = offsets_EDGE_TOP_FRONT_BIT; break;
+					case 1: offsets = offsets_EDGE_TOP_RIGHT_BIT; break;
+					default: offsets = offsets_EDGE_SIDE_FRONTRIGHT_BIT; break;
+				}
+				// Lines within the face use the smaller voxel size of the two
+				// regions, and lines on the border may be even smaller
+				const int32_t faceVoxelSize = ( 1 << ae::Min( levels[ getRegionIdx( r ) ], levels[ getRegionIdx( neighbor ) ] ) );
+				for( int32_t line = 0; line < regionSize; line += faceVoxelSize )
+				{
+					if( line == 0 && faceAxis > lineAxis )
+					{
+						continue; // Processed by the face of lineAxis
+					}
+					// The voxel size of the line is the smallest of the regions
+					// around it, which is constant along the line
+					int32_t voxelSize = regionSize;
+					bool complete = true;
+					for( int32_t i = 0; i < 4; i++ )
+					{
+						ae::Vec3 p( regionCorner );
+						p[ edgeAxis ] += 0.5f;
+						p[ faceAxis ] += ( i & 1 ) ? 0.5f : -0.5f;
+						p[ lineAxis ] += line + ( ( i & 2 ) ? 0.5f : -0.5f );
+						int32_t size = 0;
+						complete = complete && getVoxel( p, &size ).has_value();
+						voxelSize = ae::Min( voxelSize, size );
+					}
+					if( !complete )
+					{
+						continue;
+					}
+					for( int32_t edge = 0; edge < regionSize; edge += voxelSize )
+					{
+						ae::Int3 edge0 = regionCorner;
+						edge0[ lineAxis ] += line;
+						edge0[ edgeAxis ] += edge;
+						ae::Int3 edge1 = edge0;
+						edge1[ edgeAxis ] += voxelSize;
+						const float value0 = sample( ae::Vec3( edge0 ) );
+						const float value1 = sample( ae::Vec3( edge1 ) );
+						if( value0 * value1 >= 0.0f )
+						{
+							continue;
+						}
+						// Same voxel order and winding as m_DoVoxel(), where
+						// edge1 is the shared corner
+						ae::Int3 base = edge0;
+						base[ faceAxis ] -= voxelSize;
+						base[ lineAxis ] -= voxelSize;
+						IsosurfaceIndex quad[ 4 ];
+						for( int32_t j = 0; j < 4; j++ )
+						{
+							const ae::Vec3 center = ae::Vec3( base + offsets[ j ] * voxelSize ) + ae::Vec3( voxelSize * 0.5f );
+							int32_t size = 0;
+							const Index voxel = getVoxel( center, &size ).value();
+							quad[ j ] = getIndex( voxel );
+							if( quad[ j ] == kInvalidIsosurfaceIndex )
+							{
+								quad[ j ] = addSeamVertex( voxel, ae::Vec3( edge0 ), ae::Vec3( edge1 ), value0, value1 );
+							}
+						}
+						const bool flip = ( edgeAxis == 0 ) ? ( value1 > 0.0f ) : ( value1 < 0.0f );
+						const IsosurfaceIndex tris[ 2 ][ 3 ] =
+						{
+							{ quad[ 0 ], flip ? quad[ 1 ] : quad[ 2 ], flip ? quad[ 2 ] : quad[ 1 ] },
+							{ quad[ 1 ], flip ? quad[ 3 ] : quad[ 2 ], flip ? quad[ 2 ] : quad[ 3 ] }
+						};
+						for( const auto& tri : tris )
+						{
+							// Voxels shared across a level change collapse the quad
+							if( tri[ 0 ] != tri[ 1 ] && tri[ 1 ] != tri[ 2 ] && tri[ 2 ] != tri[ 0 ] )
+							{
+								indices.AppendArray( tri, 3 );
+							}
+						}
+					}
+				}
+			}
+		}
+		m_status.meshProgress01 = ( getRegionIdx( r ) + 1 ) / (float)levels.Length();
+		if( !m_UpdateStatus() )
+		{
+			return false;
+		}
+	}
+
+	m_status.threadCount = 1;
+	m_status.vertexCount = vertices.Length();
+	m_status.indexCount = indices.Length();
+	m_status.threadTime[ 0 ] = ae::GetTime() - m_startVoxelTime;
+	m_status.meshProgress01 = 1.0f;
+	return indices.Length() && vertices.Length() <= m_params.maxVerts && indices.Length() <= m_params.maxIndices && m_UpdateStatus();
+}
+
 bool IsosurfaceExtractor::Generate( const ae::IsosurfaceParams& _params )
 {
+	AE_ASSERT_MSG( _params.sampleFn || _params.sampleBatchFn, "IsosurfaceParams::sampleFn or IsosurfaceParams::sampleBatchFn must be set" );
 	if( !_params.aabb.Contains( _params.aabb.GetCenter() ) )
 	{
 		return true;
@@ -33005,6 +38142,35 @@ bool IsosurfaceExtractor::Generate( const ae::IsosurfaceParams& _params )
 	const float maxHalfSize = ae::Max( paramHalfSize.x, paramHalfSize.y, paramHalfSize.z );
 	const uint32_t halfSize = ae::NextPowerOfTwo( maxHalfSize * 2.0f + 0.5f ) / 2;
 	m_status.voxelAABBSize = (uint64_t)halfSize * halfSize * halfSize * 8;
+	m_rootCenter = m_params.aabb.GetCenter().FloorCopy();
+	m_rootHalfSize = halfSize;
+	if( m_params.lodFn || m_params.lodFocus )
+	{
+		AE_ASSERT_MSG( !m_params.incremental, "IsosurfaceParams::incremental can't be used with multi-resolution generation" );
+		if( !m_GenerateLod() )
+		{
+			vertices.Clear();
+			indices.Clear();
+			return false;
+		}
+		return true;
+	}
+	const uint32_t threadCount = ae::Clip( m_params.threadCount ? m_params.threadCount : ae::GetMaxConcurrentThreads(), 1u, IsosurfaceStatus::kMaxThreads );
+	if( threadCount > 1 && halfSize > kBrickMapSize ) // Not worth splitting up a single brick
+	{
+		if( !m_GenerateParallel( m_params.aabb.GetCenter().FloorCopy(), halfSize, threadCount ) )
+		{
+			vertices.Clear();
+			indices.Clear();
+			return false;
+		}
+		if( m_params.incremental )
+		{
+			m_InitializeIncremental();
+		}
+		return true;
+	}
+	m_status.threadCount = 1;
 	m_GenerateVerts( m_params.aabb.GetCenter().FloorCopy(), halfSize );
 	m_status.vertexCount = vertices.Length();
 	m_status.indexCount = indices.Length();
@@ -33017,287 +38183,1474 @@ bool IsosurfaceExtractor::Generate( const ae::IsosurfaceParams& _params )
 	}
 
 	m_startMeshTime = ae::GetTime();
-	const float progressPerVert = 1.0f / vertices.Length();
-	const ae::Int3 sdfMin = m_params.aabb.GetMin().FloorCopy();
-	const ae::Int3 sdfMax = m_params.aabb.GetMax().CeilCopy();
 	for( IsosurfaceVertex& vertex : vertices )
 	{
-		const int32_t x = ae::Floor( vertex.position.x );
-		const int32_t y = ae::Floor( vertex.position.y );
-		const int32_t z = ae::Floor( vertex.position.z );
-		if( x < sdfMin.x && y < sdfMin.y && z < sdfMin.z ){ continue; }
-		if( x > sdfMax.x && y > sdfMax.y && z > sdfMax.z ){ continue; }
+		m_GenerateVertex( &vertex, m_voxels );
+
+		m_status.meshProgress01 += 1.0f / (float)vertices.Length();
+		if( !m_UpdateStatus() )
+		{
+			vertices.Clear();
+			indices.Clear();
+			return false;
+		}
+	}
+
+	AE_DEBUG_ASSERT( vertices.Length() <= m_params.maxVerts );
+	AE_DEBUG_ASSERT( indices.Length() <= m_params.maxIndices );
+	m_status.threadTime[ 0 ] = ae::GetTime() - m_startVoxelTime;
+	m_status.meshProgress01 = 1.0f;
+	if( !m_UpdateStatus() )
+	{
+		vertices.Clear();
+		indices.Clear();
+		return false;
+	}
+	if( m_params.incremental )
+	{
+		m_InitializeIncremental();
+	}
+	return true;
+}
+
+bool IsosurfaceExtractor::Update( const ae::AABB* dirtyAABBs, uint32_t dirtyCount )
+{
+	if( !m_incrementalReady )
+	{
+		AE_ASSERT_MSG( !indices.Length(), "IsosurfaceParams::incremental must be set to update the mesh" );
+		return false;
+	}
+	const double startTime = ae::GetTime();
+	m_status = {};
+	m_status.threadCount = 1;
+	m_startVoxelTime = startTime;
+	m_startMeshTime = 0.0;
+
+	// Samples in the dirty areas are stale, so drop any bricks containing them
+	for( uint32_t i = 0; i < dirtyCount; i++ )
+	{
+		const ae::Int3 brickMin = Brick::MakeIndex( dirtyAABBs[ i ].GetMin().FloorCopy() - ae::Int3( 1 ) ).first;
+		const ae::Int3 brickMax = Brick::MakeIndex( dirtyAABBs[ i ].GetMax().CeilCopy() ).first;
+		for( int32_t z = brickMin.z; z <= brickMax.z; z++ )
+		for( int32_t y = brickMin.y; y <= brickMax.y; y++ )
+		for( int32_t x = brickMin.x; x <= brickMax.x; x++ )
+		{
+			m_brickMap.Remove( { x, y, z } );
+		}
+	}
+
+	// Edges within two voxels of a change, plus the normal sampling offset, may
+	// move. Whole bricks are regenerated so that each keeps a single range.
+	const ae::Int3 margin( 2 + (int32_t)ae::Ceil( m_params.normalSampleOffset ) );
+	auto clip = [&]( ae::Int3 v )
+	{
+		return ae::Int3(
+			ae::Clip( v.x, m_minInclusive.x, m_maxInclusive.x ),
+			ae::Clip( v.y, m_minInclusive.y, m_maxInclusive.y ),
+			ae::Clip( v.z, m_minInclusive.z, m_maxInclusive.z ) );
+	};
+	for( uint32_t i = 0; i < dirtyCount; i++ )
+	{
+		const ae::Int3 dirtyMin = dirtyAABBs[ i ].GetMin().FloorCopy() - margin;
+		const ae::Int3 dirtyMax = dirtyAABBs[ i ].GetMax().CeilCopy() + margin;
+		if( dirtyMin.x > m_maxInclusive.x || dirtyMin.y > m_maxInclusive.y || dirtyMin.z > m_maxInclusive.z ||
+			dirtyMax.x < m_minInclusive.x || dirtyMax.y < m_minInclusive.y || dirtyMax.z < m_minInclusive.z )
+		{
+			continue;
+		}
+		const ae::Int3 regionMin = ae::Int3( Brick::MakeIndex( clip( dirtyMin ) ).first ) * kBrickMapSize;
+		const ae::Int3 regionMax = ( ae::Int3( Brick::MakeIndex( clip( dirtyMax ) ).first ) + ae::Int3( 1 ) ) * kBrickMapSize - ae::Int3( 1 );
+		m_UpdateRegion( clip( regionMin ), clip( regionMax ) );
+	}
+	if( m_indexWaste > indices.Length() / 2 )
+	{
+		m_CompactIndices();
+	}
+
+	m_status.vertexCount = vertices.Length();
+	m_status.indexCount = indices.Length();
+	m_status.voxelWorkingSize = m_voxels.Length();
+	m_status.elapsedTime = ae::GetTime() - startTime;
+	m_status.voxelTime = m_status.elapsedTime;
+	m_status.threadTime[ 0 ] = m_status.elapsedTime;
+	m_status.voxelProgress01 = 1.0f;
+	m_status.meshProgress01 = 1.0f;
+	if( vertices.Length() > m_params.maxVerts || indices.Length() > m_params.maxIndices )
+	{
+		const IsosurfaceParams params = m_params;
+		const IsosurfaceStatus status = m_status;
+		Reset();
+		m_params = params;
+		m_status = status;
+		return false;
+	}
+	return true;
+}
 
-		int32_t ec = 0;
-		ae::Vec3 p[ 12 ];
-		ae::Vec3 n[ 12 ];
-		Voxel te = m_voxels.Get( { x + 1, y + 1, z + 1 }, {} );
-		if( te.edgeBits & EDGE_TOP_FRONT_BIT )
+void IsosurfaceExtractor::m_InitializeIncremental()
+{
+	m_vertexVoxels.Clear();
+	m_vertexVoxels.Append( Index( 0, 0, 0 ), vertices.Length() );
+	for( uint32_t i = 0; i < m_voxels.Length(); i++ )
+	{
+		const IsosurfaceIndex index = m_voxels.GetValue( i ).index;
+		if( index != kInvalidIsosurfaceIndex )
 		{
-			p[ ec ] = te.edgePos[ 0 ];
-			n[ ec ] = te.edgeNormal[ 0 ];
-			ec++;
+			m_vertexVoxels[ index ] = m_voxels.GetKey( i );
 		}
-		if( te.edgeBits & EDGE_TOP_RIGHT_BIT )
+	}
+	m_vertexRefs.Clear();
+	m_vertexRefs.Append( 0, vertices.Length() );
+	for( IsosurfaceIndex index : indices )
+	{
+		m_vertexRefs[ index ]++;
+	}
+	m_freeVertices.Clear();
+
+	// Group quads by brick. The first index of each quad is always the vertex
+	// of the voxel that generated it, see m_DoVoxel().
+	m_brickMeshes.Clear();
+	for( uint32_t i = 0; i < indices.Length(); i += 6 )
+	{
+		const Index brick = Brick::MakeIndex( ae::Int3( m_vertexVoxels[ indices[ i ] ] ) ).first;
+		BrickMesh* mesh = m_brickMeshes.TryGet( brick );
+		mesh = mesh ? mesh : &m_brickMeshes.Set( brick, {} );
+		mesh->indexCapacity += 6;
+	}
+	uint32_t indexBegin = 0;
+	for( uint32_t i = 0; i < m_brickMeshes.Length(); i++ )
+	{
+		BrickMesh* mesh = &m_brickMeshes.GetValue( i );
+		mesh->indexBegin = indexBegin;
+		indexBegin += mesh->indexCapacity;
+	}
+	ae::Array< IsosurfaceIndex > grouped( vertices.Tag(), 0, indices.Length() );
+	for( uint32_t i = 0; i < indices.Length(); i += 6 )
+	{
+		BrickMesh* mesh = m_brickMeshes.TryGet( Brick::MakeIndex( ae::Int3( m_vertexVoxels[ indices[ i ] ] ) ).first );
+		for( uint32_t j = 0; j < 6; j++ )
 		{
-			p[ ec ] = te.edgePos[ 1 ];
-			n[ ec ] = te.edgeNormal[ 1 ];
-			ec++;
+			grouped[ mesh->indexBegin + mesh->indexCount++ ] = indices[ i + j ];
 		}
-		if( te.edgeBits & EDGE_SIDE_FRONTRIGHT_BIT )
+	}
+	indices = std::move( grouped );
+	m_indexWaste = 0;
+	m_incrementalReady = true;
+}
+
+void IsosurfaceExtractor::m_UpdateRegion( ae::Int3 minInclusive, ae::Int3 maxInclusive )
+{
+	// Find the new surface voxels of the region with a separate extractor, the
+	// same as a worker thread in m_GenerateParallel()
+	const ae::Tag tag = vertices.Tag();
+	IsosurfaceExtractor* extractor = ae::New< IsosurfaceExtractor >( tag, tag );
+	extractor->m_params = m_params;
+	extractor->m_params.statusFn = nullptr;
+	extractor->m_params.octree = nullptr;
+	extractor->m_params.brickMap = nullptr;
+	extractor->m_params.errors = nullptr;
+	extractor->m_params.incremental = false;
+	extractor->m_params.maxVerts = ae::MaxValue< uint32_t >();
+	extractor->m_params.maxIndices = ae::MaxValue< uint32_t >();
+	extractor->m_minInclusive = minInclusive;
+	extractor->m_maxInclusive = maxInclusive;
+	extractor->m_GenerateVerts( m_rootCenter, m_rootHalfSize );
+
+	// Replace the edges of the region, keeping the existing vertex indices.
+	// The edges of each voxel are stored in the "top" corner of the dual grid.
+	for( int32_t z = minInclusive.z + 1; z <= maxInclusive.z + 1; z++ )
+	for( int32_t y = minInclusive.y + 1; y <= maxInclusive.y + 1; y++ )
+	for( int32_t x = minInclusive.x + 1; x <= maxInclusive.x + 1; x++ )
+	{
+		const Voxel* newVoxel = extractor->m_voxels.TryGet( { x, y, z } );
+		Voxel* voxel = m_voxels.TryGet( { x, y, z } );
+		if( newVoxel && newVoxel->edgeBits )
 		{
-			p[ ec ] = te.edgePos[ 2 ];
-			n[ ec ] = te.edgeNormal[ 2 ];
-			ec++;
+			voxel = voxel ? voxel : &m_voxels.Set( { x, y, z }, {} );
+			const IsosurfaceIndex index = voxel->index;
+			*voxel = *newVoxel;
+			voxel->index = index;
 		}
-		te = m_voxels.Get( { x, y + 1, z + 1 }, {} );
-		if( te.edgeBits & EDGE_TOP_RIGHT_BIT )
+		else if( voxel )
 		{
-			p[ ec ] = te.edgePos[ 1 ];
-			p[ ec ].x -= 1.0f;
-			n[ ec ] = te.edgeNormal[ 1 ];
-			ec++;
+			voxel->edgeBits = 0;
 		}
-		if( te.edgeBits & EDGE_SIDE_FRONTRIGHT_BIT )
+	}
+
+	// Sort the new quads by brick
+	const ae::Int3 brickMin = Brick::MakeIndex( minInclusive ).first;
+	const ae::Int3 brickSize = ae::Int3( Brick::MakeIndex( maxInclusive ).first ) - brickMin + ae::Int3( 1 );
+	auto getBrickSlot = [&]( ae::Int3 voxel )
+	{
+		const ae::Int3 b = ae::Int3( Brick::MakeIndex( voxel ).first ) - brickMin;
+		return (uint32_t)( b.x + brickSize.x * ( b.y + brickSize.y * b.z ) );
+	};
+	const uint32_t brickCount = brickSize.x * brickSize.y * brickSize.z;
+	ae::Array< uint32_t > brickOffsets( tag, 0, brickCount + 1 );
+	for( uint32_t i = 0; i < extractor->indices.Length(); i += 6 )
+	{
+		const ae::Vec4 p = extractor->vertices[ extractor->indices[ i ] ].position;
+		brickOffsets[ getBrickSlot( p.GetXYZ().FloorCopy() ) + 1 ] += 6;
+	}
+	for( uint32_t i = 0; i < brickCount; i++ )
+	{
+		brickOffsets[ i + 1 ] += brickOffsets[ i ];
+	}
+	// Vertices of the extractor are still centered in their voxels, which
+	// identifies the existing vertex to use or where a new one is needed
+	ae::Array< IsosurfaceIndex > remap( tag, kInvalidIsosurfaceIndex, extractor->vertices.Length() );
+	ae::Array< IsosurfaceIndex > sortedIndices( tag, 0, extractor->indices.Length() );
+	ae::Array< uint32_t > brickWrite = brickOffsets;
+	for( uint32_t i = 0; i < extractor->indices.Length(); i += 6 )
+	{
+		const ae::Vec4 p = extractor->vertices[ extractor->indices[ i ] ].position;
+		uint32_t& write = brickWrite[ getBrickSlot( p.GetXYZ().FloorCopy() ) ];
+		for( uint32_t j = 0; j < 6; j++ )
 		{
-			p[ ec ] = te.edgePos[ 2 ];
-			p[ ec ].x -= 1.0f;
-			n[ ec ] = te.edgeNormal[ 2 ];
-			ec++;
+			const IsosurfaceIndex extractorIndex = extractor->indices[ i + j ];
+			IsosurfaceIndex& index = remap[ extractorIndex ];
+			if( index == kInvalidIsosurfaceIndex )
+			{
+				const ae::Int3 voxelPos = extractor->vertices[ extractorIndex ].position.GetXYZ().FloorCopy();
+				const Index key( voxelPos.x, voxelPos.y, voxelPos.z );
+				Voxel* voxel = m_voxels.TryGet( key );
+				voxel = voxel ? voxel : &m_voxels.Set( key, {} );
+				if( voxel->index == kInvalidIsosurfaceIndex )
+				{
+					if( m_freeVertices.Length() )
+					{
+						voxel->index = m_freeVertices[ m_freeVertices.Length() - 1 ];
+						m_freeVertices.Remove( m_freeVertices.Length() - 1 );
+						m_vertexVoxels[ voxel->index ] = key;
+					}
+					else
+					{
+						voxel->index = vertices.Length();
+						vertices.Append( {} );
+						m_vertexVoxels.Append( key );
+						m_vertexRefs.Append( 0 );
+					}
+				}
+				index = voxel->index;
+			}
+			sortedIndices[ write++ ] = index;
 		}
-		te = m_voxels.Get( { x + 1, y, z + 1 }, {} );
-		if( te.edgeBits & EDGE_TOP_FRONT_BIT )
+	}
+
+	// Splice the new quads into the range of each brick, moving the brick to
+	// the end of the index buffer only when it has outgrown its range
+	for( int32_t z = 0; z < brickSize.z; z++ )
+	for( int32_t y = 0; y < brickSize.y; y++ )
+	for( int32_t x = 0; x < brickSize.x; x++ )
+	{
+		const uint32_t slot = x + brickSize.x * ( y + brickSize.y * z );
+		const Index brick( brickMin.x + x, brickMin.y + y, brickMin.z + z );
+		const uint32_t newCount = brickOffsets[ slot + 1 ] - brickOffsets[ slot ];
+		BrickMesh* mesh = m_brickMeshes.TryGet( brick );
+		if( !mesh && !newCount )
 		{
-			p[ ec ] = te.edgePos[ 0 ];
-			p[ ec ].y -= 1.0f;
-			n[ ec ] = te.edgeNormal[ 0 ];
-			ec++;
+			continue;
 		}
-		if( te.edgeBits & EDGE_SIDE_FRONTRIGHT_BIT )
+		mesh = mesh ? mesh : &m_brickMeshes.Set( brick, {} );
+		for( uint32_t i = 0; i < mesh->indexCount; i++ )
 		{
-			p[ ec ] = te.edgePos[ 2 ];
-			p[ ec ].y -= 1.0f;
-			n[ ec ] = te.edgeNormal[ 2 ];
-			ec++;
+			IsosurfaceIndex& index = indices[ mesh->indexBegin + i ];
+			m_vertexRefs[ index ]--;
+			index = 0; // Degenerate
 		}
-		te = m_voxels.Get( { x, y, z + 1 }, {} );
-		if( te.edgeBits & EDGE_SIDE_FRONTRIGHT_BIT )
+		if( newCount > mesh->indexCapacity )
 		{
-			p[ ec ] = te.edgePos[ 2 ];
-			p[ ec ].x -= 1.0f;
-			p[ ec ].y -= 1.0f;
-			n[ ec ] = te.edgeNormal[ 2 ];
-			ec++;
+			m_indexWaste += mesh->indexCapacity;
+			mesh->indexBegin = indices.Length();
+			mesh->indexCapacity = ( ( newCount + newCount / 2 ) / 6 + 1 ) * 6;
+			indices.Append( 0, mesh->indexCapacity );
 		}
-		te = m_voxels.Get( { x, y + 1, z }, {} );
-		if( te.edgeBits & EDGE_TOP_RIGHT_BIT )
+		mesh->indexCount = newCount;
+		for( uint32_t i = 0; i < newCount; i++ )
 		{
-			p[ ec ] = te.edgePos[ 1 ];
-			p[ ec ].x -= 1.0f;
-			p[ ec ].z -= 1.0f;
-			n[ ec ] = te.edgeNormal[ 1 ];
-			ec++;
+			const IsosurfaceIndex index = sortedIndices[ brickOffsets[ slot ] + i ];
+			indices[ mesh->indexBegin + i ] = index;
+			m_vertexRefs[ index ]++;
 		}
-		te = m_voxels.Get( { x + 1, y, z }, {} );
-		if( te.edgeBits & EDGE_TOP_FRONT_BIT )
+	}
+
+	// Release vertices that are no longer referenced and reposition the rest,
+	// which may depend on the replaced edges
+	for( int32_t z = minInclusive.z; z <= maxInclusive.z + 1; z++ )
+	for( int32_t y = minInclusive.y; y <= maxInclusive.y + 1; y++ )
+	for( int32_t x = minInclusive.x; x <= maxInclusive.x + 1; x++ )
+	{
+		Voxel* voxel = m_voxels.TryGet( { x, y, z } );
+		if( !voxel || voxel->index == kInvalidIsosurfaceIndex )
 		{
-			p[ ec ] = te.edgePos[ 0 ];
-			p[ ec ].y -= 1.0f;
-			p[ ec ].z -= 1.0f;
-			n[ ec ] = te.edgeNormal[ 0 ];
-			ec++;
+			continue;
 		}
-		te = m_voxels.Get( { x + 1, y + 1, z }, {} );
-		if( te.edgeBits & EDGE_TOP_FRONT_BIT )
+		IsosurfaceVertex* vertex = &vertices[ voxel->index ];
+		if( m_vertexRefs[ voxel->index ] )
 		{
-			p[ ec ] = te.edgePos[ 0 ];
-			p[ ec ].z -= 1.0f;
-			n[ ec ] = te.edgeNormal[ 0 ];
-			ec++;
+			vertex->position = ae::Vec4( x + 0.5f, y + 0.5f, z + 0.5f, 1.0f );
+			m_GenerateVertex( vertex, m_voxels );
 		}
-		if( te.edgeBits & EDGE_TOP_RIGHT_BIT )
+		else
 		{
-			p[ ec ] = te.edgePos[ 1 ];
-			p[ ec ].z -= 1.0f;
-			n[ ec ] = te.edgeNormal[ 1 ];
-			ec++;
+			*vertex = {};
+			m_freeVertices.Append( voxel->index );
+			voxel->index = kInvalidIsosurfaceIndex;
 		}
+	}
 
-		// Validation
-		AE_DEBUG_ASSERT( ec != 0 );
-		for( int32_t j = 0; j < ec; j++ )
+	// Keep the samples of the extractor for future updates
+	for( uint32_t i = 0; i < extractor->m_brickMap.Length(); i++ )
+	{
+		if( !m_brickMap.TryGet( extractor->m_brickMap.GetKey( i ) ) )
 		{
-			AE_DEBUG_ASSERT( p[ j ] == p[ j ] );
-			AE_DEBUG_ASSERT( p[ j ].x >= 0.0f && p[ j ].x <= 1.0f );
-			AE_DEBUG_ASSERT( p[ j ].y >= 0.0f && p[ j ].y <= 1.0f );
-			AE_DEBUG_ASSERT( p[ j ].z >= 0.0f && p[ j ].z <= 1.0f );
-			AE_DEBUG_ASSERT( n[ j ] == n[ j ] );
+			m_brickMap.Set( extractor->m_brickMap.GetKey( i ), extractor->m_brickMap.GetValue( i ) );
 		}
+	}
+	uint64_t IsosurfaceStatus::* const counts[] =
+	{
+		&IsosurfaceStatus::sampleRawCount,
+		&IsosurfaceStatus::sampleCallCount,
+		&IsosurfaceStatus::sampleCacheCount,
+		&IsosurfaceStatus::sampleBrickMissCount,
+		&IsosurfaceStatus::sampleBrickCount,
+		&IsosurfaceStatus::voxelCheckCount,
+		&IsosurfaceStatus::voxelMissCount,
+		&IsosurfaceStatus::voxelSearchProgress
+	};
+	for( auto count : counts )
+	{
+		m_status.*count += extractor->m_status.*count;
+	}
+	ae::Delete( extractor );
+}
 
-		ae::Vec3 position;
-		if( m_params.dualContouring )
+void IsosurfaceExtractor::m_CompactIndices()
+{
+	ae::Array< IsosurfaceIndex > compacted( vertices.Tag() );
+	compacted.Reserve( indices.Length() );
+	for( uint32_t i = 0; i < m_brickMeshes.Length(); i++ )
+	{
+		BrickMesh* mesh = &m_brickMeshes.GetValue( i );
+		const uint32_t begin = compacted.Length();
+		if( mesh->indexCount )
 		{
-			// Get intersection of edge planes for vertex positioning
+			compacted.AppendArray( &indices[ mesh->indexBegin ], mesh->indexCount );
+		}
+		mesh->indexBegin = begin;
+		mesh->indexCapacity = mesh->indexCount;
+	}
+	indices = compacted;
+	m_indexWaste = 0;
+}
+
+//------------------------------------------------------------------------------
+// ae::MeshSimplifier member functions
+//------------------------------------------------------------------------------
+static const uint32_t _kMeshSimplifierNone = ~0u;
+
+//! Interleaves the lower 10 bits of \p x with zeros for a 30 bit Morton code
+static uint32_t _MeshSimplifierSpreadBits( uint32_t x )
+{
+	x &= 0x3ff;
+	x = ( x | ( x << 16 ) ) & 0x030000ff;
+	x = ( x | ( x << 8 ) ) & 0x0300f00f;
+	x = ( x | ( x << 4 ) ) & 0x030c30c3;
+	x = ( x | ( x << 2 ) ) & 0x09249249;
+	return x;
+}
+
+void MeshSimplifier::Quadric::AddPlane( ae::Vec3 normal, float d, double weight )
+{
+	const double a = normal.x;
+	const double b = normal.y;
+	const double c = normal.z;
+	q[ 0 ] += weight * a * a;
+	q[ 1 ] += weight * a * b;
+	q[ 2 ] += weight * a * c;
+	q[ 3 ] += weight * a * d;
+	q[ 4 ] += weight * b * b;
+	q[ 5 ] += weight * b * c;
+	q[ 6 ] += weight * b * d;
+	q[ 7 ] += weight * c * c;
+	q[ 8 ] += weight * c * d;
+	q[ 9 ] += weight * (double)d * d;
+}
+
+void MeshSimplifier::Quadric::operator+=( const Quadric& other )
+{
+	for( uint32_t i = 0; i < countof( q ); i++ )
+	{
+		q[ i ] += other.q[ i ];
+	}
+	area += other.area;
+}
+
+double MeshSimplifier::Quadric::Evaluate( ae::Vec3 p ) const
+{
+	const double x = p.x;
+	const double y = p.y;
+	const double z = p.z;
+	const double result = q[ 0 ] * x * x + 2.0 * q[ 1 ] * x * y + 2.0 * q[ 2 ] * x * z + 2.0 * q[ 3 ] * x
+		+ q[ 4 ] * y * y + 2.0 * q[ 5 ] * y * z + 2.0 * q[ 6 ] * y
+		+ q[ 7 ] * z * z + 2.0 * q[ 8 ] * z
+		+ q[ 9 ];
+	return ( result > 0.0 ) ? result : 0.0; // Rounding can make the result slightly negative
+}
+
+MeshSimplifier::MeshSimplifier( ae::Tag tag ) :
+	positions( tag ),
+	attributes( tag ),
+	indices( tag ),
+	m_positions( tag ),
+	m_attributes( tag ),
+	m_quadrics( tag ),
+	m_tris( tag ),
+	m_triAlive( tag ),
+	m_cornerNext( tag ),
+	m_vertexHead( tag ),
+	m_vertexTail( tag ),
+	m_vertexVersion( tag ),
+	m_vertexCluster( tag ),
+	m_vertexFlags( tag )
+{}
+
+bool MeshSimplifier::Simplify( const Params& params )
+{
+	AE_ASSERT_MSG( params.vertexPositions || !params.vertexCount, "MeshSimplifier::Params::vertexPositions must be set" );
+	AE_ASSERT_MSG( params.vertexPositionStride >= sizeof(float) * 3, "Invalid vertex position stride #", params.vertexPositionStride );
+	AE_ASSERT_MSG( params.vertexAttributeCount <= kMaxAttributes, "Too many vertex attributes # (max #)", params.vertexAttributeCount, kMaxAttributes );
+	AE_ASSERT_MSG( !params.vertexAttributeCount || ( params.vertexAttributes && params.vertexAttributeStride >= sizeof(float) * params.vertexAttributeCount ), "Invalid vertex attributes" );
+	AE_ASSERT_MSG( params.indices || !params.indexCount, "MeshSimplifier::Params::indices must be set" );
+	AE_ASSERT_MSG( params.indexSize == 2 || params.indexSize == 4, "Invalid index size #", params.indexSize );
+	AE_ASSERT_MSG( params.indexCount % 3 == 0, "Index count # is not a multiple of 3", params.indexCount );
+	const ae::Tag tag = positions.Tag();
+	const uint32_t vertexCount = params.vertexCount;
+	const uint32_t attributeCount = params.vertexAttributeCount;
+	m_params = params;
+	m_error = 0.0f;
+	positions.Clear();
+	attributes.Clear();
+	indices.Clear();
+
+	// Copy vertices
+	m_positions.Clear();
+	m_positions.Reserve( vertexCount );
+	m_attributes.Clear();
+	m_attributes.Reserve( vertexCount * attributeCount );
+	for( uint32_t i = 0; i < vertexCount; i++ )
+	{
+		const float* p = (const float*)( (const uint8_t*)params.vertexPositions + i * params.vertexPositionStride );
+		m_positions.Append( ae::Vec3( p[ 0 ], p[ 1 ], p[ 2 ] ) );
+		if( attributeCount )
+		{
+			m_attributes.AppendArray( (const float*)( (const uint8_t*)params.vertexAttributes + i * params.vertexAttributeStride ), attributeCount );
+		}
+	}
+
+	// Copy triangles, skipping any with repeated vertices
+	m_tris.Clear();
+	m_tris.Reserve( params.indexCount );
+	for( uint32_t i = 0; i < params.indexCount; i += 3 )
+	{
+		uint32_t tri[ 3 ];
+		for( uint32_t j = 0; j < 3; j++ )
+		{
+			tri[ j ] = ( params.indexSize == 2 ) ? ( (const uint16_t*)params.indices )[ i + j ] : ( (const uint32_t*)params.indices )[ i + j ];
+			AE_ASSERT_MSG( tri[ j ] < vertexCount, "Index # is out of range (vertex count #)", tri[ j ], vertexCount );
+		}
+		if( tri[ 0 ] != tri[ 1 ] && tri[ 1 ] != tri[ 2 ] && tri[ 2 ] != tri[ 0 ] )
+		{
+			m_tris.AppendArray( tri, 3 );
+		}
+	}
+	const uint32_t triCount = m_tris.Length() / 3;
+	m_triAlive.Clear();
+	m_triAlive.Append( 1, triCount );
+
+	// Each vertex starts with the area weighted planes of its triangles
+	m_quadrics.Clear();
+	m_quadrics.Append( {}, vertexCount );
+	for( uint32_t i = 0; i < triCount; i++ )
+	{
+		const uint32_t* tri = &m_tris[ i * 3 ];
+		const ae::Vec3 p0 = m_positions[ tri[ 0 ] ];
+		ae::Vec3 normal = ( m_positions[ tri[ 1 ] ] - p0 ).Cross( m_positions[ tri[ 2 ] ] - p0 );
+		const float length = normal.Length();
+		if( length <= 0.0f )
+		{
+			continue;
+		}
+		normal /= length;
+		const double area = length * 0.5;
+		for( uint32_t j = 0; j < 3; j++ )
+		{
+			Quadric* quadric = &m_quadrics[ tri[ j ] ];
+			quadric->AddPlane( normal, -normal.Dot( p0 ), area );
+			quadric->area += area;
+		}
+	}
+
+	// Edges not shared by exactly two triangles are boundaries. Open edges get
+	// a heavily weighted plane perpendicular to their triangle so they only
+	// move along themselves.
+	ae::Map< uint64_t, uint32_t > edgeCounts = tag;
+	const auto getEdgeKey = []( uint32_t a, uint32_t b ) -> uint64_t
+	{
+		return ( a < b ) ? ( ( (uint64_t)a << 32 ) | b ) : ( ( (uint64_t)b << 32 ) | a );
+	};
+	for( uint32_t i = 0; i < triCount * 3; i++ )
+	{
+		const uint64_t key = getEdgeKey( m_tris[ i ], m_tris[ i - i % 3 + ( i + 1 ) % 3 ] );
+		edgeCounts.Set( key, edgeCounts.Get( key, 0 ) + 1 );
+	}
+	m_vertexFlags.Clear();
+	m_vertexFlags.Append( 0, vertexCount );
+	for( uint32_t i = 0; i < triCount * 3; i++ )
+	{
+		const uint32_t* tri = &m_tris[ i - i % 3 ];
+		const uint32_t a = tri[ i % 3 ];
+		const uint32_t b = tri[ ( i + 1 ) % 3 ];
+		const uint32_t edgeCount = edgeCounts.Get( getEdgeKey( a, b ), 0 );
+		if( edgeCount == 2 )
+		{
+			continue;
+		}
+		m_vertexFlags[ a ] |= kVertexBoundary;
+		m_vertexFlags[ b ] |= kVertexBoundary;
+		if( edgeCount == 1 && params.preserveBoundaries )
+		{
+			const ae::Vec3 p0 = m_positions[ tri[ 0 ] ];
+			const ae::Vec3 faceNormal = ( m_positions[ tri[ 1 ] ] - p0 ).Cross( m_positions[ tri[ 2 ] ] - p0 );
+			const ae::Vec3 edge = m_positions[ b ] - m_positions[ a ];
+			const ae::Vec3 normal = edge.Cross( faceNormal ).SafeNormalizeCopy();
+			if( normal != ae::Vec3( 0.0f ) )
 			{
-#if defined(__SSE3__)
-				__m128 c128 = _mm_setzero_ps();
-				for( uint32_t i = 0; i < ec; i++ )
+				const double weight = 100.0 * edge.LengthSquared();
+				const float d = -normal.Dot( m_positions[ a ] );
+				m_quadrics[ a ].AddPlane( normal, d, weight );
+				m_quadrics[ b ].AddPlane( normal, d, weight );
+			}
+		}
+	}
+
+	// Link the triangle corners of each vertex
+	m_cornerNext.Clear();
+	m_cornerNext.Append( _kMeshSimplifierNone, triCount * 3 );
+	m_vertexHead.Clear();
+	m_vertexHead.Append( _kMeshSimplifierNone, vertexCount );
+	m_vertexTail.Clear();
+	m_vertexTail.Append( _kMeshSimplifierNone, vertexCount );
+	for( uint32_t i = 0; i < triCount * 3; i++ )
+	{
+		const uint32_t v = m_tris[ i ];
+		if( m_vertexHead[ v ] == _kMeshSimplifierNone )
+		{
+			m_vertexHead[ v ] = i;
+		}
+		else
+		{
+			m_cornerNext[ m_vertexTail[ v ] ] = i;
+		}
+		m_vertexTail[ v ] = i;
+	}
+	m_vertexVersion.Clear();
+	m_vertexVersion.Append( 0, vertexCount );
+	m_vertexCluster.Clear();
+	m_vertexCluster.Append( 0, vertexCount );
+	ae::Array< uint32_t > verts = tag;
+	verts.Reserve( vertexCount );
+	for( uint32_t i = 0; i < vertexCount; i++ )
+	{
+		if( m_vertexHead[ i ] == _kMeshSimplifierNone )
+		{
+			m_vertexFlags[ i ] |= kVertexRemoved;
+		}
+		else
+		{
+			verts.Append( i );
+		}
+	}
+
+	uint32_t aliveCount = triCount;
+	const uint32_t targetCount = params.targetTriangleCount;
+	const uint32_t threadCount = ae::Clip( params.threadCount ? params.threadCount : ae::GetMaxConcurrentThreads(), 1u, kMaxThreads );
+	// Several clusters per thread balances clusters that finish early
+	const uint32_t clusterCount = threadCount * 4;
+	if( threadCount > 1 && aliveCount > targetCount && verts.Length() >= clusterCount * 64 )
+	{
+		// Split vertices into equally sized clusters along a Morton curve
+		ae::AABB bounds;
+		for( uint32_t v : verts )
+		{
+			bounds.Expand( m_positions[ v ] );
+		}
+		const ae::Vec3 boundsMin = bounds.GetMin();
+		const ae::Vec3 boundsSize = bounds.GetMax() - boundsMin;
+		const float maxSize = ae::Max( boundsSize.x, boundsSize.y, boundsSize.z );
+		const float scale = ( maxSize > 0.0f ) ? ( 1023.0f / maxSize ) : 0.0f;
+		ae::Array< uint64_t > order( tag, verts.Length() );
+		for( uint32_t v : verts )
+		{
+			const ae::Vec3 p = ( m_positions[ v ] - boundsMin ) * scale;
+			const uint32_t code = _MeshSimplifierSpreadBits( (uint32_t)p.x )
+				| ( _MeshSimplifierSpreadBits( (uint32_t)p.y ) << 1 )
+				| ( _MeshSimplifierSpreadBits( (uint32_t)p.z ) << 2 );
+			order.Append( ( (uint64_t)code << 32 ) | v );
+		}
+		std::sort( order.begin(), order.end() );
+		ae::Array< uint32_t > clusterVerts( tag, order.Length() );
+		for( uint32_t i = 0; i < order.Length(); i++ )
+		{
+			const uint32_t v = (uint32_t)order[ i ];
+			m_vertexCluster[ v ] = (uint32_t)( (uint64_t)i * clusterCount / order.Length() );
+			clusterVerts.Append( v );
+		}
+
+		// Vertices with neighbors in other clusters are locked, so each cluster
+		// only modifies triangles that no other cluster can reach
+		ae::Array< uint32_t > clusterTriCounts( tag, 0, clusterCount );
+		for( uint32_t i = 0; i < triCount; i++ )
+		{
+			const uint32_t* tri = &m_tris[ i * 3 ];
+			const uint32_t cluster = m_vertexCluster[ tri[ 0 ] ];
+			if( cluster == m_vertexCluster[ tri[ 1 ] ] && cluster == m_vertexCluster[ tri[ 2 ] ] )
+			{
+				clusterTriCounts[ cluster ]++;
+			}
+			else
+			{
+				m_vertexFlags[ tri[ 0 ] ] |= kVertexClusterBorder;
+				m_vertexFlags[ tri[ 1 ] ] |= kVertexClusterBorder;
+				m_vertexFlags[ tri[ 2 ] ] |= kVertexClusterBorder;
+			}
+		}
+
+		// Each cluster removes most of its share of the triangles, leaving the
+		// rest to the final pass so the last collapses are chosen globally
+		const uint64_t removeTotal = ( aliveCount - targetCount ) * 3 / 4;
+		std::atomic< uint32_t > nextCluster = { 0 };
+		std::atomic< uint32_t > removedCount = { 0 };
+		float threadErrors[ kMaxThreads ] = {};
+		const auto simplifyClusters = [ & ]( uint32_t threadIndex )
+		{
+			for( uint32_t cluster = nextCluster++; cluster < clusterCount; cluster = nextCluster++ )
+			{
+				const uint32_t begin = (uint32_t)( ( (uint64_t)cluster * clusterVerts.Length() + clusterCount - 1 ) / clusterCount );
+				const uint32_t end = (uint32_t)( ( (uint64_t)( cluster + 1 ) * clusterVerts.Length() + clusterCount - 1 ) / clusterCount );
+				float error = 0.0f;
+				bool errorLimit = false;
+				removedCount += m_Simplify( cluster, clusterVerts.Data() + begin, end - begin, (uint32_t)( removeTotal * clusterTriCounts[ cluster ] / aliveCount ), &error, &errorLimit );
+				threadErrors[ threadIndex ] = ae::Max( threadErrors[ threadIndex ], error );
+			}
+		};
+		std::thread threads[ kMaxThreads - 1 ];
+		for( uint32_t i = 1; i < threadCount; i++ )
+		{
+			threads[ i - 1 ] = std::thread( simplifyClusters, i );
+		}
+		simplifyClusters( 0 );
+		for( uint32_t i = 1; i < threadCount; i++ )
+		{
+			threads[ i - 1 ].join();
+			threadErrors[ 0 ] = ae::Max( threadErrors[ 0 ], threadErrors[ i ] );
+		}
+		aliveCount -= removedCount;
+		m_error = threadErrors[ 0 ];
+
+		verts.Clear();
+		for( uint32_t v : clusterVerts )
+		{
+			if( !( m_vertexFlags[ v ] & kVertexRemoved ) )
+			{
+				verts.Append( v );
+			}
+		}
+	}
+
+	// Finish with the whole mesh, including cluster borders
+	float error = 0.0f;
+	bool errorLimit = false;
+	aliveCount -= m_Simplify( kAllClusters, verts.Data(), verts.Length(), ( aliveCount > targetCount ) ? ( aliveCount - targetCount ) : 0, &error, &errorLimit );
+	m_error = ae::Max( m_error, error );
+
+	// Output the remaining triangles and the vertices they use
+	ae::Array< uint32_t > remap( tag, _kMeshSimplifierNone, vertexCount );
+	indices.Reserve( aliveCount * 3 );
+	for( uint32_t i = 0; i < triCount * 3; i++ )
+	{
+		if( !m_triAlive[ i / 3 ] )
+		{
+			continue;
+		}
+		const uint32_t v = m_tris[ i ];
+		if( remap[ v ] == _kMeshSimplifierNone )
+		{
+			remap[ v ] = positions.Length();
+			positions.Append( m_positions[ v ] );
+			if( attributeCount )
+			{
+				attributes.AppendArray( &m_attributes[ v * attributeCount ], attributeCount );
+			}
+		}
+		indices.Append( remap[ v ] );
+	}
+	return ( aliveCount <= targetCount ) || errorLimit;
+}
+
+bool MeshSimplifier::m_CanCollapse( uint32_t v, uint32_t cluster ) const
+{
+	const uint8_t flags = m_vertexFlags[ v ];
+	if( flags & kVertexRemoved )
+	{
+		return false;
+	}
+	return ( cluster == kAllClusters ) || ( m_vertexCluster[ v ] == cluster && !( flags & kVertexClusterBorder ) );
+}
+
+void MeshSimplifier::m_GetTriangles( uint32_t v, ae::Array< uint32_t >* trisOut )
+{
+	// Unlink the corners of removed triangles while walking the list
+	uint32_t prev = _kMeshSimplifierNone;
+	uint32_t corner = m_vertexHead[ v ];
+	while( corner != _kMeshSimplifierNone )
+	{
+		const uint32_t next = m_cornerNext[ corner ];
+		if( m_triAlive[ corner / 3 ] )
+		{
+			trisOut->Append( corner / 3 );
+			prev = corner;
+		}
+		else
+		{
+			if( prev == _kMeshSimplifierNone )
+			{
+				m_vertexHead[ v ] = next;
+			}
+			else
+			{
+				m_cornerNext[ prev ] = next;
+			}
+			if( m_vertexTail[ v ] == corner )
+			{
+				m_vertexTail[ v ] = prev;
+			}
+		}
+		corner = next;
+	}
+}
+
+float MeshSimplifier::m_GetError( uint32_t remove, uint32_t keep, ae::Vec3* positionOut, float* tOut ) const
+{
+	Quadric quadric = m_quadrics[ remove ];
+	quadric += m_quadrics[ keep ];
+	const ae::Vec3 a = m_positions[ remove ];
+	const ae::Vec3 b = m_positions[ keep ];
+	const ae::Vec3 mid = ( a + b ) * 0.5f;
+	const float edgeLengthSq = ( b - a ).LengthSquared();
+
+	ae::Vec3 position = mid;
+	double cost = quadric.Evaluate( mid );
+	const ae::Vec3 candidates[] = { a, b };
+	for( ae::Vec3 candidate : candidates )
+	{
+		const double candidateCost = quadric.Evaluate( candidate );
+		if( candidateCost < cost )
+		{
+			position = candidate;
+			cost = candidateCost;
+		}
+	}
+	// Use the position that minimizes the quadric when it's well defined (eg.
+	// not on a flat area) and doesn't leave the neighborhood of the edge
+	const double* q = quadric.q;
+	const double i00 = q[ 4 ] * q[ 7 ] - q[ 5 ] * q[ 5 ];
+	const double i01 = q[ 2 ] * q[ 5 ] - q[ 1 ] * q[ 7 ];
+	const double i02 = q[ 1 ] * q[ 5 ] - q[ 2 ] * q[ 4 ];
+	const double det = q[ 0 ] * i00 + q[ 1 ] * i01 + q[ 2 ] * i02;
+	const double trace = q[ 0 ] + q[ 4 ] + q[ 7 ];
+	if( trace > 0.0 && std::abs( det ) > 1e-6 * trace * trace * trace )
+	{
+		const double i11 = q[ 0 ] * q[ 7 ] - q[ 2 ] * q[ 2 ];
+		const double i12 = q[ 1 ] * q[ 2 ] - q[ 0 ] * q[ 5 ];
+		const double i22 = q[ 0 ] * q[ 4 ] - q[ 1 ] * q[ 1 ];
+		const double r0 = -q[ 3 ];
+		const double r1 = -q[ 6 ];
+		const double r2 = -q[ 8 ];
+		const ae::Vec3 optimal(
+			(float)( ( i00 * r0 + i01 * r1 + i02 * r2 ) / det ),
+			(float)( ( i01 * r0 + i11 * r1 + i12 * r2 ) / det ),
+			(float)( ( i02 * r0 + i12 * r1 + i22 * r2 ) / det )
+		);
+		if( ( optimal - mid ).LengthSquared() <= edgeLengthSq )
+		{
+			const double optimalCost = quadric.Evaluate( optimal );
+			if( optimalCost < cost )
+			{
+				position = optimal;
+				cost = optimalCost;
+			}
+		}
+	}
+	if( quadric.area > 0.0 )
+	{
+		cost /= quadric.area;
+	}
+
+	const uint32_t attributeCount = m_params.vertexAttributeCount;
+	if( attributeCount )
+	{
+		const float* removeAttributes = &m_attributes[ remove * attributeCount ];
+		const float* keepAttributes = &m_attributes[ keep * attributeCount ];
+		double attributeCost = 0.0;
+		for( uint32_t i = 0; i < attributeCount; i++ )
+		{
+			const double diff = keepAttributes[ i ] - removeAttributes[ i ];
+			attributeCost += diff * diff;
+		}
+		cost += attributeCost * m_params.attributeWeight;
+	}
+
+	if( positionOut )
+	{
+		*positionOut = position;
+	}
+	if( tOut )
+	{
+		*tOut = ( edgeLengthSq > 0.0f ) ? ae::Clip01( ( position - a ).Dot( b - a ) / edgeLengthSq ) : 0.5f;
+	}
+	return (float)std::sqrt( cost );
+}
+
+uint32_t MeshSimplifier::m_Collapse( uint32_t remove, uint32_t keep, ae::Vec3 position, float t, ae::Array< uint32_t >* scratch )
+{
+	scratch->Clear();
+	m_GetTriangles( remove, scratch );
+	const uint32_t removeTriCount = scratch->Length();
+	m_GetTriangles( keep, scratch );
+	const uint32_t* removeTris = scratch->Data();
+	const uint32_t* keepTris = removeTris + removeTriCount;
+	const uint32_t keepTriCount = scratch->Length() - removeTriCount;
+	const auto contains = []( const uint32_t* tri, uint32_t v )
+	{
+		return tri[ 0 ] == v || tri[ 1 ] == v || tri[ 2 ] == v;
+	};
+
+	// Find the triangles on the edge and their third vertices
+	uint32_t sharedCount = 0;
+	uint32_t opposite[ 2 ];
+	for( uint32_t i = 0; i < removeTriCount; i++ )
+	{
+		const uint32_t* tri = &m_tris[ removeTris[ i ] * 3 ];
+		if( contains( tri, keep ) )
+		{
+			if( sharedCount == 2 )
+			{
+				return 0; // Non-manifold edge
+			}
+			opposite[ sharedCount++ ] = tri[ 0 ] ^ tri[ 1 ] ^ tri[ 2 ] ^ remove ^ keep;
+		}
+	}
+	if( !sharedCount )
+	{
+		return 0;
+	}
+	// Two boundary vertices can only be joined along a boundary edge, otherwise
+	// the mesh would be pinched together
+	if( ( m_vertexFlags[ remove ] & kVertexBoundary ) && ( m_vertexFlags[ keep ] & kVertexBoundary ) && sharedCount != 1 )
+	{
+		return 0;
+	}
+	// The only neighbors the vertices can share are the third vertices of the
+	// edge triangles, otherwise the collapse would fold the surface
+	for( uint32_t i = 0; i < removeTriCount; i++ )
+	{
+		const uint32_t* tri = &m_tris[ removeTris[ i ] * 3 ];
+		if( contains( tri, keep ) )
+		{
+			continue;
+		}
+		for( uint32_t j = 0; j < 3; j++ )
+		{
+			const uint32_t n = tri[ j ];
+			if( n == remove || n == opposite[ 0 ] || ( sharedCount == 2 && n == opposite[ 1 ] ) )
+			{
+				continue;
+			}
+			for( uint32_t k = 0; k < keepTriCount; k++ )
+			{
+				if( contains( &m_tris[ keepTris[ k ] * 3 ], n ) )
 				{
-					__m128 p128 = _mm_load_ps( (float*)( p + i ) );
-					c128 = _mm_add_ps( c128, p128 );
+					return 0;
 				}
-				__m128 div = _mm_set1_ps( 1.0f / ec );
-				c128 = _mm_mul_ps( c128, div );
-	
-				for( uint32_t i = 0; i < 10; i++ )
+			}
+		}
+	}
+	// Don't allow any triangle to flip over
+	const auto flips = [ this, position ]( uint32_t triIndex, uint32_t moved )
+	{
+		const uint32_t* tri = &m_tris[ triIndex * 3 ];
+		ae::Vec3 p[ 3 ] = { m_positions[ tri[ 0 ] ], m_positions[ tri[ 1 ] ], m_positions[ tri[ 2 ] ] };
+		const ae::Vec3 before = ( p[ 1 ] - p[ 0 ] ).Cross( p[ 2 ] - p[ 0 ] );
+		p[ ( tri[ 0 ] == moved ) ? 0 : ( ( tri[ 1 ] == moved ) ? 1 : 2 ) ] = position;
+		const ae::Vec3 after = ( p[ 1 ] - p[ 0 ] ).Cross( p[ 2 ] - p[ 0 ] );
+		return before.LengthSquared() > 0.0f && before.Dot( after ) <= 0.0f;
+	};
+	for( uint32_t i = 0; i < removeTriCount; i++ )
+	{
+		if( !contains( &m_tris[ removeTris[ i ] * 3 ], keep ) && flips( removeTris[ i ], remove ) )
+		{
+			return 0;
+		}
+	}
+	for( uint32_t i = 0; i < keepTriCount; i++ )
+	{
+		if( !contains( &m_tris[ keepTris[ i ] * 3 ], remove ) && flips( keepTris[ i ], keep ) )
+		{
+			return 0;
+		}
+	}
+
+	// Apply the collapse
+	for( uint32_t i = 0; i < removeTriCount; i++ )
+	{
+		uint32_t* tri = &m_tris[ removeTris[ i ] * 3 ];
+		if( contains( tri, keep ) )
+		{
+			m_triAlive[ removeTris[ i ] ] = 0;
+		}
+		else
+		{
+			for( uint32_t j = 0; j < 3; j++ )
+			{
+				if( tri[ j ] == remove )
 				{
-					for( uint32_t j = 0; j < ec; j++ )
-					{
-						__m128 p128 = _mm_load_ps( (float*)( p + j ) );
-						p128 = _mm_sub_ps( p128, c128 );
-						__m128 n128 = _mm_load_ps( (float*)( n + j ) );
-	
-						__m128 d = _mm_mul_ps( p128, n128 );
-						d = _mm_hadd_ps( d, d );
-						d = _mm_hadd_ps( d, d );
-	
-						__m128 s = _mm_set1_ps( 0.5f );
-						s = _mm_mul_ps( s, n128 );
-						s = _mm_mul_ps( s, d );
-						c128 = _mm_add_ps( c128, s );
-					}
+					tri[ j ] = keep;
 				}
-				_mm_store_ps( (float*)&position, c128 );
-#elif defined(__ARM_NEON__) || defined(__ARM_NEON)
-				float32x4_t c128 = vdupq_n_f32( 0.0f );
-				for( uint32_t i = 0; i < ec; i++ )
+			}
+		}
+	}
+	m_positions[ keep ] = position;
+	const uint32_t attributeCount = m_params.vertexAttributeCount;
+	for( uint32_t i = 0; i < attributeCount; i++ )
+	{
+		float* keepAttribute = &m_attributes[ keep * attributeCount + i ];
+		*keepAttribute = ae::Lerp( m_attributes[ remove * attributeCount + i ], *keepAttribute, t );
+	}
+	m_quadrics[ keep ] += m_quadrics[ remove ];
+	m_vertexFlags[ keep ] |= ( m_vertexFlags[ remove ] & kVertexBoundary );
+	m_vertexFlags[ remove ] |= kVertexRemoved;
+	m_vertexVersion[ remove ]++;
+	m_vertexVersion[ keep ]++;
+	// Move the corners of the removed vertex to the kept vertex. Corners of the
+	// removed triangles are unlinked later by m_GetTriangles().
+	if( m_vertexHead[ remove ] != _kMeshSimplifierNone )
+	{
+		m_cornerNext[ m_vertexTail[ keep ] ] = m_vertexHead[ remove ];
+		m_vertexTail[ keep ] = m_vertexTail[ remove ];
+		m_vertexHead[ remove ] = _kMeshSimplifierNone;
+		m_vertexTail[ remove ] = _kMeshSimplifierNone;
+	}
+	return sharedCount;
+}
+
+void MeshSimplifier::m_PushCollapses( uint32_t v, uint32_t cluster, bool allNeighbors, ae::Array< Collapse >* heap, ae::Array< uint32_t >* scratch )
+{
+	const auto compare = []( const Collapse& a, const Collapse& b ) { return a.error > b.error; };
+	scratch->Clear();
+	m_GetTriangles( v, scratch );
+	const uint32_t triCount = scratch->Length();
+	for( uint32_t i = 0; i < triCount; i++ )
+	{
+		for( uint32_t j = 0; j < 3; j++ )
+		{
+			// Neighbors are stored after the triangles to skip duplicates
+			const uint32_t n = m_tris[ (*scratch)[ i ] * 3 + j ];
+			if( n == v || ( !allNeighbors && n < v ) )
+			{
+				continue;
+			}
+			bool seen = false;
+			for( uint32_t k = triCount; k < scratch->Length() && !seen; k++ )
+			{
+				seen = ( (*scratch)[ k ] == n );
+			}
+			if( seen )
+			{
+				continue;
+			}
+			scratch->Append( n );
+			if( !m_CanCollapse( n, cluster ) )
+			{
+				continue;
+			}
+			Collapse collapse;
+			collapse.error = m_GetError( v, n, nullptr, nullptr );
+			collapse.remove = v;
+			collapse.keep = n;
+			collapse.removeVersion = m_vertexVersion[ v ];
+			collapse.keepVersion = m_vertexVersion[ n ];
+			heap->Append( collapse );
+			std::push_heap( heap->begin(), heap->end(), compare );
+		}
+	}
+}
+
+uint32_t MeshSimplifier::m_Simplify( uint32_t cluster, const uint32_t* verts, uint32_t vertCount, uint32_t removeCount, float* errorOut, bool* errorLimitOut )
+{
+	*errorOut = 0.0f;
+	*errorLimitOut = false;
+	if( !removeCount )
+	{
+		return 0;
+	}
+	const auto compare = []( const Collapse& a, const Collapse& b ) { return a.error > b.error; };
+	ae::Array< Collapse > heap = positions.Tag();
+	ae::Array< uint32_t > scratch = positions.Tag();
+	for( uint32_t i = 0; i < vertCount; i++ )
+	{
+		if( m_CanCollapse( verts[ i ], cluster ) )
+		{
+			m_PushCollapses( verts[ i ], cluster, false, &heap, &scratch );
+		}
+	}
+
+	uint32_t removedCount = 0;
+	while( removedCount < removeCount && heap.Length() )
+	{
+		std::pop_heap( heap.begin(), heap.end(), compare );
+		const Collapse collapse = heap[ heap.Length() - 1 ];
+		heap.Remove( heap.Length() - 1 );
+		if( collapse.removeVersion != m_vertexVersion[ collapse.remove ] || collapse.keepVersion != m_vertexVersion[ collapse.keep ] )
+		{
+			continue; // One of the vertices changed since this was queued
+		}
+		if( collapse.error > m_params.maxError )
+		{
+			*errorLimitOut = true;
+			break;
+		}
+		ae::Vec3 position;
+		float t;
+		m_GetError( collapse.remove, collapse.keep, &position, &t );
+		const uint32_t count = m_Collapse( collapse.remove, collapse.keep, position, t, &scratch );
+		if( count )
+		{
+			removedCount += count;
+			*errorOut = ae::Max( *errorOut, collapse.error );
+			m_PushCollapses( collapse.keep, cluster, true, &heap, &scratch );
+		}
+	}
+	return removedCount;
+}
+
+//------------------------------------------------------------------------------
+// ae::WeldVertices, ae::OptimizeVertexCache, ae::OptimizeOverdraw, and ae::GetVertexFetchRemap
+//------------------------------------------------------------------------------
+static uint32_t _GetMeshIndex( const void* indices, uint32_t indexSize, uint32_t i )
+{
+	return ( indexSize == 2 ) ? ( (const uint16_t*)indices )[ i ] : ( (const uint32_t*)indices )[ i ];
+}
+
+static void _SetMeshIndex( void* indices, uint32_t indexSize, uint32_t i, uint32_t index )
+{
+	if( indexSize == 2 )
+	{
+		AE_ASSERT_MSG( index <= 0xFFFF, "Index # does not fit in 16 bits", index );
+		( (uint16_t*)indices )[ i ] = (uint16_t)index;
+	}
+	else
+	{
+		( (uint32_t*)indices )[ i ] = index;
+	}
+}
+
+static void _CheckMeshIndices( const void* indices, uint32_t indexCount, uint32_t indexSize, uint32_t vertexCount )
+{
+	AE_ASSERT_MSG( indexSize == 2 || indexSize == 4, "Invalid index size #", indexSize );
+	AE_ASSERT_MSG( indexCount % 3 == 0, "Index count # is not a multiple of 3", indexCount );
+	AE_ASSERT( indices || !indexCount );
+	for( uint32_t i = 0; i < indexCount; i++ )
+	{
+		AE_ASSERT_MSG( _GetMeshIndex( indices, indexSize, i ) < vertexCount, "Index # is out of range (vertex count #)", _GetMeshIndex( indices, indexSize, i ), vertexCount );
+	}
+}
+
+//! Per vertex lists of the triangles that use them
+struct _MeshAdjacency
+{
+	_MeshAdjacency( const void* indices, uint32_t indexCount, uint32_t indexSize, uint32_t vertexCount ) :
+		offsets( AE_ALLOC_TAG_MESH, 0, vertexCount + 1 ),
+		triangles( AE_ALLOC_TAG_MESH, 0, indexCount )
+	{
+		for( uint32_t i = 0; i < indexCount; i++ )
+		{
+			offsets[ _GetMeshIndex( indices, indexSize, i ) + 1 ]++;
+		}
+		for( uint32_t i = 0; i < vertexCount; i++ )
+		{
+			offsets[ i + 1 ] += offsets[ i ];
+		}
+		ae::Array< uint32_t > counts( AE_ALLOC_TAG_MESH, 0, vertexCount );
+		for( uint32_t i = 0; i < indexCount; i++ )
+		{
+			const uint32_t v = _GetMeshIndex( indices, indexSize, i );
+			triangles[ offsets[ v ] + counts[ v ]++ ] = i / 3;
+		}
+	}
+	ae::Array< uint32_t > offsets;
+	ae::Array< uint32_t > triangles;
+};
+
+uint32_t WeldVertices( const float* positions, uint32_t positionStride, uint32_t vertexCount, float tolerance, uint32_t* remapOut, const float* attributes, uint32_t attributeStride, uint32_t attributeCount )
+{
+	AE_ASSERT_MSG( positionStride >= sizeof(float) * 3, "Invalid position stride #", positionStride );
+	AE_ASSERT_MSG( !attributeCount || ( attributes && attributeStride >= sizeof(float) * attributeCount ), "Invalid vertex attributes" );
+	AE_ASSERT( remapOut || !vertexCount );
+	tolerance = ae::Max( tolerance, 0.0f );
+	const auto getPosition = [ positions, positionStride ]( uint32_t i )
+	{
+		const float* p = (const float*)( (const uint8_t*)positions + i * positionStride );
+		return ae::Vec3( p[ 0 ], p[ 1 ], p[ 2 ] );
+	};
+	// Vertices are stored in a grid of cells twice the size of the tolerance,
+	// so each vertex only needs to search the (up to 8) cells it overlaps
+	const double cellSize = ( tolerance > 0.0f ) ? tolerance * 2.0 : 1.0;
+	const auto getCellKey = []( int64_t x, int64_t y, int64_t z ) -> uint64_t
+	{
+		return (uint64_t)x * 73856093ull ^ (uint64_t)y * 19349663ull ^ (uint64_t)z * 83492791ull;
+	};
+	ae::Map< uint64_t, uint32_t > cells = AE_ALLOC_TAG_MESH;
+	ae::Array< uint32_t > next( AE_ALLOC_TAG_MESH, ~0u, vertexCount );
+	uint32_t uniqueCount = 0;
+	for( uint32_t i = 0; i < vertexCount; i++ )
+	{
+		const ae::Vec3 p = getPosition( i );
+		const float* attribs = attributeCount ? (const float*)( (const uint8_t*)attributes + i * attributeStride ) : nullptr;
+		int64_t cellMin[ 3 ];
+		int64_t cellMax[ 3 ];
+		for( uint32_t j = 0; j < 3; j++ )
+		{
+			cellMin[ j ] = (int64_t)std::floor( ( p[ j ] - tolerance ) / cellSize );
+			cellMax[ j ] = (int64_t)std::floor( ( p[ j ] + tolerance ) / cellSize );
+		}
+		uint32_t match = ~0u;
+		for( int64_t z = cellMin[ 2 ]; z <= cellMax[ 2 ] && match == ~0u; z++ )
+		for( int64_t y = cellMin[ 1 ]; y <= cellMax[ 1 ] && match == ~0u; y++ )
+		for( int64_t x = cellMin[ 0 ]; x <= cellMax[ 0 ] && match == ~0u; x++ )
+		{
+			const uint32_t* head = cells.TryGet( getCellKey( x, y, z ) );
+			for( uint32_t other = head ? *head : ~0u; other != ~0u; other = next[ other ] )
+			{
+				if( ( getPosition( other ) - p ).LengthSquared() > tolerance * tolerance )
 				{
-					const float32x4_t p128 = vld1q_f32( (float*)( p + i ) );
-					c128 = vaddq_f32( c128, p128 );
+					continue;
 				}
-				float32x4_t div = vdupq_n_f32( 1.0f / ec );
-				c128 = vmulq_f32( c128, div );
-	
-				for( uint32_t i = 0; i < 10; i++ )
+				bool attributesMatch = true;
+				if( attribs )
 				{
-					for( uint32_t j = 0; j < ec; j++ )
+					const float* otherAttribs = (const float*)( (const uint8_t*)attributes + other * attributeStride );
+					for( uint32_t j = 0; j < attributeCount && attributesMatch; j++ )
 					{
-						float32x4_t p128 = vld1q_f32( (float*)( p + j ) );
-						p128 = vsubq_f32( p128, c128 );
-						const float32x4_t n128 = vld1q_f32( (float*)( n + j ) );
-	
-						// Dot product (p128 . n128)
-						const float32x4_t d = vmulq_f32( p128, n128 );
-						const float32x2_t d_low = vget_low_f32( d );
-						const float32x2_t d_high = vget_high_f32( d );
-						const float32x2_t sum = vpadd_f32( d_low, d_high );
-						const float32_t dot = vget_lane_f32( sum, 0 ) + vget_lane_f32( sum, 1 );
-	
-						const float32x4_t s = vmulq_n_f32( n128, 0.5f * dot );
-						c128 = vaddq_f32( c128, s );
+						attributesMatch = ( std::abs( otherAttribs[ j ] - attribs[ j ] ) <= tolerance );
 					}
 				}
-				vst1q_f32( (float*)&position, c128 );
-#else
-				position = ae::Vec3( 0.0f );
-				for( uint32_t i = 0; i < ec; i++ )
-				{
-					position += p[ i ];
-				}
-				position /= ec;
-				for( uint32_t i = 0; i < 10; i++ )
+				if( attributesMatch )
 				{
-					for( uint32_t j = 0; j < ec; j++ )
-					{
-						float d = n[ j ].Dot( p[ j ] - position );
-						position += n[ j ] * ( d * 0.5f );
-					}
+					match = other;
+					break;
 				}
-#endif
-				AE_DEBUG_ASSERT( position.x == position.x && position.y == position.y && position.z == position.z );
-				// @NOTE: Bias towards average of intersection points. This solves some intersecting triangles on sharp edges.
-				// Based on notes here: https://www.boristhebrave.com/2018/04/15/dual-contouring-tutorial/
-				ae::Vec3 averagePos( 0.0f );
-				for( int32_t i = 0; i < ec; i++ )
+			}
+		}
+		if( match != ~0u )
+		{
+			remapOut[ i ] = remapOut[ match ];
+		}
+		else
+		{
+			const uint64_t key = getCellKey( (int64_t)std::floor( p.x / cellSize ), (int64_t)std::floor( p.y / cellSize ), (int64_t)std::floor( p.z / cellSize ) );
+			uint32_t* head = cells.TryGet( key );
+			if( head )
+			{
+				next[ i ] = *head;
+				*head = i;
+			}
+			else
+			{
+				cells.Set( key, i );
+			}
+			remapOut[ i ] = uniqueCount++;
+		}
+	}
+	return uniqueCount;
+}
+
+void RemapVertices( const void* vertices, uint32_t vertexSize, uint32_t vertexCount, const uint32_t* remap, void* verticesOut )
+{
+	ae::Array< uint8_t > copy = AE_ALLOC_TAG_MESH;
+	if( vertices == verticesOut )
+	{
+		copy.AppendArray( (const uint8_t*)vertices, vertexSize * vertexCount );
+		vertices = copy.Data();
+	}
+	for( uint32_t i = 0; i < vertexCount; i++ )
+	{
+		if( remap[ i ] != ~0u )
+		{
+			memcpy( (uint8_t*)verticesOut + remap[ i ] * vertexSize, (const uint8_t*)vertices + i * vertexSize, vertexSize );
+		}
+	}
+}
+
+void RemapIndices( void* indices, uint32_t indexCount, uint32_t indexSize, const uint32_t* remap )
+{
+	AE_ASSERT_MSG( indexSize == 2 || indexSize == 4, "Invalid index size #", indexSize );
+	for( uint32_t i = 0; i < indexCount; i++ )
+	{
+		const uint32_t index = remap[ _GetMeshIndex( indices, indexSize, i ) ];
+		AE_ASSERT_MSG( index != ~0u, "Index # was removed by the remap", _GetMeshIndex( indices, indexSize, i ) );
+		_SetMeshIndex( indices, indexSize, i, index );
+	}
+}
+
+void OptimizeVertexCache( void* indices, uint32_t indexCount, uint32_t indexSize, uint32_t vertexCount, uint32_t cacheSize )
+{
+	_CheckMeshIndices( indices, indexCount, indexSize, vertexCount );
+	AE_ASSERT_MSG( cacheSize >= 3, "Invalid vertex cache size #", cacheSize );
+	const uint32_t triCount = indexCount / 3;
+	if( !triCount )
+	{
+		return;
+	}
+	const _MeshAdjacency adjacency( indices, indexCount, indexSize, vertexCount );
+	ae::Array< uint32_t > liveCounts( AE_ALLOC_TAG_MESH, vertexCount );
+	for( uint32_t i = 0; i < vertexCount; i++ )
+	{
+		liveCounts.Append( adjacency.offsets[ i + 1 ] - adjacency.offsets[ i ] );
+	}
+	ae::Array< uint32_t > cacheTimes( AE_ALLOC_TAG_MESH, 0, vertexCount );
+	ae::Array< uint8_t > emitted( AE_ALLOC_TAG_MESH, 0, triCount );
+	ae::Array< uint32_t > deadEnds( AE_ALLOC_TAG_MESH, indexCount );
+	ae::Array< uint32_t > candidates = AE_ALLOC_TAG_MESH;
+	ae::Array< uint32_t > result( AE_ALLOC_TAG_MESH, indexCount );
+	uint32_t time = cacheSize + 1;
+	uint32_t cursor = 0;
+	uint32_t fanning = ~0u;
+	while( true )
+	{
+		if( fanning == ~0u )
+		{
+			// Dead end, continue from a recently used vertex or the next vertex
+			// in the input order with remaining triangles
+			while( deadEnds.Length() && fanning == ~0u )
+			{
+				const uint32_t v = deadEnds[ deadEnds.Length() - 1 ];
+				deadEnds.Remove( deadEnds.Length() - 1 );
+				fanning = liveCounts[ v ] ? v : ~0u;
+			}
+			while( cursor < vertexCount && fanning == ~0u )
+			{
+				fanning = liveCounts[ cursor ] ? cursor : ~0u;
+				cursor++;
+			}
+			if( fanning == ~0u )
+			{
+				break;
+			}
+		}
+
+		// Emit all remaining triangles around the fanning vertex
+		candidates.Clear();
+		for( uint32_t i = adjacency.offsets[ fanning ]; i < adjacency.offsets[ fanning + 1 ]; i++ )
+		{
+			const uint32_t tri = adjacency.triangles[ i ];
+			if( emitted[ tri ] )
+			{
+				continue;
+			}
+			emitted[ tri ] = 1;
+			for( uint32_t j = 0; j < 3; j++ )
+			{
+				const uint32_t v = _GetMeshIndex( indices, indexSize, tri * 3 + j );
+				result.Append( v );
+				deadEnds.Append( v );
+				candidates.Append( v );
+				liveCounts[ v ]--;
+				if( time - cacheTimes[ v ] > cacheSize )
 				{
-					averagePos += p[ i ];
+					cacheTimes[ v ] = time++;
 				}
-				averagePos /= (float)ec;
-				position = ae::Lerp( position, averagePos, 0.1f ); // @TODO: This bias should be removed or be adjustable
 			}
+		}
 
-			// Use the average edge normals for the vertex normal
-			vertex.normal = ae::Vec3( 0.0f );
-			for( int32_t j = 0; j < ec; j++ )
+		// Fan next around the candidate that will still be in the cache after
+		// emitting its remaining triangles, preferring the oldest
+		fanning = ~0u;
+		int32_t bestPriority = -1;
+		for( uint32_t v : candidates )
+		{
+			if( !liveCounts[ v ] )
 			{
-				vertex.normal += n[ j ];
+				continue;
+			}
+			int32_t priority = 0;
+			if( time - cacheTimes[ v ] + 2 * liveCounts[ v ] <= cacheSize )
+			{
+				priority = time - cacheTimes[ v ];
+			}
+			if( priority > bestPriority )
+			{
+				bestPriority = priority;
+				fanning = v;
 			}
-			vertex.normal.SafeNormalize();
 		}
-		else
+	}
+	AE_ASSERT( result.Length() == indexCount );
+	for( uint32_t i = 0; i < indexCount; i++ )
+	{
+		_SetMeshIndex( indices, indexSize, i, result[ i ] );
+	}
+}
+
+void OptimizeOverdraw( void* indices, uint32_t indexCount, uint32_t indexSize, const float* positions, uint32_t positionStride, uint32_t vertexCount, uint32_t cacheSize )
+{
+	_CheckMeshIndices( indices, indexCount, indexSize, vertexCount );
+	AE_ASSERT_MSG( positionStride >= sizeof(float) * 3, "Invalid position stride #", positionStride );
+	const uint32_t triCount = indexCount / 3;
+	if( triCount < 2 )
+	{
+		return;
+	}
+	const auto getPosition = [ & ]( uint32_t i )
+	{
+		const float* p = (const float*)( (const uint8_t*)positions + _GetMeshIndex( indices, indexSize, i ) * positionStride );
+		return ae::Vec3( p[ 0 ], p[ 1 ], p[ 2 ] );
+	};
+
+	// Split triangles into clusters wherever the cache is flushed, ie. when a
+	// triangle misses on all of its vertices
+	struct Cluster
+	{
+		uint32_t begin;
+		uint32_t end;
+		float score;
+	};
+	ae::Array< Cluster > clusters = AE_ALLOC_TAG_MESH;
+	ae::Array< uint32_t > cacheTimes( AE_ALLOC_TAG_MESH, 0, vertexCount );
+	uint32_t time = cacheSize + 1;
+	for( uint32_t i = 0; i < triCount; i++ )
+	{
+		uint32_t missCount = 0;
+		for( uint32_t j = 0; j < 3; j++ )
 		{
-			position = ae::Vec3( 0.0f );
-			for( int32_t i = 0; i < ec; i++ )
+			const uint32_t v = _GetMeshIndex( indices, indexSize, i * 3 + j );
+			if( time - cacheTimes[ v ] > cacheSize )
 			{
-				position += p[ i ];
+				cacheTimes[ v ] = time++;
+				missCount++;
 			}
-			position /= (float)ec;
-
-			// Calculate the normal from the 8 dual corner samples
-			const float cornerSamples[ 8 ] =
-			{
-				m_DualSample( ae::Int3( x, y, z ) ).distance, // 0, left, back, bottom
-				m_DualSample( ae::Int3( x + 1, y, z ) ).distance, // 1, right, back, bottom
-				m_DualSample( ae::Int3( x, y + 1, z ) ).distance, // 2, left, front, bottom
-				m_DualSample( ae::Int3( x + 1, y + 1, z ) ).distance, // 3, right, front, bottom
-				m_DualSample( ae::Int3( x, y, z + 1 ) ).distance, // 4, left, back, top
-				m_DualSample( ae::Int3( x + 1, y, z + 1 ) ).distance, // 5, right, back, top
-				m_DualSample( ae::Int3( x, y + 1, z + 1 ) ).distance, // 6, left, front, top
-				m_DualSample( ae::Int3( x + 1, y + 1, z + 1 ) ).distance // 7, right, front, top
-			};
-			vertex.normal = ae::Vec3( 0.0f );
-			vertex.normal.x += ( cornerSamples[ 1 ] - cornerSamples[ 0 ] ); // back, bottom
-			vertex.normal.x += ( cornerSamples[ 3 ] - cornerSamples[ 2 ] ); // front, bottom
-			vertex.normal.x += ( cornerSamples[ 5 ] - cornerSamples[ 4 ] ); // back, top
-			vertex.normal.x += ( cornerSamples[ 7 ] - cornerSamples[ 6 ] ); // front, top
-			vertex.normal.y += ( cornerSamples[ 2 ] - cornerSamples[ 0 ] ); // left, bottom
-			vertex.normal.y += ( cornerSamples[ 3 ] - cornerSamples[ 1 ] ); // right, bottom
-			vertex.normal.y += ( cornerSamples[ 6 ] - cornerSamples[ 4 ] ); // left, top
-			vertex.normal.y += ( cornerSamples[ 7 ] - cornerSamples[ 5 ] ); // right, top
-			vertex.normal.z += ( cornerSamples[ 4 ] - cornerSamples[ 0 ] ); // left, back
-			vertex.normal.z += ( cornerSamples[ 5 ] - cornerSamples[ 1 ] ); // right, back
-			vertex.normal.z += ( cornerSamples[ 6 ] - cornerSamples[ 2 ] ); // left, front
-			vertex.normal.z += ( cornerSamples[ 7 ] - cornerSamples[ 3 ] ); // right, front
-			vertex.normal.SafeNormalize();
-		}
-		// @NOTE: Do not clamp position values to voxel boundary. It's valid for a vertex to be placed
-		// outside of the voxel is was generated from. This happens when a voxel has all corners inside
-		// or outside of the sdf boundary, while also still having intersections (normally two per edge)
-		// on one or more edges of the voxel.
-		position.x = x + position.x;
-		position.y = y + position.y;
-		position.z = z + position.z;
-		vertex.position = ae::Vec4( position, 1.0f );
+		}
+		if( !i || missCount == 3 )
+		{
+			clusters.Append( { i, i + 1, 0.0f } );
+		}
+		else
+		{
+			clusters[ clusters.Length() - 1 ].end = i + 1;
+		}
+	}
+	if( clusters.Length() < 2 )
+	{
+		return;
+	}
 
-		m_status.meshProgress01 += 1.0f / (float)vertices.Length();
-		if( !m_UpdateStatus() )
+	// Clusters pointing away from the center of the mesh are more likely to
+	// occlude other parts of the mesh, so they're drawn first
+	ae::Vec3 meshCenter( 0.0f );
+	float meshArea = 0.0f;
+	ae::Array< ae::Vec3 > clusterCenters = AE_ALLOC_TAG_MESH;
+	ae::Array< ae::Vec3 > clusterNormals = AE_ALLOC_TAG_MESH;
+	for( const Cluster& cluster : clusters )
+	{
+		ae::Vec3 center( 0.0f );
+		ae::Vec3 normal( 0.0f );
+		float area = 0.0f;
+		for( uint32_t i = cluster.begin; i < cluster.end; i++ )
 		{
-			vertices.Clear();
-			indices.Clear();
-			return false;
+			const ae::Vec3 p0 = getPosition( i * 3 );
+			const ae::Vec3 p1 = getPosition( i * 3 + 1 );
+			const ae::Vec3 p2 = getPosition( i * 3 + 2 );
+			const ae::Vec3 triNormal = ( p1 - p0 ).Cross( p2 - p0 );
+			const float triArea = triNormal.Length();
+			center += ( p0 + p1 + p2 ) * ( triArea / 3.0f );
+			normal += triNormal;
+			area += triArea;
 		}
+		meshCenter += center;
+		meshArea += area;
+		clusterCenters.Append( ( area > 0.0f ) ? center / area : getPosition( cluster.begin * 3 ) );
+		clusterNormals.Append( normal.SafeNormalizeCopy() );
+	}
+	meshCenter = ( meshArea > 0.0f ) ? meshCenter / meshArea : clusterCenters[ 0 ];
+	for( uint32_t i = 0; i < clusters.Length(); i++ )
+	{
+		clusters[ i ].score = ( clusterCenters[ i ] - meshCenter ).Dot( clusterNormals[ i ] );
 	}
+	std::stable_sort( clusters.begin(), clusters.end(), []( const Cluster& a, const Cluster& b ) { return a.score > b.score; } );
 
-	AE_DEBUG_ASSERT( vertices.Length() <= m_params.maxVerts );
-	AE_DEBUG_ASSERT( indices.Length() <= m_params.maxIndices );
-	m_status.meshProgress01 = 1.0f;
-	if( !m_UpdateStatus() )
+	ae::Array< uint32_t > result( AE_ALLOC_TAG_MESH, indexCount );
+	for( const Cluster& cluster : clusters )
 	{
-		vertices.Clear();
-		indices.Clear();
-		return false;
+		for( uint32_t i = cluster.begin * 3; i < cluster.end * 3; i++ )
+		{
+			result.Append( _GetMeshIndex( indices, indexSize, i ) );
+		}
 	}
-	return true;
+	for( uint32_t i = 0; i < indexCount; i++ )
+	{
+		_SetMeshIndex( indices, indexSize, i, result[ i ] );
+	}
+}
+
+uint32_t GetVertexFetchRemap( const void* indices, uint32_t indexCount, uint32_t indexSize, uint32_t vertexCount, uint32_t* remapOut )
+{
+	_CheckMeshIndices( indices, indexCount, indexSize, vertexCount );
+	for( uint32_t i = 0; i < vertexCount; i++ )
+	{
+		remapOut[ i ] = ~0u;
+	}
+	uint32_t usedCount = 0;
+	for( uint32_t i = 0; i < indexCount; i++ )
+	{
+		uint32_t* remap = &remapOut[ _GetMeshIndex( indices, indexSize, i ) ];
+		if( *remap == ~0u )
+		{
+			*remap = usedCount++;
+		}
+	}
+	return usedCount;
+}
+
+float GetVertexCacheMissRatio( const void* indices, uint32_t indexCount, uint32_t indexSize, uint32_t vertexCount, uint32_t cacheSize )
+{
+	_CheckMeshIndices( indices, indexCount, indexSize, vertexCount );
+	if( !indexCount )
+	{
+		return 0.0f;
+	}
+	ae::Array< uint32_t > cacheTimes( AE_ALLOC_TAG_MESH, 0, vertexCount );
+	uint32_t time = cacheSize + 1;
+	uint32_t missCount = 0;
+	for( uint32_t i = 0; i < indexCount; i++ )
+	{
+		const uint32_t v = _GetMeshIndex( indices, indexSize, i );
+		if( time - cacheTimes[ v ] > cacheSize )
+		{
+			cacheTimes[ v ] = time++;
+			missCount++;
+		}
+	}
+	return missCount / ( indexCount / 3.0f );
 }
 
 } // ae end
@@ -439,6 +439,7 @@ int main( int argc, char* argv[] )
 				.maxVerts=0,
 				.maxIndices=0,
 				.dualContouring=dualContouringEnabled,
+				.threadCount=0,
 				.octree=&octree,
 				.brickMap=&brickMap,
 				.errors=&errors
@@ -25,7 +25,6 @@
 //------------------------------------------------------------------------------
 #include "ae/aeTerrain.h"
 #include "ae/aeCompactingAllocator.h"
-#include "ctpl_stl.h"
 #if _AE_WINDOWS_
   #pragma warning( disable : 4244 )
 #endif
@@ -49,6 +48,15 @@
   #define AE_TERRAIN_TOUCH_UP_VERT 0
 #endif
 
+// Jobs allocated per worker thread. Extra jobs wait in the scheduler queue so
+// they can be ordered by score, re-scored, or cancelled before running. The
+// queue is kept shallow because each job preallocates several MB of output and
+// scratch buffers, and Terrain::Update() re-sorts all chunks by score each frame
+// before handing them to free jobs anyway.
+#ifndef AE_TERRAIN_JOBS_PER_THREAD
+  #define AE_TERRAIN_JOBS_PER_THREAD 2
+#endif
+
 //------------------------------------------------------------------------------
 // SIMD headers
 //------------------------------------------------------------------------------
@@ -261,11 +269,6 @@ TerrainChunk::TerrainChunk() :
   m_pos = ae::Int3( 0 );
 
   m_geoDirty = false; // @NOTE: Start false. This flag is only for chunks that need to be regenerated
-  m_lightDirty = false;
-
-  memset( m_t, 0, sizeof( m_t ) );
-  memset( m_l, 0, sizeof( m_l ) );
-  memset( m_i, ~(uint8_t)0, sizeof( m_i ) );
 }
 
 TerrainChunk::~TerrainChunk()
@@ -323,9 +326,18 @@ uint32_t TerrainChunk::GetIndex() const
   return GetIndex( m_pos );
 }
 
+//------------------------------------------------------------------------------
+// TerrainJob member functions
+//------------------------------------------------------------------------------
+// @NOTE: Increment when chunk generation changes to invalidate cached chunks
+const uint32_t kChunkCacheVersion = 3;
+const uint32_t kChunkCacheMagic = 0x43546561; // 'aeTC'
+
 TerrainJob::TerrainJob() :
   m_hasJob( false ),
   m_running( false ),
+  m_cancel( false ),
+  m_cancelled( false ),
   m_chunk( nullptr ),
   m_vertexCount( kChunkCountEmpty ),
   m_indexCount( 0 ),
@@ -333,12 +345,17 @@ TerrainJob::TerrainJob() :
   m_indices( ae::Array< TerrainIndex >( AE_ALLOC_TAG_TERRAIN, TerrainIndex(), kMaxChunkIndices ) )
 {
   edgeInfo = ae::NewArray< TempEdges >( AE_ALLOC_TAG_TERRAIN, kTempChunkSize3 );
+  voxelInfo = ae::New< TempVoxels >( AE_ALLOC_TAG_TERRAIN );
 }
 
 TerrainJob::~TerrainJob()
 {
   ae::Delete( edgeInfo );
   edgeInfo = nullptr;
+  ae::Delete( voxelInfo );
+  voxelInfo = nullptr;
+  ae::Delete( m_voxels );
+  m_voxels = nullptr;
 }
 
 void TerrainJob::StartNew( const TerrainParams& params, const TerrainSdf* sdf, TerrainChunk* chunk )
@@ -351,21 +368,20 @@ void TerrainJob::StartNew( const TerrainParams& params, const TerrainSdf* sdf, T
 
   m_hasJob = true;
   m_running = true;
+  m_cancel = false;
+  m_cancelled = false;
 
   m_vertexCount = kChunkCountEmpty;
   m_indexCount = 0;
   m_chunk = chunk;
+  // @NOTE: Generated directly into the grid that's published for
+  // Terrain::GetVoxel(), so the chunk's voxels aren't copied
+  AE_ASSERT( !m_voxels );
+  m_voxels = ae::New< TerrainVoxelGrid< Block::Type > >( AE_ALLOC_TAG_TERRAIN, Block::Exterior );
+  m_chunk->m_t = m_voxels;
   
   // 1) Add shapes to job that intersect current chunk
-  ae::AABB aabb = chunk->GetAABB();
-  for( uint32_t i = 0; i < sdf->GetShapeCount(); i++ )
-  {
-    ae::Sdf* shape = sdf->GetShapeAtIndex( i );
-    if( shape->GetAABB().Intersect( aabb ) )
-    {
-      m_shapes.Append( shape );
-    }
-  }
+  sdf->GetShapes( chunk->GetAABB(), &m_shapes );
   
   // 2) Put shapes in order
   std::stable_sort( m_shapes.begin(), m_shapes.end(), []( const ae::Sdf* s0, const ae::Sdf* s1 )
@@ -387,15 +403,22 @@ void TerrainJob::StartNew( const TerrainParams& params, const TerrainSdf* sdf, T
   }
 }
 
-void TerrainJob::Do()
+bool TerrainJob::Do()
 {
   AE_ASSERT( m_chunk );
+  if( m_cancel )
+  {
+    m_cancelled = true;
+    m_running = false;
+    return false;
+  }
   
   // Hash
   m_parameterHash = ae::Hash32();
   
   m_parameterHash = m_p.GetHash( m_parameterHash );
   
+  m_parameterHash = m_parameterHash.HashType( kChunkCacheVersion );
   ae::Int3 chunkPos = m_chunk->m_pos;
   m_parameterHash = m_parameterHash.HashType( chunkPos.x );
   m_parameterHash = m_parameterHash.HashType( chunkPos.y );
@@ -408,54 +431,103 @@ void TerrainJob::Do()
   
   // Check disk to see if job has been completed before
   ae::Str128 filePath = ae::Str128::Format( "terrain/#_#_#_#", chunkPos.x, chunkPos.y, chunkPos.z, m_parameterHash.Get() );
-  uint32_t fileSize = m_p.vfs ? m_p.vfs->GetSize( ae::FileSystem::Root::Cache, filePath.c_str() ) : 0;
-  if( fileSize )
-  {
-    ae::Scratch< uint8_t > fileData( fileSize );
-    m_p.vfs->Read( ae::FileSystem::Root::Cache, filePath.c_str(), fileData.Data(), fileSize );
-    ae::BinaryReader rStream( fileData.Data(), fileSize );
-    rStream.SerializeUInt32( m_vertexCount.Get() );
-    rStream.SerializeUInt32( m_indexCount );
+  bool cached = m_ReadCache( filePath.c_str() );
+  if( !cached )
+  {
+    m_sdfCache.Generate( m_chunk->m_pos, this );
+    if( m_cancel )
+    {
+      // @NOTE: Check between the two expensive steps so chunks that have moved
+      // out of range don't hold up a worker
+      m_cancelled = true;
+      m_running = false;
+      return false;
+    }
+    m_chunk->Generate( &m_sdfCache, this, edgeInfo, voxelInfo, &m_vertices[ 0 ], &m_indices[ 0 ], &m_vertexCount, &m_indexCount );
+    m_voxels->Set( voxelInfo->t );
+  }
+  
+  // Load
+  m_chunk->m_mesh.AddIndexed(
+    ae::Matrix4::Identity(),
+    (float*)&m_vertices[ 0 ].position,
+    (uint32_t)m_vertexCount,
+    sizeof(m_vertices[ 0 ]),
+    &m_indices[ 0 ],
+    m_indexCount,
+    sizeof(m_indices[ 0 ])
+  );
+  m_chunk->m_mesh.BuildBVH();
+  
+  if( !cached )
+  {
+    m_WriteCache( filePath.c_str() );
+  }
+  
+  m_running = false;
+  return true;
+}
+
+bool TerrainJob::m_ReadCache( const char* filePath )
+{
+  uint32_t fileSize = m_p.vfs ? m_p.vfs->GetSize( ae::FileSystem::Root::Cache, filePath ) : 0;
+  if( !fileSize )
+  {
+    return false;
+  }
+  ae::Scratch< uint8_t > fileData( fileSize );
+  if( m_p.vfs->Read( ae::FileSystem::Root::Cache, filePath, fileData.Data(), fileSize ) != fileSize )
+  {
+    return false;
+  }
+  
+  ae::BinaryReader rStream( fileData.Data(), fileSize );
+  uint32_t magic = 0;
+  rStream.SerializeUInt32( magic );
+  rStream.SerializeUInt32( m_vertexCount.Get() );
+  rStream.SerializeUInt32( m_indexCount );
+  // @NOTE: Validate counts before reading so a corrupt file can't overflow the job buffers
+  if( rStream.IsValid() && magic == kChunkCacheMagic
+    && m_vertexCount <= kMaxChunkVerts && m_indexCount <= kMaxChunkIndices )
+  {
     rStream.SerializeRaw( &m_vertices[ 0 ], (uint32_t)m_vertexCount * sizeof(m_vertices[ 0 ]) );
     rStream.SerializeRaw( &m_indices[ 0 ], m_indexCount * sizeof(m_indices[ 0 ]) );
     rStream.SerializeObject( *m_chunk );
-  }
-  else
-  {
-    AE_ASSERT( m_chunk );
-    m_sdfCache.Generate( m_chunk->m_pos, this );
-    m_chunk->Generate( &m_sdfCache, this, edgeInfo, &m_vertices[ 0 ], &m_indices[ 0 ], &m_vertexCount, &m_indexCount );
-    
-    // Load
-    m_chunk->m_mesh.AddIndexed(
-      ae::Matrix4::Identity(),
-      (float*)&m_vertices[ 0 ].position,
-      (uint32_t)m_vertexCount,
-      sizeof(m_vertices[ 0 ]),
-      &m_indices[ 0 ],
-      m_indexCount,
-      sizeof(m_indices[ 0 ])
-    );
-    m_chunk->m_mesh.BuildBVH();
-    
-    if( m_p.vfs )
-    {
-      // Write result
-      ae::Array< uint8_t > data = AE_ALLOC_TAG_TERRAIN;
-      ae::BinaryWriter wStream( &data );
-      wStream.SerializeUInt32( m_vertexCount.Get() );
-      wStream.SerializeUInt32( m_indexCount );
-      wStream.SerializeRaw( &m_vertices[ 0 ], (uint32_t)m_vertexCount * sizeof(m_vertices[ 0 ]) );
-      wStream.SerializeRaw( &m_indices[ 0 ], m_indexCount * sizeof(m_indices[ 0 ]) );
-      wStream.SerializeObject( *m_chunk );
-      if( !m_p.vfs->Write( ae::FileSystem::Root::Cache, filePath.c_str(), wStream.GetData(), wStream.GetOffset(), true ) )
-      {
-        AE_WARN( "Failed writing terrain chunk '#'", filePath );
+    // @NOTE: Also catches files that were only partially written
+    if( rStream.IsValid() && !rStream.GetRemainingBytes() )
+    {
+      if( AE_TERRAIN_LOG )
+      {
+        AE_LOG( "Loaded cached terrain chunk '#'", filePath );
       }
+      return true;
     }
   }
   
-  m_running = false;
+  AE_WARN( "Invalid terrain chunk cache file '#'", filePath );
+  m_vertexCount = kChunkCountEmpty;
+  m_indexCount = 0;
+  return false;
+}
+
+void TerrainJob::m_WriteCache( const char* filePath ) const
+{
+  if( !m_p.vfs )
+  {
+    return;
+  }
+  ae::Array< uint8_t > data = AE_ALLOC_TAG_TERRAIN;
+  ae::BinaryWriter wStream( &data );
+  wStream.SerializeUInt32( kChunkCacheMagic );
+  wStream.SerializeUInt32( m_vertexCount.Get() );
+  wStream.SerializeUInt32( m_indexCount );
+  wStream.SerializeRaw( &m_vertices[ 0 ], (uint32_t)m_vertexCount * sizeof(m_vertices[ 0 ]) );
+  wStream.SerializeRaw( &m_indices[ 0 ], m_indexCount * sizeof(m_indices[ 0 ]) );
+  wStream.SerializeObject( *m_chunk );
+  if( !m_p.vfs->Write( ae::FileSystem::Root::Cache, filePath, wStream.GetData(), wStream.GetOffset(), true ) )
+  {
+    AE_WARN( "Failed writing terrain chunk '#'", filePath );
+  }
 }
 
 void TerrainJob::Finish()
@@ -468,19 +540,30 @@ void TerrainJob::Finish()
     ae::Delete( shape );
   }
   m_shapes.Clear();
+  ae::Delete( m_voxels );
+  m_voxels = nullptr;
 
   m_hasJob = false;
+  m_cancel = false;
+  m_cancelled = false;
   m_vertexCount = kChunkCountEmpty;
   m_indexCount = 0;
   m_chunk = nullptr;
 }
 
+TerrainVoxelGrid< Block::Type >* TerrainJob::TakeVoxels()
+{
+  TerrainVoxelGrid< Block::Type >* voxels = m_voxels;
+  m_voxels = nullptr;
+  return voxels;
+}
+
 bool TerrainJob::HasChunk( ae::Int3 pos ) const
 {
   return m_chunk && m_chunk->m_pos == pos;
 }
 
-void TerrainChunk::Generate( const TerrainSdfCache* sdf, const TerrainJob* job, TerrainJob::TempEdges* edgeInfo, TerrainVertex* verticesOut, TerrainIndex* indexOut, VertexCount* vertexCountOut, uint32_t* indexCountOut )
+void TerrainChunk::Generate( const TerrainSdfCache* sdf, const TerrainJob* job, TerrainJob::TempEdges* edgeInfo, TerrainJob::TempVoxels* voxelInfo, TerrainVertex* verticesOut, TerrainIndex* indexOut, VertexCount* vertexCountOut, uint32_t* indexCountOut )
 {
 #if AE_TERRAIN_FANCY_NORMALS
   struct TempTri
@@ -511,6 +594,9 @@ void TerrainChunk::Generate( const TerrainSdfCache* sdf, const TerrainJob* job,
   int32_t chunkOffsetZ = m_pos.z * kChunkSize;
   
   memset( edgeInfo, 0, kTempChunkSize3 * sizeof( *edgeInfo ) );
+  // @NOTE: Block::Exterior and kInvalidTerrainIndex
+  memset( voxelInfo->t, 0, sizeof( voxelInfo->t ) );
+  memset( voxelInfo->i, ~(uint8_t)0, sizeof( voxelInfo->i ) );
   
   uint16_t mask[ 3 ];
   mask[ 0 ] = EDGE_TOP_FRONT_BIT;
@@ -565,7 +651,7 @@ void TerrainChunk::Generate( const TerrainSdfCache* sdf, const TerrainJob* job,
     {
       if( x >= 0 && y >= 0 && z >= 0 && x < kChunkSize && y < kChunkSize && z < kChunkSize )
       {
-        if( m_i[ x ][ y ][ z ] != kInvalidTerrainIndex )
+        if( voxelInfo->i[ x ][ y ][ z ] != kInvalidTerrainIndex )
         {
           continue;
         }
@@ -575,7 +661,7 @@ void TerrainChunk::Generate( const TerrainSdfCache* sdf, const TerrainJob* job,
         g.y = chunkOffsetY + y + 0.5f;
         g.z = chunkOffsetZ + z + 0.5f;
         // @TODO: This is really expensive and might not be needed. Investigate removing 'Block' type altogether
-        m_t[ x ][ y ][ z ] = ( sdf->GetValue( g ) > 0.0f ) ? Block::Exterior : Block::Interior;
+        voxelInfo->t[ x ][ y ][ z ] = ( sdf->GetValue( g ) > 0.0f ) ? Block::Exterior : Block::Interior;
       }
       continue;
     }
@@ -680,7 +766,7 @@ void TerrainChunk::Generate( const TerrainSdfCache* sdf, const TerrainJob* job,
         }
         
         bool inCurrentChunk = ox < kChunkSize && oy < kChunkSize && oz < kChunkSize;
-        if( !inCurrentChunk || m_i[ ox ][ oy ][ oz ] == kInvalidTerrainIndex )
+        if( !inCurrentChunk || voxelInfo->i[ ox ][ oy ][ oz ] == kInvalidTerrainIndex )
         {
           TerrainVertex vertex;
           vertex.position.x = ox + 0.5f;
@@ -701,20 +787,20 @@ void TerrainChunk::Generate( const TerrainSdfCache* sdf, const TerrainJob* job,
           
           if( inCurrentChunk )
           {
-            m_i[ ox ][ oy ][ oz ] = index;
-            m_t[ ox ][ oy ][ oz ] = Block::Surface;
+            voxelInfo->i[ ox ][ oy ][ oz ] = index;
+            voxelInfo->t[ ox ][ oy ][ oz ] = Block::Surface;
           }
         }
         else
         {
-          TerrainIndex index = m_i[ ox ][ oy ][ oz ];
+          TerrainIndex index = voxelInfo->i[ ox ][ oy ][ oz ];
 #if !AE_TERRAIN_FANCY_NORMALS
           AE_ASSERT_MSG( index < (TerrainIndex)vertexCount, "# < # ox:# oy:# oz:#", index, vertexCount, ox, oy, oz );
 #endif
           AE_ASSERT( ox < kChunkSize );
           AE_ASSERT( oy < kChunkSize );
           AE_ASSERT( oz < kChunkSize );
-          AE_ASSERT( m_t[ ox ][ oy ][ oz ] == Block::Surface );
+          AE_ASSERT( voxelInfo->t[ ox ][ oy ][ oz ] == Block::Surface );
           ind[ j ] = index;
         }
       }
@@ -1096,7 +1182,7 @@ void TerrainChunk::Generate( const TerrainSdfCache* sdf, const TerrainJob* job,
 #endif
 }
 
-const uint32_t kChunkFormatVersion = 1;
+const uint32_t kChunkFormatVersion = 3;
 void TerrainChunk::Serialize( ae::BinaryStream* stream )
 {
   uint32_t version = kChunkFormatVersion;
@@ -1107,20 +1193,10 @@ void TerrainChunk::Serialize( ae::BinaryStream* stream )
     return;
   }
   
-  AE_FAIL();
-//  ae::CollisionMesh::SerializationParams params;
-//  params.position = true;
-//  params.normal = true;
-//  params.uvSets = 0;
-//  params.colorSets = 0;
-//  params.userDataCount = 0;
-//  m_mesh.Serialize( params, stream );
-  
-  stream->SerializeRaw( m_t, sizeof(m_t) );
-  stream->SerializeRaw( m_l, sizeof(m_l) );
-  stream->SerializeRaw( m_i, sizeof(m_i) );
-  
-  //@TODO: m_lightDirty
+  // @NOTE: m_mesh is rebuilt from the cached vertices and indices by the job
+  AE_ASSERT( m_t );
+  stream->SerializeObject( *m_t );
+  stream->SerializeObject( m_l );
   
   // @NOTE: Don't modify 'm_geoDirty' because the chunk contents
   // could have changed since the job calling Serialize() has started
@@ -1163,42 +1239,6 @@ void TerrainChunk::m_SetVertexData( const TerrainVertex* verts, const TerrainInd
 //------------------------------------------------------------------------------
 // TerrainMember functions
 //------------------------------------------------------------------------------
-void Terrain::UpdateChunkLighting( TerrainChunk* chunk )
-{
-//  int32_t cx = chunk->pos[ 0 ] * kChunkSize;
-//  int32_t cy = chunk->pos[ 1 ] * kChunkSize;
-//  int32_t cz = chunk->pos[ 2 ] * kChunkSize;
-//  
-//  ae::Vec3 ray[ 9 ];
-//  for( int32_t sy = 0; sy < 3; sy++ )
-//  for( int32_t sx = 0; sx < 3; sx++ )
-//  {
-//    int32_t i = sy * 3 + sx;
-//    ray[ i ].x = sx - 1;
-//    ray[ i ].y = sy - 1;
-//    ray[ i ].z = 1;
-//    ray[ i ].Normalize();
-//    ray[ i ] *= 40.0f;
-//  }
-  
-  for( uint32_t z = 0; z < kChunkSize; z++ )
-  for( uint32_t y = 0; y < kChunkSize; y++ )
-  for( uint32_t x = 0; x < kChunkSize; x++ )
-  {
-//    int32_t hits = 0;
-//    ae::Vec3 source( cx + x + 0.5f, cy + y + 0.5f, cz + z + 0.5f );
-//    for( int32_t r = 0; r < 9; r++ )
-//    {
-//      if( VoxelRaycast( source, ray[ r ], 9   ) != Block::Exterior ) { hits++; }
-//    }
-//    float mod = 1.0f - ( hits / 9.0f );
-    float mod = 0.7125f;
-    chunk->m_l[ x ][ y ][ z ] = kSkyBrightness * mod * 0.85f;
-  }
-  
-  chunk->m_lightDirty = false;
-}
-
 TerrainChunk* Terrain::AllocChunk( ae::Int3 pos )
 {
   TerrainChunk* chunk = m_chunkPool.New();
@@ -1208,7 +1248,6 @@ TerrainChunk* Terrain::AllocChunk( ae::Int3 pos )
   }
   
   chunk->m_pos = pos;
-  chunk->m_lightDirty = true;
   
   //AE_ASSERT( chunk->m_mesh.GetVertexCount() == 0 );
   
@@ -1368,6 +1407,236 @@ void TerrainChunk::m_GetQuadVertexOffsetsFromEdge( uint32_t edgeBit, int32_t (&o
   }
 }
 
+//------------------------------------------------------------------------------
+// TerrainVoxelTable member functions
+//------------------------------------------------------------------------------
+TerrainVoxelTable::TerrainVoxelTable()
+{
+  for( std::atomic< uint64_t >& reader : m_readers )
+  {
+    reader.store( 0 );
+  }
+  m_table.store( m_NewTable( 1024 ) );
+}
+
+TerrainVoxelTable::~TerrainVoxelTable()
+{
+  Clear();
+  m_DeleteTable( m_table.load() );
+  m_table.store( nullptr );
+}
+
+void TerrainVoxelTable::Publish( uint32_t chunkIndex, const Voxels* voxels )
+{
+  const uint64_t key = chunkIndex | ( 1ull << 32 );
+  Table* table = m_table.load( std::memory_order_relaxed );
+  if( Entry* entry = m_Find( table, key ) )
+  {
+    const Voxels* prev = entry->voxels.load( std::memory_order_relaxed );
+    if( prev == voxels )
+    {
+      return;
+    }
+    entry->voxels.store( voxels, std::memory_order_release );
+    if( prev && !m_IsUniform( prev ) )
+    {
+      m_retired.Append( { prev, nullptr, m_epoch.load() } );
+    }
+    return;
+  }
+
+  if( ( table->count + 1 ) * 2 > table->capacity )
+  {
+    // @NOTE: Readers may still be walking the old table, so build a new one
+    // and retire the old one instead of rehashing in place
+    Table* next = m_NewTable( table->capacity * 2 );
+    for( uint32_t i = 0; i < table->capacity; i++ )
+    {
+      const Entry& src = table->entries[ i ];
+      if( uint64_t srcKey = src.key.load( std::memory_order_relaxed ) )
+      {
+        uint32_t mask = next->capacity - 1;
+        uint32_t slot = (uint32_t)srcKey * 0x9E3779B1u;
+        while( next->entries[ slot & mask ].key.load( std::memory_order_relaxed ) ) { slot++; }
+        next->entries[ slot & mask ].voxels.store( src.voxels.load( std::memory_order_relaxed ), std::memory_order_relaxed );
+        next->entries[ slot & mask ].key.store( srcKey, std::memory_order_relaxed );
+        next->count++;
+      }
+    }
+    m_table.store( next );
+    m_retired.Append( { nullptr, table, m_epoch.load() } );
+    table = next;
+  }
+
+  // @NOTE: Store the grid before the key so readers never find a key without it
+  uint32_t mask = table->capacity - 1;
+  uint32_t slot = chunkIndex * 0x9E3779B1u;
+  while( table->entries[ slot & mask ].key.load( std::memory_order_relaxed ) ) { slot++; }
+  table->entries[ slot & mask ].voxels.store( voxels, std::memory_order_relaxed );
+  table->entries[ slot & mask ].key.store( key, std::memory_order_release );
+  table->count++;
+}
+
+void TerrainVoxelTable::Reclaim()
+{
+  if( !m_retired.Length() )
+  {
+    return;
+  }
+  
+  // @NOTE: Readers that announce the new epoch started after everything in
+  // m_retired was unpublished. The fence pairs with the one in Reader() so a
+  // reader is either seen here or sees the latest table and grids.
+  uint64_t minEpoch = m_epoch.fetch_add( 1 ) + 1;
+  std::atomic_thread_fence( std::memory_order_seq_cst );
+  for( const std::atomic< uint64_t >& reader : m_readers )
+  {
+    uint64_t epoch = reader.load();
+    if( epoch && epoch < minEpoch )
+    {
+      minEpoch = epoch;
+    }
+  }
+  
+  for( int32_t i = m_retired.Length() - 1; i >= 0; i-- )
+  {
+    const Retired& retired = m_retired[ i ];
+    if( retired.epoch < minEpoch )
+    {
+      ae::Delete( (Voxels*)retired.voxels );
+      m_DeleteTable( retired.table );
+      m_retired.Remove( i );
+    }
+  }
+}
+
+void TerrainVoxelTable::Clear()
+{
+  for( const std::atomic< uint64_t >& reader : m_readers )
+  {
+    AE_ASSERT_MSG( !reader.load(), "Can't clear TerrainVoxelTable while it's being read" );
+  }
+  
+  for( const Retired& retired : m_retired )
+  {
+    ae::Delete( (Voxels*)retired.voxels );
+    m_DeleteTable( retired.table );
+  }
+  m_retired.Clear();
+  
+  Table* table = m_table.load();
+  for( uint32_t i = 0; i < table->capacity; i++ )
+  {
+    const Voxels* voxels = table->entries[ i ].voxels.load( std::memory_order_relaxed );
+    if( voxels && !m_IsUniform( voxels ) )
+    {
+      ae::Delete( (Voxels*)voxels );
+    }
+  }
+  m_table.store( m_NewTable( table->capacity ) );
+  m_DeleteTable( table );
+}
+
+const TerrainVoxelTable::Voxels* TerrainVoxelTable::GetUniform( Block::Type type )
+{
+  static const Voxels s_uniform[] =
+  {
+    Voxels( Block::Exterior ),
+    Voxels( Block::Interior ),
+    Voxels( Block::Surface ),
+    Voxels( Block::Blocking ),
+    Voxels( Block::Unloaded )
+  };
+  static_assert( countof( s_uniform ) == Block::COUNT, "Missing uniform voxel grid" );
+  AE_ASSERT( type < Block::COUNT );
+  return &s_uniform[ type ];
+}
+
+TerrainVoxelTable::Table* TerrainVoxelTable::m_NewTable( uint32_t capacity )
+{
+  AE_ASSERT( capacity && !( capacity & ( capacity - 1 ) ) );
+  Table* table = ae::New< Table >( AE_ALLOC_TAG_TERRAIN );
+  table->capacity = capacity;
+  table->count = 0;
+  table->entries = ae::NewArray< Entry >( AE_ALLOC_TAG_TERRAIN, capacity );
+  for( uint32_t i = 0; i < capacity; i++ )
+  {
+    table->entries[ i ].key.store( 0, std::memory_order_relaxed );
+    table->entries[ i ].voxels.store( nullptr, std::memory_order_relaxed );
+  }
+  return table;
+}
+
+void TerrainVoxelTable::m_DeleteTable( Table* table )
+{
+  if( table )
+  {
+    ae::Delete( table->entries );
+    ae::Delete( table );
+  }
+}
+
+TerrainVoxelTable::Entry* TerrainVoxelTable::m_Find( const Table* table, uint64_t key )
+{
+  // @NOTE: Entries are never removed and tables are at most half full, so
+  // probing always ends at an empty entry
+  uint32_t mask = table->capacity - 1;
+  for( uint32_t slot = (uint32_t)key * 0x9E3779B1u;; slot++ )
+  {
+    Entry* entry = &table->entries[ slot & mask ];
+    uint64_t entryKey = entry->key.load( std::memory_order_acquire );
+    if( entryKey == key )
+    {
+      return entry;
+    }
+    else if( !entryKey )
+    {
+      return nullptr;
+    }
+  }
+}
+
+bool TerrainVoxelTable::m_IsUniform( const Voxels* voxels )
+{
+  const Voxels* uniform = GetUniform( Block::Exterior );
+  return voxels >= uniform && voxels < uniform + Block::COUNT;
+}
+
+TerrainVoxelTable::Reader::Reader( const TerrainVoxelTable* table ) :
+  m_owner( table )
+{
+  // @NOTE: Start searching from the last slot this thread used, which is
+  // almost always still free
+  static thread_local uint32_t s_slotHint = 0;
+  for( uint32_t i = s_slotHint;; i++ )
+  {
+    m_slot = i % kReaderSlots;
+    uint64_t expected = 0;
+    if( table->m_readers[ m_slot ].compare_exchange_strong( expected, table->m_epoch.load() ) )
+    {
+      break;
+    }
+    else if( i - s_slotHint >= kReaderSlots )
+    {
+      std::this_thread::yield();
+    }
+  }
+  s_slotHint = m_slot;
+  std::atomic_thread_fence( std::memory_order_seq_cst );
+  m_table = table->m_table.load();
+}
+
+TerrainVoxelTable::Reader::~Reader()
+{
+  m_owner->m_readers[ m_slot ].store( 0, std::memory_order_release );
+}
+
+const TerrainVoxelTable::Voxels* TerrainVoxelTable::Reader::Get( uint32_t chunkIndex ) const
+{
+  const Entry* entry = m_Find( m_table, chunkIndex | ( 1ull << 32 ) );
+  return entry ? entry->voxels.load( std::memory_order_acquire ) : nullptr;
+}
+
 //------------------------------------------------------------------------------
 // Terrain chunk member functions
 //------------------------------------------------------------------------------
@@ -1411,116 +1680,689 @@ VertexCount Terrain::GetVertexCount( ae::Int3 pos ) const
 }
 
 //------------------------------------------------------------------------------
-// Terrain member functions
+// TerrainScheduler member functions
 //------------------------------------------------------------------------------
-Terrain::Terrain() :
-  sdf( this )
-{}
-
-Terrain::~Terrain()
+TerrainScheduler::~TerrainScheduler()
 {
   Terminate();
 }
 
-void Terrain::Initialize( uint32_t maxThreads, bool render )
+void TerrainScheduler::Initialize( uint32_t workerCount )
 {
-  // @NOTE: This doesn't handle the case where enough verts are split
-  // that the count surpasses TerrainIndex max.
-  AE_ASSERT( kMaxChunkVerts <= VertexCount( ae::MaxValue< TerrainIndex >() ) );
-
-  m_render = render;
-
-  //m_chunkPool.Initialize(); @TODO: Reset pool
-  
-  for( uint32_t i = 0; i < Block::COUNT; i++) { m_blockCollision[ i ] = true; }
-  m_blockCollision[ Block::Exterior ] = false;
-  m_blockCollision[ Block::Unloaded ] = false;
-  
-  for( uint32_t i = 0; i < Block::COUNT; i++) { m_blockDensity[ i ] = 1.0f; }
+  AE_ASSERT_MSG( !m_workers.Length() && !m_queue.Length(), "TerrainScheduler is already initialized" );
+  m_stop = false;
+  m_runningCount = 0;
+  m_stats = Stats();
+  m_latencySum = 0.0;
+  for( uint32_t i = 0; i < workerCount; i++ )
+  {
+    m_workers.Append( ae::New< std::thread >( AE_ALLOC_TAG_TERRAIN, [ this ]() { m_Run(); } ) );
+  }
+}
 
-  m_threadPool = ae::New< ctpl::thread_pool >( AE_ALLOC_TAG_TERRAIN, maxThreads );
-  maxThreads = ae::Max( 1u, maxThreads );
-  for( uint32_t i = 0; i < maxThreads; i++ )
+void TerrainScheduler::Terminate()
+{
   {
-    m_terrainJobs.Append( ae::New< TerrainJob >( AE_ALLOC_TAG_TERRAIN ) );
+    std::lock_guard< std::mutex > lock( m_lock );
+    m_stop = true;
   }
+  m_wake.notify_all();
+  for( std::thread* worker : m_workers )
+  {
+    worker->join();
+    ae::Delete( worker );
+  }
+  m_workers.Clear();
+  // Jobs that never started are cancelled so they can be finished
+  for( const Entry& entry : m_queue )
+  {
+    entry.job->Cancel();
+    entry.job->Do();
+  }
+  m_queue.Clear();
 }
 
-void Terrain::Terminate()
+void TerrainScheduler::Submit( TerrainJob* job, float score )
 {
-  if( m_threadPool )
+  AE_ASSERT( job );
   {
-    m_threadPool->stop( true );
-    ae::Delete( m_threadPool );
-    m_threadPool = nullptr;
+    std::lock_guard< std::mutex > lock( m_lock );
+    m_queue.Append( { job, score, ae::GetTime() } );
+    std::push_heap( m_queue.begin(), m_queue.end() );
+    m_stats.submitCount++;
+    m_stats.maxQueueDepth = ae::Max( m_stats.maxQueueDepth, m_queue.Length() );
   }
+  m_wake.notify_one();
+}
 
-  for( uint32_t i = 0; i < m_terrainJobs.Length(); i++ )
+void TerrainScheduler::Cancel( TerrainJob* job )
+{
+  AE_ASSERT( job );
+  job->Cancel();
   {
-    TerrainJob* job = m_terrainJobs[ i ];
-    if( job->IsPendingFinish() )
+    std::lock_guard< std::mutex > lock( m_lock );
+    int32_t index = m_queue.FindFn( [ job ]( const Entry& e ) { return e.job == job; } );
+    if( index < 0 )
     {
-      job->Finish();
+      // Running, so Do() will return early
+      return;
     }
-    ae::Delete( job );
+    m_queue.Remove( index );
+    std::make_heap( m_queue.begin(), m_queue.end() );
+    m_stats.cancelCount++;
   }
-  m_terrainJobs.Clear();
+  // Returns immediately, leaving the job pending finish
+  job->Do();
+}
 
-  for( TerrainChunk* next = m_chunkPool.GetFirst(); next;  )
+void TerrainScheduler::Reprioritize( std::function< float( const TerrainJob* ) > scoreFn )
+{
+  std::lock_guard< std::mutex > lock( m_lock );
+  for( Entry& entry : m_queue )
   {
-    TerrainChunk* current = next;
-    next = m_chunkPool.GetNext( next );
-    FreeChunk( current );
+    entry.score = scoreFn( entry.job );
   }
-  AE_ASSERT( m_chunkPool.Length() == 0 );
+  std::make_heap( m_queue.begin(), m_queue.end() );
 }
 
-void Terrain::Update( ae::Vec3 center, float radius )
+TerrainJob* TerrainScheduler::RunNext()
 {
-  int32_t chunkViewRadius = radius / kChunkSize;
-  const int32_t kChunkViewDiam = chunkViewRadius + chunkViewRadius;
-
-  m_center = center;
-  m_radius = radius;
-
-  //------------------------------------------------------------------------------
-  // Dirty the chunks containing sdf shapes that have been modified
-  //------------------------------------------------------------------------------
-  // @TODO: This isn't entirely thread safe... The memory location is guaranteed to
-  // be valid, but it's possible for values to change while another thread is reading
-  // them. It's possible these shapes could be accessed from a job. They should
-  // probably be duplicated and given to the job when it starts.
-  for( uint32_t i = 0; i < sdf.GetShapeCount(); i++ )
+  Entry entry;
   {
-    Sdf* shape = sdf.GetShapeAtIndex( i );
-    if( shape->m_dirty )
+    std::lock_guard< std::mutex > lock( m_lock );
+    if( !m_queue.Length() )
     {
-      m_Dirty( shape->m_aabbPrev );
-      m_Dirty( shape->GetAABB() );
-
-      shape->m_dirty = false;
-      shape->m_aabbPrev = shape->GetAABB();
+      return nullptr;
     }
+    entry = m_Pop();
   }
-  
-  //------------------------------------------------------------------------------
-  // Determine which chunks will be processed
-  //------------------------------------------------------------------------------
-  //t_chunkMap.Clear();
-  //t_chunkMap.Reserve( kChunkViewDiam * kChunkViewDiam * kChunkViewDiam );
-  t_chunkMap_hack.clear();
-  ae::Int3 viewChunk = ( m_center / kChunkSize ).NearestCopy();
-  for( int32_t k = 0; k < kChunkViewDiam; k++ )
+  const bool completed = entry.job->Do();
+  std::lock_guard< std::mutex > lock( m_lock );
+  m_Finished( entry, completed );
+  return entry.job;
+}
+
+bool TerrainScheduler::IsIdle() const
+{
+  std::lock_guard< std::mutex > lock( m_lock );
+  return !m_queue.Length() && !m_runningCount;
+}
+
+TerrainScheduler::Stats TerrainScheduler::GetStats() const
+{
+  std::lock_guard< std::mutex > lock( m_lock );
+  Stats stats = m_stats;
+  stats.queueDepth = m_queue.Length();
+  stats.runningCount = m_runningCount;
+  stats.averageLatency = stats.completeCount ? ( m_latencySum / stats.completeCount ) : 0.0;
+  return stats;
+}
+
+void TerrainScheduler::m_Run()
+{
+  std::unique_lock< std::mutex > lock( m_lock );
+  while( true )
   {
-    for( int32_t j = 0; j < kChunkViewDiam; j++ )
+    m_wake.wait( lock, [ this ]() { return m_stop || m_queue.Length(); } );
+    if( m_stop )
     {
-      for( int32_t i = 0; i < kChunkViewDiam; i++ )
-      {
-        ae::Int3 chunkPos( i, j, k );
-        chunkPos -= ae::Int3( chunkViewRadius );
-        chunkPos += viewChunk;
+      return;
+    }
+    const Entry entry = m_Pop();
+    lock.unlock();
+    // @NOTE: The job belongs to the main thread again as soon as Do() returns
+    const bool completed = entry.job->Do();
+    lock.lock();
+    m_Finished( entry, completed );
+  }
+}
 
-        ae::Vec3 chunkCenter = TerrainChunk::GetAABB( chunkPos ).GetCenter();
+TerrainScheduler::Entry TerrainScheduler::m_Pop()
+{
+  std::pop_heap( m_queue.begin(), m_queue.end() );
+  const Entry entry = m_queue[ m_queue.Length() - 1 ];
+  m_queue.Remove( m_queue.Length() - 1 );
+  m_runningCount++;
+  return entry;
+}
+
+void TerrainScheduler::m_Finished( const Entry& entry, bool completed )
+{
+  AE_ASSERT( m_runningCount );
+  m_runningCount--;
+  if( completed )
+  {
+    const double latency = ae::GetTime() - entry.submitTime;
+    m_stats.completeCount++;
+    m_stats.maxLatency = ae::Max( m_stats.maxLatency, latency );
+    m_latencySum += latency;
+  }
+  else
+  {
+    m_stats.cancelCount++;
+  }
+}
+
+//------------------------------------------------------------------------------
+// TerrainLight member functions
+//------------------------------------------------------------------------------
+namespace
+{
+  const ae::Int3 kLightNeighbors[ 6 ] =
+  {
+    ae::Int3( 1, 0, 0 ), ae::Int3( -1, 0, 0 ),
+    ae::Int3( 0, 1, 0 ), ae::Int3( 0, -1, 0 ),
+    ae::Int3( 0, 0, 1 ), ae::Int3( 0, 0, -1 )
+  };
+  const uint32_t kLightDown = 5;
+
+  aeFloat16 _GetSpreadLight( aeFloat16 light, uint32_t neighbor )
+  {
+    if( neighbor == kLightDown && light == kSkyBrightness )
+    {
+      return kSkyBrightness;
+    }
+    return ae::Max( light - kLightFalloff, aeFloat16( 0.0f ) );
+  }
+
+  bool _IsLightTransparent( Block::Type type )
+  {
+    return type == Block::Exterior || type == Block::Surface;
+  }
+
+  // Calls fn( inside, outside ) for each voxel on the faces of the chunk at
+  // 'chunkPos' and the voxel across the face from it
+  template< typename Fn >
+  void _ForEachChunkBorder( ae::Int3 chunkPos, Fn fn )
+  {
+    const ae::Int3 origin = chunkPos * kChunkSize;
+    const int32_t last = kChunkSize - 1;
+    for( uint32_t axis = 0; axis < 3; axis++ )
+    for( int32_t side = 0; side < 2; side++ )
+    for( int32_t v = 0; v < (int32_t)kChunkSize; v++ )
+    for( int32_t u = 0; u < (int32_t)kChunkSize; u++ )
+    {
+      ae::Int3 local;
+      local[ axis ] = side ? last : 0;
+      local[ ( axis + 1 ) % 3 ] = u;
+      local[ ( axis + 2 ) % 3 ] = v;
+      ae::Int3 outside = local;
+      outside[ axis ] += side ? 1 : -1;
+      fn( origin + local, origin + outside );
+    }
+  }
+}
+
+TerrainLight::~TerrainLight()
+{
+  Terminate();
+}
+
+void TerrainLight::Initialize( bool threaded )
+{
+  AE_ASSERT_MSG( !m_thread.joinable(), "TerrainLight is already initialized" );
+  m_threaded = threaded;
+  m_busy = false;
+  m_stop = false;
+  if( m_threaded )
+  {
+    m_thread = std::thread( [ this ]() { m_Run(); } );
+  }
+}
+
+void TerrainLight::Terminate()
+{
+  if( m_thread.joinable() )
+  {
+    {
+      std::lock_guard< std::mutex > lock( m_lock );
+      m_stop = true;
+    }
+    m_wake.notify_all();
+    m_thread.join();
+  }
+  m_removeQueue.Clear();
+  m_addQueue.Clear();
+  m_removeHead = 0;
+  m_addHead = 0;
+  for( uint32_t i = 0; i < m_chunks.Length(); i++ )
+  {
+    ae::Delete( m_chunks.GetValue( i ) );
+  }
+  m_chunks.Clear();
+  for( Chunk* chunk : m_freeChunks )
+  {
+    ae::Delete( chunk );
+  }
+  m_freeChunks.Clear();
+}
+
+void TerrainLight::QueueChunk( ae::Int3 pos, const TerrainChunk* oldChunk, TerrainChunk* newChunk, bool wasInterior, bool isInterior )
+{
+  AE_ASSERT_MSG( !m_busy, "Call TerrainLight::Wait() before modifying chunks" );
+  AE_ASSERT( !oldChunk || oldChunk->m_pos == pos );
+  AE_ASSERT( !newChunk || newChunk->m_pos == pos );
+  m_FreeChunk( TerrainChunk::GetIndex( pos ) );
+  const ae::Int3 origin = pos * kChunkSize;
+  if( oldChunk && newChunk )
+  {
+    // @NOTE: Only voxels that started or stopped carrying light are seeded,
+    // so small edits only relight the area around them
+    newChunk->m_l = oldChunk->m_l;
+    for( int32_t x = 0; x < (int32_t)kChunkSize; x++ )
+    for( int32_t y = 0; y < (int32_t)kChunkSize; y++ )
+    for( int32_t z = 0; z < (int32_t)kChunkSize; z++ )
+    {
+      bool was = _IsLightTransparent( oldChunk->m_t->Get( x, y, z ) );
+      bool is = _IsLightTransparent( newChunk->m_t->Get( x, y, z ) );
+      if( was == is )
+      {
+        continue;
+      }
+      ae::Int3 p = origin + ae::Int3( x, y, z );
+      if( was )
+      {
+        m_removeQueue.Append( { p, oldChunk->m_l.Get( x, y, z ) } );
+      }
+      else
+      {
+        for( ae::Int3 n : kLightNeighbors )
+        {
+          m_addQueue.Append( p + n );
+        }
+      }
+    }
+  }
+  else if( newChunk )
+  {
+    // Light from the unloaded chunk is removed from its neighbors, and then
+    // the neighbors light the new chunk
+    newChunk->m_l.Clear( aeFloat16( 0.0f ) );
+    _ForEachChunkBorder( pos, [ this, wasInterior ]( ae::Int3 inside, ae::Int3 outside )
+    {
+      if( !wasInterior )
+      {
+        m_removeQueue.Append( { inside, kSkyBrightness } );
+      }
+      m_addQueue.Append( outside );
+    } );
+  }
+  else if( !isInterior )
+  {
+    // Unloaded chunk now shines into its neighbors
+    _ForEachChunkBorder( pos, [ this ]( ae::Int3 inside, ae::Int3 ) { m_addQueue.Append( inside ); } );
+  }
+  else if( oldChunk || !wasInterior )
+  {
+    // Unloaded chunk now blocks light
+    _ForEachChunkBorder( pos, [ this, oldChunk, origin ]( ae::Int3 inside, ae::Int3 )
+    {
+      ae::Int3 local = inside - origin;
+      aeFloat16 light = oldChunk ? oldChunk->m_l.Get( local.x, local.y, local.z ) : kSkyBrightness;
+      m_removeQueue.Append( { inside, light } );
+    } );
+  }
+}
+
+bool TerrainLight::HasPending() const
+{
+  {
+    std::lock_guard< std::mutex > lock( m_lock );
+    if( m_busy )
+    {
+      return true;
+    }
+  }
+  // @NOTE: Only the light thread modifies the queues and chunks while busy
+  if( m_removeHead < m_removeQueue.Length() || m_addHead < m_addQueue.Length() )
+  {
+    return true;
+  }
+  for( uint32_t i = 0; i < m_chunks.Length(); i++ )
+  {
+    if( m_chunks.GetValue( i )->hasResult )
+    {
+      return true;
+    }
+  }
+  return false;
+}
+
+void TerrainLight::Start()
+{
+  if( m_removeHead == m_removeQueue.Length() && m_addHead == m_addQueue.Length() )
+  {
+    return;
+  }
+  if( !m_threaded )
+  {
+    m_Propagate();
+    m_Publish();
+    return;
+  }
+  {
+    std::lock_guard< std::mutex > lock( m_lock );
+    AE_ASSERT_MSG( !m_busy, "Previous light batch not finished" );
+    m_busy = true;
+  }
+  m_wake.notify_all();
+}
+
+void TerrainLight::Wait()
+{
+  {
+    std::unique_lock< std::mutex > lock( m_lock );
+    m_wake.wait( lock, [ this ]() { return !m_busy; } );
+  }
+  m_Publish();
+}
+
+void TerrainLight::m_Publish()
+{
+  // @NOTE: Light is only copied into chunks here on the Terrain thread so that
+  // Terrain::GetLight() doesn't need to lock while the next batch is running
+  for( uint32_t i = 0; i < m_chunks.Length(); i++ )
+  {
+    Chunk* chunk = m_chunks.GetValue( i );
+    if( chunk->hasResult )
+    {
+      chunk->chunk->m_l = std::move( chunk->result );
+      chunk->hasResult = false;
+    }
+  }
+  if( !HasPending() )
+  {
+    while( m_chunks.Length() )
+    {
+      m_FreeChunk( m_chunks.GetKey( 0 ) );
+    }
+  }
+}
+
+void TerrainLight::m_FreeChunk( uint32_t index )
+{
+  Chunk* chunk = nullptr;
+  if( m_chunks.Remove( index, &chunk ) )
+  {
+    AE_ASSERT( !chunk->dirty && !chunk->hasResult );
+    m_freeChunks.Append( chunk );
+  }
+}
+
+void TerrainLight::m_Run()
+{
+  while( true )
+  {
+    {
+      std::unique_lock< std::mutex > lock( m_lock );
+      m_wake.wait( lock, [ this ]() { return m_stop || m_busy; } );
+      if( m_stop )
+      {
+        return;
+      }
+    }
+    // @NOTE: The Terrain doesn't modify chunks or the queues until Wait() returns
+    m_Propagate();
+    {
+      std::lock_guard< std::mutex > lock( m_lock );
+      m_busy = false;
+    }
+    m_wake.notify_all();
+  }
+}
+
+void TerrainLight::m_Propagate()
+{
+  uint32_t steps = 0;
+  
+  // Removal first so voxels that lost their source are dark before light
+  // from the remaining sources refills them
+  while( m_removeHead < m_removeQueue.Length() && steps < kBatchSize )
+  {
+    const Removal removal = m_removeQueue[ m_removeHead++ ];
+    steps++;
+    ae::Int3 chunkPos, local;
+    TerrainChunk::GetPosFromWorld( removal.pos, &chunkPos, &local );
+    if( Chunk* chunk = m_GetSlot( chunkPos ).chunk )
+    {
+      chunk->l[ local.x ][ local.y ][ local.z ] = aeFloat16( 0.0f );
+      chunk->dirty = true;
+    }
+    for( uint32_t i = 0; i < 6; i++ )
+    {
+      ae::Int3 n = removal.pos + kLightNeighbors[ i ];
+      Chunk* chunk;
+      aeFloat16 light;
+      if( !m_GetVoxel( n, &chunk, &local, &light ) )
+      {
+        continue;
+      }
+      if( chunk && light > 0.0f && ( light < removal.light || light == _GetSpreadLight( removal.light, i ) ) )
+      {
+        // Lit by the removed voxel
+        chunk->l[ local.x ][ local.y ][ local.z ] = aeFloat16( 0.0f );
+        chunk->dirty = true;
+        m_removeQueue.Append( { n, light } );
+      }
+      else if( light > 0.0f )
+      {
+        // Lit by another source which needs to spread back into the removed area
+        m_addQueue.Append( n );
+      }
+    }
+  }
+  
+  while( m_removeHead == m_removeQueue.Length() && m_addHead < m_addQueue.Length() && steps < kBatchSize )
+  {
+    const ae::Int3 pos = m_addQueue[ m_addHead++ ];
+    steps++;
+    Chunk* chunk;
+    ae::Int3 local;
+    aeFloat16 light;
+    if( !m_GetVoxel( pos, &chunk, &local, &light ) || light <= 0.0f )
+    {
+      continue;
+    }
+    for( uint32_t i = 0; i < 6; i++ )
+    {
+      ae::Int3 n = pos + kLightNeighbors[ i ];
+      aeFloat16 spread = _GetSpreadLight( light, i );
+      Chunk* nChunk;
+      ae::Int3 nLocal;
+      aeFloat16 nLight;
+      if( m_GetVoxel( n, &nChunk, &nLocal, &nLight ) && nChunk && spread > nLight )
+      {
+        nChunk->l[ nLocal.x ][ nLocal.y ][ nLocal.z ] = spread;
+        nChunk->dirty = true;
+        m_addQueue.Append( n );
+      }
+    }
+  }
+  
+  // Drop processed queue entries, keeping the rest for the next batch
+  m_removeQueue.Remove( 0, m_removeHead );
+  m_addQueue.Remove( 0, m_addHead );
+  m_removeHead = 0;
+  m_addHead = 0;
+  
+  for( uint32_t i = 0; i < m_chunks.Length(); i++ )
+  {
+    Chunk* chunk = m_chunks.GetValue( i );
+    if( chunk->dirty )
+    {
+      chunk->result.Set( chunk->l );
+      chunk->dirty = false;
+      chunk->hasResult = true;
+    }
+  }
+  m_slots.Clear();
+}
+
+TerrainLight::Slot TerrainLight::m_GetSlot( ae::Int3 chunkPos )
+{
+  const uint32_t index = TerrainChunk::GetIndex( chunkPos );
+  if( const Slot* slot = m_slots.TryGet( index ) )
+  {
+    return *slot;
+  }
+  Slot slot;
+  slot.chunk = nullptr;
+  slot.interior = false;
+  if( TerrainChunk* terrainChunk = m_terrain->GetChunk( index ) )
+  {
+    Chunk* chunk = m_chunks.Get( index, nullptr );
+    if( !chunk )
+    {
+      if( m_freeChunks.Length() )
+      {
+        chunk = m_freeChunks[ m_freeChunks.Length() - 1 ];
+        m_freeChunks.Remove( m_freeChunks.Length() - 1 );
+      }
+      else
+      {
+        chunk = ae::New< Chunk >( AE_ALLOC_TAG_TERRAIN );
+      }
+      chunk->chunk = terrainChunk;
+      chunk->dirty = false;
+      chunk->hasResult = false;
+      terrainChunk->m_t->Get( chunk->t );
+      terrainChunk->m_l.Get( chunk->l );
+      m_chunks.Set( index, chunk );
+    }
+    // @NOTE: QueueChunk() frees cached chunks when they are replaced
+    AE_DEBUG_ASSERT( chunk->chunk == terrainChunk );
+    slot.chunk = chunk;
+  }
+  else
+  {
+    slot.interior = ( m_terrain->GetVertexCount( index ) == kChunkCountInterior );
+  }
+  m_slots.Set( index, slot );
+  return slot;
+}
+
+bool TerrainLight::m_GetVoxel( ae::Int3 pos, Chunk** chunkOut, ae::Int3* localOut, aeFloat16* lightOut )
+{
+  ae::Int3 chunkPos;
+  TerrainChunk::GetPosFromWorld( pos, &chunkPos, localOut );
+  const Slot slot = m_GetSlot( chunkPos );
+  *chunkOut = slot.chunk;
+  if( !slot.chunk )
+  {
+    *lightOut = slot.interior ? aeFloat16( 0.0f ) : kSkyBrightness;
+    return !slot.interior;
+  }
+  const ae::Int3 l = *localOut;
+  *lightOut = slot.chunk->l[ l.x ][ l.y ][ l.z ];
+  return _IsLightTransparent( slot.chunk->t[ l.x ][ l.y ][ l.z ] );
+}
+
+//------------------------------------------------------------------------------
+// Terrain member functions
+//------------------------------------------------------------------------------
+Terrain::Terrain() :
+  sdf( this ),
+  m_light( this )
+{}
+
+Terrain::~Terrain()
+{
+  Terminate();
+}
+
+void Terrain::Initialize( uint32_t maxThreads, bool render )
+{
+  // @NOTE: This doesn't handle the case where enough verts are split
+  // that the count surpasses TerrainIndex max.
+  AE_ASSERT( kMaxChunkVerts <= VertexCount( ae::MaxValue< TerrainIndex >() ) );
+
+  m_render = render;
+
+  //m_chunkPool.Initialize(); @TODO: Reset pool
+  
+  for( uint32_t i = 0; i < Block::COUNT; i++) { m_blockCollision[ i ] = true; }
+  m_blockCollision[ Block::Exterior ] = false;
+  m_blockCollision[ Block::Unloaded ] = false;
+  
+  for( uint32_t i = 0; i < Block::COUNT; i++) { m_blockDensity[ i ] = 1.0f; }
+
+  m_scheduler.Initialize( maxThreads );
+  m_schedulerCenter = m_center;
+  m_light.Initialize( maxThreads > 0 );
+  const uint32_t jobCount = maxThreads ? maxThreads * AE_TERRAIN_JOBS_PER_THREAD : 1;
+  for( uint32_t i = 0; i < jobCount; i++ )
+  {
+    m_terrainJobs.Append( ae::New< TerrainJob >( AE_ALLOC_TAG_TERRAIN ) );
+  }
+}
+
+void Terrain::Terminate()
+{
+  m_scheduler.Terminate();
+  m_light.Terminate();
+  m_voxels.Clear();
+
+  for( uint32_t i = 0; i < m_terrainJobs.Length(); i++ )
+  {
+    TerrainJob* job = m_terrainJobs[ i ];
+    if( job->IsPendingFinish() )
+    {
+      job->Finish();
+    }
+    ae::Delete( job );
+  }
+  m_terrainJobs.Clear();
+
+  for( TerrainChunk* next = m_chunkPool.GetFirst(); next;  )
+  {
+    TerrainChunk* current = next;
+    next = m_chunkPool.GetNext( next );
+    FreeChunk( current );
+  }
+  AE_ASSERT( m_chunkPool.Length() == 0 );
+}
+
+void Terrain::Update( ae::Vec3 center, float radius )
+{
+  int32_t chunkViewRadius = radius / kChunkSize;
+  const int32_t kChunkViewDiam = chunkViewRadius + chunkViewRadius;
+  m_idle = false;
+
+  // @NOTE: Chunks can't be loaded or freed while light is propagating
+  m_light.Wait();
+  // Free voxels replaced in previous updates once no other thread can be reading them
+  m_voxels.Reclaim();
+
+  m_center = center;
+  m_radius = radius;
+
+  //------------------------------------------------------------------------------
+  // Dirty the chunks containing sdf shapes that have been modified
+  //------------------------------------------------------------------------------
+  // @TODO: This isn't entirely thread safe... The memory location is guaranteed to
+  // be valid, but it's possible for values to change while another thread is reading
+  // them. It's possible these shapes could be accessed from a job. They should
+  // probably be duplicated and given to the job when it starts.
+  sdf.UpdateDirty();
+  
+  //------------------------------------------------------------------------------
+  // Determine which chunks will be processed
+  //------------------------------------------------------------------------------
+  //t_chunkMap.Clear();
+  //t_chunkMap.Reserve( kChunkViewDiam * kChunkViewDiam * kChunkViewDiam );
+  t_chunkMap_hack.clear();
+  ae::Int3 viewChunk = ( m_center / kChunkSize ).NearestCopy();
+  for( int32_t k = 0; k < kChunkViewDiam; k++ )
+  {
+    for( int32_t j = 0; j < kChunkViewDiam; j++ )
+    {
+      for( int32_t i = 0; i < kChunkViewDiam; i++ )
+      {
+        ae::Int3 chunkPos( i, j, k );
+        chunkPos -= ae::Int3( chunkViewRadius );
+        chunkPos += viewChunk;
+
+        ae::Vec3 chunkCenter = TerrainChunk::GetAABB( chunkPos ).GetCenter();
         float centerDistance = ( m_center - chunkCenter ).Length();
         if( centerDistance >= radius )
         {
@@ -1640,6 +2482,31 @@ void Terrain::Update( ae::Vec3 center, float radius )
     }
   }
   
+  //------------------------------------------------------------------------------
+  // Cancel terrain jobs for chunks that have moved out of range, and re-score
+  // queued jobs when the center moves
+  //------------------------------------------------------------------------------
+  for( uint32_t i = 0; i < m_terrainJobs.Length(); i++ )
+  {
+    TerrainJob* job = m_terrainJobs[ i ];
+    if( !job->HasJob() || job->IsPendingFinish() || job->IsCancelRequested() )
+    {
+      continue;
+    }
+    // @NOTE: Allow an extra chunk of distance so jobs at the edge of the view
+    // radius aren't repeatedly cancelled and restarted
+    ae::Vec3 chunkCenter = job->GetChunk()->GetAABB().GetCenter();
+    if( ( m_center - chunkCenter ).Length() >= radius + kChunkSize )
+    {
+      m_scheduler.Cancel( job );
+    }
+  }
+  if( ( m_center - m_schedulerCenter ).Length() >= kChunkSize * 0.5f )
+  {
+    m_scheduler.Reprioritize( [ this ]( const TerrainJob* job ) { return GetChunkScore( job->GetChunk()->m_pos ); } );
+    m_schedulerCenter = m_center;
+  }
+  
   //------------------------------------------------------------------------------
   // Finish terrain jobs
   // @NOTE: Do this as late as possible so jobs can run while sorting is happening
@@ -1656,12 +2523,30 @@ void Terrain::Update( ae::Vec3 center, float radius )
     AE_ASSERT( newChunk );
     AE_ASSERT( newChunk->m_check == 0xCDCDCDCD );
     uint32_t chunkIndex = newChunk->GetIndex();
+    ae::Int3 chunkPos = newChunk->m_pos;
+    if( job->IsCancelled() )
+    {
+      if( AE_TERRAIN_LOG )
+      {
+        AE_LOG( "Cancel terrain job # #", chunkIndex, newChunk->GetAABB() );
+      }
+      // @NOTE: The dirty flag was cleared when the job started, so set it again
+      // to regenerate the chunk if it comes back into range
+      if( TerrainChunk* oldChunk = GetChunk( chunkIndex ) )
+      {
+        oldChunk->m_geoDirty = true;
+      }
+      FreeChunk( newChunk );
+      job->Finish();
+      continue;
+    }
     if( AE_TERRAIN_LOG )
     {
       AE_LOG( "Finish terrain job # #", newChunk->GetIndex(), newChunk->GetAABB() );
     }
 
     TerrainChunk* oldChunk = GetChunk( chunkIndex );
+    const bool wasInterior = ( GetVertexCount( chunkIndex ) == kChunkCountInterior );
 
     VertexCount vertexCount = job->GetVertexCount();
     AE_ASSERT( vertexCount <= kMaxChunkVerts );
@@ -1679,8 +2564,6 @@ void Terrain::Update( ae::Vec3 center, float radius )
         newChunk->m_SetVertexData( job->GetVertices(), job->GetIndices(), vertexCount, job->GetIndexCount() );
       }
 
-      // Ready for lighting
-      newChunk->m_lightDirty = true;
       if( oldChunk )
       {
         // @NOTE: Copy dirty flag to new chunk in case it's been modified since the job started.
@@ -1688,6 +2571,15 @@ void Terrain::Update( ae::Vec3 center, float radius )
       }
     }
 
+    m_light.QueueChunk( chunkPos, oldChunk, newChunk, wasInterior, vertexCount == kChunkCountInterior );
+    if( newChunk )
+    {
+      m_voxels.Publish( chunkIndex, job->TakeVoxels() );
+    }
+    else
+    {
+      m_voxels.Publish( chunkIndex, TerrainVoxelTable::GetUniform( ( vertexCount == kChunkCountInterior ) ? Block::Interior : Block::Exterior ) );
+    }
     if( oldChunk )
     {
       // @NOTE: Replace old chunk in sorted list with the job chunk
@@ -1717,7 +2609,9 @@ void Terrain::Update( ae::Vec3 center, float radius )
     job->Finish();
   }
 
-  if( m_threadPool->size() == 0 || m_threadPool->n_idle() == m_threadPool->size() )
+  // @NOTE: Chunks dirtied by new or removed shapes are only sorted next update
+  bool idle = !sdf.HasPending();
+  if( m_scheduler.IsIdle() )
   {
     // "Commit" changes to sdf safely while no jobs are running
     sdf.UpdatePending();
@@ -1725,6 +2619,7 @@ void Terrain::Update( ae::Vec3 center, float radius )
   else if( sdf.HasPending() )
   {
     // Don't start new terrain jobs if sdf has changed
+    m_light.Start();
     return;
   }
 
@@ -1760,11 +2655,7 @@ void Terrain::Update( ae::Vec3 center, float radius )
 
     if( !chunk || chunk->m_geoDirty )
     {
-      if( m_threadPool->n_idle() == 0 && m_threadPool->size() > 0 )
-      {
-        break;
-      }
-
+      idle = false;
       int32_t jobIndex = m_terrainJobs.FindFn( []( TerrainJob* j ) { return !j->HasJob(); } );
       if( jobIndex < 0 )
       {
@@ -1800,6 +2691,8 @@ void Terrain::Update( ae::Vec3 center, float radius )
             // @NOTE: Always steal the lowest priority chunk to regenerate dirty chunks
             if( chunkDirty || other->score > chunkSort->score )
             {
+              m_light.QueueChunk( other->c->m_pos, other->c, nullptr, false, false );
+              m_voxels.Publish( other->c->GetIndex(), TerrainVoxelTable::GetUniform( Block::Unloaded ) );
               FreeChunk( other->c );
               t_chunkSorts.Remove( i );
 
@@ -1833,18 +2726,10 @@ void Terrain::Update( ae::Vec3 center, float radius )
       job->StartNew( m_params, &sdf, chunk );
       // @NOTE: replaceDirty_CHECK doesn't do anything, but is used to assert when the job
       // is done that another chunk is being replaced.
-      if( m_threadPool->size() )
-      {
-        m_threadPool->push( [ job ]( int id )
-        {
-          AE_ASSERT( job );
-          AE_ASSERT( job->GetChunk() );
-          job->Do();
-        } );
-      }
-      else
+      m_scheduler.Submit( job, chunkSort->score );
+      if( !m_scheduler.GetWorkerCount() )
       {
-        job->Do();
+        m_scheduler.RunNext();
         break;
       }
     }
@@ -1865,6 +2750,9 @@ void Terrain::Update( ae::Vec3 center, float radius )
 
     sdf.RenderDebug( m_params.debug );
   }
+
+  m_light.Start();
+  m_idle = idle && !m_light.HasPending() && m_terrainJobs.FindFn( []( TerrainJob* j ) { return j->HasJob(); } ) < 0;
 }
 
 void Terrain::Render( const ae::Shader* shader, const ae::UniformList& shaderParams )
@@ -1955,6 +2843,7 @@ void Terrain::m_Dirty( ae::AABB aabb )
         AE_LOG( "Dirty chunk #", pos );
       }
       m_SetVertexCount( TerrainChunk::GetIndex( pos ), kChunkCountDirty );
+      m_voxels.Publish( TerrainChunk::GetIndex( pos ), TerrainVoxelTable::GetUniform( Block::Unloaded ) );
     }
   }
 }
@@ -1964,6 +2853,11 @@ bool Terrain::GetCollision( int32_t x, int32_t y, int32_t z ) const
   return m_blockCollision[ GetVoxel( x, y, z ) ];
 }
 
+bool Terrain::GetCollision( const TerrainVoxelTable::Reader& reader, int32_t x, int32_t y, int32_t z ) const
+{
+  return m_blockCollision[ GetVoxel( reader, x, y, z ) ];
+}
+
 bool Terrain::GetCollision( ae::Vec3 position ) const
 {
   Block::Type type = GetVoxel(
@@ -1984,19 +2878,19 @@ Block::Type Terrain::GetVoxel( ae::Vec3 position ) const
 }
 
 Block::Type Terrain::GetVoxel( int32_t x, int32_t y, int32_t z ) const
+{
+  TerrainVoxelTable::Reader reader( &m_voxels );
+  return GetVoxel( reader, x, y, z );
+}
+
+Block::Type Terrain::GetVoxel( const TerrainVoxelTable::Reader& reader, int32_t x, int32_t y, int32_t z ) const
 {
   ae::Int3 chunkPos, localPos;
   TerrainChunk::GetPosFromWorld( ae::Int3( x, y, z ), &chunkPos, &localPos );
-  uint32_t ci = TerrainChunk::GetIndex( chunkPos );
-
-  VertexCount vc = GetVertexCount( ci );
-  if( vc == kChunkCountEmpty ) { return Block::Exterior; }
-  if( vc == kChunkCountDirty ) { return Block::Unloaded; }
-  if( vc == kChunkCountInterior ) { return Block::Interior; }
-
-  const TerrainChunk* chunk = GetChunk( ci );
-  if( !chunk ) { return Block::Unloaded; }
-  return chunk->m_t[ localPos.x ][ localPos.y ][ localPos.z ];
+  // @NOTE: Reads published voxels instead of chunks so this is safe to call
+  // from any thread. Chunks that were never generated are empty.
+  const TerrainVoxelTable::Voxels* voxels = reader.Get( TerrainChunk::GetIndex( chunkPos ) );
+  return voxels ? voxels->Get( localPos.x, localPos.y, localPos.z ) : Block::Exterior;
 }
 
 //bool Terrain::m_GetVertex( int32_t x, int32_t y, int32_t z, TerrainVertex* outVertex ) const
@@ -2034,16 +2928,15 @@ Block::Type Terrain::GetVoxel( int32_t x, int32_t y, int32_t z ) const
 
 aeFloat16 Terrain::GetLight( int32_t x, int32_t y, int32_t z ) const
 {
-  const TerrainChunk* chunk = GetChunk( ae::Int3( x, y, z ) );
+  ae::Int3 chunkPos, localPos;
+  TerrainChunk::GetPosFromWorld( ae::Int3( x, y, z ), &chunkPos, &localPos );
+  const TerrainChunk* chunk = GetChunk( chunkPos );
   if( chunk == nullptr )
   {
-    return kSkyBrightness;
+    // @NOTE: Matches how TerrainLight treats chunks that aren't loaded
+    return ( GetVertexCount( chunkPos ) == kChunkCountInterior ) ? aeFloat16( 0.0f ) : kSkyBrightness;
   }
-
-  x = ae::Mod( x, (int32_t)kChunkSize );
-  y = ae::Mod( y, (int32_t)kChunkSize );
-  z = ae::Mod( z, (int32_t)kChunkSize );
-  return chunk->m_l[ x ][ y ][ z ];
+  return chunk->m_l.Get( localPos.x, localPos.y, localPos.z );
 }
 
 //------------------------------------------------------------------------------
@@ -2105,6 +2998,37 @@ namespace
     }
     return p + d * tmin;
   }
+
+  // Remembers the last chunk touched by a ray so voxel lookups only search the
+  // voxel table when the ray crosses a chunk border
+  struct VoxelRayChunkCache
+  {
+    Block::Type Get( const TerrainVoxelTable::Reader& reader, ae::Int3 pos )
+    {
+      ae::Int3 chunkPos(
+        ( pos.x >= 0 ? pos.x : pos.x - (int32_t)kChunkSize + 1 ) / (int32_t)kChunkSize,
+        ( pos.y >= 0 ? pos.y : pos.y - (int32_t)kChunkSize + 1 ) / (int32_t)kChunkSize,
+        ( pos.z >= 0 ? pos.z : pos.z - (int32_t)kChunkSize + 1 ) / (int32_t)kChunkSize
+      );
+      if( !valid || chunkPos != this->chunkPos )
+      {
+        // @NOTE: Matches Terrain::GetVoxel()
+        voxels = reader.Get( TerrainChunk::GetIndex( chunkPos ) );
+        this->chunkPos = chunkPos;
+        valid = true;
+      }
+      if( !voxels )
+      {
+        return Block::Exterior;
+      }
+      ae::Int3 local = pos - chunkPos * kChunkSize;
+      return voxels->Get( local.x, local.y, local.z );
+    }
+
+    const TerrainVoxelTable::Voxels* voxels = nullptr;
+    ae::Int3 chunkPos;
+    bool valid = false;
+  };
 }
 
 //------------------------------------------------------------------------------
@@ -2214,8 +3138,12 @@ bool Terrain::VoxelRaycast( ae::Vec3 start, ae::Vec3 ray, int32_t minSteps ) con
     return false;
   }
   
+  // @NOTE: One reader for the whole ray so it only searches the voxel table
+  // when crossing a chunk border
+  TerrainVoxelTable::Reader reader( &m_voxels );
+  VoxelRayChunkCache cache;
   int32_t steps = 0;
-  while( !GetCollision( x, y, z ) || steps < minSteps )
+  while( !m_blockCollision[ cache.Get( reader, ae::Int3( x, y, z ) ) ] || steps < minSteps )
   {
     if( m_params.debug )
     {
@@ -2279,6 +3207,94 @@ bool Terrain::VoxelRaycast( ae::Vec3 start, ae::Vec3 ray, int32_t minSteps ) con
   return true;
 }
 
+void Terrain::VoxelRaycast( const ae::Vec3* starts, const ae::Vec3* rays, uint32_t count, TerrainRaycastResult* resultsOut ) const
+{
+  // @NOTE: One reader for the whole batch instead of one per voxel
+  TerrainVoxelTable::Reader reader( &m_voxels );
+  for( uint32_t i = 0; i < count; i++ )
+  {
+    const ae::Vec3 start = starts[ i ];
+    const ae::Vec3 ray = rays[ i ];
+    TerrainRaycastResult& result = resultsOut[ i ];
+    result.hit = false;
+    result.type = Block::Exterior;
+    result.distance = ray.Length();
+    result.posi = ae::Int3( ae::Floor( start.x ), ae::Floor( start.y ), ae::Floor( start.z ) );
+    result.posf = start + ray;
+    result.normal = ae::Vec3( 0.0f );
+    result.touchedUnloaded = false;
+    if( ray.LengthSquared() < 0.001f )
+    {
+      continue;
+    }
+    
+    // @NOTE: Same setup and stepping as the single ray VoxelRaycast() so both
+    // visit the same voxels, even when a ray passes exactly through an edge
+    const ae::Vec3 dir = ray.SafeNormalizeCopy();
+    const ae::Vec3 end = start + ray;
+    ae::Int3 voxel = result.posi;
+    ae::Int3 step, out;
+    ae::Vec3 tMax, tDelta( 0.0f );
+    for( uint32_t axis = 0; axis < 3; axis++ )
+    {
+      int32_t boundary;
+      if( dir[ axis ] > 0.0f )
+      {
+        step[ axis ] = 1;
+        out[ axis ] = ceil( end[ axis ] );
+        boundary = voxel[ axis ] + 1;
+      }
+      else
+      {
+        step[ axis ] = -1;
+        out[ axis ] = ae::Floor( end[ axis ] ) - 1;
+        boundary = voxel[ axis ];
+      }
+      if( dir[ axis ] != 0.0f )
+      {
+        const float r = 1.0f / dir[ axis ];
+        tMax[ axis ] = ( boundary - start[ axis ] ) * r;
+        tDelta[ axis ] = step[ axis ] * r;
+      }
+      else
+      {
+        tMax[ axis ] = 1000000;
+      }
+    }
+    
+    VoxelRayChunkCache cache;
+    float t = 0.0f;
+    ae::Vec3 normal( 0.0f );
+    while( true )
+    {
+      const Block::Type type = cache.Get( reader, voxel );
+      result.touchedUnloaded = result.touchedUnloaded || ( type == Block::Unloaded );
+      if( m_blockCollision[ type ] )
+      {
+        result.hit = true;
+        result.type = type;
+        result.distance = t;
+        result.posi = voxel;
+        result.posf = start + dir * t;
+        result.normal = normal;
+        break;
+      }
+      
+      // Step into the next voxel (Amanatides-Woo)
+      const uint32_t axis = ( tMax.x < tMax.y ) ? ( ( tMax.x < tMax.z ) ? 0 : 2 ) : ( ( tMax.y < tMax.z ) ? 1 : 2 );
+      voxel[ axis ] += step[ axis ];
+      if( voxel[ axis ] == out[ axis ] )
+      {
+        break;
+      }
+      t = tMax[ axis ];
+      tMax[ axis ] += tDelta[ axis ];
+      normal = ae::Vec3( 0.0f );
+      normal[ axis ] = -step[ axis ];
+    }
+  }
+}
+
 //TerrainRaycastResult Terrain::RaycastFast( ae::Vec3 start, ae::Vec3 ray, bool allowSourceCollision ) const
 //{
 //  DebugRay debugRay( start, ray, m_params.debug );
@@ -2470,23 +3486,46 @@ bool Terrain::VoxelRaycast( ae::Vec3 start, ae::Vec3 ray, int32_t minSteps ) con
 //  return result;
 //}
 
-bool Terrain::Raycast( const ae::RaycastParams& _params, ae::RaycastResult* outResult ) const
+bool Terrain::Raycast( const ae::RaycastParams& params, ae::RaycastResult* outResult ) const
 {
-  ae::Vec3 start = _params.source;
-  ae::Vec3 ray = _params.ray;
+  ae::CollisionMeshRaycastParams meshRaycastParams;
+  meshRaycastParams.debug = m_params.debug;
+  ae::RaycastResult resultsAccum;
+  m_RaycastChunks( params, [&]( const TerrainChunk* chunk )
+  {
+    resultsAccum = chunk->m_mesh.Raycast( params, meshRaycastParams, resultsAccum );
+    return true;
+  } );
+  if( outResult )
+  {
+    *outResult = resultsAccum;
+  }
+  return resultsAccum.hits.Length();
+}
+
+bool Terrain::RaycastEach( const ae::RaycastParams& params, std::function< bool( const ae::RaycastResult::Hit& ) > hitFn ) const
+{
+  ae::CollisionMeshRaycastParams meshRaycastParams;
+  meshRaycastParams.debug = m_params.debug;
+  return m_RaycastChunks( params, [&]( const TerrainChunk* chunk )
+  {
+    return chunk->m_mesh.RaycastEach( params, hitFn, meshRaycastParams );
+  } );
+}
+
+bool Terrain::m_RaycastChunks( const ae::RaycastParams& params, std::function< bool( const TerrainChunk* ) > chunkFn ) const
+{
+  ae::Vec3 start = params.source;
+  ae::Vec3 ray = params.ray;
   ae::Vec3 dir = ray;
   float length = dir.SafeNormalize();
   DebugRay debugRay( start, ray, m_params.debug );
   
   if( length < 0.001f )
   {
-    return false;
+    return true;
   }
   
-  ae::RaycastParams params = _params;
-  ae::CollisionMeshRaycastParams meshRaycastParams;
-  meshRaycastParams.debug = m_params.debug;
-  
   start /= kChunkSize;
   ray /= kChunkSize;
   
@@ -2581,17 +3620,15 @@ bool Terrain::Raycast( const ae::RaycastParams& _params, ae::RaycastResult* outR
   AE_DEBUG_ASSERT( tdelta != ae::Vec3( 0.0f ) );
   if( tdelta == ae::Vec3( 0.0f ) )
   {
-    return false;
+    return true;
   }
 
-
-  ae::RaycastResult resultsAccum;
   while( true )
   {
     const TerrainChunk* chunk = GetChunk( ae::Int3( x, y, z ) );
-    if( chunk )
+    if( chunk && !chunkFn( chunk ) )
     {
-      resultsAccum = chunk->m_mesh.Raycast( params, meshRaycastParams, resultsAccum );
+      return false;
     }
     
     if( tmax.x < tmax.y )
@@ -2637,12 +3674,7 @@ bool Terrain::Raycast( const ae::RaycastParams& _params, ae::RaycastResult* outR
       }
     }
   }
-
-  if( outResult )
-  {
-    *outResult = resultsAccum;
-  }
-  return resultsAccum.hits.Length();
+  return true;
 }
 
 ae::PushOutInfo Terrain::PushOutSphere( const ae::PushOutParams& _params, const ae::PushOutInfo& info ) const
@@ -430,6 +430,8 @@ void TerrainSdf::UpdatePending()
   // @NOTE: UpdatePending() is called when no terrain jobs are running,
   // so it's safe to modify the terrain shapes array
 
+  m_bvhDirty |= HasPending();
+
   // Old
   for( uint32_t i = 0; i < m_pendingDestroy.Length(); i++ )
   {
@@ -439,7 +441,10 @@ void TerrainSdf::UpdatePending()
     AE_ASSERT( index >= 0 );
     m_shapes.Remove( index );
 
-    m_terrain->m_Dirty( shape->GetAABB() );
+    if( m_terrain )
+    {
+      m_terrain->m_Dirty( shape->GetAABB() );
+    }
     ae::Delete( shape );
   }
   m_pendingDestroy.Clear();
@@ -449,12 +454,114 @@ void TerrainSdf::UpdatePending()
   {
     Sdf* shape = m_pendingCreated[ i ];
     m_shapes.Append( shape );
-    m_terrain->m_Dirty( shape->GetAABB() );
+    if( m_terrain )
+    {
+      m_terrain->m_Dirty( shape->GetAABB() );
+    }
 
     shape->m_dirty = false;
     shape->m_aabbPrev = shape->GetAABB();
   }
   m_pendingCreated.Clear();
+
+  m_UpdateBVH();
+}
+
+void TerrainSdf::UpdateDirty()
+{
+  for( Sdf* shape : m_shapes )
+  {
+    if( !shape->m_dirty )
+    {
+      continue;
+    }
+    if( m_terrain )
+    {
+      m_terrain->m_Dirty( shape->m_aabbPrev );
+      m_terrain->m_Dirty( shape->GetAABB() );
+    }
+    shape->m_dirty = false;
+    shape->m_aabbPrev = shape->GetAABB();
+    
+    AE_ASSERT( shape->m_bvhNodeIdx >= 0 );
+    m_bvh.Refit( shape->m_bvhNodeIdx, m_GetBVHShapeAABB );
+    m_bvhRefitCount++;
+  }
+  
+  // @NOTE: Refitting keeps the tree built for the original shape positions, so
+  // queries get slower as shapes move away. Rebuild once there have been as
+  // many refits as shapes to keep the cost of rebuilding amortized.
+  if( m_bvhRefitCount > m_shapes.Length() )
+  {
+    m_bvhDirty = true;
+    m_UpdateBVH();
+  }
+}
+
+void TerrainSdf::GetShapes( const ae::AABB& aabb, ae::Array< Sdf* >* shapesOut ) const
+{
+  AE_ASSERT_MSG( !m_bvhDirty, "Shapes were modified since the last TerrainSdf::UpdatePending()" );
+  // @NOTE: Shapes are gathered into a local array so they can be sorted by
+  // their original index before being appended to 'shapesOut'
+  ae::Array< BVHShape > shapes = AE_ALLOC_TAG_TERRAIN;
+  m_bvh.QueryAABB( aabb, [&]( const ae::BVHLeaf< BVHShape >& leaf )
+  {
+    for( uint32_t i = 0; i < leaf.count; i++ )
+    {
+      const BVHShape& s = leaf.data[ i ];
+      if( s.shape->GetAABB().Intersect( aabb ) )
+      {
+        shapes.Append( s );
+      }
+    }
+    return true;
+  } );
+  std::sort( shapes.begin(), shapes.end(), []( const BVHShape& s0, const BVHShape& s1 )
+  {
+    return s0.index < s1.index;
+  } );
+  for( const BVHShape& s : shapes )
+  {
+    shapesOut->Append( s.shape );
+  }
+}
+
+void TerrainSdf::m_UpdateBVH()
+{
+  // @NOTE: Rebuilding is only required when shapes are created or destroyed,
+  // moved shapes are refit by UpdateDirty(). Jobs work on clones of their
+  // shapes so this never races with them.
+  if( !m_bvhDirty )
+  {
+    return;
+  }
+  m_bvhDirty = false;
+  m_bvhRefitCount = 0;
+  m_bvhShapes.Clear();
+  m_bvh.Clear();
+  if( !m_shapes.Length() )
+  {
+    return;
+  }
+  m_bvhShapes.Reserve( m_shapes.Length() );
+  for( uint32_t i = 0; i < m_shapes.Length(); i++ )
+  {
+    m_bvhShapes.Append( { m_shapes[ i ], i } );
+  }
+  m_bvh.Build( m_bvhShapes.begin(), m_bvhShapes.Length(), m_GetBVHShapeAABB, 4 );
+  // Remember each shape's leaf so it can be refit when moved
+  for( uint32_t i = 0; i < m_bvh.GetNodeCount(); i++ )
+  {
+    const ae::BVHNode* node = m_bvh.GetNode( i );
+    if( node->leafIdx >= 0 )
+    {
+      const ae::BVHLeaf< BVHShape >& leaf = m_bvh.GetLeaf( node->leafIdx );
+      for( uint32_t j = 0; j < leaf.count; j++ )
+      {
+        leaf.data[ j ].shape->m_bvhNodeIdx = (int32_t)i;
+      }
+    }
+  }
 }
 
 bool TerrainSdf::HasPending() const
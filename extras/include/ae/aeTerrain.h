@@ -27,8 +27,12 @@
 //------------------------------------------------------------------------------
 // Headers
 //------------------------------------------------------------------------------
+#include <algorithm>
 #include <atomic>
+#include <condition_variable>
 #include <map>
+#include <mutex>
+#include <thread>
 #include <type_traits>
 #include "aether.h"
 #include "ae/aeCompactingAllocator.h"
@@ -79,11 +83,6 @@ inline std::ostream& operator<<( std::ostream& os, const aeUnit< T >& u )
   return os << (T)u;
 }
 
-namespace ctpl
-{
-  class thread_pool;
-}
-
 typedef float aeFloat16;
 
 //------------------------------------------------------------------------------
@@ -95,6 +94,7 @@ namespace ae {
 // Terrain types
 //------------------------------------------------------------------------------
 typedef uint8_t TerrainMaterialId;
+template< typename T > class TerrainVoxelGrid;
 
 struct TerrainVertex
 {
@@ -130,6 +130,7 @@ const VertexCount kMaxChunkVerts = VertexCount( ae::MaxValue< uint16_t >() );
 const uint32_t kMaxChunkIndices = uint32_t( kMaxChunkVerts ) * 6; // Average vertex valence
 const uint32_t kMaxChunkAllocationsPerTick = 1;
 const aeFloat16 kSkyBrightness = aeFloat16( 5.0f );
+const aeFloat16 kLightFalloff = aeFloat16( 0.25f ); // Light lost per voxel, except for sky light travelling down
 const float kSdfBoundary = 2.0f;
 
 struct Block
@@ -224,6 +225,7 @@ public:
   // Internal
   bool m_dirty = false;
   ae::AABB m_aabbPrev;
+  int32_t m_bvhNodeIdx = -1; // Leaf node containing this shape in TerrainSdf's bvh
 };
 template<> inline uint32_t GetHash32( const Sdf::Type& value ) { return (std::underlying_type_t< Sdf::Type >)value; }
 
@@ -297,6 +299,7 @@ struct TerrainParams
 class TerrainSdf
 {
 public:
+  // 'terrain' may be null when the shapes aren't used to generate a Terrain, ie. sampled directly by TerrainJobs
   TerrainSdf( class Terrain* terrain );
 
   template< typename T >
@@ -305,18 +308,35 @@ public:
 
   void UpdatePending();
   bool HasPending() const;
+  // Applies changes to shapes that called Sdf::Dirty() since the last call.
+  // Unlike UpdatePending() this can be called while jobs are running.
+  void UpdateDirty();
   void RenderDebug( ae::DebugLines* debug );
   
   uint32_t GetShapeCount() const { return m_shapes.Length(); }
   Sdf* GetShapeAtIndex( uint32_t index ) const { return m_shapes[ index ]; }
+  // Appends shapes overlapping 'aabb' to 'shapesOut' in the same order as GetShapeAtIndex()
+  void GetShapes( const ae::AABB& aabb, ae::Array< Sdf* >* shapesOut ) const;
   
   TerrainNoise noise;
 
 private:
-  friend class Terrain;
+  void m_UpdateBVH();
+
+  struct BVHShape
+  {
+    Sdf* shape;
+    uint32_t index;
+  };
+  static ae::AABB m_GetBVHShapeAABB( const BVHShape& s ) { return s.shape->GetAABB(); }
 
   class Terrain* m_terrain;
   ae::Array< Sdf* > m_shapes = AE_ALLOC_TAG_TERRAIN;
+  // @NOTE: Built from copies of m_shapes because ae::BVH::Build() reorders its input
+  ae::Array< BVHShape > m_bvhShapes = AE_ALLOC_TAG_TERRAIN;
+  ae::BVH< BVHShape > m_bvh = AE_ALLOC_TAG_TERRAIN;
+  bool m_bvhDirty = false;
+  uint32_t m_bvhRefitCount = 0;
   ae::Array< Sdf* > m_shapesPrev = AE_ALLOC_TAG_TERRAIN;
   ae::Array< Sdf* > m_pendingCreated = AE_ALLOC_TAG_TERRAIN;
   ae::Array< Sdf* > m_pendingDestroy = AE_ALLOC_TAG_TERRAIN;
@@ -371,12 +391,18 @@ public:
   TerrainJob();
   ~TerrainJob();
   void StartNew( const TerrainParams& params, const TerrainSdf* sdf, struct TerrainChunk* chunk );
-  void Do();
+  // Returns false if the job was cancelled before it finished
+  bool Do();
   void Finish();
+  // Can be called from any thread. Do() returns early without output, and
+  // IsCancelled() returns true once the job is pending finish.
+  void Cancel() { m_cancel = true; }
+  bool IsCancelRequested() const { return m_cancel; }
 
   bool HasJob() const { return m_hasJob; }
   bool HasChunk( ae::Int3 pos ) const;
   bool IsPendingFinish() const { return m_hasJob && !m_running; }
+  bool IsCancelled() const { return m_cancelled; }
 
   const TerrainChunk* GetChunk() const { return m_chunk; }
   TerrainChunk* GetChunk() { return m_chunk; }
@@ -384,15 +410,25 @@ public:
   const TerrainIndex* GetIndices() const { return m_indices.Data(); }
   VertexCount GetVertexCount() const { return m_vertexCount; }
   uint32_t GetIndexCount() const { return m_indexCount; }
+  // Returns the chunk voxels set by Do() and releases ownership of them, so
+  // they can be published to TerrainVoxelTable. These are the same voxels as
+  // TerrainChunk::m_t, not a copy.
+  TerrainVoxelGrid< Block::Type >* TakeVoxels();
   
   float GetValue( ae::Vec3 pos ) const;
   ae::Vec3 GetDerivative( ae::Vec3 pos ) const;
   TerrainMaterialId GetMaterial( ae::Vec3 pos, ae::Vec3 normal ) const;
 
 private:
+  // Reads and writes generated chunks to FileSystem::Root::Cache when TerrainParams::vfs is set
+  bool m_ReadCache( const char* filePath );
+  void m_WriteCache( const char* filePath ) const;
+
   // Management
   bool m_hasJob;
   std::atomic_bool m_running;
+  std::atomic_bool m_cancel;
+  bool m_cancelled;
 
   // Input
   ae::Hash32 m_parameterHash;
@@ -408,6 +444,7 @@ private:
   uint32_t m_indexCount;
   ae::Array< TerrainVertex > m_vertices;
   ae::Array< TerrainIndex > m_indices;
+  TerrainVoxelGrid< Block::Type >* m_voxels = nullptr;
 
 public:
   const TerrainParams& GetTerrainParams() const { return m_p; }
@@ -429,6 +466,452 @@ public:
   };
 
   TempEdges* edgeInfo;
+  
+  // Dense voxels written during generation and then compressed into the chunk
+  struct TempVoxels
+  {
+    Block::Type t[ kChunkSize ][ kChunkSize ][ kChunkSize ];
+    TerrainIndex i[ kChunkSize ][ kChunkSize ][ kChunkSize ];
+  };
+  
+  TempVoxels* voxelInfo;
+};
+
+//------------------------------------------------------------------------------
+// TerrainScheduler class
+// @NOTE: Runs TerrainJobs on worker threads, lowest score first. All workers
+//        pop from one shared priority queue, so jobs start in score order no
+//        matter which worker is free. Queued jobs can be cancelled or re-scored
+//        when the terrain center moves. All functions except the workers
+//        themselves are called from the thread that owns the Terrain.
+//------------------------------------------------------------------------------
+class TerrainScheduler
+{
+public:
+  struct Stats
+  {
+    uint32_t queueDepth = 0; // Jobs waiting for a worker
+    uint32_t maxQueueDepth = 0;
+    uint32_t runningCount = 0;
+    uint64_t submitCount = 0;
+    uint64_t completeCount = 0;
+    uint64_t cancelCount = 0; // Includes running jobs that stopped early
+    double averageLatency = 0.0; // Seconds from Submit() until a job finished running
+    double maxLatency = 0.0;
+  };
+
+  TerrainScheduler() = default;
+  ~TerrainScheduler();
+  // With no workers, queued jobs only run when RunNext() is called
+  void Initialize( uint32_t workerCount );
+  void Terminate();
+
+  void Submit( TerrainJob* job, float score );
+  // Removes the job from the queue, or asks it to stop early if it's running.
+  // Either way the job will become pending finish and IsCancelled().
+  void Cancel( TerrainJob* job );
+  // Recalculates the scores of all queued jobs
+  void Reprioritize( std::function< float( const TerrainJob* ) > scoreFn );
+  // Runs the lowest scoring queued job on the calling thread and returns it,
+  // or returns null if no jobs are queued
+  TerrainJob* RunNext();
+
+  bool IsIdle() const;
+  uint32_t GetWorkerCount() const { return m_workers.Length(); }
+  Stats GetStats() const;
+
+private:
+  struct Entry
+  {
+    TerrainJob* job;
+    float score;
+    double submitTime;
+    bool operator < ( const Entry& o ) const { return score > o.score; } // Lowest score on top of heap
+  };
+  void m_Run();
+  // These are called with m_lock held
+  Entry m_Pop();
+  void m_Finished( const Entry& entry, bool completed );
+
+  ae::Array< std::thread* > m_workers = AE_ALLOC_TAG_TERRAIN;
+  mutable std::mutex m_lock; // Guards everything below
+  std::condition_variable m_wake;
+  ae::Array< Entry > m_queue = AE_ALLOC_TAG_TERRAIN;
+  uint32_t m_runningCount = 0;
+  bool m_stop = false;
+  Stats m_stats;
+  double m_latencySum = 0.0;
+};
+
+//------------------------------------------------------------------------------
+// TerrainVoxelGrid class
+// @NOTE: Palette compressed kChunkSize^3 voxel grid. Each voxel stores a bit
+//        packed index into a palette of the unique values in the grid, so
+//        uniform grids store a single value and no indices at all. Indices are
+//        0, 1, 2, 4, 8 or 16 bits so they never straddle words. Grids with so
+//        many unique values that the palette and indices would be at least as
+//        large as the values themselves are stored dense instead. Generation
+//        works on a dense grid which is compressed with Set() when finished.
+//------------------------------------------------------------------------------
+template< typename T >
+class TerrainVoxelGrid
+{
+public:
+  static constexpr uint32_t kCount = kChunkSize * kChunkSize * kChunkSize;
+  static constexpr uint32_t kDenseBits = sizeof(T) * 8;
+  typedef T Dense[ kChunkSize ][ kChunkSize ][ kChunkSize ];
+
+  TerrainVoxelGrid( T value = T() ) { Clear( value ); }
+  // Sets every voxel to 'value' and releases all index storage
+  void Clear( T value );
+  // Compresses 'values' into the grid
+  void Set( const Dense& values );
+  // Decompresses the grid into 'valuesOut'
+  void Get( Dense& valuesOut ) const;
+  T Get( uint32_t x, uint32_t y, uint32_t z ) const;
+  
+  bool IsUniform() const { return m_bitsPerIndex == 0; }
+  bool IsDense() const { return m_bitsPerIndex == kDenseBits; }
+  // Returns kCount when the grid is dense
+  uint32_t GetPaletteSize() const { return m_palette.Length(); }
+  // Returns kDenseBits when the grid is dense
+  uint32_t GetBitsPerIndex() const { return m_bitsPerIndex; }
+  // Bytes used by the palette and indices
+  uint32_t GetMemoryUsage() const { return m_palette.Length() * sizeof(T) + m_words.Length() * sizeof(uint32_t); }
+  
+  void Serialize( ae::BinaryStream* stream );
+
+private:
+  // Palettes up to this size are searched linearly by Set(), larger ones are
+  // sorted. Large enough for every light level, see TerrainLight.
+  static constexpr uint32_t kLinearPaletteSize = 32;
+  static uint32_t m_GetBitsPerIndex( uint32_t paletteSize );
+  static uint32_t m_GetWordCount( uint32_t bitsPerIndex ) { const uint32_t perWord = 32 / bitsPerIndex; return ( kCount + perWord - 1 ) / perWord; }
+  static uint32_t m_GetKey( T value );
+  static T m_GetValue( uint32_t key );
+  bool m_SetLinear( const T* flat, uint16_t* indicesOut );
+  bool m_SetSorted( const T* flat, uint16_t* indicesOut );
+  uint32_t m_GetIndex( uint32_t voxel ) const;
+  
+  ae::Array< T > m_palette = AE_ALLOC_TAG_TERRAIN; // Every voxel value when dense
+  ae::Array< uint32_t > m_words = AE_ALLOC_TAG_TERRAIN;
+  uint32_t m_bitsPerIndex = 0;
+};
+
+template< typename T >
+void TerrainVoxelGrid< T >::Clear( T value )
+{
+  m_palette.Clear();
+  m_palette.Append( value );
+  m_words.Clear();
+  m_bitsPerIndex = 0;
+}
+
+template< typename T >
+void TerrainVoxelGrid< T >::Set( const Dense& values )
+{
+  // @NOTE: Dense grids are [x][y][z] so they can be walked as a flat array
+  const T* flat = &values[ 0 ][ 0 ][ 0 ];
+  ae::Scratch< uint16_t > indices( kCount );
+  m_palette.Clear();
+  m_words.Clear();
+  if( !m_SetLinear( flat, indices.Data() ) && !m_SetSorted( flat, indices.Data() ) )
+  {
+    m_palette.AppendArray( flat, kCount );
+    m_bitsPerIndex = kDenseBits;
+    return;
+  }
+  
+  m_bitsPerIndex = m_GetBitsPerIndex( m_palette.Length() );
+  if( m_bitsPerIndex )
+  {
+    const uint32_t perWord = 32 / m_bitsPerIndex;
+    m_words.Append( 0u, m_GetWordCount( m_bitsPerIndex ) );
+    for( uint32_t i = 0; i < kCount; i++ )
+    {
+      m_words[ i / perWord ] |= (uint32_t)indices[ i ] << ( ( i % perWord ) * m_bitsPerIndex );
+    }
+  }
+}
+
+template< typename T >
+bool TerrainVoxelGrid< T >::m_SetLinear( const T* flat, uint16_t* indicesOut )
+{
+  // @NOTE: Most grids only have a few unique values, so a linear search of
+  // the palette is faster than hashing or sorting every voxel
+  uint32_t keys[ kLinearPaletteSize ];
+  uint32_t prevKey = 0;
+  uint16_t prevIndex = 0;
+  for( uint32_t i = 0; i < kCount; i++ )
+  {
+    // Neighboring voxels usually match so skip the search for runs
+    const uint32_t key = m_GetKey( flat[ i ] );
+    if( i && key == prevKey )
+    {
+      indicesOut[ i ] = prevIndex;
+      continue;
+    }
+    uint16_t index = 0;
+    while( index < m_palette.Length() && keys[ index ] != key )
+    {
+      index++;
+    }
+    if( index == m_palette.Length() )
+    {
+      if( index == kLinearPaletteSize )
+      {
+        m_palette.Clear();
+        return false;
+      }
+      keys[ index ] = key;
+      m_palette.Append( flat[ i ] );
+    }
+    indicesOut[ i ] = index;
+    prevKey = key;
+    prevIndex = index;
+  }
+  if( m_GetBitsPerIndex( m_palette.Length() ) == kDenseBits )
+  {
+    // Small types such as bytes are dense before the palette is full
+    m_palette.Clear();
+    return false;
+  }
+  return true;
+}
+
+template< typename T >
+bool TerrainVoxelGrid< T >::m_SetSorted( const T* flat, uint16_t* indicesOut )
+{
+  // @NOTE: Returns false without setting the palette if the grid should be dense
+  ae::Scratch< uint32_t > keysScratch( kCount );
+  uint32_t* keysBegin = keysScratch.Data();
+  for( uint32_t i = 0; i < kCount; i++ )
+  {
+    keysBegin[ i ] = m_GetKey( flat[ i ] );
+  }
+  std::sort( keysBegin, keysBegin + kCount );
+  uint32_t* keysEnd = std::unique( keysBegin, keysBegin + kCount );
+  if( m_GetBitsPerIndex( (uint32_t)( keysEnd - keysBegin ) ) == kDenseBits )
+  {
+    return false;
+  }
+  for( const uint32_t* key = keysBegin; key != keysEnd; key++ )
+  {
+    m_palette.Append( m_GetValue( *key ) );
+  }
+  uint32_t prevKey = 0;
+  uint16_t prevIndex = 0;
+  for( uint32_t i = 0; i < kCount; i++ )
+  {
+    const uint32_t key = m_GetKey( flat[ i ] );
+    if( !i || key != prevKey )
+    {
+      prevIndex = (uint16_t)( std::lower_bound( keysBegin, keysEnd, key ) - keysBegin );
+      prevKey = key;
+    }
+    indicesOut[ i ] = prevIndex;
+  }
+  return true;
+}
+
+template< typename T >
+void TerrainVoxelGrid< T >::Get( Dense& valuesOut ) const
+{
+  T* flat = &valuesOut[ 0 ][ 0 ][ 0 ];
+  if( !m_bitsPerIndex )
+  {
+    std::fill( flat, flat + kCount, m_palette[ 0 ] );
+    return;
+  }
+  if( IsDense() )
+  {
+    std::copy( m_palette.begin(), m_palette.end(), flat );
+    return;
+  }
+  for( uint32_t i = 0; i < kCount; i++ )
+  {
+    flat[ i ] = m_palette[ m_GetIndex( i ) ];
+  }
+}
+
+template< typename T >
+T TerrainVoxelGrid< T >::Get( uint32_t x, uint32_t y, uint32_t z ) const
+{
+  AE_DEBUG_ASSERT( x < kChunkSize && y < kChunkSize && z < kChunkSize );
+  if( !m_bitsPerIndex )
+  {
+    return m_palette[ 0 ];
+  }
+  const uint32_t voxel = z + kChunkSize * ( y + kChunkSize * x );
+  return m_palette[ IsDense() ? voxel : m_GetIndex( voxel ) ];
+}
+
+template< typename T >
+void TerrainVoxelGrid< T >::Serialize( ae::BinaryStream* stream )
+{
+  uint32_t paletteSize = m_palette.Length();
+  uint32_t bitsPerIndex = m_bitsPerIndex;
+  stream->SerializeUInt32( paletteSize );
+  stream->SerializeUInt32( bitsPerIndex );
+  if( stream->AsReader() )
+  {
+    // @NOTE: Validate sizes before allocating so a corrupt stream can't request huge buffers
+    if( !stream->IsValid() || !paletteSize || paletteSize > kCount || bitsPerIndex != m_GetBitsPerIndex( paletteSize )
+      || ( bitsPerIndex == kDenseBits && paletteSize != kCount ) )
+    {
+      stream->Invalidate();
+      Clear( T() );
+      return;
+    }
+    m_palette.Clear();
+    m_palette.Append( T(), paletteSize );
+    m_words.Clear();
+    if( bitsPerIndex && bitsPerIndex != kDenseBits )
+    {
+      m_words.Append( 0u, m_GetWordCount( bitsPerIndex ) );
+    }
+    m_bitsPerIndex = bitsPerIndex;
+  }
+  stream->SerializeRaw( m_palette.Data(), m_palette.Length() * sizeof(T) );
+  stream->SerializeRaw( m_words.Data(), m_words.Length() * sizeof(uint32_t) );
+  if( stream->AsReader() )
+  {
+    bool valid = stream->IsValid();
+    for( uint32_t i = 0; valid && m_words.Length() && i < kCount; i++ )
+    {
+      valid = ( m_GetIndex( i ) < paletteSize );
+    }
+    if( !valid )
+    {
+      stream->Invalidate();
+      Clear( T() );
+    }
+  }
+}
+
+template< typename T >
+uint32_t TerrainVoxelGrid< T >::m_GetBitsPerIndex( uint32_t paletteSize )
+{
+  uint32_t bits = 0;
+  while( ( 1u << bits ) < paletteSize )
+  {
+    bits = bits ? bits * 2 : 1;
+  }
+  // Store values directly when that's no larger than the palette and indices
+  if( bits && paletteSize * sizeof(T) + m_GetWordCount( bits ) * sizeof(uint32_t) >= kCount * sizeof(T) )
+  {
+    return kDenseBits;
+  }
+  return bits;
+}
+
+template< typename T >
+uint32_t TerrainVoxelGrid< T >::m_GetKey( T value )
+{
+  AE_STATIC_ASSERT( sizeof(T) <= sizeof(uint32_t) );
+  uint32_t key = 0;
+  memcpy( &key, &value, sizeof(T) );
+  return key;
+}
+
+template< typename T >
+T TerrainVoxelGrid< T >::m_GetValue( uint32_t key )
+{
+  T value;
+  memcpy( &value, &key, sizeof(T) );
+  return value;
+}
+
+template< typename T >
+uint32_t TerrainVoxelGrid< T >::m_GetIndex( uint32_t voxel ) const
+{
+  const uint32_t perWord = 32 / m_bitsPerIndex;
+  const uint32_t mask = ( 1u << m_bitsPerIndex ) - 1;
+  return ( m_words[ voxel / perWord ] >> ( ( voxel % perWord ) * m_bitsPerIndex ) ) & mask;
+}
+
+//------------------------------------------------------------------------------
+// TerrainVoxelTable class
+// @NOTE: Maps chunk indices to immutable voxel grids so any thread can read
+//        voxels without locks while chunks are loaded and replaced. Jobs copy
+//        their chunk's voxels and the thread that owns the Terrain (the only
+//        writer) publishes them with an atomic pointer swap, so readers see
+//        either the old or the new grid. Replaced grids and outgrown tables
+//        are retired and only freed by Reclaim() once no reader can still be
+//        using them. Readers announce the epoch they started in with one of
+//        kReaderSlots slots.
+//------------------------------------------------------------------------------
+class TerrainVoxelTable
+{
+  struct Table;
+public:
+  typedef TerrainVoxelGrid< Block::Type > Voxels;
+  
+  TerrainVoxelTable();
+  ~TerrainVoxelTable();
+  
+  // Writer only. Takes ownership of 'voxels' unless it's from GetUniform().
+  void Publish( uint32_t chunkIndex, const Voxels* voxels );
+  // Writer only. Frees retired grids and tables that readers can no longer see.
+  void Reclaim();
+  // Writer only. There must be no readers.
+  void Clear();
+  // Writer only. Returns the number of grids and tables waiting for Reclaim().
+  uint32_t GetRetiredCount() const { return m_retired.Length(); }
+  
+  // Shared grids for chunks that aren't loaded
+  static const Voxels* GetUniform( Block::Type type );
+  
+  // Keeps all grids seen through it alive until it is destroyed. Get() always
+  // returns the latest grid, so chunks read at different times may come from
+  // different updates. Creating a Reader costs a few atomic operations and
+  // waits when kReaderSlots Readers already exist, so create one per batch of
+  // queries instead of one per query. Readers shouldn't be kept for long
+  // though, as they delay Reclaim().
+  class Reader
+  {
+  public:
+    Reader( const TerrainVoxelTable* table );
+    ~Reader();
+    // Returns null if nothing was published for the chunk
+    const Voxels* Get( uint32_t chunkIndex ) const;
+  private:
+    Reader( const Reader& ) = delete;
+    Reader& operator = ( const Reader& ) = delete;
+    const TerrainVoxelTable* m_owner;
+    const Table* m_table;
+    uint32_t m_slot;
+  };
+  
+  static const uint32_t kReaderSlots = 64;
+
+private:
+  struct Entry
+  {
+    std::atomic< uint64_t > key; // Chunk index with bit 32 set, or 0 if unused
+    std::atomic< const Voxels* > voxels;
+  };
+  struct Table
+  {
+    uint32_t capacity;
+    uint32_t count;
+    Entry* entries;
+  };
+  struct Retired
+  {
+    const Voxels* voxels;
+    Table* table;
+    uint64_t epoch;
+  };
+  static Table* m_NewTable( uint32_t capacity );
+  static void m_DeleteTable( Table* table );
+  static Entry* m_Find( const Table* table, uint64_t key );
+  static bool m_IsUniform( const Voxels* voxels );
+  
+  std::atomic< Table* > m_table;
+  std::atomic< uint64_t > m_epoch = { 1 };
+  mutable std::atomic< uint64_t > m_readers[ kReaderSlots ]; // Epoch of each active reader, or 0
+  ae::Array< Retired > m_retired = AE_ALLOC_TAG_TERRAIN;
 };
 
 //------------------------------------------------------------------------------
@@ -446,7 +929,7 @@ struct TerrainChunk
   static void GetPosFromWorld( ae::Int3 pos, ae::Int3* chunkPos, ae::Int3* localPos );
 
   uint32_t GetIndex() const;
-  void Generate( const TerrainSdfCache* sdf, const TerrainJob* job, TerrainJob::TempEdges* edgeBuffer, TerrainVertex* verticesOut, TerrainIndex* indexOut, VertexCount* vertexCountOut, uint32_t* indexCountOut );
+  void Generate( const TerrainSdfCache* sdf, const TerrainJob* job, TerrainJob::TempEdges* edgeBuffer, TerrainJob::TempVoxels* voxelBuffer, TerrainVertex* verticesOut, TerrainIndex* indexOut, VertexCount* vertexCountOut, uint32_t* indexCountOut );
   
   void Serialize( ae::BinaryStream* stream );
 
@@ -458,19 +941,114 @@ struct TerrainChunk
   uint32_t m_check;
   ae::Int3 m_pos;
   bool m_geoDirty;
-  bool m_lightDirty;
   ae::VertexBuffer m_data;
   ae::CollisionMesh<> m_mesh = AE_ALLOC_TAG_TERRAIN;
   ae::ListNode< TerrainChunk > m_generatedList;
   
-  Block::Type m_t[ kChunkSize ][ kChunkSize ][ kChunkSize ];
-  aeFloat16 m_l[ kChunkSize ][ kChunkSize ][ kChunkSize ];
-  TerrainIndex m_i[ kChunkSize ][ kChunkSize ][ kChunkSize ];
+  // @NOTE: Compressed because most chunks are uniform. Vertex indices per
+  // voxel are only needed during generation, see TerrainJob::TempVoxels.
+  // Owned by the TerrainJob generating the chunk and then by
+  // Terrain::m_voxels, which frees it once readers are done after the chunk
+  // is replaced. Never modified after generation.
+  TerrainVoxelGrid< Block::Type >* m_t = nullptr;
+  // @NOTE: Only written on the Terrain thread, see TerrainLight::Wait()
+  TerrainVoxelGrid< aeFloat16 > m_l = aeFloat16( 0.0f );
 
 private:
   static void m_GetQuadVertexOffsetsFromEdge( uint32_t edgeBit, int32_t( &offsets )[ 4 ][ 3 ] );
 };
 
+//------------------------------------------------------------------------------
+// TerrainLight class
+// @NOTE: Incremental flood fill lighting. Chunks that aren't loaded (and are
+//        not entirely interior) shine kSkyBrightness into their neighbors. Sky
+//        light travels straight down without falloff and loses kLightFalloff
+//        per voxel in every other direction. Only Block::Exterior and
+//        Block::Surface voxels carry light. Chunk changes queue removal and
+//        addition seeds so only voxels whose light changes are visited, even
+//        across chunk borders. Propagation runs in batches on its own thread
+//        while the Terrain isn't loading or freeing chunks, see Wait(). A
+//        single thread is used because the flood fill crosses chunk borders
+//        constantly, so per chunk locks would be taken on nearly every step.
+//------------------------------------------------------------------------------
+class TerrainLight
+{
+public:
+  TerrainLight( class Terrain* terrain ) : m_terrain( terrain ) {}
+  ~TerrainLight();
+  // Propagation runs in Start() when not threaded
+  void Initialize( bool threaded );
+  void Terminate();
+
+  // Queues light updates for the chunk at 'pos' changing from 'oldChunk' to
+  // 'newChunk'. Either can be null when the chunk isn't loaded, in which case
+  // 'wasInterior' and 'isInterior' say whether it blocks light.
+  void QueueChunk( ae::Int3 pos, const TerrainChunk* oldChunk, TerrainChunk* newChunk, bool wasInterior, bool isInterior );
+  // Starts propagating queued light updates. At most kBatchSize voxels are
+  // visited per call, and the rest are left for the next call.
+  void Start();
+  // Blocks until the batch started by Start() is finished and copies its
+  // results into TerrainChunk::m_l. This must be called before the Terrain
+  // loads, frees, or replaces chunks.
+  void Wait();
+  
+  // Returns true if a batch is running, there are queued light updates, or
+  // results are waiting to be copied into chunks by Wait()
+  bool HasPending() const;
+  
+  static const uint32_t kBatchSize = 1 << 16;
+
+private:
+  struct Removal
+  {
+    ae::Int3 pos;
+    aeFloat16 light; // Light before removal
+  };
+  // Decompressed light and block types of a loaded chunk. These are kept
+  // between batches until the chunk is replaced or there is no light left to
+  // propagate, so long running updates don't decompress chunks every batch.
+  struct Chunk
+  {
+    TerrainChunk* chunk;
+    TerrainVoxelGrid< Block::Type >::Dense t;
+    TerrainVoxelGrid< aeFloat16 >::Dense l;
+    TerrainVoxelGrid< aeFloat16 > result; // Compressed 'l', see m_Publish()
+    bool dirty; // 'l' modified since 'result' was set
+    bool hasResult; // 'result' not yet copied into TerrainChunk::m_l
+  };
+  struct Slot
+  {
+    Chunk* chunk; // Null if the chunk isn't loaded
+    bool interior;
+  };
+  void m_Run();
+  void m_Propagate();
+  // Terrain thread only
+  void m_Publish();
+  void m_FreeChunk( uint32_t index );
+  Slot m_GetSlot( ae::Int3 chunkPos );
+  // Returns true if the voxel at world position 'pos' carries light. 'chunkOut'
+  // is null if the chunk isn't loaded, and 'lightOut' is then constant.
+  bool m_GetVoxel( ae::Int3 pos, Chunk** chunkOut, ae::Int3* localOut, aeFloat16* lightOut );
+  
+  class Terrain* m_terrain;
+  ae::Array< Removal > m_removeQueue = AE_ALLOC_TAG_TERRAIN;
+  ae::Array< ae::Int3 > m_addQueue = AE_ALLOC_TAG_TERRAIN;
+  uint32_t m_removeHead = 0;
+  uint32_t m_addHead = 0;
+  
+  ae::Map< uint32_t, Slot > m_slots = AE_ALLOC_TAG_TERRAIN; // Current batch
+  ae::Map< uint32_t, Chunk* > m_chunks = AE_ALLOC_TAG_TERRAIN;
+  ae::Array< Chunk* > m_freeChunks = AE_ALLOC_TAG_TERRAIN;
+  
+  bool m_threaded = false;
+  std::thread m_thread;
+  mutable std::mutex m_lock;
+  std::condition_variable m_wake;
+  bool m_busy = false;
+  bool m_stop = false;
+};
+
 //------------------------------------------------------------------------------
 // Terrain class
 //------------------------------------------------------------------------------
@@ -489,12 +1067,25 @@ public:
   void GetParams( TerrainParams* outParams );
 
   void SetDebugTextCallback( std::function< void( ae::Vec3, const char* ) > fn ) { m_debugTextFn = fn; }
-  uint32_t GetMaxThreads() const { return m_terrainJobs.Length(); }
+  uint32_t GetMaxThreads() const { return ae::Max( 1u, m_scheduler.GetWorkerCount() ); }
+  TerrainScheduler::Stats GetSchedulerStats() const { return m_scheduler.GetStats(); }
+  // Returns true when the last Update() had no chunks to generate and no light left to propagate
+  bool IsIdle() const { return m_idle; }
   
+  // Voxel and collision queries can be called from any thread, even while
+  // Update() runs. Callers making many queries should create one
+  // TerrainVoxelTable::Reader from GetVoxelTable() and use the overloads
+  // taking it, instead of creating a Reader on every call.
   Block::Type GetVoxel( int32_t x, int32_t y, int32_t z ) const;
   Block::Type GetVoxel( ae::Vec3 position ) const;
+  Block::Type GetVoxel( const TerrainVoxelTable::Reader& reader, int32_t x, int32_t y, int32_t z ) const;
   bool GetCollision( int32_t x, int32_t y, int32_t z ) const;
   bool GetCollision( ae::Vec3 position ) const;
+  bool GetCollision( const TerrainVoxelTable::Reader& reader, int32_t x, int32_t y, int32_t z ) const;
+  const TerrainVoxelTable* GetVoxelTable() const { return &m_voxels; }
+  
+  // Not thread safe. Light is copied into chunks during Update(), so this must
+  // only be called from the thread calling Update().
   aeFloat16 GetLight( int32_t x, int32_t y, int32_t z ) const;
 
   TerrainChunk* GetChunk( uint32_t chunkIndex );
@@ -506,11 +1097,21 @@ public:
 
   // Simple voxel grid test
   bool VoxelRaycast( ae::Vec3 start, ae::Vec3 ray, int32_t minSteps ) const;
+  // Traces 'count' rays through the voxel grid with a DDA, stopping each at the
+  // first voxel with collision. Each ray goes from 'starts[ i ]' to
+  // 'starts[ i ] + rays[ i ]'. Visits the same voxels as the single ray
+  // version, but all rays share one TerrainVoxelTable::Reader and each only
+  // looks up its chunk when crossing a chunk border.
+  void VoxelRaycast( const ae::Vec3* starts, const ae::Vec3* rays, uint32_t count, TerrainRaycastResult* resultsOut ) const;
   // Uses voxel grid and terrain normal so position result is slightly lumpy (non-continuous)
   //TerrainRaycastResult RaycastFast( ae::Vec3 start, ae::Vec3 ray, bool allowSourceCollision ) const;
   
   // Triangle raycast against terrain
   bool Raycast( const ae::RaycastParams& params, ae::RaycastResult* outResult ) const;
+  // Calls hitFn for every triangle hit, chunk by chunk along the ray, with no
+  // limit on the number of hits. hitFn can return false to stop. Returns false
+  // if stopped early. See ae::CollisionMesh::RaycastEach().
+  bool RaycastEach( const ae::RaycastParams& params, std::function< bool( const ae::RaycastResult::Hit& ) > hitFn ) const;
   // Triangle-sphere push out
   ae::PushOutInfo PushOutSphere( const ae::PushOutParams& params, const ae::PushOutInfo& info ) const;
   
@@ -518,16 +1119,19 @@ public:
 
 private:
   //bool m_GetVertex( int32_t x, int32_t y, int32_t z, TerrainVertex* outVertex ) const;
-  void UpdateChunkLighting( TerrainChunk* chunk );
   
   TerrainChunk* AllocChunk( ae::Int3 pos );
   void FreeChunk( TerrainChunk* chunk );
   void m_SetVertexCount( uint32_t chunkIndex, VertexCount count );
   float GetChunkScore( ae::Int3 pos ) const;
+  // Calls chunkFn for each loaded chunk touched by the ray in order. Returns
+  // false if chunkFn returned false.
+  bool m_RaycastChunks( const ae::RaycastParams& params, std::function< bool( const TerrainChunk* ) > chunkFn ) const;
 
   TerrainParams m_params;
 
   bool m_render = false;
+  bool m_idle = false;
   ae::Vec3 m_center = ae::Vec3( 0.0f );
   float m_radius = 0.0f;
   
@@ -551,8 +1155,11 @@ private:
   bool m_blockCollision[ Block::COUNT ];
   aeFloat16 m_blockDensity[ Block::COUNT ];
   
-  ctpl::thread_pool* m_threadPool = nullptr;
+  TerrainScheduler m_scheduler;
+  ae::Vec3 m_schedulerCenter = ae::Vec3( 0.0f ); // Center when queued jobs were last scored
   ae::Array< TerrainJob* > m_terrainJobs = AE_ALLOC_TAG_TERRAIN; // @TODO: Should be static, and shouldn't be a pointer
+  TerrainLight m_light;
+  TerrainVoxelTable m_voxels; // Read by GetVoxel() from any thread
 
   std::function< void( ae::Vec3, const char* ) > m_debugTextFn;
 
@@ -0,0 +1,313 @@
+//------------------------------------------------------------------------------
+// BVHTest.cpp
+//------------------------------------------------------------------------------
+// Copyright (c) 2026 John Hughes
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files( the "Software" ), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and /or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions :
+//
+// The above copyright notice and this permission notice shall be included in all
+// copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+// SOFTWARE.
+//------------------------------------------------------------------------------
+// Headers
+//------------------------------------------------------------------------------
+#include <catch2/catch_test_macros.hpp>
+#include "aether.h"
+
+//------------------------------------------------------------------------------
+// BVH test helpers
+//------------------------------------------------------------------------------
+namespace
+{
+const ae::Tag TAG_BVH_TEST = "bvh_test";
+
+ae::Array< ae::Vec3 > GetRandomPoints( uint32_t count, uint64_t seed )
+{
+	ae::Array< ae::Vec3 > points = TAG_BVH_TEST;
+	for( uint32_t i = 0; i < count; i++ )
+	{
+		points.Append( ae::Vec3( ae::Random( -50.0f, 50.0f, &seed ), ae::Random( -50.0f, 50.0f, &seed ), ae::Random( -50.0f, 50.0f, &seed ) ) );
+	}
+	return points;
+}
+
+ae::AABB GetPointAABB( const ae::Vec3& p )
+{
+	return ae::AABB( p, p );
+}
+}
+
+//------------------------------------------------------------------------------
+// ae::BVH query tests
+//------------------------------------------------------------------------------
+TEST_CASE( "BVH Traverse visits every element once", "[ae::BVH]" )
+{
+	ae::Array< ae::Vec3 > points = GetRandomPoints( 1000, 1 );
+	ae::BVH< ae::Vec3 > bvh = TAG_BVH_TEST;
+	bvh.Build( points.Data(), points.Length(), GetPointAABB, 4 );
+	uint32_t count = 0;
+	REQUIRE( bvh.Traverse( []( const ae::BVHNode& ) { return true; }, [&]( const ae::BVHLeaf< ae::Vec3 >& leaf ) { count += leaf.count; return true; } ) );
+	REQUIRE( count == points.Length() );
+}
+
+TEST_CASE( "BVH Traverse stops early", "[ae::BVH]" )
+{
+	ae::Array< ae::Vec3 > points = GetRandomPoints( 1000, 2 );
+	ae::BVH< ae::Vec3 > bvh = TAG_BVH_TEST;
+	bvh.Build( points.Data(), points.Length(), GetPointAABB, 4 );
+	uint32_t leafCount = 0;
+	REQUIRE_FALSE( bvh.Traverse( []( const ae::BVHNode& ) { return true; }, [&]( const ae::BVHLeaf< ae::Vec3 >& ) { leafCount++; return false; } ) );
+	REQUIRE( leafCount == 1 );
+}
+
+TEST_CASE( "BVH Traverse empty", "[ae::BVH]" )
+{
+	ae::BVH< ae::Vec3 > bvh = TAG_BVH_TEST;
+	uint32_t leafCount = 0;
+	REQUIRE( bvh.Traverse( []( const ae::BVHNode& ) { return true; }, [&]( const ae::BVHLeaf< ae::Vec3 >& ) { leafCount++; return true; } ) );
+	REQUIRE( leafCount == 0 );
+}
+
+TEST_CASE( "BVH QueryAABB finds all contained points", "[ae::BVH]" )
+{
+	ae::Array< ae::Vec3 > points = GetRandomPoints( 2000, 3 );
+	ae::BVH< ae::Vec3 > bvh = TAG_BVH_TEST;
+	bvh.Build( points.Data(), points.Length(), GetPointAABB, 8 );
+	const ae::AABB query( ae::Vec3( -10.0f, -20.0f, 0.0f ), ae::Vec3( 15.0f, 5.0f, 30.0f ) );
+	
+	uint32_t expected = 0;
+	for( const ae::Vec3& p : points ) { expected += query.Contains( p ) ? 1 : 0; }
+	REQUIRE( expected > 0 );
+	
+	uint32_t found = 0;
+	uint32_t visited = 0;
+	bvh.QueryAABB( query, [&]( const ae::BVHLeaf< ae::Vec3 >& leaf )
+	{
+		for( uint32_t i = 0; i < leaf.count; i++ ) { found += query.Contains( leaf.data[ i ] ) ? 1 : 0; }
+		visited += leaf.count;
+		return true;
+	} );
+	REQUIRE( found == expected );
+	REQUIRE( visited < points.Length() ); // Culling should skip some leaves
+
+	ae::Array< const ae::BVHLeaf< ae::Vec3 >*, 4 > leaves;
+	bvh.QueryAABB( query, &leaves );
+	REQUIRE( leaves.Length() == 4 ); // Stops when full
+}
+
+TEST_CASE( "BVH Refit matches brute force after elements move", "[ae::BVH]" )
+{
+	ae::Array< ae::Vec3 > points = GetRandomPoints( 2000, 4 );
+	ae::BVH< ae::Vec3 > bvh = TAG_BVH_TEST;
+	bvh.Build( points.Data(), points.Length(), GetPointAABB, 8 );
+	
+	// Move every third point and refit only the leaves that contain them
+	uint64_t seed = 5;
+	for( uint32_t nodeIdx = 0; nodeIdx < bvh.GetNodeCount(); nodeIdx++ )
+	{
+		const ae::BVHNode* node = bvh.GetNode( nodeIdx );
+		if( node->leafIdx < 0 ) { continue; }
+		const ae::BVHLeaf< ae::Vec3 >& leaf = bvh.GetLeaf( node->leafIdx );
+		bool moved = false;
+		for( uint32_t i = 0; i < leaf.count; i++ )
+		{
+			if( ( leaf.data - points.Data() + i ) % 3 == 0 )
+			{
+				leaf.data[ i ] += ae::Vec3( ae::Random( -30.0f, 30.0f, &seed ), ae::Random( -30.0f, 30.0f, &seed ), ae::Random( -30.0f, 30.0f, &seed ) );
+				moved = true;
+			}
+		}
+		if( moved )
+		{
+			bvh.Refit( nodeIdx, GetPointAABB );
+		}
+	}
+	
+	ae::AABB allPoints;
+	for( const ae::Vec3& p : points ) { allPoints.Expand( p ); }
+	REQUIRE( bvh.GetAABB() == allPoints );
+	
+	for( uint32_t q = 0; q < 20; q++ )
+	{
+		const ae::Vec3 center( ae::Random( -60.0f, 60.0f, &seed ), ae::Random( -60.0f, 60.0f, &seed ), ae::Random( -60.0f, 60.0f, &seed ) );
+		const ae::AABB query( center - ae::Vec3( 15.0f ), center + ae::Vec3( 15.0f ) );
+		uint32_t expected = 0;
+		for( const ae::Vec3& p : points ) { expected += query.Contains( p ) ? 1 : 0; }
+		uint32_t found = 0;
+		bvh.QueryAABB( query, [&]( const ae::BVHLeaf< ae::Vec3 >& leaf )
+		{
+			for( uint32_t i = 0; i < leaf.count; i++ ) { found += query.Contains( leaf.data[ i ] ) ? 1 : 0; }
+			return true;
+		} );
+		REQUIRE( found == expected );
+	}
+}
+
+TEST_CASE( "BVH QuerySphere finds all contained points", "[ae::BVH]" )
+{
+	ae::Array< ae::Vec3 > points = GetRandomPoints( 2000, 4 );
+	ae::BVH< ae::Vec3 > bvh = TAG_BVH_TEST;
+	bvh.Build( points.Data(), points.Length(), GetPointAABB, 8 );
+	const ae::Sphere query( ae::Vec3( 5.0f, -5.0f, 10.0f ), 20.0f );
+	
+	uint32_t expected = 0;
+	for( const ae::Vec3& p : points ) { expected += ( ( p - query.center ).Length() <= query.radius ) ? 1 : 0; }
+	REQUIRE( expected > 0 );
+	
+	ae::Array< const ae::BVHLeaf< ae::Vec3 >* > leaves = TAG_BVH_TEST;
+	bvh.QuerySphere( query, &leaves );
+	uint32_t found = 0;
+	for( const ae::BVHLeaf< ae::Vec3 >* leaf : leaves )
+	{
+		for( uint32_t i = 0; i < leaf->count; i++ ) { found += ( ( leaf->data[ i ] - query.center ).Length() <= query.radius ) ? 1 : 0; }
+	}
+	REQUIRE( found == expected );
+}
+
+TEST_CASE( "BVH QueryFrustum finds all visible points", "[ae::BVH]" )
+{
+	ae::Array< ae::Vec3 > points = GetRandomPoints( 2000, 5 );
+	ae::BVH< ae::Vec3 > bvh = TAG_BVH_TEST;
+	bvh.Build( points.Data(), points.Length(), GetPointAABB, 8 );
+	const ae::Frustum frustum( ae::Matrix4::ViewToProjection( ae::HalfPi, 1.0f, 0.1f, 30.0f ) );
+	
+	uint32_t expected = 0;
+	for( const ae::Vec3& p : points ) { expected += frustum.Intersects( p ) ? 1 : 0; }
+	REQUIRE( expected > 0 );
+	
+	uint32_t found = 0;
+	uint32_t visited = 0;
+	bvh.QueryFrustum( frustum, [&]( const ae::BVHLeaf< ae::Vec3 >& leaf )
+	{
+		for( uint32_t i = 0; i < leaf.count; i++ ) { found += frustum.Intersects( leaf.data[ i ] ) ? 1 : 0; }
+		visited += leaf.count;
+		return true;
+	} );
+	REQUIRE( found == expected );
+	REQUIRE( visited < points.Length() );
+}
+
+TEST_CASE( "BVH QueryNearest matches brute force", "[ae::BVH]" )
+{
+	ae::Array< ae::Vec3 > points = GetRandomPoints( 2000, 6 );
+	ae::BVH< ae::Vec3 > bvh = TAG_BVH_TEST;
+	bvh.Build( points.Data(), points.Length(), GetPointAABB, 8 );
+	uint64_t seed = 7;
+	for( uint32_t test = 0; test < 20; test++ )
+	{
+		const ae::Vec3 query( ae::Random( -60.0f, 60.0f, &seed ), ae::Random( -60.0f, 60.0f, &seed ), ae::Random( -60.0f, 60.0f, &seed ) );
+		ae::Array< float > distances = TAG_BVH_TEST;
+		for( const ae::Vec3& p : points ) { distances.Append( ( p - query ).Length() ); }
+		std::sort( distances.begin(), distances.end() );
+		
+		ae::Array< ae::BVHNearest< ae::Vec3 >, 5 > nearest;
+		bvh.QueryNearest( query, 5, [query]( const ae::Vec3& p ) { return ( p - query ).Length(); }, &nearest );
+		REQUIRE( nearest.Length() == 5 );
+		for( uint32_t i = 0; i < nearest.Length(); i++ )
+		{
+			REQUIRE( nearest[ i ].distance == distances[ i ] );
+			REQUIRE( ( *nearest[ i ].data - query ).Length() == distances[ i ] );
+		}
+	}
+}
+
+TEST_CASE( "BVH QueryNearest respects max distance", "[ae::BVH]" )
+{
+	ae::Vec3 points[] = { ae::Vec3( 0.0f ), ae::Vec3( 1.0f, 0.0f, 0.0f ), ae::Vec3( 10.0f, 0.0f, 0.0f ) };
+	ae::BVH< ae::Vec3, 8 > bvh;
+	bvh.Build( points, countof( points ), GetPointAABB, 1 );
+	ae::Array< ae::BVHNearest< ae::Vec3 >, 3 > nearest;
+	bvh.QueryNearest( ae::Vec3( 0.0f ), 3, []( const ae::Vec3& p ) { return p.Length(); }, &nearest, 5.0f );
+	REQUIRE( nearest.Length() == 2 );
+	REQUIRE( nearest[ 0 ].distance == 0.0f );
+	REQUIRE( nearest[ 1 ].distance == 1.0f );
+}
+
+//------------------------------------------------------------------------------
+// ae::QuantizedBVH tests
+//------------------------------------------------------------------------------
+TEST_CASE( "QuantizedBVH Raycast visits leaves hit by the ray", "[ae::QuantizedBVH]" )
+{
+	ae::Array< ae::Vec3 > points = GetRandomPoints( 2000, 8 );
+	auto aabbFn = []( const ae::Vec3& p ) { return ae::AABB( p - ae::Vec3( 1.0f ), p + ae::Vec3( 1.0f ) ); };
+	ae::BVH< ae::Vec3 > bvh = TAG_BVH_TEST;
+	bvh.Build( points.Data(), points.Length(), aabbFn, 4 );
+	ae::QuantizedBVH< ae::Vec3 > qbvh = TAG_BVH_TEST;
+	qbvh.Build( bvh );
+	REQUIRE( qbvh.GetNodeCount() );
+	REQUIRE( qbvh.GetNodeCount() < bvh.GetNodeCount() / 2 );
+
+	uint64_t seed = 9;
+	uint32_t hitCount = 0;
+	for( uint32_t test = 0; test < 100; test++ )
+	{
+		const ae::Vec3 source( ae::Random( -60.0f, 60.0f, &seed ), ae::Random( -60.0f, 60.0f, &seed ), ae::Random( -60.0f, 60.0f, &seed ) );
+		const ae::Vec3 target( ae::Random( -60.0f, 60.0f, &seed ), ae::Random( -60.0f, 60.0f, &seed ), ae::Random( -60.0f, 60.0f, &seed ) );
+		const ae::Vec3 ray = target - source;
+		uint32_t visitedCount = 0;
+		ae::Array< const ae::Vec3* > visited = TAG_BVH_TEST;
+		qbvh.Raycast( source, ray, [&]( const ae::BVHLeaf< ae::Vec3 >& leaf, float maxT )
+		{
+			REQUIRE( maxT == 1.0f );
+			for( uint32_t i = 0; i < leaf.count; i++ ) { visited.Append( &leaf.data[ i ] ); }
+			visitedCount++;
+			return maxT;
+		} );
+		for( const ae::Vec3& p : points )
+		{
+			if( aabbFn( p ).Raycast( source, ray ) )
+			{
+				REQUIRE( visited.Find( &p ) >= 0 );
+				hitCount++;
+			}
+		}
+		REQUIRE( visitedCount < bvh.GetLeafCount() );
+	}
+	REQUIRE( hitCount > 0 );
+}
+
+TEST_CASE( "QuantizedBVH Raycast visits nearest first and stops", "[ae::QuantizedBVH]" )
+{
+	ae::Vec3 points[ 16 ];
+	for( uint32_t i = 0; i < countof( points ); i++ )
+	{
+		points[ i ] = ae::Vec3( i * 4.0f, 0.0f, 0.0f );
+	}
+	auto aabbFn = []( const ae::Vec3& p ) { return ae::AABB( p - ae::Vec3( 1.0f ), p + ae::Vec3( 1.0f ) ); };
+	ae::BVH< ae::Vec3, 32 > bvh;
+	bvh.Build( points, countof( points ), aabbFn, 1 );
+	ae::QuantizedBVH< ae::Vec3, 32 > qbvh;
+	qbvh.Build( bvh );
+
+	float prevX = INFINITY;
+	uint32_t visitedCount = 0;
+	qbvh.Raycast( ae::Vec3( 100.0f, 0.0f, 0.0f ), ae::Vec3( -200.0f, 0.0f, 0.0f ), [&]( const ae::BVHLeaf< ae::Vec3 >& leaf, float maxT )
+	{
+		REQUIRE( leaf.count == 1 );
+		REQUIRE( leaf.data->x < prevX );
+		prevX = leaf.data->x;
+		visitedCount++;
+		return maxT;
+	} );
+	REQUIRE( visitedCount == countof( points ) );
+
+	visitedCount = 0;
+	qbvh.Raycast( ae::Vec3( 100.0f, 0.0f, 0.0f ), ae::Vec3( -200.0f, 0.0f, 0.0f ), [&]( const ae::BVHLeaf< ae::Vec3 >& leaf, float )
+	{
+		visitedCount++;
+		return ( visitedCount == 3 ) ? -1.0f : 1.0f;
+	} );
+	REQUIRE( visitedCount == 3 );
+}
@@ -0,0 +1,237 @@
+//------------------------------------------------------------------------------
+// BroadphaseTest.cpp
+//------------------------------------------------------------------------------
+// Copyright (c) 2026 John Hughes
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files( the "Software" ), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and /or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions :
+//
+// The above copyright notice and this permission notice shall be included in all
+// copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+// SOFTWARE.
+//------------------------------------------------------------------------------
+// Headers
+//------------------------------------------------------------------------------
+#include <catch2/catch_test_macros.hpp>
+#include "aether.h"
+
+//------------------------------------------------------------------------------
+// Broadphase test helpers
+//------------------------------------------------------------------------------
+namespace
+{
+const ae::Tag TAG_BROADPHASE_TEST = "broadphase_test";
+
+ae::AABB GetRandomAABB( float worldSize, float maxSize, uint64_t* seed )
+{
+	const ae::Vec3 center( ae::Random( 0.0f, worldSize, seed ), ae::Random( 0.0f, worldSize, seed ), ae::Random( 0.0f, worldSize, seed ) );
+	const ae::Vec3 halfSize( ae::Random( 0.1f, maxSize, seed ), ae::Random( 0.1f, maxSize, seed ), ae::Random( 0.1f, maxSize, seed ) );
+	return ae::AABB( center - halfSize, center + halfSize );
+}
+
+ae::Array< ae::BroadphasePair > GetBruteForcePairs( const ae::Broadphase& broadphase, const ae::Array< uint32_t >& proxies )
+{
+	ae::Array< ae::BroadphasePair > pairs = TAG_BROADPHASE_TEST;
+	for( uint32_t i = 0; i < proxies.Length(); i++ )
+	{
+		for( uint32_t j = i + 1; j < proxies.Length(); j++ )
+		{
+			if( broadphase.GetAABB( proxies[ i ] ).Intersect( broadphase.GetAABB( proxies[ j ] ) ) )
+			{
+				const uint32_t p0 = ae::Min( proxies[ i ], proxies[ j ] );
+				const uint32_t p1 = ae::Max( proxies[ i ], proxies[ j ] );
+				pairs.Append( { p0, p1 } );
+			}
+		}
+	}
+	std::sort( pairs.begin(), pairs.end(), []( const ae::BroadphasePair& a, const ae::BroadphasePair& b ) { return a.GetId() < b.GetId(); } );
+	return pairs;
+}
+
+void RequireSamePairs( const ae::Array< ae::BroadphasePair >& a, const ae::Array< ae::BroadphasePair >& b )
+{
+	REQUIRE( a.Length() == b.Length() );
+	for( uint32_t i = 0; i < a.Length(); i++ )
+	{
+		REQUIRE( a[ i ] == b[ i ] );
+	}
+}
+}
+
+//------------------------------------------------------------------------------
+// ae::Broadphase tests
+//------------------------------------------------------------------------------
+TEST_CASE( "Broadphase pairs and events match brute force", "[ae::Broadphase]" )
+{
+	for( ae::BroadphaseType type : { ae::BroadphaseType::SweepAndPrune, ae::BroadphaseType::SpatialHash } )
+	{
+		ae::Broadphase broadphase( TAG_BROADPHASE_TEST, type, 2.0f );
+		ae::Array< uint32_t > proxies = TAG_BROADPHASE_TEST;
+		uint64_t seed = 1;
+		for( uint32_t i = 0; i < 300; i++ )
+		{
+			proxies.Append( broadphase.Add( GetRandomAABB( 40.0f, 2.0f, &seed ) ) );
+		}
+		ae::Array< ae::BroadphasePair > prevPairs = TAG_BROADPHASE_TEST;
+		uint32_t beginCount = 0;
+		uint32_t endCount = 0;
+		for( uint32_t frame = 0; frame < 10; frame++ )
+		{
+			for( uint32_t proxy : proxies )
+			{
+				const ae::AABB aabb = broadphase.GetAABB( proxy );
+				const ae::Vec3 offset( ae::Random( -1.0f, 1.0f, &seed ), ae::Random( -1.0f, 1.0f, &seed ), ae::Random( -1.0f, 1.0f, &seed ) );
+				broadphase.Update( proxy, ae::AABB( aabb.GetMin() + offset, aabb.GetMax() + offset ) );
+			}
+			broadphase.UpdatePairs();
+			const ae::Array< ae::BroadphasePair > pairs = GetBruteForcePairs( broadphase, proxies );
+			RequireSamePairs( broadphase.GetPairs(), pairs );
+
+			for( const ae::BroadphasePair& pair : broadphase.GetBeginPairs() )
+			{
+				REQUIRE( pairs.Find( pair ) >= 0 );
+				REQUIRE( prevPairs.Find( pair ) < 0 );
+			}
+			for( const ae::BroadphasePair& pair : broadphase.GetEndPairs() )
+			{
+				REQUIRE( pairs.Find( pair ) < 0 );
+				REQUIRE( prevPairs.Find( pair ) >= 0 );
+			}
+			REQUIRE( prevPairs.Length() + broadphase.GetBeginPairs().Length() - broadphase.GetEndPairs().Length() == pairs.Length() );
+			beginCount += broadphase.GetBeginPairs().Length();
+			endCount += broadphase.GetEndPairs().Length();
+			prevPairs = pairs;
+		}
+		REQUIRE( beginCount > 0 );
+		REQUIRE( endCount > 0 );
+	}
+}
+
+TEST_CASE( "Broadphase remove ends pairs before reusing ids", "[ae::Broadphase]" )
+{
+	for( ae::BroadphaseType type : { ae::BroadphaseType::SweepAndPrune, ae::BroadphaseType::SpatialHash } )
+	{
+		int userData = 0;
+		ae::Broadphase broadphase( TAG_BROADPHASE_TEST, type );
+		const uint32_t a = broadphase.Add( ae::AABB( ae::Vec3( 0.0f ), ae::Vec3( 1.0f ) ), &userData );
+		const uint32_t b = broadphase.Add( ae::AABB( ae::Vec3( 0.5f ), ae::Vec3( 1.5f ) ) );
+		const uint32_t c = broadphase.Add( ae::AABB( ae::Vec3( 10.0f ), ae::Vec3( 11.0f ) ) );
+		REQUIRE( broadphase.GetUserData( a ) == &userData );
+		broadphase.UpdatePairs();
+		REQUIRE( broadphase.GetPairs().Length() == 1 );
+		REQUIRE( broadphase.GetBeginPairs().Length() == 1 );
+		REQUIRE( broadphase.GetBeginPairs()[ 0 ] == ae::BroadphasePair{ a, b } );
+
+		broadphase.UpdatePairs();
+		REQUIRE( broadphase.GetPairs().Length() == 1 );
+		REQUIRE( broadphase.GetBeginPairs().Length() == 0 );
+		REQUIRE( broadphase.GetEndPairs().Length() == 0 );
+
+		broadphase.Remove( b );
+		const uint32_t d = broadphase.Add( ae::AABB( ae::Vec3( 0.5f ), ae::Vec3( 1.5f ) ) );
+		REQUIRE( d != b );
+		REQUIRE( broadphase.GetProxyCount() == 3 );
+		broadphase.UpdatePairs();
+		REQUIRE( broadphase.GetEndPairs().Length() == 1 );
+		REQUIRE( broadphase.GetEndPairs()[ 0 ] == ae::BroadphasePair{ a, b } );
+		REQUIRE( broadphase.GetBeginPairs().Length() == 1 );
+		REQUIRE( broadphase.GetBeginPairs()[ 0 ] == ae::BroadphasePair{ a, d } );
+
+		REQUIRE( broadphase.Add( ae::AABB( ae::Vec3( 10.5f ), ae::Vec3( 11.5f ) ) ) == b );
+		broadphase.UpdatePairs();
+		REQUIRE( broadphase.GetBeginPairs().Length() == 1 );
+		REQUIRE( broadphase.GetBeginPairs()[ 0 ] == ae::BroadphasePair{ ae::Min( b, c ), ae::Max( b, c ) } );
+	}
+}
+
+TEST_CASE( "Broadphase pairs and events match brute force with adds and removes", "[ae::Broadphase]" )
+{
+	for( ae::BroadphaseType type : { ae::BroadphaseType::SweepAndPrune, ae::BroadphaseType::SpatialHash } )
+	{
+		ae::Broadphase broadphase( TAG_BROADPHASE_TEST, type, 2.0f );
+		ae::Array< uint32_t > proxies = TAG_BROADPHASE_TEST;
+		uint64_t seed = 3;
+		ae::Array< ae::BroadphasePair > prevPairs = TAG_BROADPHASE_TEST;
+		for( uint32_t frame = 0; frame < 20; frame++ )
+		{
+			for( uint32_t i = 0; i < 20; i++ )
+			{
+				proxies.Append( broadphase.Add( GetRandomAABB( 30.0f, 2.0f, &seed ) ) );
+			}
+			for( uint32_t i = 0; i < 10 && proxies.Length(); i++ )
+			{
+				const uint32_t index = ae::Random( 0, (int32_t)proxies.Length(), &seed );
+				broadphase.Remove( proxies[ index ] );
+				proxies.Remove( index );
+			}
+			for( uint32_t proxy : proxies )
+			{
+				const ae::AABB aabb = broadphase.GetAABB( proxy );
+				const ae::Vec3 offset( ae::Random( -0.5f, 0.5f, &seed ), ae::Random( -0.5f, 0.5f, &seed ), ae::Random( -0.5f, 0.5f, &seed ) );
+				broadphase.Update( proxy, ae::AABB( aabb.GetMin() + offset, aabb.GetMax() + offset ) );
+			}
+			broadphase.UpdatePairs();
+			const ae::Array< ae::BroadphasePair > pairs = GetBruteForcePairs( broadphase, proxies );
+			RequireSamePairs( broadphase.GetPairs(), pairs );
+
+			// Pairs with removed proxies end, so old pairs either continue or end
+			uint32_t continued = 0;
+			for( const ae::BroadphasePair& pair : prevPairs )
+			{
+				const bool ended = ( broadphase.GetEndPairs().Find( pair ) >= 0 );
+				REQUIRE( ended == ( pairs.Find( pair ) < 0 ) );
+				continued += !ended;
+			}
+			REQUIRE( continued + broadphase.GetBeginPairs().Length() == pairs.Length() );
+			for( const ae::BroadphasePair& pair : broadphase.GetBeginPairs() )
+			{
+				REQUIRE( prevPairs.Find( pair ) < 0 );
+			}
+			prevPairs = pairs;
+		}
+	}
+}
+
+TEST_CASE( "Broadphase handles huge and infinite proxies", "[ae::Broadphase]" )
+{
+	for( ae::BroadphaseType type : { ae::BroadphaseType::SweepAndPrune, ae::BroadphaseType::SpatialHash } )
+	{
+		ae::Broadphase broadphase( TAG_BROADPHASE_TEST, type, 1.0f );
+		ae::Array< uint32_t > proxies = TAG_BROADPHASE_TEST;
+		uint64_t seed = 5;
+		for( uint32_t i = 0; i < 50; i++ )
+		{
+			proxies.Append( broadphase.Add( GetRandomAABB( 20.0f, 1.0f, &seed ) ) );
+		}
+		const float inf = std::numeric_limits< float >::infinity();
+		const uint32_t huge = broadphase.Add( ae::AABB( ae::Vec3( -1e20f ), ae::Vec3( 1e20f ) ) );
+		const uint32_t infinite = broadphase.Add( ae::AABB( ae::Vec3( -inf ), ae::Vec3( inf ) ) );
+		const uint32_t plane = broadphase.Add( ae::AABB( ae::Vec3( -inf, -inf, 5.0f ), ae::Vec3( inf, inf, 6.0f ) ) );
+		const uint32_t large = broadphase.Add( ae::AABB( ae::Vec3( 0.0f ), ae::Vec3( 10.0f ) ) ); // More than 64 cells
+		const uint32_t far = broadphase.Add( ae::AABB( ae::Vec3( 1e30f ), ae::Vec3( 1e30f + 1e24f ) ) );
+		proxies.Append( huge );
+		proxies.Append( infinite );
+		proxies.Append( plane );
+		proxies.Append( large );
+		proxies.Append( far );
+		for( uint32_t frame = 0; frame < 3; frame++ )
+		{
+			broadphase.UpdatePairs();
+			RequireSamePairs( broadphase.GetPairs(), GetBruteForcePairs( broadphase, proxies ) );
+			broadphase.Update( large, ae::AABB( ae::Vec3( frame * 2.0f ), ae::Vec3( frame * 2.0f + 10.0f ) ) );
+		}
+		REQUIRE( broadphase.GetPairs().Find( ae::BroadphasePair{ ae::Min( huge, infinite ), ae::Max( huge, infinite ) } ) >= 0 );
+		REQUIRE( broadphase.GetPairs().Find( ae::BroadphasePair{ ae::Min( infinite, far ), ae::Max( infinite, far ) } ) >= 0 );
+	}
+}
@@ -0,0 +1,576 @@
+//------------------------------------------------------------------------------
+// CollisionMeshTest.cpp
+//------------------------------------------------------------------------------
+// Copyright (c) 2026 John Hughes
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files( the "Software" ), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and /or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions :
+//
+// The above copyright notice and this permission notice shall be included in all
+// copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+// SOFTWARE.
+//------------------------------------------------------------------------------
+// Headers
+//------------------------------------------------------------------------------
+#include <catch2/catch_test_macros.hpp>
+#include "aether.h"
+
+//------------------------------------------------------------------------------
+// CollisionMesh test helpers
+//------------------------------------------------------------------------------
+namespace
+{
+const ae::Tag TAG_COLLISION_MESH_TEST = "collision_mesh_test";
+
+bool Approx( float a, float b, float epsilon = 0.001f ) { return std::abs( a - b ) < epsilon; }
+bool Approx( const ae::Vec3& a, const ae::Vec3& b, float epsilon = 0.001f ) { return Approx( a.x, b.x, epsilon ) && Approx( a.y, b.y, epsilon ) && Approx( a.z, b.z, epsilon ); }
+
+//! Rays from above the grid towards random points below it, neighboring rays
+//! are coherent
+ae::Array< ae::RaycastParams > GetGridRays( uint32_t count, float size, uint32_t maxHits, uint64_t seed )
+{
+	ae::Array< ae::RaycastParams > rays = TAG_COLLISION_MESH_TEST;
+	const ae::Vec3 source( size * 0.5f, size * 0.5f, 20.0f );
+	for( uint32_t i = 0; i < count; i++ )
+	{
+		ae::RaycastParams& params = rays.Append( {} );
+		params.source = source + ae::Vec3( ae::Random( -1.0f, 1.0f, &seed ), ae::Random( -1.0f, 1.0f, &seed ), 0.0f );
+		const ae::Vec3 target( ae::Random( -2.0f, size + 2.0f, &seed ), ae::Random( -2.0f, size + 2.0f, &seed ), -5.0f );
+		params.ray = target - params.source;
+		params.maxHits = maxHits;
+	}
+	return rays;
+}
+
+void RequireSameHits( const ae::RaycastResult& r0, const ae::RaycastResult& r1 )
+{
+	REQUIRE( r0.hits.Length() == r1.hits.Length() );
+	for( uint32_t i = 0; i < r0.hits.Length(); i++ )
+	{
+		REQUIRE( Approx( r0.hits[ i ].position, r1.hits[ i ].position ) );
+		REQUIRE( Approx( r0.hits[ i ].normal, r1.hits[ i ].normal ) );
+		REQUIRE( Approx( r0.hits[ i ].distance, r1.hits[ i ].distance ) );
+		REQUIRE( r0.hits[ i ].extra == r1.hits[ i ].extra );
+	}
+}
+
+//! Grid of size x size unit quads on the z=0 plane, facing +z, with each
+//! vertex extra set to its vertex index. Non-zero \p bumpHeight offsets the
+//! vertices along z.
+void BuildGrid( ae::CollisionMesh<>* mesh, uint32_t size, float bumpHeight = 0.0f )
+{
+	ae::Array< ae::Vec3 > positions = TAG_COLLISION_MESH_TEST;
+	ae::Array< ae::CollisionExtra > extras = TAG_COLLISION_MESH_TEST;
+	ae::Array< uint32_t > indices = TAG_COLLISION_MESH_TEST;
+	for( uint32_t y = 0; y <= size; y++ )
+	{
+		for( uint32_t x = 0; x <= size; x++ )
+		{
+			extras.Append( positions.Length() );
+			const float z = bumpHeight * ae::Sin( x * 0.7f ) * ae::Cos( y * 0.5f );
+			positions.Append( ae::Vec3( (float)x, (float)y, z ) );
+		}
+	}
+	for( uint32_t y = 0; y < size; y++ )
+	{
+		for( uint32_t x = 0; x < size; x++ )
+		{
+			const uint32_t i0 = y * ( size + 1 ) + x;
+			const uint32_t i1 = i0 + 1;
+			const uint32_t i2 = i0 + size + 1;
+			const uint32_t i3 = i2 + 1;
+			indices.Append( i0 ); indices.Append( i1 ); indices.Append( i3 );
+			indices.Append( i0 ); indices.Append( i3 ); indices.Append( i2 );
+		}
+	}
+	ae::CollisionMesh<>::AddIndexedParams params;
+	params.vertexPositions = positions.Data()->data;
+	params.vertexPositionStride = sizeof( ae::Vec3 );
+	params.vertexExtras = extras.Data();
+	params.vertexExtraStride = sizeof( ae::CollisionExtra );
+	params.vertexCount = positions.Length();
+	params.indices = indices.Data();
+	params.indexCount = indices.Length();
+	params.indexSize = sizeof( uint32_t );
+	mesh->AddIndexed( params );
+	mesh->BuildBVH();
+}
+}
+
+//------------------------------------------------------------------------------
+// ae::CollisionMesh query tests
+//------------------------------------------------------------------------------
+TEST_CASE( "CollisionMesh GetClosestPoint above surface", "[ae::CollisionMesh]" )
+{
+	ae::CollisionMesh<> mesh = TAG_COLLISION_MESH_TEST;
+	BuildGrid( &mesh, 16 );
+	ae::CollisionMeshClosestPoint result;
+	REQUIRE( mesh.GetClosestPoint( ae::Vec3( 4.25f, 7.5f, 3.0f ), &result ) );
+	REQUIRE( Approx( result.position, ae::Vec3( 4.25f, 7.5f, 0.0f ) ) );
+	REQUIRE( Approx( result.normal, ae::Vec3( 0.0f, 0.0f, 1.0f ) ) );
+	REQUIRE( Approx( result.distance, 3.0f ) );
+	REQUIRE( mesh.GetTriangleExtra( result.triIdx ) == result.extra );
+}
+
+TEST_CASE( "CollisionMesh GetClosestPoint outside edge", "[ae::CollisionMesh]" )
+{
+	ae::CollisionMesh<> mesh = TAG_COLLISION_MESH_TEST;
+	BuildGrid( &mesh, 16 );
+	ae::CollisionMeshClosestPoint result;
+	REQUIRE( mesh.GetClosestPoint( ae::Vec3( -3.0f, 5.5f, 4.0f ), &result ) );
+	REQUIRE( Approx( result.position, ae::Vec3( 0.0f, 5.5f, 0.0f ) ) );
+	REQUIRE( Approx( result.distance, 5.0f ) );
+	REQUIRE_FALSE( mesh.GetClosestPoint( ae::Vec3( -3.0f, 5.5f, 4.0f ), &result, 4.0f ) );
+}
+
+TEST_CASE( "CollisionMesh GetClosestPoint empty", "[ae::CollisionMesh]" )
+{
+	ae::CollisionMesh<> mesh = TAG_COLLISION_MESH_TEST;
+	REQUIRE_FALSE( mesh.GetClosestPoint( ae::Vec3( 0.0f ), nullptr ) );
+}
+
+TEST_CASE( "CollisionMesh QueryNearest sorted", "[ae::CollisionMesh]" )
+{
+	ae::CollisionMesh<> mesh = TAG_COLLISION_MESH_TEST;
+	BuildGrid( &mesh, 16 );
+	ae::Array< ae::CollisionMeshClosestPoint > nearest = TAG_COLLISION_MESH_TEST;
+	mesh.QueryNearest( ae::Vec3( 8.5f, 8.25f, 1.0f ), 6, &nearest );
+	REQUIRE( nearest.Length() == 6 );
+	REQUIRE( Approx( nearest[ 0 ].distance, 1.0f ) );
+	for( uint32_t i = 1; i < nearest.Length(); i++ )
+	{
+		REQUIRE( nearest[ i - 1 ].distance <= nearest[ i ].distance );
+		REQUIRE( nearest[ i - 1 ].triIdx != nearest[ i ].triIdx );
+	}
+}
+
+TEST_CASE( "CollisionMesh QueryAABB matches brute force", "[ae::CollisionMesh]" )
+{
+	ae::CollisionMesh<> mesh = TAG_COLLISION_MESH_TEST;
+	BuildGrid( &mesh, 32 );
+	const ae::AABB query( ae::Vec3( 3.5f, 3.5f, -1.0f ), ae::Vec3( 6.5f, 5.5f, 1.0f ) );
+	uint32_t expected = 0;
+	for( uint32_t i = 0; i < mesh.GetTriangleCount(); i++ )
+	{
+		const ae::Triangle tri = mesh.GetTriangle( i );
+		ae::AABB triAABB;
+		for( const ae::Vec3& v : tri.vertices ) { triAABB.Expand( v ); }
+		expected += triAABB.Intersect( query ) ? 1 : 0;
+	}
+	ae::Array< uint32_t > tris = TAG_COLLISION_MESH_TEST;
+	mesh.QueryAABB( query, &tris );
+	REQUIRE( tris.Length() == expected );
+	REQUIRE( expected == 4 * 3 * 2 );
+
+	ae::Array< uint32_t, 3 > limitedTris;
+	mesh.QueryAABB( query, &limitedTris );
+	REQUIRE( limitedTris.Length() == 3 );
+}
+
+TEST_CASE( "CollisionMesh QuerySphere", "[ae::CollisionMesh]" )
+{
+	ae::CollisionMesh<> mesh = TAG_COLLISION_MESH_TEST;
+	BuildGrid( &mesh, 32 );
+	ae::Array< uint32_t > tris = TAG_COLLISION_MESH_TEST;
+	mesh.QuerySphere( ae::Sphere( ae::Vec3( 10.5f, 10.5f, 2.0f ), 1.0f ), &tris );
+	REQUIRE( tris.Length() == 0 );
+	mesh.QuerySphere( ae::Sphere( ae::Vec3( 10.5f, 10.75f, 0.25f ), 0.3f ), &tris );
+	REQUIRE( tris.Length() == 1 ); // Upper left triangle of a single quad
+	uint32_t count = 0;
+	mesh.QuerySphere( ae::Sphere( ae::Vec3( 10.0f, 10.0f, 0.0f ), 0.1f ), [&]( uint32_t triIdx )
+	{
+		const ae::Triangle tri = mesh.GetTriangle( triIdx );
+		REQUIRE( ( tri.ClosestPoint( ae::Vec3( 10.0f, 10.0f, 0.0f ) ) - ae::Vec3( 10.0f, 10.0f, 0.0f ) ).Length() < 0.1f );
+		count++;
+		return true;
+	} );
+	REQUIRE( count == 6 ); // All triangles sharing the vertex
+}
+
+TEST_CASE( "CollisionMesh QueryFrustum", "[ae::CollisionMesh]" )
+{
+	ae::CollisionMesh<> mesh = TAG_COLLISION_MESH_TEST;
+	BuildGrid( &mesh, 32 );
+	// Camera at 16,16,10 looking down -z
+	const ae::Matrix4 worldToView = ae::Matrix4::Translation( ae::Vec3( -16.0f, -16.0f, -10.0f ) );
+	const ae::Frustum frustum( ae::Matrix4::ViewToProjection( ae::HalfPi * 0.5f, 1.0f, 0.1f, 100.0f ) * worldToView );
+	ae::Array< uint32_t > tris = TAG_COLLISION_MESH_TEST;
+	mesh.QueryFrustum( frustum, &tris );
+	REQUIRE( tris.Length() > 0 );
+	REQUIRE( tris.Length() < mesh.GetTriangleCount() );
+	for( uint32_t triIdx : tris )
+	{
+		const ae::Triangle tri = mesh.GetTriangle( triIdx );
+		REQUIRE( ae::Abs( tri.vertices[ 0 ].x - 16.0f ) < 8.0f );
+		REQUIRE( ae::Abs( tri.vertices[ 0 ].y - 16.0f ) < 8.0f );
+	}
+}
+
+//------------------------------------------------------------------------------
+// ae::CollisionMesh::RaycastBatch tests
+//------------------------------------------------------------------------------
+TEST_CASE( "CollisionMesh RaycastBatch matches Raycast", "[ae::CollisionMesh]" )
+{
+	ae::CollisionMesh<> mesh = TAG_COLLISION_MESH_TEST;
+	BuildGrid( &mesh, 32, 3.0f );
+	const ae::Matrix4 transforms[] =
+	{
+		ae::Matrix4::Identity(),
+		ae::Matrix4::Translation( 1.0f, 2.0f, 3.0f ) * ae::Matrix4::Scaling( 1.0f, 2.0f, 0.5f )
+	};
+	for( const ae::Matrix4& transform : transforms )
+	for( bool hitClockwise : { false, true } )
+	for( uint32_t maxHits : { 1, 3 } )
+	{
+		ae::CollisionMeshRaycastParams meshParams;
+		meshParams.transform = transform;
+		meshParams.hitClockwise = hitClockwise;
+		const ae::Array< ae::RaycastParams > rays = GetGridRays( 203, 32.0f, maxHits, 1 ); // Not a multiple of the packet size
+		ae::Array< ae::RaycastResult > results = TAG_COLLISION_MESH_TEST;
+		results.Append( {}, rays.Length() );
+		mesh.RaycastBatch( rays.Data(), rays.Length(), results.Data(), meshParams );
+		uint32_t hitCount = 0;
+		for( uint32_t i = 0; i < rays.Length(); i++ )
+		{
+			RequireSameHits( mesh.Raycast( rays[ i ], meshParams ), results[ i ] );
+			hitCount += results[ i ].hits.Length();
+		}
+		REQUIRE( hitCount > rays.Length() / 2 );
+	}
+}
+
+TEST_CASE( "CollisionMesh RaycastBatch accumulates previous results", "[ae::CollisionMesh]" )
+{
+	ae::CollisionMesh<> mesh = TAG_COLLISION_MESH_TEST;
+	BuildGrid( &mesh, 8 );
+	ae::RaycastParams rays[ 4 ];
+	rays[ 0 ].source = ae::Vec3( 2.5f, 2.5f, 10.0f );
+	rays[ 0 ].ray = ae::Vec3( 0.0f, 0.0f, -20.0f );
+	rays[ 0 ].maxHits = 2;
+	rays[ 1 ] = rays[ 0 ];
+	rays[ 1 ].maxHits = 0; // Skipped
+	rays[ 2 ] = rays[ 0 ];
+	rays[ 2 ].maxHits = 1; // Early out, previous hit is closer than the mesh
+	rays[ 3 ] = rays[ 0 ];
+	rays[ 3 ].source = ae::Vec3( 100.0f, 2.5f, 10.0f ); // Early out, misses the mesh
+	ae::RaycastResult results[ 4 ];
+	ae::RaycastResult::Hit prevHit;
+	prevHit.position = ae::Vec3( 2.5f, 2.5f, 5.0f );
+	prevHit.distance = 5.0f;
+	results[ 0 ].hits.Append( prevHit );
+	results[ 2 ].hits.Append( prevHit );
+	mesh.RaycastBatch( rays, 4, results );
+	REQUIRE( results[ 0 ].hits.Length() == 2 );
+	REQUIRE( results[ 0 ].hits[ 0 ].distance == 5.0f );
+	REQUIRE( Approx( results[ 0 ].hits[ 1 ].distance, 10.0f ) );
+	REQUIRE( Approx( results[ 0 ].hits[ 1 ].normal, ae::Vec3( 0.0f, 0.0f, 1.0f ) ) );
+	REQUIRE( results[ 1 ].hits.Length() == 0 );
+	REQUIRE( results[ 2 ].hits.Length() == 1 );
+	REQUIRE( results[ 2 ].hits[ 0 ].distance == 5.0f );
+	REQUIRE( results[ 3 ].hits.Length() == 0 );
+}
+
+TEST_CASE( "CollisionMesh quantized bvh Raycast matches Raycast", "[ae::CollisionMesh]" )
+{
+	ae::CollisionMesh<> mesh = TAG_COLLISION_MESH_TEST;
+	ae::CollisionMesh<> quantizedMesh = TAG_COLLISION_MESH_TEST;
+	BuildGrid( &mesh, 32, 3.0f );
+	quantizedMesh.SetQuantizedBVHEnabled( true );
+	BuildGrid( &quantizedMesh, 32, 3.0f );
+	REQUIRE_FALSE( quantizedMesh.RequiresBVHRebuild() );
+	const ae::Matrix4 transforms[] =
+	{
+		ae::Matrix4::Identity(),
+		ae::Matrix4::Translation( 1.0f, 2.0f, 3.0f ) * ae::Matrix4::Scaling( 1.0f, 2.0f, 0.5f )
+	};
+	for( const ae::Matrix4& transform : transforms )
+	for( bool hitClockwise : { false, true } )
+	for( uint32_t maxHits : { 1, 3 } )
+	{
+		ae::CollisionMeshRaycastParams meshParams;
+		meshParams.transform = transform;
+		meshParams.hitClockwise = hitClockwise;
+		const ae::Array< ae::RaycastParams > rays = GetGridRays( 200, 32.0f, maxHits, 3 );
+		uint32_t hitCount = 0;
+		for( const ae::RaycastParams& ray : rays )
+		{
+			const ae::RaycastResult result = quantizedMesh.Raycast( ray, meshParams );
+			RequireSameHits( mesh.Raycast( ray, meshParams ), result );
+			hitCount += result.hits.Length();
+		}
+		REQUIRE( hitCount > rays.Length() / 2 );
+	}
+
+	quantizedMesh.SetQuantizedBVHEnabled( false );
+	REQUIRE( quantizedMesh.RequiresBVHRebuild() );
+	quantizedMesh.BuildBVH();
+	const ae::Array< ae::RaycastParams > rays = GetGridRays( 20, 32.0f, 2, 4 );
+	for( const ae::RaycastParams& ray : rays )
+	{
+		RequireSameHits( mesh.Raycast( ray ), quantizedMesh.Raycast( ray ) );
+	}
+}
+
+TEST_CASE( "CollisionMesh RaycastEach visits every hit", "[ae::CollisionMesh]" )
+{
+	// Stacked layers so a vertical ray hits more triangles than RaycastResult can hold
+	ae::Array< ae::Vec3 > positions = TAG_COLLISION_MESH_TEST;
+	ae::Array< uint32_t > indices = TAG_COLLISION_MESH_TEST;
+	const uint32_t size = 4;
+	for( uint32_t y = 0; y <= size; y++ )
+	{
+		for( uint32_t x = 0; x <= size; x++ )
+		{
+			positions.Append( ae::Vec3( (float)x, (float)y, 0.0f ) );
+		}
+	}
+	for( uint32_t y = 0; y < size; y++ )
+	{
+		for( uint32_t x = 0; x < size; x++ )
+		{
+			const uint32_t i0 = y * ( size + 1 ) + x;
+			indices.Append( i0 ); indices.Append( i0 + 1 ); indices.Append( i0 + size + 2 );
+			indices.Append( i0 ); indices.Append( i0 + size + 2 ); indices.Append( i0 + size + 1 );
+		}
+	}
+	const uint32_t layerCount = 12;
+	for( bool quantized : { false, true } )
+	{
+		ae::CollisionMesh<> mesh = TAG_COLLISION_MESH_TEST;
+		REQUIRE( mesh.RaycastEach( {}, []( const ae::RaycastResult::Hit& ) { return true; } ) );
+		for( uint32_t i = 0; i < layerCount; i++ )
+		{
+			mesh.AddIndexed( ae::Matrix4::Translation( 0.0f, 0.0f, (float)i ), positions.Data()->data, positions.Length(), sizeof( ae::Vec3 ), indices.Data(), indices.Length(), sizeof( uint32_t ) );
+		}
+		mesh.SetQuantizedBVHEnabled( quantized );
+		mesh.BuildBVH();
+
+		ae::RaycastParams params;
+		params.source = ae::Vec3( 2.3f, 2.6f, 20.0f );
+		params.ray = ae::Vec3( 0.0f, 0.0f, -25.0f );
+		params.maxHits = 8;
+		ae::Array< ae::RaycastResult::Hit > hits = TAG_COLLISION_MESH_TEST;
+		REQUIRE( mesh.RaycastEach( params, [&]( const ae::RaycastResult::Hit& hit )
+		{
+			hits.Append( hit );
+			return true;
+		} ) );
+		REQUIRE( hits.Length() == layerCount );
+		std::sort( hits.begin(), hits.end(), []( const ae::RaycastResult::Hit& a, const ae::RaycastResult::Hit& b ) { return a.distance < b.distance; } );
+		const ae::RaycastResult result = mesh.Raycast( params );
+		REQUIRE( result.hits.Length() == params.maxHits );
+		for( uint32_t i = 0; i < result.hits.Length(); i++ )
+		{
+			REQUIRE( Approx( hits[ i ].position, result.hits[ i ].position ) );
+			REQUIRE( Approx( hits[ i ].normal, result.hits[ i ].normal ) );
+			REQUIRE( Approx( hits[ i ].distance, result.hits[ i ].distance ) );
+		}
+		REQUIRE( Approx( hits[ layerCount - 1 ].position, ae::Vec3( 2.3f, 2.6f, 0.0f ) ) );
+
+		// Returning false stops the query
+		uint32_t visitCount = 0;
+		REQUIRE_FALSE( mesh.RaycastEach( params, [&]( const ae::RaycastResult::Hit& )
+		{
+			return ++visitCount < 3;
+		} ) );
+		REQUIRE( visitCount == 3 );
+	}
+}
+
+TEST_CASE( "CollisionMesh Serialize round trip", "[ae::CollisionMesh]" )
+{
+	for( bool quantized : { false, true } )
+	{
+		ae::CollisionMesh<> mesh = TAG_COLLISION_MESH_TEST;
+		mesh.SetQuantizedBVHEnabled( quantized );
+		BuildGrid( &mesh, 16, 2.0f );
+		ae::Array< uint8_t > data = TAG_COLLISION_MESH_TEST;
+		ae::BinaryWriter writer( &data );
+		writer.SerializeObject( mesh );
+		REQUIRE( writer.IsValid() );
+
+		ae::CollisionMesh<> loaded = TAG_COLLISION_MESH_TEST;
+		ae::BinaryReader reader( data );
+		reader.SerializeObject( loaded );
+		REQUIRE( reader.IsValid() );
+		REQUIRE( reader.GetRemainingBytes() == 0 );
+		REQUIRE_FALSE( loaded.RequiresBVHRebuild() );
+		REQUIRE( loaded.GetQuantizedBVHEnabled() == quantized );
+		REQUIRE( loaded.GetVertexCount() == mesh.GetVertexCount() );
+		REQUIRE( loaded.GetIndexCount() == mesh.GetIndexCount() );
+		REQUIRE( memcmp( loaded.GetIndices(), mesh.GetIndices(), mesh.GetIndexCount() * sizeof(uint32_t) ) == 0 );
+		REQUIRE( loaded.GetAABB() == mesh.GetAABB() );
+
+		for( const ae::RaycastParams& ray : GetGridRays( 50, 16.0f, 2, 5 ) )
+		{
+			RequireSameHits( mesh.Raycast( ray ), loaded.Raycast( ray ) );
+		}
+		ae::CollisionMeshClosestPoint p0, p1;
+		REQUIRE( mesh.GetClosestPoint( ae::Vec3( 3.3f, 7.1f, 4.0f ), &p0 ) );
+		REQUIRE( loaded.GetClosestPoint( ae::Vec3( 3.3f, 7.1f, 4.0f ), &p1 ) );
+		REQUIRE( p0.triIdx == p1.triIdx );
+		REQUIRE( p0.extra == p1.extra );
+
+		// Output is deterministic
+		ae::Array< uint8_t > data2 = TAG_COLLISION_MESH_TEST;
+		ae::BinaryWriter writer2( &data2 );
+		writer2.SerializeObject( loaded );
+		REQUIRE( data2.Length() == data.Length() );
+		REQUIRE( memcmp( data2.Data(), data.Data(), data.Length() ) == 0 );
+	}
+}
+
+TEST_CASE( "CollisionMesh Serialize rejects invalid data", "[ae::CollisionMesh]" )
+{
+	ae::CollisionMesh<> mesh = TAG_COLLISION_MESH_TEST;
+	BuildGrid( &mesh, 8 );
+	ae::Array< uint8_t > data = TAG_COLLISION_MESH_TEST;
+	ae::BinaryWriter writer( &data );
+	writer.SerializeObject( mesh );
+
+	SECTION( "Truncated" )
+	{
+		ae::CollisionMesh<> loaded = TAG_COLLISION_MESH_TEST;
+		ae::BinaryReader reader( data.Data(), data.Length() - 4 );
+		reader.SerializeObject( loaded );
+		REQUIRE_FALSE( reader.IsValid() );
+		REQUIRE( loaded.GetIndexCount() == 0 );
+		REQUIRE_FALSE( loaded.Raycast( GetGridRays( 1, 8.0f, 1, 6 )[ 0 ] ).hits.Length() );
+	}
+	SECTION( "Version" )
+	{
+		data[ 4 ]++;
+		ae::CollisionMesh<> loaded = TAG_COLLISION_MESH_TEST;
+		ae::BinaryReader reader( data );
+		reader.SerializeObject( loaded );
+		REQUIRE_FALSE( reader.IsValid() );
+		REQUIRE( loaded.GetVertexCount() == 0 );
+	}
+	SECTION( "Static capacity" )
+	{
+		ae::CollisionMesh< 16, 16, 16 > loaded;
+		ae::BinaryReader reader( data );
+		reader.SerializeObject( loaded );
+		REQUIRE_FALSE( reader.IsValid() );
+		REQUIRE( loaded.GetVertexCount() == 0 );
+	}
+	SECTION( "Static" )
+	{
+		ae::CollisionMesh< 128, 256, 256 > loaded;
+		ae::BinaryReader reader( data );
+		reader.SerializeObject( loaded );
+		REQUIRE( reader.IsValid() );
+		for( const ae::RaycastParams& ray : GetGridRays( 20, 8.0f, 1, 7 ) )
+		{
+			RequireSameHits( mesh.Raycast( ray ), loaded.Raycast( ray ) );
+		}
+	}
+}
+
+TEST_CASE( "CollisionMesh Sweep sphere matches Triangle::SphereCast", "[ae::CollisionMesh]" )
+{
+	ae::CollisionMesh<> mesh = TAG_COLLISION_MESH_TEST;
+	BuildGrid( &mesh, 16, 2.0f );
+	uint64_t seed = 8;
+	uint32_t hitCount = 0;
+	for( uint32_t i = 0; i < 100; i++ )
+	{
+		ae::SweepParams params;
+		params.source = ae::Vec3( ae::Random( 0.0f, 16.0f, &seed ), ae::Random( 0.0f, 16.0f, &seed ), 5.0f );
+		params.sweep = ae::Vec3( ae::Random( -4.0f, 4.0f, &seed ), ae::Random( -4.0f, 4.0f, &seed ), -8.0f );
+		params.radius = ae::Random( 0.1f, 1.0f, &seed );
+		const ae::SweepResult result = mesh.Sweep( params );
+
+		float bestDistance = INFINITY;
+		for( uint32_t j = 0; j < mesh.GetTriangleCount(); j++ )
+		{
+			float distance;
+			if( mesh.GetTriangle( j ).SphereCast( params.source, params.sweep, params.radius, true, false, nullptr, nullptr, &distance ) )
+			{
+				bestDistance = ae::Min( bestDistance, distance );
+			}
+		}
+		REQUIRE( result.hit == ( bestDistance != INFINITY ) );
+		if( result.hit )
+		{
+			REQUIRE( Approx( result.distance, bestDistance ) );
+			REQUIRE( Approx( result.t, bestDistance / params.sweep.Length() ) );
+			const ae::Vec3 center = params.source + params.sweep * result.t;
+			REQUIRE( Approx( ( center - result.position ).Length(), params.radius ) );
+			REQUIRE( Approx( result.normal, ( center - result.position ).SafeNormalizeCopy() ) );
+			hitCount++;
+		}
+	}
+	REQUIRE( hitCount > 50 );
+}
+
+TEST_CASE( "CollisionMesh Sweep capsule", "[ae::CollisionMesh]" )
+{
+	ae::CollisionMesh<> mesh = TAG_COLLISION_MESH_TEST;
+	BuildGrid( &mesh, 4 );
+	ae::SweepParams params;
+	params.source = ae::Vec3( -10.0f, 1.5f, 3.0f );
+	params.capsuleOffset = ae::Vec3( 20.0f, 0.0f, 0.0f ); // Ends are outside of the mesh
+	params.radius = 0.5f;
+	params.sweep = ae::Vec3( 0.0f, 0.0f, -10.0f );
+	params.userData = 7;
+
+	ae::SweepResult result = mesh.Sweep( params );
+	REQUIRE( result.hit );
+	REQUIRE( Approx( result.t, 0.25f ) );
+	REQUIRE( Approx( result.distance, 2.5f ) );
+	REQUIRE( Approx( result.position.z, 0.0f ) );
+	REQUIRE( Approx( result.normal, ae::Vec3( 0.0f, 0.0f, 1.0f ) ) );
+	REQUIRE( result.userData.Get< int >( 0 ) == 7 );
+
+	// Transformed mesh
+	ae::CollisionMeshSweepParams meshParams;
+	meshParams.transform = ae::Matrix4::Translation( 0.0f, 0.0f, -1.0f ) * ae::Matrix4::Scaling( 1.0f, 1.0f, 2.0f );
+	result = mesh.Sweep( params, meshParams );
+	REQUIRE( result.hit );
+	REQUIRE( Approx( result.distance, 3.5f ) );
+	REQUIRE( Approx( result.position.z, -1.0f ) );
+
+	// Initially overlapping
+	params.source.z = 0.25f;
+	result = mesh.Sweep( params );
+	REQUIRE( result.hit );
+	REQUIRE( result.t == 0.0f );
+
+	// Miss
+	params.source = ae::Vec3( -10.0f, 20.0f, 3.0f );
+	result = mesh.Sweep( params );
+	REQUIRE_FALSE( result.hit );
+	REQUIRE( result.t == 1.0f );
+}
+
+TEST_CASE( "CollisionMesh Sweep keeps earlier previous result", "[ae::CollisionMesh]" )
+{
+	ae::CollisionMesh<> mesh = TAG_COLLISION_MESH_TEST;
+	BuildGrid( &mesh, 4 );
+	ae::SweepParams params;
+	params.source = ae::Vec3( 2.0f, 2.0f, 5.0f );
+	params.sweep = ae::Vec3( 0.0f, 0.0f, -10.0f );
+	params.radius = 1.0f;
+
+	ae::SweepResult prev;
+	prev.hit = true;
+	prev.t = 0.1f;
+	prev.extra = 1234;
+	REQUIRE( mesh.Sweep( params, {}, prev ).extra == 1234 );
+	prev.t = 0.5f;
+	const ae::SweepResult result = mesh.Sweep( params, {}, prev );
+	REQUIRE( Approx( result.t, 0.4f ) );
+	REQUIRE( result.extra != 1234 );
+}
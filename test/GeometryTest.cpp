@@ -33,6 +33,7 @@ namespace
 {
 bool Approx( float a, float b, float epsilon = 0.001f ) { return std::abs( a - b ) < epsilon; }
 bool Approx( const ae::Vec3& a, const ae::Vec3& b, float epsilon = 0.001f ) { return Approx( a.x, b.x, epsilon ) && Approx( a.y, b.y, epsilon ) && Approx( a.z, b.z, epsilon ); }
+const ae::Tag TAG_GEOMETRY_TEST = "geometry_test";
 }
 
 //------------------------------------------------------------------------------
@@ -244,6 +245,104 @@ TEST_CASE( "Triangle sphere cast - both sides hit", "[ae::Triangle]" )
 	REQUIRE( Approx( normal, ae::Vec3( 0.0f, 0.0f, -1.0f ) ) );
 }
 
+//------------------------------------------------------------------------------
+// ae::Triangle CapsuleCast tests
+// Triangle: (0,0,0),(1,0,0),(0,1,0) in XY plane, CCW normal = (0,0,1)
+//------------------------------------------------------------------------------
+TEST_CASE( "Triangle capsule cast - zero length matches sphere cast", "[ae::Triangle]" )
+{
+	ae::Triangle t( ae::Vec3( 0, 0, 0 ), ae::Vec3( 2, 0, 0 ), ae::Vec3( 0, 2, 0 ) );
+	const ae::Vec3 sources[] = { ae::Vec3( 0.25f, 0.25f, 2.0f ), ae::Vec3( 1.0f, -3.0f, 0.0f ), ae::Vec3( -3.0f, -3.0f, 0.5f ) };
+	const ae::Vec3 rays[] = { ae::Vec3( 0.0f, 0.0f, -4.0f ), ae::Vec3( 0.0f, 6.0f, 0.0f ), ae::Vec3( 6.0f, 6.0f, -1.0f ) };
+	for( uint32_t i = 0; i < countof( sources ); i++ )
+	{
+		ae::Vec3 hit0, normal0, hit1, normal1;
+		float distance0, distance1;
+		REQUIRE( t.SphereCast( sources[ i ], rays[ i ], 0.5f, true, false, &hit0, &normal0, &distance0 ) );
+		REQUIRE( t.CapsuleCast( sources[ i ], sources[ i ], rays[ i ], 0.5f, true, false, &hit1, &normal1, &distance1 ) );
+		REQUIRE( Approx( distance0, distance1 ) );
+		REQUIRE( Approx( hit0, hit1 ) );
+		REQUIRE( Approx( normal0, normal1 ) );
+	}
+}
+
+TEST_CASE( "Triangle capsule cast - segment interior hits face", "[ae::Triangle]" )
+{
+	ae::Triangle t( ae::Vec3( 0, 0, 0 ), ae::Vec3( 1, 0, 0 ), ae::Vec3( 0, 1, 0 ) );
+
+	// Capsule ends are far outside the triangle, only its middle touches it
+	ae::Vec3 hit, normal;
+	float distance;
+	REQUIRE( t.CapsuleCast( ae::Vec3( -5.0f, 0.25f, 2.0f ), ae::Vec3( 5.0f, 0.25f, 2.0f ), ae::Vec3( 0.0f, 0.0f, -4.0f ), 0.5f, true, false, &hit, &normal, &distance ) );
+	REQUIRE( Approx( distance, 1.5f ) );
+	REQUIRE( Approx( hit.z, 0.0f ) );
+	REQUIRE( Approx( normal, ae::Vec3( 0.0f, 0.0f, 1.0f ) ) );
+	REQUIRE_FALSE( t.SphereCast( ae::Vec3( -5.0f, 0.25f, 2.0f ), ae::Vec3( 0.0f, 0.0f, -4.0f ), 0.5f, true, false ) );
+}
+
+TEST_CASE( "Triangle capsule cast - side hits edge", "[ae::Triangle]" )
+{
+	ae::Triangle t( ae::Vec3( 0, 0, 0 ), ae::Vec3( 2, 0, 0 ), ae::Vec3( 0, 2, 0 ) );
+
+	// Vertical capsule moving in +Y towards edge AB, like the sphere edge test
+	ae::Vec3 hit, normal;
+	float distance;
+	REQUIRE( t.CapsuleCast( ae::Vec3( 1.0f, -3.0f, -2.0f ), ae::Vec3( 1.0f, -3.0f, 2.0f ), ae::Vec3( 0.0f, 6.0f, 0.0f ), 1.0f, true, true, &hit, &normal, &distance ) );
+	REQUIRE( Approx( distance, 2.0f ) );
+	REQUIRE( Approx( hit, ae::Vec3( 1.0f, 0.0f, 0.0f ) ) );
+	REQUIRE( Approx( normal, ae::Vec3( 0.0f, -1.0f, 0.0f ) ) );
+}
+
+TEST_CASE( "Triangle capsule cast - initial overlap, miss, and backface", "[ae::Triangle]" )
+{
+	ae::Triangle t( ae::Vec3( 0, 0, 0 ), ae::Vec3( 1, 0, 0 ), ae::Vec3( 0, 1, 0 ) );
+	float distance = -1.0f;
+	REQUIRE( t.CapsuleCast( ae::Vec3( 0.25f, 0.25f, 0.25f ), ae::Vec3( 0.25f, 0.25f, 1.0f ), ae::Vec3( 0.0f, 0.0f, -1.0f ), 0.5f, true, false, nullptr, nullptr, &distance ) );
+	REQUIRE( distance == 0.0f );
+	REQUIRE_FALSE( t.CapsuleCast( ae::Vec3( 0.25f, 0.25f, 2.0f ), ae::Vec3( 0.25f, 0.25f, 3.0f ), ae::Vec3( 0.0f, 0.0f, 1.0f ), 0.5f, true, false ) );
+	REQUIRE_FALSE( t.CapsuleCast( ae::Vec3( 5.0f, 5.0f, 2.0f ), ae::Vec3( 6.0f, 5.0f, 2.0f ), ae::Vec3( 0.0f, 0.0f, -4.0f ), 0.1f, true, false ) );
+	REQUIRE_FALSE( t.CapsuleCast( ae::Vec3( 0.25f, 0.25f, -2.0f ), ae::Vec3( 0.5f, 0.25f, -2.0f ), ae::Vec3( 0.0f, 0.0f, 4.0f ), 0.5f, true, false ) );
+	REQUIRE( t.CapsuleCast( ae::Vec3( 0.25f, 0.25f, -2.0f ), ae::Vec3( 0.5f, 0.25f, -2.0f ), ae::Vec3( 0.0f, 0.0f, 4.0f ), 0.5f, false, true, nullptr, nullptr, &distance ) );
+	REQUIRE( Approx( distance, 1.5f ) );
+}
+
+TEST_CASE( "Triangle capsule cast - grazing contacts", "[ae::Triangle]" )
+{
+	ae::Triangle t( ae::Vec3( 0, 0, 0 ), ae::Vec3( 1, 0, 0 ), ae::Vec3( 0, 1, 0 ) );
+	const float radius = 1.0f;
+	const float tolerance = 1e-4f; // See Triangle::CapsuleCast()
+
+	// Sphere sliding over the face just within the contact tolerance. The rate
+	// of approach goes to zero before the distance reaches the radius.
+	ae::Vec3 hit, normal;
+	float distance;
+	REQUIRE( t.CapsuleCast( ae::Vec3( -3.0f, 0.25f, radius + tolerance * 0.95f ), ae::Vec3( -3.0f, 0.25f, radius + tolerance * 0.95f ), ae::Vec3( 6.0f, 0.0f, 0.0f ), radius, true, false, &hit, &normal, &distance ) );
+	REQUIRE( distance > 2.9f );
+	REQUIRE( distance < 3.0f );
+	REQUIRE( Approx( hit, ae::Vec3( 0.0f, 0.25f, 0.0f ), 0.01f ) );
+	REQUIRE( normal.z > 0.99f );
+
+	// Sphere passing a vertex at its closest approach, the distance has a
+	// minimum between two steps instead of reaching the radius
+	const ae::Vec3 side = ae::Vec3( -1.0f, -1.0f, 0.0f ).NormalizeCopy();
+	const ae::Vec3 along = ae::Vec3( 1.0f, -1.0f, 0.0f ).NormalizeCopy();
+	const ae::Vec3 closest = side * ( radius + tolerance * 0.95f );
+	REQUIRE( t.CapsuleCast( closest - along * 1.7f, closest - along * 1.7f, along * 3.4f, radius, true, true, &hit, &normal, &distance ) );
+	REQUIRE( Approx( distance, 1.7f, 0.02f ) );
+	REQUIRE( Approx( hit, ae::Vec3( 0.0f ) ) );
+	REQUIRE( Approx( normal, side, 0.02f ) );
+
+	// Same paths just outside the tolerance miss
+	REQUIRE_FALSE( t.CapsuleCast( ae::Vec3( -3.0f, 0.25f, radius + tolerance * 2.0f ), ae::Vec3( -3.0f, 0.25f, radius + tolerance * 2.0f ), ae::Vec3( 6.0f, 0.0f, 0.0f ), radius, true, false ) );
+	const ae::Vec3 miss = side * ( radius + tolerance * 2.0f );
+	REQUIRE_FALSE( t.CapsuleCast( miss - along * 1.7f, miss - along * 1.7f, along * 3.4f, radius, true, true ) );
+
+	// Capsule segment sliding along an edge
+	REQUIRE( t.CapsuleCast( ae::Vec3( -3.0f, -radius - tolerance * 0.95f, -1.0f ), ae::Vec3( -3.0f, -radius - tolerance * 0.95f, 1.0f ), ae::Vec3( 6.0f, 0.0f, 0.0f ), radius, true, true, &hit, &normal, &distance ) );
+	REQUIRE( distance < 3.0f );
+	REQUIRE( Approx( normal, ae::Vec3( 0.0f, -1.0f, 0.0f ), 0.02f ) );
+}
+
 //------------------------------------------------------------------------------
 // ae::RaycastResult early out tests
 //------------------------------------------------------------------------------
@@ -796,6 +895,236 @@ TEST_CASE( "Frustum GetPlane sign convention", "[geometry]" )
 	}
 }
 
+TEST_CASE( "Frustum Intersects obb", "[geometry]" )
+{
+	const ae::Matrix4 view = ae::Matrix4::WorldToView(
+		ae::Vec3( 0.0f, 0.0f, 5.0f ),
+		ae::Vec3( 0.0f, 0.0f, -1.0f ),
+		ae::Vec3( 0.0f, 1.0f, 0.0f ) );
+	const ae::Matrix4 proj = ae::Matrix4::ViewToProjection( 1.5707963f, 1.0f, 0.1f, 100.0f );
+	const ae::Frustum frustum( proj * view );
+	// Box fully inside
+	REQUIRE( frustum.Intersects( ae::OBB( ae::Matrix4::RotationY( 0.5f ) ) ) );
+	// Box behind the camera
+	REQUIRE_FALSE( frustum.Intersects( ae::OBB( ae::Matrix4::Translation( 0.0f, 0.0f, 20.0f ) * ae::Matrix4::RotationY( 0.5f ) ) ) );
+	// Thin box just outside and parallel to the right plane, its aabb is not culled
+	const ae::OBB obb( ae::Matrix4::Translation( 8.0f, 0.0f, -2.0f ) * ae::Matrix4::RotationY( ae::QuarterPi ) * ae::Matrix4::Scaling( 10.0f, 0.2f, 0.2f ) );
+	REQUIRE_FALSE( frustum.Intersects( obb ) );
+	REQUIRE( frustum.Intersects( obb.GetAABB() ) );
+	// Same box moved inside the right plane
+	REQUIRE( frustum.Intersects( ae::OBB( ae::Matrix4::Translation( 6.0f, 0.0f, -2.0f ) * ae::Matrix4::RotationY( ae::QuarterPi ) * ae::Matrix4::Scaling( 10.0f, 0.2f, 0.2f ) ) ) );
+}
+
+TEST_CASE( "Frustum CullAABBs and CullSpheres match single tests", "[geometry]" )
+{
+	const ae::Matrix4 view = ae::Matrix4::WorldToView(
+		ae::Vec3( 0.0f, 0.0f, 5.0f ),
+		ae::Vec3( 0.3f, 0.1f, -1.0f ),
+		ae::Vec3( 0.0f, 1.0f, 0.0f ) );
+	const ae::Matrix4 proj = ae::Matrix4::ViewToProjection( 1.2f, 1.5f, 0.1f, 50.0f );
+	const ae::Frustum frustum( proj * view );
+
+	// Not a multiple of four to exercise the tail
+	const uint32_t count = 1003;
+	ae::Array< float > minX = TAG_GEOMETRY_TEST, minY = TAG_GEOMETRY_TEST, minZ = TAG_GEOMETRY_TEST;
+	ae::Array< float > maxX = TAG_GEOMETRY_TEST, maxY = TAG_GEOMETRY_TEST, maxZ = TAG_GEOMETRY_TEST;
+	ae::Array< float > radius = TAG_GEOMETRY_TEST;
+	uint64_t seed = 1;
+	for( uint32_t i = 0; i < count; i++ )
+	{
+		const ae::Vec3 center( ae::Random( -60.0f, 60.0f, &seed ), ae::Random( -60.0f, 60.0f, &seed ), ae::Random( -60.0f, 60.0f, &seed ) );
+		const ae::Vec3 halfSize( ae::Random( 0.1f, 5.0f, &seed ), ae::Random( 0.1f, 5.0f, &seed ), ae::Random( 0.1f, 5.0f, &seed ) );
+		minX.Append( center.x - halfSize.x );
+		minY.Append( center.y - halfSize.y );
+		minZ.Append( center.z - halfSize.z );
+		maxX.Append( center.x + halfSize.x );
+		maxY.Append( center.y + halfSize.y );
+		maxZ.Append( center.z + halfSize.z );
+		radius.Append( halfSize.x );
+	}
+	ae::Frustum::AABBArrays aabbs;
+	aabbs.minX = minX.Data();
+	aabbs.minY = minY.Data();
+	aabbs.minZ = minZ.Data();
+	aabbs.maxX = maxX.Data();
+	aabbs.maxY = maxY.Data();
+	aabbs.maxZ = maxZ.Data();
+	aabbs.count = count;
+	ae::Frustum::SphereArrays spheres;
+	spheres.centerX = minX.Data();
+	spheres.centerY = minY.Data();
+	spheres.centerZ = minZ.Data();
+	spheres.radius = radius.Data();
+	spheres.count = count;
+
+	uint32_t bits[ ( count + 31 ) / 32 ];
+	uint32_t indices[ count ];
+	const uint32_t aabbCount = frustum.CullAABBs( aabbs, bits, indices );
+	REQUIRE( frustum.CullAABBs( aabbs, nullptr ) == aabbCount );
+	uint32_t expectedCount = 0;
+	for( uint32_t i = 0; i < count; i++ )
+	{
+		const bool visible = frustum.Intersects( ae::AABB( ae::Vec3( minX[ i ], minY[ i ], minZ[ i ] ), ae::Vec3( maxX[ i ], maxY[ i ], maxZ[ i ] ) ) );
+		REQUIRE( ( ( bits[ i / 32 ] >> ( i % 32 ) ) & 1 ) == visible );
+		if( visible )
+		{
+			REQUIRE( indices[ expectedCount++ ] == i );
+		}
+	}
+	REQUIRE( aabbCount == expectedCount );
+	REQUIRE( expectedCount > 0 );
+	REQUIRE( expectedCount < count );
+	// Bits past the end are cleared
+	REQUIRE( ( bits[ count / 32 ] >> ( count % 32 ) ) == 0 );
+
+	const uint32_t sphereCount = frustum.CullSpheres( spheres, bits, indices );
+	expectedCount = 0;
+	for( uint32_t i = 0; i < count; i++ )
+	{
+		const bool visible = frustum.Intersects( ae::Sphere( ae::Vec3( minX[ i ], minY[ i ], minZ[ i ] ), radius[ i ] ) );
+		REQUIRE( ( ( bits[ i / 32 ] >> ( i % 32 ) ) & 1 ) == visible );
+		if( visible )
+		{
+			REQUIRE( indices[ expectedCount++ ] == i );
+		}
+	}
+	REQUIRE( sphereCount == expectedCount );
+	REQUIRE( expectedCount > 0 );
+	REQUIRE( expectedCount < count );
+}
+
+//------------------------------------------------------------------------------
+// ae::TransformPoints, ae::TransformNormals, and ae::TransformAABBs tests
+//------------------------------------------------------------------------------
+namespace
+{
+struct TransformTestVertex
+{
+	ae::Vec3 position;
+	float u;
+	ae::Vec3 normal;
+	float v;
+};
+ae::Matrix4 GetTransformTestMatrix()
+{
+	return ae::Matrix4::LocalToWorld(
+		ae::Vec3( 3.0f, -2.0f, 7.5f ),
+		ae::Quaternion( ae::Vec3( 1.0f, 2.0f, -0.5f ).NormalizeCopy(), 0.8f ),
+		ae::Vec3( 2.0f, 0.5f, -1.5f ) );
+}
+}
+
+TEST_CASE( "TransformPoints and TransformNormals match scalar transforms", "[geometry]" )
+{
+	const ae::Matrix4 transform = GetTransformTestMatrix();
+	const ae::Matrix4 normalTransform = transform.GetNormalMatrix();
+	// Odd count exercises the scalar tail, large count exercises the threaded path
+	for( uint32_t count : { 1u, 7u, 100003u } )
+	{
+		ae::Array< TransformTestVertex > vertices = TAG_GEOMETRY_TEST;
+		uint64_t seed = count;
+		for( uint32_t i = 0; i < count; i++ )
+		{
+			TransformTestVertex& vertex = vertices.Append( {} );
+			vertex.position = ae::Vec3( ae::Random( -10.0f, 10.0f, &seed ), ae::Random( -10.0f, 10.0f, &seed ), ae::Random( -10.0f, 10.0f, &seed ) );
+			vertex.normal = ( i % 5 == 0 ) ? ae::Vec3( 0.0f ) : ae::Vec3( ae::Random( -1.0f, 1.0f, &seed ), ae::Random( -1.0f, 1.0f, &seed ), ae::Random( -1.0f, 1.0f, &seed ) );
+			vertex.u = (float)i;
+			vertex.v = -(float)i;
+		}
+		ae::Array< ae::Vec3 > positions = TAG_GEOMETRY_TEST;
+		positions.Append( ae::Vec3( 0.0f ), count );
+		ae::TransformPoints( transform, vertices[ 0 ].position.data, sizeof(TransformTestVertex), positions[ 0 ].data, sizeof(ae::Vec3), count );
+		ae::TransformNormals( transform, vertices[ 0 ].normal.data, sizeof(TransformTestVertex), vertices[ 0 ].normal.data, sizeof(TransformTestVertex), count );
+		seed = count;
+		bool allMatch = true;
+		for( uint32_t i = 0; i < count; i++ )
+		{
+			const ae::Vec3 position( ae::Random( -10.0f, 10.0f, &seed ), ae::Random( -10.0f, 10.0f, &seed ), ae::Random( -10.0f, 10.0f, &seed ) );
+			const ae::Vec3 normal = ( i % 5 == 0 ) ? ae::Vec3( 0.0f ) : ae::Vec3( ae::Random( -1.0f, 1.0f, &seed ), ae::Random( -1.0f, 1.0f, &seed ), ae::Random( -1.0f, 1.0f, &seed ) );
+			allMatch = allMatch
+				&& Approx( positions[ i ], transform.TransformPoint3x4( position ) )
+				&& Approx( vertices[ i ].normal, normalTransform.TransformVector3x4( normal ).SafeNormalizeCopy() )
+				&& vertices[ i ].u == (float)i && vertices[ i ].v == -(float)i; // Untouched by strided writes
+		}
+		REQUIRE( allMatch );
+	}
+}
+
+TEST_CASE( "TransformAABBs fits transformed corners", "[geometry]" )
+{
+	const ae::Matrix4 transform = GetTransformTestMatrix();
+	ae::Array< ae::AABB > aabbs = TAG_GEOMETRY_TEST;
+	uint64_t seed = 5;
+	for( uint32_t i = 0; i < 33; i++ )
+	{
+		const ae::Vec3 center( ae::Random( -10.0f, 10.0f, &seed ), ae::Random( -10.0f, 10.0f, &seed ), ae::Random( -10.0f, 10.0f, &seed ) );
+		const ae::Vec3 halfSize( ae::Random( 0.0f, 3.0f, &seed ), ae::Random( 0.0f, 3.0f, &seed ), ae::Random( 0.0f, 3.0f, &seed ) );
+		aabbs.Append( ae::AABB( center - halfSize, center + halfSize ) );
+	}
+	aabbs.Append( ae::AABB() );
+	ae::Array< ae::AABB > result = TAG_GEOMETRY_TEST;
+	result.Append( ae::AABB(), aabbs.Length() );
+	ae::TransformAABBs( transform, aabbs.Data(), sizeof(ae::AABB), result.Data(), sizeof(ae::AABB), aabbs.Length() );
+	for( uint32_t i = 0; i < aabbs.Length() - 1; i++ )
+	{
+		ae::AABB expected;
+		for( uint32_t c = 0; c < 8; c++ )
+		{
+			const ae::Vec3 min = aabbs[ i ].GetMin();
+			const ae::Vec3 max = aabbs[ i ].GetMax();
+			expected.Expand( transform.TransformPoint3x4( ae::Vec3( ( c & 1 ) ? max.x : min.x, ( c & 2 ) ? max.y : min.y, ( c & 4 ) ? max.z : min.z ) ) );
+		}
+		REQUIRE( Approx( result[ i ].GetMin(), expected.GetMin() ) );
+		REQUIRE( Approx( result[ i ].GetMax(), expected.GetMax() ) );
+	}
+	REQUIRE( result[ aabbs.Length() - 1 ] == ae::AABB() );
+
+	// In place
+	ae::TransformAABBs( transform, aabbs.Data(), sizeof(ae::AABB), aabbs.Data(), sizeof(ae::AABB), aabbs.Length() );
+	for( uint32_t i = 0; i < aabbs.Length(); i++ )
+	{
+		REQUIRE( aabbs[ i ] == result[ i ] );
+	}
+}
+
+TEST_CASE( "TransformPoints TransformNormals and TransformAABBs threaded results match single threaded", "[geometry]" )
+{
+	const ae::Matrix4 transform = GetTransformTestMatrix();
+	const uint32_t count = 100003; // Splits across threads with a scalar tail
+	ae::Array< ae::Vec3 > positions = TAG_GEOMETRY_TEST;
+	ae::Array< ae::AABB > aabbs = TAG_GEOMETRY_TEST;
+	uint64_t seed = 3;
+	for( uint32_t i = 0; i < count; i++ )
+	{
+		const ae::Vec3 p( ae::Random( -10.0f, 10.0f, &seed ), ae::Random( -10.0f, 10.0f, &seed ), ae::Random( -10.0f, 10.0f, &seed ) );
+		positions.Append( p );
+		aabbs.Append( ae::AABB( p, p + ae::Vec3( ae::Random( 0.0f, 2.0f, &seed ) ) ) );
+	}
+	ae::Array< ae::Vec3 > single = TAG_GEOMETRY_TEST;
+	ae::Array< ae::Vec3 > threaded = TAG_GEOMETRY_TEST;
+	single.Append( ae::Vec3( 0.0f ), count );
+	threaded.Append( ae::Vec3( 0.0f ), count );
+	ae::TransformPoints( transform, positions[ 0 ].data, sizeof(ae::Vec3), single[ 0 ].data, sizeof(ae::Vec3), count );
+	ae::TransformPoints( transform, positions[ 0 ].data, sizeof(ae::Vec3), threaded[ 0 ].data, sizeof(ae::Vec3), count, 3 );
+	REQUIRE( memcmp( single.Data(), threaded.Data(), count * sizeof(ae::Vec3) ) == 0 );
+	REQUIRE( single[ count - 1 ] == transform.TransformPoint3x4( positions[ count - 1 ] ) );
+
+	ae::TransformNormals( transform, positions[ 0 ].data, sizeof(ae::Vec3), single[ 0 ].data, sizeof(ae::Vec3), count );
+	ae::TransformNormals( transform, positions[ 0 ].data, sizeof(ae::Vec3), threaded[ 0 ].data, sizeof(ae::Vec3), count, 0 );
+	REQUIRE( memcmp( single.Data(), threaded.Data(), count * sizeof(ae::Vec3) ) == 0 );
+
+	ae::Array< ae::AABB > singleAABBs = TAG_GEOMETRY_TEST;
+	ae::Array< ae::AABB > threadedAABBs = TAG_GEOMETRY_TEST;
+	singleAABBs.Append( ae::AABB(), count );
+	threadedAABBs.Append( ae::AABB(), count );
+	ae::TransformAABBs( transform, aabbs.Data(), sizeof(ae::AABB), singleAABBs.Data(), sizeof(ae::AABB), count );
+	ae::TransformAABBs( transform, aabbs.Data(), sizeof(ae::AABB), threadedAABBs.Data(), sizeof(ae::AABB), count, 64 );
+	for( uint32_t i = 0; i < count; i++ )
+	{
+		REQUIRE( singleAABBs[ i ] == threadedAABBs[ i ] );
+	}
+}
+
 //------------------------------------------------------------------------------
 // ae::Rect tests
 //------------------------------------------------------------------------------
@@ -1054,6 +1383,41 @@ TEST_CASE( "RaycastResult Accumulate member adds hit", "[geometry]" )
 	REQUIRE( Approx( result.hits[ 0 ].distance, 3.0f ) );
 }
 
+TEST_CASE( "RaycastEach free functions match Raycast", "[geometry]" )
+{
+	ae::RaycastParams params;
+	params.source = ae::Vec3( 0.2f, 0.1f, 10.0f );
+	params.ray = ae::Vec3( 0.0f, 0.0f, -20.0f );
+	const ae::Sphere sphere( ae::Vec3( 0.0f ), 1.0f );
+	const ae::AABB aabb( ae::Vec3( -1.0f ), ae::Vec3( 1.0f ) );
+	const ae::Triangle tri( ae::Vec3( -1.0f, -1.0f, 0.0f ), ae::Vec3( 1.0f, -1.0f, 0.0f ), ae::Vec3( 0.0f, 1.0f, 0.0f ) );
+
+	ae::Array< ae::RaycastResult::Hit, 4 > hits;
+	auto appendHit = [&]( const ae::RaycastResult::Hit& hit )
+	{
+		hits.Append( hit );
+		return true;
+	};
+	REQUIRE( ae::RaycastEach( sphere, params, appendHit ) );
+	REQUIRE( ae::RaycastEach( aabb, params, appendHit ) );
+	REQUIRE( ae::RaycastEach( tri, params, appendHit ) );
+	const ae::RaycastResult expected[] = { ae::Raycast( sphere, params ), ae::Raycast( aabb, params ), ae::Raycast( tri, params ) };
+	REQUIRE( hits.Length() == 3 );
+	for( uint32_t i = 0; i < hits.Length(); i++ )
+	{
+		REQUIRE( expected[ i ].hits.Length() == 1 );
+		REQUIRE( Approx( hits[ i ].position, expected[ i ].hits[ 0 ].position ) );
+		REQUIRE( Approx( hits[ i ].normal, expected[ i ].hits[ 0 ].normal ) );
+		REQUIRE( Approx( hits[ i ].distance, expected[ i ].hits[ 0 ].distance ) );
+	}
+
+	// Misses don't call the visitor
+	const ae::Sphere farSphere( ae::Vec3( 10.0f, 0.0f, 0.0f ), 1.0f );
+	REQUIRE( ae::RaycastEach( farSphere, params, []( const ae::RaycastResult::Hit& ) { return false; } ) );
+	// Returning false from the visitor is reported to the caller
+	REQUIRE_FALSE( ae::RaycastEach( sphere, params, []( const ae::RaycastResult::Hit& ) { return false; } ) );
+}
+
 //------------------------------------------------------------------------------
 // ae::Plane tests
 //------------------------------------------------------------------------------
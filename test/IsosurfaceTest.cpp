@@ -0,0 +1,345 @@
+//------------------------------------------------------------------------------
+// IsosurfaceTest.cpp
+//------------------------------------------------------------------------------
+// Copyright (c) 2026 John Hughes
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files( the "Software" ), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and /or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions :
+//
+// The above copyright notice and this permission notice shall be included in all
+// copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+// SOFTWARE.
+//------------------------------------------------------------------------------
+// Headers
+//------------------------------------------------------------------------------
+#include <catch2/catch_test_macros.hpp>
+#include "aether.h"
+#include <algorithm>
+#include <array>
+
+//------------------------------------------------------------------------------
+// Isosurface test helpers
+//------------------------------------------------------------------------------
+namespace
+{
+const ae::Tag TAG_ISOSURFACE_TEST = "isosurface_test";
+
+ae::IsosurfaceValue SampleShapes( const void*, ae::Vec3 p )
+{
+	// Union of a sphere and a rounded rotated box
+	const float sphere = ( p - ae::Vec3( 4.0f, -3.0f, 2.0f ) ).Length() - 17.5f;
+	const ae::Vec3 q = ae::Vec3( p.x * 0.8f - p.y * 0.6f, p.x * 0.6f + p.y * 0.8f, p.z ) - ae::Vec3( -10.0f, 8.0f, -6.0f );
+	const ae::Vec3 d = ae::Vec3( std::abs( q.x ), std::abs( q.y ), std::abs( q.z ) ) - ae::Vec3( 10.5f, 3.5f, 7.5f );
+	const float box = ae::Vec3( ae::Max( d.x, 0.0f ), ae::Max( d.y, 0.0f ), ae::Max( d.z, 0.0f ) ).Length() + ae::Min( ae::Max( d.x, d.y, d.z ), 0.0f );
+	return { ae::Min( sphere, box - 1.5f ), 0.0f };
+}
+
+void SampleShapesBatch( const void*, const ae::Vec3* p, ae::IsosurfaceValue* valuesOut, uint32_t count )
+{
+	for( uint32_t i = 0; i < count; i++ )
+	{
+		valuesOut[ i ] = SampleShapes( nullptr, p[ i ] );
+	}
+}
+
+//! A sphere that can be moved around on top of SampleShapes()
+struct SculptedShapes
+{
+	ae::Vec3 center = ae::Vec3( 0.0f );
+	float radius = 0.0f;
+	ae::AABB GetAABB() const { return ae::AABB( center - ae::Vec3( radius ), center + ae::Vec3( radius ) ); }
+};
+
+ae::IsosurfaceValue SampleSculptedShapes( const void* userData, ae::Vec3 p )
+{
+	const SculptedShapes* sculpt = (const SculptedShapes*)userData;
+	const float sphere = ( p - sculpt->center ).Length() - sculpt->radius;
+	return { ae::Min( SampleShapes( nullptr, p ).distance, sphere ), 0.0f };
+}
+
+//! Returns each triangle as positions and normals, rotated so the smallest
+//! position is first to preserve winding, and sorted
+std::vector< std::array< float, 18 > > GetTriangles( const ae::IsosurfaceExtractor& extractor )
+{
+	std::vector< std::array< float, 18 > > result;
+	for( uint32_t i = 0; i < extractor.indices.Length(); i += 3 )
+	{
+		if( extractor.indices[ i ] == extractor.indices[ i + 1 ] && extractor.indices[ i ] == extractor.indices[ i + 2 ] )
+		{
+			continue; // Degenerate padding from ae::IsosurfaceParams::incremental
+		}
+		std::array< std::array< float, 6 >, 3 > tri;
+		for( uint32_t j = 0; j < 3; j++ )
+		{
+			const ae::IsosurfaceVertex& v = extractor.vertices[ extractor.indices[ i + j ] ];
+			tri[ j ] = { v.position.x, v.position.y, v.position.z, v.normal.x, v.normal.y, v.normal.z };
+		}
+		std::rotate( tri.begin(), std::min_element( tri.begin(), tri.end() ), tri.end() );
+		std::array< float, 18 > flat;
+		for( uint32_t j = 0; j < 18; j++ )
+		{
+			flat[ j ] = tri[ j / 6 ][ j % 6 ];
+		}
+		result.push_back( flat );
+	}
+	std::sort( result.begin(), result.end() );
+	return result;
+}
+}
+
+//------------------------------------------------------------------------------
+// ae::IsosurfaceExtractor threading tests
+//------------------------------------------------------------------------------
+TEST_CASE( "Isosurface multithreaded generation matches single threaded", "[ae::IsosurfaceExtractor]" )
+{
+	for( bool dualContouring : { false, true } )
+	{
+		INFO( "dualContouring: " << dualContouring );
+		ae::IsosurfaceParams params;
+		params.sampleFn = &SampleShapes;
+		params.aabb = ae::AABB( ae::Vec3( -30.0f, -28.0f, -25.0f ), ae::Vec3( 29.0f, 27.5f, 24.0f ) );
+		params.dualContouring = dualContouring;
+		ae::Array< ae::AABB > octree0 = TAG_ISOSURFACE_TEST;
+		ae::Array< ae::AABB > brickMap0 = TAG_ISOSURFACE_TEST;
+		ae::Array< ae::AABB > octree1 = TAG_ISOSURFACE_TEST;
+		ae::Array< ae::AABB > brickMap1 = TAG_ISOSURFACE_TEST;
+
+		ae::IsosurfaceExtractor single = TAG_ISOSURFACE_TEST;
+		params.threadCount = 1;
+		params.octree = &octree0;
+		params.brickMap = &brickMap0;
+		REQUIRE( single.Generate( params ) );
+		REQUIRE( single.GetStatus().threadCount == 1 );
+
+		ae::IsosurfaceExtractor multi = TAG_ISOSURFACE_TEST;
+		params.threadCount = 4;
+		params.octree = &octree1;
+		params.brickMap = &brickMap1;
+		REQUIRE( multi.Generate( params ) );
+		const ae::IsosurfaceStatus& status = multi.GetStatus();
+		REQUIRE( status.threadCount == 4 );
+		for( uint32_t i = 0; i < status.threadCount; i++ )
+		{
+			REQUIRE( status.threadTime[ i ] > 0.0 );
+		}
+		REQUIRE( status.voxelCheckCount == single.GetStatus().voxelCheckCount );
+		REQUIRE( status.voxelSearchProgress == single.GetStatus().voxelSearchProgress );
+
+		REQUIRE( single.vertices.Length() > 1000 );
+		REQUIRE( multi.vertices.Length() == single.vertices.Length() );
+		REQUIRE( multi.indices.Length() == single.indices.Length() );
+		REQUIRE( GetTriangles( multi ) == GetTriangles( single ) );
+		REQUIRE( octree1.Length() == octree0.Length() );
+		REQUIRE( brickMap1.Length() == brickMap0.Length() );
+	}
+}
+
+TEST_CASE( "Isosurface multithreaded generation can be cancelled", "[ae::IsosurfaceExtractor]" )
+{
+	uint32_t statusCount = 0;
+	ae::IsosurfaceParams params;
+	params.sampleFn = &SampleShapes;
+	params.statusFn = []( const void* userData, const ae::IsosurfaceStatus& status )
+	{
+		uint32_t* count = (uint32_t*)userData;
+		( *count )++;
+		return status.voxelProgress01 < 0.3f;
+	};
+	params.userData = &statusCount;
+	params.aabb = ae::AABB( ae::Vec3( -30.0f ), ae::Vec3( 30.0f ) );
+	params.threadCount = 4;
+	ae::IsosurfaceExtractor extractor = TAG_ISOSURFACE_TEST;
+	REQUIRE( !extractor.Generate( params ) );
+	REQUIRE( statusCount );
+	REQUIRE( extractor.vertices.Length() == 0 );
+	REQUIRE( extractor.indices.Length() == 0 );
+
+	params.statusFn = nullptr;
+	params.maxIndices = 60;
+	REQUIRE( !extractor.Generate( params ) );
+	REQUIRE( extractor.indices.Length() == 0 );
+}
+
+TEST_CASE( "Isosurface batch sampling matches single sampling", "[ae::IsosurfaceExtractor]" )
+{
+	for( bool dualContouring : { false, true } )
+	{
+		INFO( "dualContouring: " << dualContouring );
+		ae::IsosurfaceParams params;
+		params.aabb = ae::AABB( ae::Vec3( -30.0f, -28.0f, -25.0f ), ae::Vec3( 29.0f, 27.5f, 24.0f ) );
+		params.dualContouring = dualContouring;
+
+		ae::IsosurfaceExtractor single = TAG_ISOSURFACE_TEST;
+		params.sampleFn = &SampleShapes;
+		REQUIRE( single.Generate( params ) );
+		const ae::IsosurfaceStatus& singleStatus = single.GetStatus();
+		REQUIRE( singleStatus.sampleCallCount == singleStatus.sampleRawCount );
+
+		// Batch only
+		ae::IsosurfaceExtractor batch = TAG_ISOSURFACE_TEST;
+		params.sampleFn = nullptr;
+		params.sampleBatchFn = &SampleShapesBatch;
+		REQUIRE( batch.Generate( params ) );
+		const ae::IsosurfaceStatus& batchStatus = batch.GetStatus();
+		REQUIRE( batchStatus.sampleRawCount == singleStatus.sampleRawCount );
+		REQUIRE( batchStatus.sampleCacheCount == singleStatus.sampleCacheCount );
+		REQUIRE( batchStatus.sampleCallCount * 4 < batchStatus.sampleRawCount );
+		REQUIRE( batch.vertices.Length() == single.vertices.Length() );
+		REQUIRE( GetTriangles( batch ) == GetTriangles( single ) );
+
+		// Both, single samples use sampleFn
+		ae::IsosurfaceExtractor both = TAG_ISOSURFACE_TEST;
+		params.sampleFn = &SampleShapes;
+		params.threadCount = 4;
+		REQUIRE( both.Generate( params ) );
+		REQUIRE( both.GetStatus().sampleCallCount < both.GetStatus().sampleRawCount );
+		REQUIRE( GetTriangles( both ) == GetTriangles( single ) );
+	}
+}
+
+TEST_CASE( "Isosurface incremental update matches full generation", "[ae::IsosurfaceExtractor]" )
+{
+	for( bool dualContouring : { false, true } )
+	{
+		INFO( "dualContouring: " << dualContouring );
+		SculptedShapes sculpt;
+		sculpt.center = ae::Vec3( -20.0f, 15.0f, 12.0f );
+		sculpt.radius = 4.5f;
+		ae::IsosurfaceParams params;
+		params.sampleFn = &SampleSculptedShapes;
+		params.userData = &sculpt;
+		params.aabb = ae::AABB( ae::Vec3( -30.0f, -28.0f, -25.0f ), ae::Vec3( 29.0f, 27.5f, 24.0f ) );
+		params.dualContouring = dualContouring;
+		params.incremental = true;
+		ae::IsosurfaceExtractor extractor = TAG_ISOSURFACE_TEST;
+		REQUIRE( extractor.Generate( params ) );
+		const uint64_t generateSamples = extractor.GetStatus().sampleRawCount;
+		ae::IsosurfaceExtractor expected = TAG_ISOSURFACE_TEST;
+		REQUIRE( expected.Generate( params ) );
+		REQUIRE( GetTriangles( extractor ) == GetTriangles( expected ) );
+
+		// Move the sphere around, including into the other shapes, out of bounds, and back
+		const ae::Vec3 centers[] = { { -18.0f, 13.0f, 12.0f }, { -10.0f, 8.0f, 4.0f }, { 40.0f, 40.0f, 40.0f }, { 27.0f, -20.0f, -5.0f }, { 27.5f, -20.0f, -5.0f } };
+		for( uint32_t i = 0; i < countof( centers ); i++ )
+		{
+			INFO( "update: " << i );
+			const ae::AABB dirty[] = { sculpt.GetAABB(), ae::AABB( centers[ i ] - ae::Vec3( sculpt.radius ), centers[ i ] + ae::Vec3( sculpt.radius ) ) };
+			sculpt.center = centers[ i ];
+			const uint32_t untouched = extractor.indices[ 0 ];
+			REQUIRE( extractor.Update( dirty, countof( dirty ) ) );
+			REQUIRE( extractor.GetStatus().sampleRawCount < generateSamples / 2 );
+			REQUIRE( extractor.indices[ 0 ] == untouched );
+			REQUIRE( expected.Generate( params ) );
+			REQUIRE( GetTriangles( extractor ) == GetTriangles( expected ) );
+		}
+		// The index buffer is compacted once relocated bricks waste enough space
+		REQUIRE( extractor.indices.Length() < expected.indices.Length() * 2 );
+	}
+}
+
+TEST_CASE( "Isosurface incremental update limits", "[ae::IsosurfaceExtractor]" )
+{
+	SculptedShapes sculpt;
+	sculpt.center = ae::Vec3( 20.0f, 20.0f, 20.0f );
+	sculpt.radius = 2.5f;
+	ae::IsosurfaceParams params;
+	params.sampleFn = &SampleSculptedShapes;
+	params.userData = &sculpt;
+	params.aabb = ae::AABB( ae::Vec3( -30.0f ), ae::Vec3( 30.0f ) );
+	params.incremental = true;
+	params.threadCount = 4;
+	ae::IsosurfaceExtractor extractor = TAG_ISOSURFACE_TEST;
+	REQUIRE( !extractor.Update( nullptr, 0 ) );
+	REQUIRE( extractor.Generate( params ) );
+	REQUIRE( extractor.Update( nullptr, 0 ) );
+
+	params.maxIndices = extractor.indices.Length() + 60;
+	REQUIRE( extractor.Generate( params ) );
+	const ae::AABB dirty( sculpt.center - ae::Vec3( 12.0f ), sculpt.center + ae::Vec3( 12.0f ) );
+	sculpt.radius = 12.0f;
+	REQUIRE( !extractor.Update( &dirty, 1 ) );
+	REQUIRE( extractor.vertices.Length() == 0 );
+	REQUIRE( extractor.indices.Length() == 0 );
+	REQUIRE( !extractor.Update( &dirty, 1 ) );
+}
+
+TEST_CASE( "Isosurface multi-resolution generation at full resolution matches single resolution", "[ae::IsosurfaceExtractor]" )
+{
+	for( bool dualContouring : { false, true } )
+	{
+		INFO( "dualContouring: " << dualContouring );
+		ae::IsosurfaceParams params;
+		params.sampleFn = &SampleShapes;
+		params.aabb = ae::AABB( ae::Vec3( -32.0f ), ae::Vec3( 32.0f ) );
+		params.dualContouring = dualContouring;
+		ae::IsosurfaceExtractor expected = TAG_ISOSURFACE_TEST;
+		REQUIRE( expected.Generate( params ) );
+
+		ae::Array< ae::AABB > regions = TAG_ISOSURFACE_TEST;
+		params.lodFn = []( const void*, ae::AABB ) { return 0u; };
+		params.lodRegionSize = 16;
+		params.octree = &regions;
+		ae::IsosurfaceExtractor extractor = TAG_ISOSURFACE_TEST;
+		REQUIRE( extractor.Generate( params ) );
+		REQUIRE( regions.Length() == 4 * 4 * 4 );
+		REQUIRE( extractor.vertices.Length() == expected.vertices.Length() );
+		REQUIRE( GetTriangles( extractor ) == GetTriangles( expected ) );
+	}
+}
+
+TEST_CASE( "Isosurface multi-resolution generation is closed", "[ae::IsosurfaceExtractor]" )
+{
+	for( bool dualContouring : { false, true } )
+	{
+		INFO( "dualContouring: " << dualContouring );
+		ae::IsosurfaceParams params;
+		params.sampleFn = &SampleShapes;
+		params.aabb = ae::AABB( ae::Vec3( -32.0f ), ae::Vec3( 32.0f ) );
+		params.dualContouring = dualContouring;
+		ae::IsosurfaceExtractor full = TAG_ISOSURFACE_TEST;
+		REQUIRE( full.Generate( params ) );
+
+		params.lodFocus = ae::Vec3( 20.0f, -10.0f, 10.0f );
+		params.lodDistance = 8.0f;
+		params.lodRegionSize = 8;
+		ae::IsosurfaceExtractor extractor = TAG_ISOSURFACE_TEST;
+		REQUIRE( extractor.Generate( params ) );
+		REQUIRE( extractor.vertices.Length() < full.vertices.Length() / 2 );
+
+		// Every edge should be shared by exactly two triangles with opposite
+		// winding, even across changes in level of detail
+		ae::Map< uint64_t, int32_t > edges = TAG_ISOSURFACE_TEST;
+		for( uint32_t i = 0; i < extractor.indices.Length(); i += 3 )
+		{
+			for( uint32_t j = 0; j < 3; j++ )
+			{
+				const uint32_t a = extractor.indices[ i + j ];
+				const uint32_t b = extractor.indices[ i + ( j + 1 ) % 3 ];
+				const uint64_t key = ( (uint64_t)ae::Min( a, b ) << 32 ) | ae::Max( a, b );
+				edges.Set( key, edges.Get( key, 0 ) + ( a < b ? 1 : -1 ) );
+			}
+		}
+		uint32_t openEdges = 0;
+		for( uint32_t i = 0; i < edges.Length(); i++ )
+		{
+			openEdges += ( edges.GetValue( i ) != 0 );
+		}
+		CHECK( openEdges == 0 );
+		for( const ae::IsosurfaceVertex& vertex : extractor.vertices )
+		{
+			// Largest voxels are the size of a region
+			REQUIRE( std::abs( SampleShapes( nullptr, vertex.position.GetXYZ() ).distance ) < params.lodRegionSize );
+		}
+	}
+}
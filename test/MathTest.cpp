@@ -29,6 +29,8 @@
 //------------------------------------------------------------------------------
 // Math test helpers
 //------------------------------------------------------------------------------
+const ae::Tag TAG_MATH_TEST = "math_test";
+
 bool IsCloseEnough( float a, float b, float epsilon = 0.001f )
 {
 	return std::abs( a - b ) < epsilon;
@@ -1055,6 +1057,138 @@ TEST_CASE( "Quaternion forward up constructor", "[ae::Quaternion]" )
 	REQUIRE( IsCloseEnough( q.Rotate( ae::Vec3( 0,1,0 ) ), ae::Vec3( 0,1,0 ) ) );
 }
 
+//------------------------------------------------------------------------------
+// ae::Matrix4 and ae::Quaternion SIMD tests
+// These compare against plain scalar reference implementations, so they cover
+// both the SSE2/NEON and AE_ENABLE_SIMD=0 paths.
+//------------------------------------------------------------------------------
+ae::Matrix4 GetRandomMatrix( uint64_t* seed )
+{
+	const ae::Quaternion rotation( ae::Vec3( ae::Random( -1.0f, 1.0f, seed ), ae::Random( -1.0f, 1.0f, seed ), 1.0f ).NormalizeCopy(), ae::Random( -ae::PI, ae::PI, seed ) );
+	const ae::Vec3 scale( ae::Random( 0.2f, 3.0f, seed ), ae::Random( 0.2f, 3.0f, seed ), ae::Random( -3.0f, -0.2f, seed ) );
+	const ae::Vec3 translation( ae::Random( -10.0f, 10.0f, seed ), ae::Random( -10.0f, 10.0f, seed ), ae::Random( -10.0f, 10.0f, seed ) );
+	ae::Matrix4 m = ae::Matrix4::Translation( translation ) * ae::Matrix4::Rotation( rotation ) * ae::Matrix4::Scaling( scale );
+	// Perspective-like bottom row so the full 4x4 is exercised
+	m.SetRow( 3, ae::Vec4( ae::Random( -0.2f, 0.2f, seed ), ae::Random( -0.2f, 0.2f, seed ), ae::Random( -0.2f, 0.2f, seed ), 1.0f ) );
+	return m;
+}
+
+bool IsCloseEnough( const ae::Matrix4& a, const ae::Matrix4& b, float e = 0.001f )
+{
+	for( uint32_t i = 0; i < 16; i++ )
+	{
+		if( !IsCloseEnough( a.data[ i ], b.data[ i ], e * ae::Max( 1.0f, std::abs( b.data[ i ] ) ) ) )
+		{
+			return false;
+		}
+	}
+	return true;
+}
+
+TEST_CASE( "Matrix4 multiply matches scalar reference", "[ae::Matrix4]" )
+{
+	uint64_t seed = 1;
+	for( uint32_t n = 0; n < 100; n++ )
+	{
+		const ae::Matrix4 a = GetRandomMatrix( &seed );
+		const ae::Matrix4 b = GetRandomMatrix( &seed );
+		ae::Matrix4 expected;
+		for( uint32_t col = 0; col < 4; col++ )
+		{
+			for( uint32_t row = 0; row < 4; row++ )
+			{
+				float sum = 0.0f;
+				for( uint32_t k = 0; k < 4; k++ )
+				{
+					sum += a.data[ k * 4 + row ] * b.data[ col * 4 + k ];
+				}
+				expected.data[ col * 4 + row ] = sum;
+			}
+		}
+		REQUIRE( IsCloseEnough( a * b, expected, 1e-5f ) );
+		ae::Matrix4 c = a;
+		c *= b;
+		REQUIRE( c == a * b );
+
+		const ae::Vec4 v( ae::Random( -5.0f, 5.0f, &seed ), ae::Random( -5.0f, 5.0f, &seed ), ae::Random( -5.0f, 5.0f, &seed ), ae::Random( -1.0f, 1.0f, &seed ) );
+		ae::Vec4 expectedV;
+		for( uint32_t row = 0; row < 4; row++ )
+		{
+			expectedV[ row ] = a.data[ row ] * v.x + a.data[ 4 + row ] * v.y + a.data[ 8 + row ] * v.z + a.data[ 12 + row ] * v.w;
+		}
+		REQUIRE( IsCloseEnough( a * v, expectedV, 1e-4f ) );
+	}
+}
+
+TEST_CASE( "Matrix4 transpose matches scalar reference", "[ae::Matrix4]" )
+{
+	uint64_t seed = 2;
+	const ae::Matrix4 m = GetRandomMatrix( &seed );
+	const ae::Matrix4 t = m.GetTranspose();
+	for( uint32_t row = 0; row < 4; row++ )
+	{
+		for( uint32_t col = 0; col < 4; col++ )
+		{
+			REQUIRE( t.data[ col * 4 + row ] == m.data[ row * 4 + col ] );
+		}
+	}
+	ae::Matrix4 t2 = t;
+	REQUIRE( t2.SetTranspose() == m );
+}
+
+TEST_CASE( "Matrix4 inverse", "[ae::Matrix4]" )
+{
+	uint64_t seed = 3;
+	for( uint32_t n = 0; n < 100; n++ )
+	{
+		const ae::Matrix4 m = GetRandomMatrix( &seed );
+		const ae::Matrix4 inv = m.GetInverse();
+		REQUIRE( IsCloseEnough( m * inv, ae::Matrix4::Identity(), 1e-4f ) );
+		REQUIRE( IsCloseEnough( inv * m, ae::Matrix4::Identity(), 1e-4f ) );
+		REQUIRE( IsCloseEnough( inv.GetInverse(), m, 1e-4f ) );
+		ae::Matrix4 inv2 = m;
+		REQUIRE( inv2.SetInverse() == inv );
+	}
+	REQUIRE( ae::Matrix4::Identity().GetInverse() == ae::Matrix4::Identity() );
+	REQUIRE( IsCloseEnough( ae::Matrix4::Scaling( 2.0f, 4.0f, 0.5f ).GetInverse(), ae::Matrix4::Scaling( 0.5f, 0.25f, 2.0f ), 1e-6f ) );
+}
+
+TEST_CASE( "Quaternion multiply and normalize match scalar reference", "[ae::Quaternion]" )
+{
+	uint64_t seed = 4;
+	for( uint32_t n = 0; n < 100; n++ )
+	{
+		const ae::Quaternion a( ae::Random( -2.0f, 2.0f, &seed ), ae::Random( -2.0f, 2.0f, &seed ), ae::Random( -2.0f, 2.0f, &seed ), ae::Random( -2.0f, 2.0f, &seed ) );
+		const ae::Quaternion b( ae::Random( -2.0f, 2.0f, &seed ), ae::Random( -2.0f, 2.0f, &seed ), ae::Random( -2.0f, 2.0f, &seed ), ae::Random( -2.0f, 2.0f, &seed ) );
+		const ae::Quaternion expected(
+			a.r * b.i + a.i * b.r + a.j * b.k - a.k * b.j,
+			a.r * b.j + a.j * b.r + a.k * b.i - a.i * b.k,
+			a.r * b.k + a.k * b.r + a.i * b.j - a.j * b.i,
+			a.r * b.r - a.i * b.i - a.j * b.j - a.k * b.k );
+		const ae::Quaternion ab = a * b;
+		REQUIRE( IsCloseEnough( ab.i, expected.i, 1e-5f ) );
+		REQUIRE( IsCloseEnough( ab.j, expected.j, 1e-5f ) );
+		REQUIRE( IsCloseEnough( ab.k, expected.k, 1e-5f ) );
+		REQUIRE( IsCloseEnough( ab.r, expected.r, 1e-5f ) );
+
+		const float length = std::sqrt( a.r * a.r + a.i * a.i + a.j * a.j + a.k * a.k );
+		const ae::Quaternion normalized = a.NormalizeCopy();
+		REQUIRE( IsCloseEnough( normalized.i, a.i / length, 1e-6f ) );
+		REQUIRE( IsCloseEnough( normalized.j, a.j / length, 1e-6f ) );
+		REQUIRE( IsCloseEnough( normalized.k, a.k / length, 1e-6f ) );
+		REQUIRE( IsCloseEnough( normalized.r, a.r / length, 1e-6f ) );
+	}
+	// Rotations compose like matrices
+	const ae::Quaternion qa( ae::Vec3( 0.0f, 0.0f, 1.0f ), 0.7f );
+	const ae::Quaternion qb( ae::Vec3( 1.0f, 0.0f, 0.0f ), -1.1f );
+	const ae::Vec3 p( 1.0f, 2.0f, 3.0f );
+	REQUIRE( IsCloseEnough( ( qa * qb ).Rotate( p ), ( ae::Matrix4::Rotation( qa ) * ae::Matrix4::Rotation( qb ) ).TransformPoint3x4( p ) ) );
+	// Zero quaternions normalize to identity
+	ae::Quaternion zero( 0.0f, 0.0f, 0.0f, 0.0f );
+	zero.Normalize();
+	REQUIRE( zero == ae::Quaternion::Identity() );
+}
+
 //------------------------------------------------------------------------------
 // ae::Color tests
 //------------------------------------------------------------------------------
@@ -0,0 +1,264 @@
+//------------------------------------------------------------------------------
+// MeshOptimizationTest.cpp
+//------------------------------------------------------------------------------
+// Copyright (c) 2026 John Hughes
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files( the "Software" ), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and /or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions :
+//
+// The above copyright notice and this permission notice shall be included in all
+// copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+// SOFTWARE.
+//------------------------------------------------------------------------------
+// Headers
+//------------------------------------------------------------------------------
+#include <catch2/catch_test_macros.hpp>
+#include "aether.h"
+#include <algorithm>
+#include <array>
+#include <vector>
+
+//------------------------------------------------------------------------------
+// Mesh optimization test helpers
+//------------------------------------------------------------------------------
+namespace
+{
+const ae::Tag TAG_MESH_OPTIMIZATION_TEST = "mesh_optimization_test";
+
+//! Flat grid of size x size quads with shuffled triangles
+void BuildShuffledGrid( uint32_t size, ae::Array< ae::Vec3 >* positionsOut, ae::Array< uint32_t >* indicesOut )
+{
+	for( uint32_t y = 0; y <= size; y++ )
+	{
+		for( uint32_t x = 0; x <= size; x++ )
+		{
+			positionsOut->Append( ae::Vec3( (float)x, (float)y, 0.0f ) );
+		}
+	}
+	std::vector< std::array< uint32_t, 3 > > tris;
+	for( uint32_t y = 0; y < size; y++ )
+	{
+		for( uint32_t x = 0; x < size; x++ )
+		{
+			const uint32_t i = y * ( size + 1 ) + x;
+			tris.push_back( { i, i + 1, i + size + 2 } );
+			tris.push_back( { i, i + size + 2, i + size + 1 } );
+		}
+	}
+	uint64_t seed = 7;
+	for( uint32_t i = (uint32_t)tris.size() - 1; i > 0; i-- )
+	{
+		std::swap( tris[ i ], tris[ ae::Random( 0, (int32_t)i + 1, &seed ) ] );
+	}
+	for( const auto& tri : tris )
+	{
+		indicesOut->AppendArray( tri.data(), 3 );
+	}
+}
+
+//! Returns each triangle as positions, rotated so the smallest index is first
+//! to preserve winding, and sorted
+std::vector< std::array< float, 9 > > GetTriangles( const ae::Vec3* positions, const uint32_t* indices, uint32_t indexCount )
+{
+	std::vector< std::array< float, 9 > > result;
+	for( uint32_t i = 0; i < indexCount; i += 3 )
+	{
+		std::array< std::array< float, 3 >, 3 > tri;
+		for( uint32_t j = 0; j < 3; j++ )
+		{
+			const ae::Vec3 p = positions[ indices[ i + j ] ];
+			tri[ j ] = { p.x, p.y, p.z };
+		}
+		std::rotate( tri.begin(), std::min_element( tri.begin(), tri.end() ), tri.end() );
+		result.push_back( { tri[ 0 ][ 0 ], tri[ 0 ][ 1 ], tri[ 0 ][ 2 ], tri[ 1 ][ 0 ], tri[ 1 ][ 1 ], tri[ 1 ][ 2 ], tri[ 2 ][ 0 ], tri[ 2 ][ 1 ], tri[ 2 ][ 2 ] } );
+	}
+	std::sort( result.begin(), result.end() );
+	return result;
+}
+
+ae::IsosurfaceValue SampleSphere( const void*, ae::Vec3 p )
+{
+	return { p.Length() - 12.0f, 0.0f };
+}
+}
+
+//------------------------------------------------------------------------------
+// ae::WeldVertices tests
+//------------------------------------------------------------------------------
+TEST_CASE( "WeldVertices merges nearby vertices", "[ae::WeldVertices]" )
+{
+	// One vertex per triangle corner, with some noise
+	ae::Array< ae::Vec3 > gridPositions = TAG_MESH_OPTIMIZATION_TEST;
+	ae::Array< uint32_t > gridIndices = TAG_MESH_OPTIMIZATION_TEST;
+	BuildShuffledGrid( 8, &gridPositions, &gridIndices );
+	ae::Array< ae::Vec3 > positions = TAG_MESH_OPTIMIZATION_TEST;
+	ae::Array< uint32_t > indices = TAG_MESH_OPTIMIZATION_TEST;
+	uint64_t seed = 3;
+	for( uint32_t index : gridIndices )
+	{
+		indices.Append( positions.Length() );
+		positions.Append( gridPositions[ index ] + ae::Vec3( ae::Random( -0.001f, 0.001f, &seed ), ae::Random( -0.001f, 0.001f, &seed ), 0.0f ) );
+	}
+	ae::Array< uint32_t > remap( TAG_MESH_OPTIMIZATION_TEST, 0, positions.Length() );
+	const uint32_t uniqueCount = ae::WeldVertices( positions[ 0 ].data, sizeof( ae::Vec3 ), positions.Length(), 0.01f, remap.Data() );
+	REQUIRE( uniqueCount == gridPositions.Length() );
+	ae::RemapVertices( positions.Data(), sizeof( ae::Vec3 ), positions.Length(), remap.Data(), positions.Data() );
+	ae::RemapIndices( indices.Data(), indices.Length(), sizeof( uint32_t ), remap.Data() );
+	positions.Remove( uniqueCount, positions.Length() - uniqueCount );
+	for( uint32_t i = 0; i < indices.Length(); i++ )
+	{
+		REQUIRE( ( positions[ indices[ i ] ] - gridPositions[ gridIndices[ i ] ] ).Length() < 0.003f );
+	}
+
+	// A tolerance smaller than the noise doesn't weld anything
+	REQUIRE( ae::WeldVertices( gridPositions[ 0 ].data, sizeof( ae::Vec3 ), gridPositions.Length(), 0.0f, remap.Data() ) == gridPositions.Length() );
+	ae::Array< ae::Vec3 > noisy = TAG_MESH_OPTIMIZATION_TEST;
+	for( uint32_t i = 0; i < 64; i++ )
+	{
+		noisy.Append( ae::Vec3( 1.0f + i * 0.002f, 2.0f, 3.0f ) );
+	}
+	REQUIRE( ae::WeldVertices( noisy[ 0 ].data, sizeof( ae::Vec3 ), noisy.Length(), 0.001f, remap.Data() ) == noisy.Length() );
+	REQUIRE( ae::WeldVertices( noisy[ 0 ].data, sizeof( ae::Vec3 ), noisy.Length(), 1.0f, remap.Data() ) == 1 );
+}
+
+TEST_CASE( "WeldVertices compares attributes", "[ae::WeldVertices]" )
+{
+	struct Vertex
+	{
+		ae::Vec3 position;
+		ae::Vec3 normal;
+	};
+	const Vertex vertices[] =
+	{
+		{ ae::Vec3( 0.0f ), ae::Vec3( 0.0f, 0.0f, 1.0f ) },
+		{ ae::Vec3( 0.0f ), ae::Vec3( 0.0f, 1.0f, 0.0f ) }, // Hard edge
+		{ ae::Vec3( 0.0f ), ae::Vec3( 0.0f, 0.0f, 1.0f ) },
+		{ ae::Vec3( 1.0f ), ae::Vec3( 0.0f, 1.0f, 0.0f ) },
+		{ ae::Vec3( 0.0f ), ae::Vec3( 0.0f, 1.0f, 0.0f ) },
+	};
+	uint32_t remap[ countof( vertices ) ];
+	REQUIRE( ae::WeldVertices( vertices[ 0 ].position.data, sizeof( Vertex ), countof( vertices ), 0.0f, remap, vertices[ 0 ].normal.data, sizeof( Vertex ), 3 ) == 3 );
+	const uint32_t expected[] = { 0, 1, 0, 2, 1 };
+	for( uint32_t i = 0; i < countof( vertices ); i++ )
+	{
+		REQUIRE( remap[ i ] == expected[ i ] );
+	}
+	REQUIRE( ae::WeldVertices( vertices[ 0 ].position.data, sizeof( Vertex ), countof( vertices ), 0.0f, remap ) == 2 );
+}
+
+//------------------------------------------------------------------------------
+// ae::OptimizeVertexCache tests
+//------------------------------------------------------------------------------
+TEST_CASE( "OptimizeVertexCache reduces cache misses", "[ae::OptimizeVertexCache]" )
+{
+	ae::Array< ae::Vec3 > positions = TAG_MESH_OPTIMIZATION_TEST;
+	ae::Array< uint32_t > indices = TAG_MESH_OPTIMIZATION_TEST;
+	BuildShuffledGrid( 64, &positions, &indices );
+	const auto triangles = GetTriangles( positions.Data(), indices.Data(), indices.Length() );
+	const float before = ae::GetVertexCacheMissRatio( indices.Data(), indices.Length(), sizeof( uint32_t ), positions.Length() );
+	REQUIRE( before > 2.0f );
+
+	ae::OptimizeVertexCache( indices.Data(), indices.Length(), sizeof( uint32_t ), positions.Length() );
+	const float after = ae::GetVertexCacheMissRatio( indices.Data(), indices.Length(), sizeof( uint32_t ), positions.Length() );
+	REQUIRE( after < 0.8f );
+	REQUIRE( GetTriangles( positions.Data(), indices.Data(), indices.Length() ) == triangles );
+
+	// 16 bit indices
+	ae::Array< uint16_t > indices16 = TAG_MESH_OPTIMIZATION_TEST;
+	for( uint32_t index : indices )
+	{
+		indices16.Append( (uint16_t)index );
+	}
+	ae::OptimizeVertexCache( indices16.Data(), indices16.Length(), sizeof( uint16_t ), positions.Length() );
+	REQUIRE( ae::GetVertexCacheMissRatio( indices16.Data(), indices16.Length(), sizeof( uint16_t ), positions.Length() ) < 0.8f );
+	ae::OptimizeVertexCache( indices16.Data(), 0, sizeof( uint16_t ), positions.Length() );
+}
+
+TEST_CASE( "OptimizeOverdraw keeps triangles and cache efficiency", "[ae::OptimizeOverdraw]" )
+{
+	ae::IsosurfaceParams params;
+	params.sampleFn = &SampleSphere;
+	params.aabb = ae::AABB( ae::Vec3( -16.0f ), ae::Vec3( 16.0f ) );
+	ae::IsosurfaceExtractor extractor = TAG_MESH_OPTIMIZATION_TEST;
+	REQUIRE( extractor.Generate( params ) );
+	ae::Array< ae::Vec3 > positions = TAG_MESH_OPTIMIZATION_TEST;
+	for( const ae::IsosurfaceVertex& vertex : extractor.vertices )
+	{
+		positions.Append( vertex.position.GetXYZ() );
+	}
+	ae::Array< uint32_t > indices = TAG_MESH_OPTIMIZATION_TEST;
+	indices.AppendArray( extractor.indices.Data(), extractor.indices.Length() );
+	const auto triangles = GetTriangles( positions.Data(), indices.Data(), indices.Length() );
+
+	ae::OptimizeVertexCache( indices.Data(), indices.Length(), sizeof( uint32_t ), positions.Length() );
+	const float cacheOptimized = ae::GetVertexCacheMissRatio( indices.Data(), indices.Length(), sizeof( uint32_t ), positions.Length() );
+	ae::OptimizeOverdraw( indices.Data(), indices.Length(), sizeof( uint32_t ), positions[ 0 ].data, sizeof( ae::Vec3 ), positions.Length() );
+	const float overdrawOptimized = ae::GetVertexCacheMissRatio( indices.Data(), indices.Length(), sizeof( uint32_t ), positions.Length() );
+	REQUIRE( overdrawOptimized < cacheOptimized * 1.05f );
+	REQUIRE( GetTriangles( positions.Data(), indices.Data(), indices.Length() ) == triangles );
+}
+
+//------------------------------------------------------------------------------
+// ae::GetVertexFetchRemap tests
+//------------------------------------------------------------------------------
+TEST_CASE( "GetVertexFetchRemap orders vertices by first use", "[ae::GetVertexFetchRemap]" )
+{
+	ae::Array< ae::Vec3 > positions = TAG_MESH_OPTIMIZATION_TEST;
+	ae::Array< uint32_t > indices = TAG_MESH_OPTIMIZATION_TEST;
+	BuildShuffledGrid( 16, &positions, &indices );
+	positions.Append( ae::Vec3( -1.0f ) ); // Unused
+	const auto triangles = GetTriangles( positions.Data(), indices.Data(), indices.Length() );
+
+	ae::Array< uint32_t > remap( TAG_MESH_OPTIMIZATION_TEST, 0, positions.Length() );
+	const uint32_t usedCount = ae::GetVertexFetchRemap( indices.Data(), indices.Length(), sizeof( uint32_t ), positions.Length(), remap.Data() );
+	REQUIRE( usedCount == positions.Length() - 1 );
+	REQUIRE( remap[ positions.Length() - 1 ] == ~0u );
+	ae::RemapVertices( positions.Data(), sizeof( ae::Vec3 ), positions.Length(), remap.Data(), positions.Data() );
+	ae::RemapIndices( indices.Data(), indices.Length(), sizeof( uint32_t ), remap.Data() );
+	positions.Remove( usedCount, positions.Length() - usedCount );
+	REQUIRE( GetTriangles( positions.Data(), indices.Data(), indices.Length() ) == triangles );
+	uint32_t next = 0;
+	for( uint32_t index : indices )
+	{
+		REQUIRE( index <= next );
+		next = ae::Max( next, index + 1 );
+	}
+}
+
+TEST_CASE( "OBJLoader optimize", "[ae::OptimizeVertexCache]" )
+{
+	const char* obj =
+		"v 0 0 0\n"
+		"v 1 0 0\n"
+		"v 1 1 0\n"
+		"v 0 1 0\n"
+		"v 5 5 5\n"
+		"f 1 2 3\n"
+		"f 1 3 4\n";
+	ae::OBJLoader::InitializeParams params;
+	params.data = (const uint8_t*)obj;
+	params.length = (uint32_t)strlen( obj );
+	params.optimize = true;
+	ae::OBJLoader loader = TAG_MESH_OPTIMIZATION_TEST;
+	REQUIRE( loader.Load( params ) );
+	REQUIRE( loader.vertices.Length() == 4 );
+	REQUIRE( loader.indices.Length() == 6 );
+	for( uint32_t i = 0; i < loader.indices.Length(); i += 3 )
+	{
+		const ae::Vec3 p0 = loader.vertices[ loader.indices[ i ] ].position.GetXYZ();
+		const ae::Vec3 p1 = loader.vertices[ loader.indices[ i + 1 ] ].position.GetXYZ();
+		const ae::Vec3 p2 = loader.vertices[ loader.indices[ i + 2 ] ].position.GetXYZ();
+		REQUIRE( ( p1 - p0 ).Cross( p2 - p0 ).z == 1.0f );
+	}
+}
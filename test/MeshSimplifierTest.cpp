@@ -0,0 +1,256 @@
+//------------------------------------------------------------------------------
+// MeshSimplifierTest.cpp
+//------------------------------------------------------------------------------
+// Copyright (c) 2026 John Hughes
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files( the "Software" ), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and /or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions :
+//
+// The above copyright notice and this permission notice shall be included in all
+// copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+// SOFTWARE.
+//------------------------------------------------------------------------------
+// Headers
+//------------------------------------------------------------------------------
+#include <catch2/catch_test_macros.hpp>
+#include "aether.h"
+
+//------------------------------------------------------------------------------
+// MeshSimplifier test helpers
+//------------------------------------------------------------------------------
+namespace
+{
+const ae::Tag TAG_MESH_SIMPLIFIER_TEST = "mesh_simplifier_test";
+
+//! Flat open grid of size x size quads on the xy plane
+void BuildGrid( uint32_t size, ae::Array< ae::Vec3 >* positionsOut, ae::Array< uint32_t >* indicesOut )
+{
+	for( uint32_t y = 0; y <= size; y++ )
+	{
+		for( uint32_t x = 0; x <= size; x++ )
+		{
+			positionsOut->Append( ae::Vec3( (float)x, (float)y, 0.0f ) );
+		}
+	}
+	for( uint32_t y = 0; y < size; y++ )
+	{
+		for( uint32_t x = 0; x < size; x++ )
+		{
+			const uint32_t i = y * ( size + 1 ) + x;
+			const uint32_t quad[] = { i, i + 1, i + size + 2, i, i + size + 2, i + size + 1 };
+			indicesOut->AppendArray( quad, countof( quad ) );
+		}
+	}
+}
+
+ae::IsosurfaceValue SampleSphere( const void*, ae::Vec3 p )
+{
+	return { ( p - ae::Vec3( 0.5f, -1.0f, 0.25f ) ).Length() - 20.0f, 0.0f };
+}
+
+void GenerateSphere( ae::IsosurfaceExtractor* extractor )
+{
+	ae::IsosurfaceParams params;
+	params.sampleFn = &SampleSphere;
+	params.aabb = ae::AABB( ae::Vec3( -24.0f ), ae::Vec3( 24.0f ) );
+	REQUIRE( extractor->Generate( params ) );
+	REQUIRE( extractor->indices.Length() / 3 > 5000 );
+}
+
+ae::MeshSimplifier::Params GetSphereParams( const ae::IsosurfaceExtractor& extractor )
+{
+	ae::MeshSimplifier::Params params;
+	params.vertexPositions = extractor.vertices[ 0 ].position.data;
+	params.vertexPositionStride = sizeof( ae::IsosurfaceVertex );
+	params.vertexAttributes = extractor.vertices[ 0 ].normal.data;
+	params.vertexAttributeStride = sizeof( ae::IsosurfaceVertex );
+	params.vertexAttributeCount = 3;
+	params.vertexCount = extractor.vertices.Length();
+	params.indices = extractor.indices.Data();
+	params.indexCount = extractor.indices.Length();
+	params.indexSize = sizeof( ae::IsosurfaceIndex );
+	return params;
+}
+
+//! Returns the number of edges that aren't shared by exactly two triangles
+//! with opposite winding
+uint32_t GetOpenEdgeCount( const ae::Array< uint32_t >& indices )
+{
+	ae::Map< uint64_t, int32_t > edges = TAG_MESH_SIMPLIFIER_TEST;
+	for( uint32_t i = 0; i < indices.Length(); i += 3 )
+	{
+		for( uint32_t j = 0; j < 3; j++ )
+		{
+			const uint32_t a = indices[ i + j ];
+			const uint32_t b = indices[ i + ( j + 1 ) % 3 ];
+			const uint64_t key = ( (uint64_t)ae::Min( a, b ) << 32 ) | ae::Max( a, b );
+			edges.Set( key, edges.Get( key, 0 ) + ( a < b ? 1 : -1 ) );
+		}
+	}
+	uint32_t openEdges = 0;
+	for( uint32_t i = 0; i < edges.Length(); i++ )
+	{
+		openEdges += ( edges.GetValue( i ) != 0 );
+	}
+	return openEdges;
+}
+}
+
+//------------------------------------------------------------------------------
+// ae::MeshSimplifier tests
+//------------------------------------------------------------------------------
+TEST_CASE( "MeshSimplifier reaches target and preserves boundaries", "[ae::MeshSimplifier]" )
+{
+	const uint32_t size = 32;
+	ae::Array< ae::Vec3 > positions = TAG_MESH_SIMPLIFIER_TEST;
+	ae::Array< uint32_t > indices = TAG_MESH_SIMPLIFIER_TEST;
+	BuildGrid( size, &positions, &indices );
+
+	ae::MeshSimplifier::Params params;
+	params.vertexPositions = positions[ 0 ].data;
+	params.vertexPositionStride = sizeof( ae::Vec3 );
+	params.vertexCount = positions.Length();
+	params.indices = indices.Data();
+	params.indexCount = indices.Length();
+	params.indexSize = sizeof( uint32_t );
+	params.targetTriangleCount = 100;
+	ae::MeshSimplifier simplifier = TAG_MESH_SIMPLIFIER_TEST;
+	REQUIRE( simplifier.Simplify( params ) );
+	REQUIRE( simplifier.indices.Length() / 3 <= params.targetTriangleCount );
+	REQUIRE( simplifier.indices.Length() / 3 > 0 );
+	REQUIRE( simplifier.GetError() < 0.001f );
+	REQUIRE( simplifier.attributes.Length() == 0 );
+
+	float area = 0.0f;
+	uint32_t corners = 0;
+	for( ae::Vec3 p : simplifier.positions )
+	{
+		REQUIRE( p.z == 0.0f );
+		corners += ( ( p.x == 0.0f || p.x == size ) && ( p.y == 0.0f || p.y == size ) );
+	}
+	REQUIRE( corners == 4 );
+	for( uint32_t i = 0; i < simplifier.indices.Length(); i += 3 )
+	{
+		const ae::Vec3 p0 = simplifier.positions[ simplifier.indices[ i ] ];
+		const ae::Vec3 p1 = simplifier.positions[ simplifier.indices[ i + 1 ] ];
+		const ae::Vec3 p2 = simplifier.positions[ simplifier.indices[ i + 2 ] ];
+		const ae::Vec3 normal = ( p1 - p0 ).Cross( p2 - p0 );
+		REQUIRE( normal.z > 0.0f ); // Nothing flipped
+		area += normal.z * 0.5f;
+	}
+	REQUIRE( std::abs( area - size * size ) < 0.01f );
+
+	// Open edges only run along the outline of the grid
+	const uint32_t openEdgeCount = GetOpenEdgeCount( simplifier.indices );
+	REQUIRE( openEdgeCount >= 4 );
+	uint32_t outlineEdgeCount = 0;
+	for( uint32_t i = 0; i < simplifier.indices.Length(); i++ )
+	{
+		const ae::Vec3 p0 = simplifier.positions[ simplifier.indices[ i ] ];
+		const ae::Vec3 p1 = simplifier.positions[ simplifier.indices[ i - i % 3 + ( i + 1 ) % 3 ] ];
+		outlineEdgeCount += ( ( p0.x == 0.0f && p1.x == 0.0f ) || ( p0.y == 0.0f && p1.y == 0.0f ) || ( p0.x == size && p1.x == size ) || ( p0.y == size && p1.y == size ) );
+	}
+	REQUIRE( outlineEdgeCount == openEdgeCount );
+
+	params.indexCount = 0;
+	REQUIRE( simplifier.Simplify( params ) );
+	REQUIRE( simplifier.positions.Length() == 0 );
+	REQUIRE( simplifier.indices.Length() == 0 );
+}
+
+TEST_CASE( "MeshSimplifier respects max error", "[ae::MeshSimplifier]" )
+{
+	ae::IsosurfaceExtractor extractor = TAG_MESH_SIMPLIFIER_TEST;
+	GenerateSphere( &extractor );
+	ae::MeshSimplifier::Params params = GetSphereParams( extractor );
+	params.maxError = 0.05f;
+	ae::MeshSimplifier simplifier = TAG_MESH_SIMPLIFIER_TEST;
+	REQUIRE( simplifier.Simplify( params ) );
+	REQUIRE( simplifier.GetError() <= params.maxError );
+	REQUIRE( simplifier.indices.Length() < extractor.indices.Length() / 2 );
+	REQUIRE( GetOpenEdgeCount( simplifier.indices ) == 0 );
+	REQUIRE( simplifier.attributes.Length() == simplifier.positions.Length() * 3 );
+	for( uint32_t i = 0; i < simplifier.positions.Length(); i++ )
+	{
+		const ae::Vec3 p = simplifier.positions[ i ];
+		const ae::Vec3 normal( simplifier.attributes[ i * 3 ], simplifier.attributes[ i * 3 + 1 ], simplifier.attributes[ i * 3 + 2 ] );
+		REQUIRE( std::abs( SampleSphere( nullptr, p ).distance ) < 0.25f );
+		REQUIRE( normal.Length() > 0.9f );
+	}
+
+	// A tighter bound keeps more triangles
+	const uint32_t triangleCount = simplifier.indices.Length() / 3;
+	params.maxError = 0.005f;
+	REQUIRE( simplifier.Simplify( params ) );
+	REQUIRE( simplifier.indices.Length() / 3 > triangleCount );
+}
+
+TEST_CASE( "MeshSimplifier multithreaded simplification is closed", "[ae::MeshSimplifier]" )
+{
+	ae::IsosurfaceExtractor extractor = TAG_MESH_SIMPLIFIER_TEST;
+	GenerateSphere( &extractor );
+	ae::MeshSimplifier::Params params = GetSphereParams( extractor );
+	params.targetTriangleCount = extractor.indices.Length() / 3 / 10;
+	for( uint32_t threadCount : { 1u, 4u } )
+	{
+		INFO( "threadCount: " << threadCount );
+		params.threadCount = threadCount;
+		ae::MeshSimplifier simplifier = TAG_MESH_SIMPLIFIER_TEST;
+		REQUIRE( simplifier.Simplify( params ) );
+		REQUIRE( simplifier.indices.Length() / 3 <= params.targetTriangleCount );
+		REQUIRE( simplifier.indices.Length() / 3 > params.targetTriangleCount - 4 );
+		REQUIRE( GetOpenEdgeCount( simplifier.indices ) == 0 );
+		REQUIRE( simplifier.GetError() < 0.5f );
+		for( ae::Vec3 p : simplifier.positions )
+		{
+			REQUIRE( std::abs( SampleSphere( nullptr, p ).distance ) < 1.0f );
+		}
+	}
+}
+
+TEST_CASE( "MeshSimplifier InitializeCollisionMesh", "[ae::MeshSimplifier]" )
+{
+	ae::Array< ae::Vec3 > positions = TAG_MESH_SIMPLIFIER_TEST;
+	ae::Array< uint32_t > indices = TAG_MESH_SIMPLIFIER_TEST;
+	BuildGrid( 16, &positions, &indices );
+	ae::Array< uint16_t > indices16 = TAG_MESH_SIMPLIFIER_TEST;
+	for( uint32_t index : indices )
+	{
+		indices16.Append( (uint16_t)index );
+	}
+
+	ae::MeshSimplifier::Params params;
+	params.vertexPositions = positions[ 0 ].data;
+	params.vertexPositionStride = sizeof( ae::Vec3 );
+	params.vertexCount = positions.Length();
+	params.indices = indices16.Data();
+	params.indexCount = indices16.Length();
+	params.indexSize = sizeof( uint16_t );
+	params.targetTriangleCount = 8;
+	ae::MeshSimplifier simplifier = TAG_MESH_SIMPLIFIER_TEST;
+	REQUIRE( simplifier.Simplify( params ) );
+
+	ae::CollisionMesh<> mesh = TAG_MESH_SIMPLIFIER_TEST;
+	simplifier.InitializeCollisionMesh( &mesh );
+	uint64_t seed = 1;
+	for( uint32_t i = 0; i < 32; i++ )
+	{
+		ae::RaycastParams raycastParams;
+		raycastParams.source = ae::Vec3( ae::Random( 0.1f, 15.9f, &seed ), ae::Random( 0.1f, 15.9f, &seed ), 5.0f );
+		raycastParams.ray = ae::Vec3( 0.0f, 0.0f, -10.0f );
+		const ae::RaycastResult result = mesh.Raycast( raycastParams );
+		REQUIRE( result.hits.Length() == 1 );
+		REQUIRE( std::abs( result.hits[ 0 ].position.z ) < 0.001f );
+	}
+}
@@ -0,0 +1,201 @@
+//------------------------------------------------------------------------------
+// NoiseTest.cpp
+//------------------------------------------------------------------------------
+// Copyright (c) 2026 John Hughes
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files( the "Software" ), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and /or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions :
+//
+// The above copyright notice and this permission notice shall be included in all
+// copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+// SOFTWARE.
+//------------------------------------------------------------------------------
+// Headers
+//------------------------------------------------------------------------------
+#include <catch2/catch_test_macros.hpp>
+#include "aether.h"
+
+//------------------------------------------------------------------------------
+// Noise test helpers
+//------------------------------------------------------------------------------
+namespace
+{
+const ae::Tag TAG_NOISE_TEST = "noise_test";
+
+bool Approx( float a, float b, float epsilon = 0.00001f ) { return std::abs( a - b ) < epsilon; }
+
+ae::Vec4 GetRandomPosition( float range, uint64_t* seed )
+{
+	return ae::Vec4( ae::Random( -range, range, seed ), ae::Random( -range, range, seed ), ae::Random( -range, range, seed ), ae::Random( -range, range, seed ) );
+}
+
+//! Calls \p fn( name, noiseFn ) with each noise function and dimension
+template< typename Fn >
+void ForEachNoise( Fn fn )
+{
+	fn( "Gradient2", []( ae::Vec4 p, uint32_t s ) { return ae::GradientNoise( p.GetXY(), s ); } );
+	fn( "Gradient3", []( ae::Vec4 p, uint32_t s ) { return ae::GradientNoise( p.GetXYZ(), s ); } );
+	fn( "Gradient4", []( ae::Vec4 p, uint32_t s ) { return ae::GradientNoise( p, s ); } );
+	fn( "Simplex2", []( ae::Vec4 p, uint32_t s ) { return ae::SimplexNoise( p.GetXY(), s ); } );
+	fn( "Simplex3", []( ae::Vec4 p, uint32_t s ) { return ae::SimplexNoise( p.GetXYZ(), s ); } );
+	fn( "Simplex4", []( ae::Vec4 p, uint32_t s ) { return ae::SimplexNoise( p, s ); } );
+}
+}
+
+//------------------------------------------------------------------------------
+// ae::GradientNoise and ae::SimplexNoise tests
+//------------------------------------------------------------------------------
+TEST_CASE( "Noise matches reference values", "[noise]" )
+{
+	// These values must not change between platforms or versions
+	REQUIRE( Approx( ae::GradientNoise( ae::Vec2( 0.3f, 1.7f ) ), -0.25993377f ) );
+	REQUIRE( Approx( ae::GradientNoise( ae::Vec3( 0.3f, 1.7f, -2.2f ) ), -0.0587885715f ) );
+	REQUIRE( Approx( ae::GradientNoise( ae::Vec4( 0.3f, 1.7f, -2.2f, 5.5f ), 7 ), 0.350069612f ) );
+	REQUIRE( Approx( ae::SimplexNoise( ae::Vec2( 0.3f, 1.7f ) ), 0.531653345f ) );
+	REQUIRE( Approx( ae::SimplexNoise( ae::Vec3( 0.3f, 1.7f, -2.2f ) ), 0.0588284507f ) );
+	REQUIRE( Approx( ae::SimplexNoise( ae::Vec4( 0.3f, 1.7f, -2.2f, 5.5f ), 7 ), 0.325190455f ) );
+}
+
+TEST_CASE( "Noise stays in range and is continuous", "[noise]" )
+{
+	ForEachNoise( []( const char* name, auto noiseFn )
+	{
+		INFO( name );
+		uint64_t seed = 1;
+		float maxValue = 0.0f;
+		float maxStep = 0.0f;
+		for( uint32_t i = 0; i < 20000; i++ )
+		{
+			const ae::Vec4 p = GetRandomPosition( 100.0f, &seed );
+			const float value = noiseFn( p, 3 );
+			maxValue = ae::Max( maxValue, std::abs( value ) );
+			maxStep = ae::Max( maxStep, std::abs( noiseFn( p + ae::Vec4( 0.001f ), 3 ) - value ) );
+		}
+		REQUIRE( maxValue <= 1.0f );
+		REQUIRE( maxValue > 0.5f );
+		REQUIRE( maxStep < 0.05f );
+	} );
+}
+
+TEST_CASE( "Noise depends on seed", "[noise]" )
+{
+	ForEachNoise( []( const char* name, auto noiseFn )
+	{
+		INFO( name );
+		uint64_t seed = 2;
+		uint32_t differentCount = 0;
+		for( uint32_t i = 0; i < 100; i++ )
+		{
+			const ae::Vec4 p = GetRandomPosition( 10.0f, &seed );
+			REQUIRE( noiseFn( p, 5 ) == noiseFn( p, 5 ) );
+			differentCount += ( noiseFn( p, 5 ) != noiseFn( p, 6 ) );
+		}
+		REQUIRE( differentCount > 90 );
+	} );
+}
+
+TEST_CASE( "Gradient noise is zero at integer coordinates", "[noise]" )
+{
+	for( int32_t i = -3; i <= 3; i++ )
+	{
+		REQUIRE( ae::GradientNoise( ae::Vec2( (float)i, (float)( i * 7 ) ) ) == 0.0f );
+		REQUIRE( ae::GradientNoise( ae::Vec3( (float)i, (float)( i * 7 ), -5.0f ), 9 ) == 0.0f );
+		REQUIRE( ae::GradientNoise( ae::Vec4( (float)i, (float)( i * 7 ), -5.0f, 100.0f ), 9 ) == 0.0f );
+	}
+}
+
+TEST_CASE( "Batched noise matches single position noise", "[noise]" )
+{
+	const uint32_t count = 23; // Not a multiple of four
+	ae::Array< ae::Vec2 > p2 = TAG_NOISE_TEST;
+	ae::Array< ae::Vec3 > p3 = TAG_NOISE_TEST;
+	ae::Array< ae::Vec4 > p4 = TAG_NOISE_TEST;
+	uint64_t seed = 4;
+	for( uint32_t i = 0; i < count; i++ )
+	{
+		const ae::Vec4 p = GetRandomPosition( 50.0f, &seed );
+		p2.Append( p.GetXY() );
+		p3.Append( p.GetXYZ() );
+		p4.Append( p );
+	}
+	ae::FractalNoiseParams params;
+	params.frequency = 0.1f;
+	params.octaves = 5;
+	params.seed = 11;
+	float out[ 6 ][ count ];
+	ae::GradientNoise( p2.Data(), out[ 0 ], count, 11 );
+	ae::GradientNoise( p3.Data(), out[ 1 ], count, 11 );
+	ae::GradientNoise( p4.Data(), out[ 2 ], count, 11 );
+	ae::SimplexNoise( p2.Data(), out[ 3 ], count, 11 );
+	ae::SimplexNoise( p3.Data(), out[ 4 ], count, 11 );
+	ae::SimplexNoise( p4.Data(), out[ 5 ], count, 11 );
+	for( uint32_t i = 0; i < count; i++ )
+	{
+		REQUIRE( out[ 0 ][ i ] == ae::GradientNoise( p2[ i ], 11 ) );
+		REQUIRE( out[ 1 ][ i ] == ae::GradientNoise( p3[ i ], 11 ) );
+		REQUIRE( out[ 2 ][ i ] == ae::GradientNoise( p4[ i ], 11 ) );
+		REQUIRE( out[ 3 ][ i ] == ae::SimplexNoise( p2[ i ], 11 ) );
+		REQUIRE( out[ 4 ][ i ] == ae::SimplexNoise( p3[ i ], 11 ) );
+		REQUIRE( out[ 5 ][ i ] == ae::SimplexNoise( p4[ i ], 11 ) );
+	}
+	for( ae::NoiseType type : { ae::NoiseType::Gradient, ae::NoiseType::Simplex } )
+	{
+		params.type = type;
+		ae::FractalNoise( p2.Data(), out[ 0 ], count, params );
+		ae::FractalNoise( p3.Data(), out[ 1 ], count, params );
+		ae::FractalNoise( p4.Data(), out[ 2 ], count, params );
+		for( uint32_t i = 0; i < count; i++ )
+		{
+			REQUIRE( out[ 0 ][ i ] == ae::FractalNoise( p2[ i ], params ) );
+			REQUIRE( out[ 1 ][ i ] == ae::FractalNoise( p3[ i ], params ) );
+			REQUIRE( out[ 2 ][ i ] == ae::FractalNoise( p4[ i ], params ) );
+		}
+	}
+}
+
+//------------------------------------------------------------------------------
+// ae::FractalNoise tests
+//------------------------------------------------------------------------------
+TEST_CASE( "FractalNoise with one octave matches base noise", "[noise]" )
+{
+	ae::FractalNoiseParams params;
+	params.octaves = 1;
+	params.frequency = 0.5f;
+	params.seed = 3;
+	uint64_t seed = 5;
+	for( uint32_t i = 0; i < 100; i++ )
+	{
+		const ae::Vec3 p = GetRandomPosition( 20.0f, &seed ).GetXYZ();
+		params.type = ae::NoiseType::Gradient;
+		REQUIRE( ae::FractalNoise( p, params ) == ae::GradientNoise( p * 0.5f, 3 ) );
+		params.type = ae::NoiseType::Simplex;
+		REQUIRE( ae::FractalNoise( p, params ) == ae::SimplexNoise( p * 0.5f, 3 ) );
+	}
+}
+
+TEST_CASE( "FractalNoise stays in range", "[noise]" )
+{
+	ae::FractalNoiseParams params;
+	params.octaves = 6;
+	params.gain = 0.6f;
+	uint64_t seed = 6;
+	for( uint32_t i = 0; i < 5000; i++ )
+	{
+		const ae::Vec4 p = GetRandomPosition( 100.0f, &seed );
+		params.type = ae::NoiseType::Gradient;
+		REQUIRE( std::abs( ae::FractalNoise( p, params ) ) <= 1.0f );
+		params.type = ae::NoiseType::Simplex;
+		REQUIRE( std::abs( ae::FractalNoise( p.GetXYZ(), params ) ) <= 1.0f );
+	}
+}
@@ -0,0 +1,235 @@
+//------------------------------------------------------------------------------
+// RandomTest.cpp
+//------------------------------------------------------------------------------
+// Copyright (c) 2026 John Hughes
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files( the "Software" ), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and /or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions :
+//
+// The above copyright notice and this permission notice shall be included in all
+// copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+// SOFTWARE.
+//------------------------------------------------------------------------------
+// Headers
+//------------------------------------------------------------------------------
+#include <catch2/catch_test_macros.hpp>
+#include "aether.h"
+
+//------------------------------------------------------------------------------
+// Random test helpers
+//------------------------------------------------------------------------------
+namespace
+{
+const ae::Tag TAG_RANDOM_TEST = "random_test";
+}
+
+//------------------------------------------------------------------------------
+// ae::RandomGenerator sequence tests
+//------------------------------------------------------------------------------
+TEST_CASE( "RandomGenerator matches xoshiro128** reference", "[ae::RandomGenerator]" )
+{
+	// Four interleaved streams, each 2^64 steps after the previous, from the
+	// reference implementation at https://prng.di.unimi.it/xoshiro128starstar.c
+	const uint32_t expected[] = { 0xb3f2a9c5u, 0x77100e13u, 0xb704f149u, 0xe4f8c5b7u, 0x853b546au, 0x34581516u, 0xbd6feb1du, 0xf585c5b7u };
+	ae::RandomGenerator generator( 1 );
+	for( uint32_t value : expected )
+	{
+		REQUIRE( generator.GetUint32() == value );
+	}
+}
+
+TEST_CASE( "RandomGenerator seeding", "[ae::RandomGenerator]" )
+{
+	ae::RandomGenerator a( 5 );
+	ae::RandomGenerator b( 5 );
+	ae::RandomGenerator c( 6 );
+	uint32_t differentCount = 0;
+	for( uint32_t i = 0; i < 100; i++ )
+	{
+		const uint32_t value = a.GetUint32();
+		REQUIRE( value == b.GetUint32() );
+		differentCount += ( value != c.GetUint32() );
+	}
+	REQUIRE( differentCount == 100 );
+
+	a.Seed( 5 );
+	b.Seed( 5 );
+	b.GetUint32();
+	a.Seed( 5 );
+	b.Seed( 5 );
+	REQUIRE( a.GetUint32() == b.GetUint32() );
+}
+
+TEST_CASE( "RandomGenerator Fill matches Get", "[ae::RandomGenerator]" )
+{
+	// Start part way through a block so all paths of the Fill functions are used
+	const uint32_t count = 37;
+	ae::RandomGenerator a( 9 );
+	ae::RandomGenerator b( 9 );
+	a.GetUint32();
+	b.GetUint32();
+
+	uint32_t uints[ count ];
+	a.FillUint32( uints, count );
+	for( uint32_t i = 0; i < count; i++ )
+	{
+		REQUIRE( uints[ i ] == b.GetUint32() );
+	}
+	float floats[ count ];
+	a.Fill01( floats, count );
+	for( uint32_t i = 0; i < count; i++ )
+	{
+		REQUIRE( floats[ i ] == b.Get01() );
+	}
+	a.Fill( floats, count, -4.0f, 12.5f );
+	for( uint32_t i = 0; i < count; i++ )
+	{
+		REQUIRE( floats[ i ] == b.Get( -4.0f, 12.5f ) );
+	}
+	int32_t ints[ count ];
+	a.Fill( ints, count, -10, 1000 );
+	for( uint32_t i = 0; i < count; i++ )
+	{
+		REQUIRE( ints[ i ] == b.Get( -10, 1000 ) );
+	}
+	ae::Vec3 vecs[ count ];
+	a.FillUnitVec3( vecs, count );
+	for( uint32_t i = 0; i < count; i++ )
+	{
+		REQUIRE( vecs[ i ] == b.GetUnitVec3() );
+	}
+	REQUIRE( a.GetUint32() == b.GetUint32() );
+}
+
+TEST_CASE( "RandomGenerator Jump creates independent streams", "[ae::RandomGenerator]" )
+{
+	ae::RandomGenerator a( 3 );
+	ae::RandomGenerator b = a;
+	b.Jump();
+	ae::RandomGenerator c = b;
+	c.Jump();
+	const uint32_t count = 100000;
+	uint32_t matchCount = 0;
+	for( uint32_t i = 0; i < count; i++ )
+	{
+		const uint32_t va = a.GetUint32();
+		const uint32_t vb = b.GetUint32();
+		const uint32_t vc = c.GetUint32();
+		matchCount += ( va == vb ) + ( vb == vc ) + ( va == vc );
+	}
+	REQUIRE( matchCount < 3 );
+}
+
+//------------------------------------------------------------------------------
+// ae::RandomGenerator statistical tests
+//------------------------------------------------------------------------------
+TEST_CASE( "RandomGenerator floats are uniform", "[ae::RandomGenerator]" )
+{
+	const uint32_t count = 1000000;
+	const uint32_t bucketCount = 256;
+	ae::Array< float > values = TAG_RANDOM_TEST;
+	values.Append( 0.0f, count );
+	ae::RandomGenerator generator( 11 );
+	generator.Fill01( values.Data(), count );
+	uint32_t buckets[ bucketCount ] = {};
+	double sum = 0.0;
+	double serial = 0.0;
+	for( uint32_t i = 0; i < count; i++ )
+	{
+		REQUIRE( values[ i ] >= 0.0f );
+		REQUIRE( values[ i ] < 1.0f );
+		buckets[ (uint32_t)( values[ i ] * bucketCount ) ]++;
+		sum += values[ i ];
+		serial += ( values[ i ] - 0.5 ) * ( values[ ( i + 1 ) % count ] - 0.5 );
+	}
+	// Chi-squared with 255 degrees of freedom, 99.9% critical value is 330.5
+	const double expected = count / (double)bucketCount;
+	double chiSquared = 0.0;
+	for( uint32_t count : buckets )
+	{
+		chiSquared += ( count - expected ) * ( count - expected ) / expected;
+	}
+	REQUIRE( chiSquared < 330.5 );
+	REQUIRE( std::abs( sum / count - 0.5 ) < 0.001 );
+	// Correlation of neighbors, normalized by the variance of 1/12
+	REQUIRE( std::abs( serial / count * 12.0 ) < 0.005 );
+}
+
+TEST_CASE( "RandomGenerator bits are balanced", "[ae::RandomGenerator]" )
+{
+	const uint32_t count = 1000000;
+	ae::Array< uint32_t > values = TAG_RANDOM_TEST;
+	values.Append( 0, count );
+	ae::RandomGenerator generator( 12 );
+	generator.FillUint32( values.Data(), count );
+	for( uint32_t bit = 0; bit < 32; bit++ )
+	{
+		uint32_t setCount = 0;
+		for( uint32_t value : values )
+		{
+			setCount += ( value >> bit ) & 1;
+		}
+		INFO( "bit " << bit );
+		REQUIRE( std::abs( (double)setCount / count - 0.5 ) < 0.002 );
+	}
+}
+
+TEST_CASE( "RandomGenerator integers are uniform and in range", "[ae::RandomGenerator]" )
+{
+	const uint32_t count = 700000;
+	ae::Array< int32_t > values = TAG_RANDOM_TEST;
+	values.Append( 0, count );
+	ae::RandomGenerator generator( 13 );
+	generator.Fill( values.Data(), count, -3, 4 );
+	uint32_t buckets[ 7 ] = {};
+	for( int32_t value : values )
+	{
+		REQUIRE( value >= -3 );
+		REQUIRE( value < 4 );
+		buckets[ value + 3 ]++;
+	}
+	for( uint32_t bucket : buckets )
+	{
+		REQUIRE( std::abs( (double)bucket / count - 1.0 / 7.0 ) < 0.002 );
+	}
+
+	generator.Fill( values.Data(), 10, 5, 5 );
+	for( uint32_t i = 0; i < 10; i++ )
+	{
+		REQUIRE( values[ i ] == 5 );
+	}
+	REQUIRE( generator.Get( ae::MinValue< int32_t >(), ae::MaxValue< int32_t >() ) < ae::MaxValue< int32_t >() );
+}
+
+TEST_CASE( "RandomGenerator unit vectors are uniform on the sphere", "[ae::RandomGenerator]" )
+{
+	const uint32_t count = 200000;
+	ae::Array< ae::Vec3 > values = TAG_RANDOM_TEST;
+	values.Append( ae::Vec3( 0.0f ), count );
+	ae::RandomGenerator generator( 14 );
+	generator.FillUnitVec3( values.Data(), count );
+	ae::Vec3 sum( 0.0f );
+	uint32_t octants[ 8 ] = {};
+	for( const ae::Vec3& v : values )
+	{
+		REQUIRE( std::abs( v.Length() - 1.0f ) < 0.0001f );
+		sum += v;
+		octants[ ( v.x > 0.0f ) | ( ( v.y > 0.0f ) << 1 ) | ( ( v.z > 0.0f ) << 2 ) ]++;
+	}
+	REQUIRE( ( sum / (float)count ).Length() < 0.01f );
+	for( uint32_t octant : octants )
+	{
+		REQUIRE( std::abs( (double)octant / count - 0.125 ) < 0.004 );
+	}
+}
@@ -0,0 +1,746 @@
+//------------------------------------------------------------------------------
+// TerrainTest.cpp
+//------------------------------------------------------------------------------
+// Copyright (c) 2026 John Hughes
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files( the "Software" ), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and /or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions :
+//
+// The above copyright notice and this permission notice shall be included in all
+// copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+//------------------------------------------------------------------------------
+// Headers
+//------------------------------------------------------------------------------
+#include <catch2/catch_test_macros.hpp>
+#include "aether.h"
+#include <filesystem>
+#include "ae/aeTerrain.h"
+
+//------------------------------------------------------------------------------
+// Terrain test helpers
+//------------------------------------------------------------------------------
+namespace
+{
+const ae::Tag TAG_TERRAIN_TEST = "terrain_test";
+
+//! TerrainSdf fills a large noise image on construction, so one is shared by
+//! all tests. Tests that add shapes must remove them before returning.
+ae::TerrainSdf* GetTestSdf()
+{
+	static ae::TerrainSdf* s_sdf = ae::New< ae::TerrainSdf >( TAG_TERRAIN_TEST, nullptr );
+	return s_sdf;
+}
+
+//! Adds a box to the shared sdf that intersects the surface of chunk 0,0,0
+struct TestBox
+{
+	TestBox()
+	{
+		ae::TerrainSdf* sdf = GetTestSdf();
+		box = sdf->CreateSdf< ae::SdfBox >();
+		box->SetTransform( ae::Matrix4::Translation( 8.0f, 8.0f, 8.0f ) * ae::Matrix4::Scaling( 10.0f ) );
+		sdf->UpdatePending();
+	}
+	~TestBox()
+	{
+		ae::TerrainSdf* sdf = GetTestSdf();
+		sdf->DestroySdf( box );
+		sdf->UpdatePending();
+	}
+	ae::SdfBox* box = nullptr;
+};
+
+//! Generates chunk 0,0,0 with a new job and chunk, like Terrain does
+bool GenerateChunk( const ae::TerrainParams& params, ae::Array< ae::TerrainVertex >* verticesOut, ae::Array< ae::TerrainIndex >* indicesOut )
+{
+	ae::TerrainChunk* chunk = ae::New< ae::TerrainChunk >( TAG_TERRAIN_TEST );
+	ae::TerrainJob* job = ae::New< ae::TerrainJob >( TAG_TERRAIN_TEST );
+	chunk->m_pos = ae::Int3( 0 );
+	job->StartNew( params, GetTestSdf(), chunk );
+	const bool result = job->Do();
+	verticesOut->Clear();
+	indicesOut->Clear();
+	if( result && job->GetVertexCount() < ae::kMaxChunkVerts )
+	{
+		verticesOut->AppendArray( job->GetVertices(), (uint32_t)job->GetVertexCount() );
+		indicesOut->AppendArray( job->GetIndices(), job->GetIndexCount() );
+	}
+	job->Finish();
+	ae::Delete( job );
+	ae::Delete( chunk );
+	return result;
+}
+
+//! Returns the paths of all terrain chunk files, relative to FileSystem::Root::Cache
+ae::Array< ae::Str256 > GetChunkCacheFiles( const ae::FileSystem& fs )
+{
+	ae::Array< ae::Str256 > result = TAG_TERRAIN_TEST;
+	ae::Str256 cacheDir;
+	if( fs.GetRootDir( ae::FileSystem::Root::Cache, &cacheDir ) )
+	{
+		std::error_code error;
+		for( const auto& entry : std::filesystem::directory_iterator( std::filesystem::path( cacheDir.c_str() ) / "terrain", error ) )
+		{
+			result.Append( ae::Str256::Format( "terrain/#", entry.path().filename().string().c_str() ) );
+		}
+	}
+	return result;
+}
+
+template< typename T >
+bool IsArrayDataEqual( const ae::Array< T >& a, const ae::Array< T >& b )
+{
+	return a.Length() == b.Length() && memcmp( a.Data(), b.Data(), a.Length() * sizeof(T) ) == 0;
+}
+
+ae::Array< uint8_t > ReadCacheFile( const ae::FileSystem& fs, const char* filePath )
+{
+	ae::Array< uint8_t > result = TAG_TERRAIN_TEST;
+	result.Append( 0, fs.GetSize( ae::FileSystem::Root::Cache, filePath ) );
+	REQUIRE( fs.Read( ae::FileSystem::Root::Cache, filePath, result.Data(), result.Length() ) == result.Length() );
+	return result;
+}
+
+void WriteCacheFile( const ae::FileSystem& fs, const char* filePath, const ae::Array< uint8_t >& data )
+{
+	REQUIRE( fs.Write( ae::FileSystem::Root::Cache, filePath, data.Data(), data.Length(), false ) == data.Length() );
+}
+
+//! Terrain jobs with an empty sdf, each generating a different chunk
+struct TestJobs
+{
+	TestJobs( uint32_t count )
+	{
+		for( uint32_t i = 0; i < count; i++ )
+		{
+			chunks.Append( ae::New< ae::TerrainChunk >( TAG_TERRAIN_TEST ) );
+			chunks[ i ]->m_pos = ae::Int3( i, 0, 0 );
+			jobs.Append( ae::New< ae::TerrainJob >( TAG_TERRAIN_TEST ) );
+		}
+	}
+	~TestJobs()
+	{
+		for( uint32_t i = 0; i < jobs.Length(); i++ )
+		{
+			if( jobs[ i ]->IsPendingFinish() )
+			{
+				jobs[ i ]->Finish();
+			}
+			ae::Delete( jobs[ i ] );
+			ae::Delete( chunks[ i ] );
+		}
+	}
+	ae::TerrainJob* Start( uint32_t index )
+	{
+		jobs[ index ]->StartNew( ae::TerrainParams(), GetTestSdf(), chunks[ index ] );
+		return jobs[ index ];
+	}
+	ae::Array< ae::TerrainChunk* > chunks = TAG_TERRAIN_TEST;
+	ae::Array< ae::TerrainJob* > jobs = TAG_TERRAIN_TEST;
+};
+//! Sets a random transform on 'shape', within a 200 unit cube
+void SetRandomTransform( ae::Sdf* shape, uint64_t* seed )
+{
+	const ae::Vec3 pos( ae::Random( -100.0f, 100.0f, seed ), ae::Random( -100.0f, 100.0f, seed ), ae::Random( -100.0f, 100.0f, seed ) );
+	const ae::Vec3 scale( ae::Random( 1.0f, 20.0f, seed ), ae::Random( 1.0f, 20.0f, seed ), ae::Random( 1.0f, 20.0f, seed ) );
+	shape->SetTransform( ae::Matrix4::Translation( pos ) * ae::Matrix4::Scaling( scale ) );
+}
+
+//! Checks TerrainSdf::GetShapes() against a linear scan of all shapes
+void RequireGetShapesMatchesLinear( const ae::TerrainSdf* sdf, uint64_t* seed )
+{
+	ae::Array< ae::Sdf* > shapes = TAG_TERRAIN_TEST;
+	ae::Array< ae::Sdf* > expected = TAG_TERRAIN_TEST;
+	for( uint32_t q = 0; q < 50; q++ )
+	{
+		const ae::Vec3 center( ae::Random( -120.0f, 120.0f, seed ), ae::Random( -120.0f, 120.0f, seed ), ae::Random( -120.0f, 120.0f, seed ) );
+		const ae::AABB query( center - ae::Vec3( 12.0f ), center + ae::Vec3( 12.0f ) );
+		expected.Clear();
+		for( uint32_t i = 0; i < sdf->GetShapeCount(); i++ )
+		{
+			if( sdf->GetShapeAtIndex( i )->GetAABB().Intersect( query ) )
+			{
+				expected.Append( sdf->GetShapeAtIndex( i ) );
+			}
+		}
+		shapes.Clear();
+		sdf->GetShapes( query, &shapes );
+		REQUIRE( shapes.Length() == expected.Length() );
+		for( uint32_t i = 0; i < shapes.Length(); i++ )
+		{
+			REQUIRE( shapes[ i ] == expected[ i ] );
+		}
+	}
+}
+//! Compresses a grid with 'uniqueCount' different values and checks that Get()
+//! and Serialize() return the same values
+template< typename T >
+void RequireVoxelGridRoundTrip( uint32_t uniqueCount, uint32_t expectedBits )
+{
+	typedef ae::TerrainVoxelGrid< T > Grid;
+	ae::Array< T > values = TAG_TERRAIN_TEST;
+	ae::Array< T > result = TAG_TERRAIN_TEST;
+	values.Append( T(), Grid::kCount );
+	result.Append( T(), Grid::kCount );
+	for( uint32_t i = 0; i < Grid::kCount; i++ )
+	{
+		// Scatter values so there are few runs, while still using every value
+		values[ i ] = (T)( ( i * 7919u ) % uniqueCount );
+	}
+
+	Grid grid;
+	grid.Set( *(const typename Grid::Dense*)values.Data() );
+	REQUIRE( grid.GetBitsPerIndex() == expectedBits );
+	REQUIRE( grid.IsUniform() == ( uniqueCount == 1 ) );
+	REQUIRE( grid.GetPaletteSize() == ( grid.IsDense() ? Grid::kCount : uniqueCount ) );
+	REQUIRE( grid.GetMemoryUsage() <= Grid::kCount * sizeof(T) );
+	grid.Get( *(typename Grid::Dense*)result.Data() );
+	REQUIRE( IsArrayDataEqual( result, values ) );
+	for( uint32_t i = 0; i < Grid::kCount; i++ )
+	{
+		const uint32_t x = i / ( ae::kChunkSize * ae::kChunkSize );
+		const uint32_t y = ( i / ae::kChunkSize ) % ae::kChunkSize;
+		const uint32_t z = i % ae::kChunkSize;
+		REQUIRE( grid.Get( x, y, z ) == values[ i ] );
+	}
+
+	ae::Array< uint8_t > data = TAG_TERRAIN_TEST;
+	ae::BinaryWriter wStream( &data );
+	wStream.SerializeObject( grid );
+	Grid grid2( T( 1 ) );
+	ae::BinaryReader rStream( data.Data(), data.Length() );
+	rStream.SerializeObject( grid2 );
+	REQUIRE( rStream.IsValid() );
+	REQUIRE( !rStream.GetRemainingBytes() );
+	REQUIRE( grid2.GetBitsPerIndex() == grid.GetBitsPerIndex() );
+	REQUIRE( grid2.GetPaletteSize() == grid.GetPaletteSize() );
+	grid2.Get( *(typename Grid::Dense*)result.Data() );
+	REQUIRE( IsArrayDataEqual( result, values ) );
+
+	Grid grid3( T( 1 ) );
+	ae::BinaryReader truncatedStream( data.Data(), data.Length() - 1 );
+	truncatedStream.SerializeObject( grid3 );
+	REQUIRE( !truncatedStream.IsValid() );
+	REQUIRE( grid3.IsUniform() );
+}
+
+//! Updates 'terrain' until all chunks around 'center' are generated and lit
+void UpdateTerrainUntilIdle( ae::Terrain* terrain, ae::Vec3 center, float radius )
+{
+	const double start = ae::GetTime();
+	do
+	{
+		terrain->Update( center, radius );
+		std::this_thread::yield();
+	} while( !terrain->IsIdle() && ae::GetTime() - start < 60.0 );
+	REQUIRE( terrain->IsIdle() );
+}
+
+}
+
+//------------------------------------------------------------------------------
+// ae::TerrainScheduler tests
+//------------------------------------------------------------------------------
+TEST_CASE( "TerrainScheduler runs jobs lowest score first", "[ae::TerrainScheduler]" )
+{
+	TestJobs testJobs( 5 );
+	ae::TerrainScheduler scheduler;
+	scheduler.Initialize( 0 );
+	const float scores[] = { 3.0f, 1.0f, 4.0f, 0.0f, 2.0f };
+	for( uint32_t i = 0; i < countof( scores ); i++ )
+	{
+		scheduler.Submit( testJobs.Start( i ), scores[ i ] );
+	}
+	REQUIRE( !scheduler.IsIdle() );
+	REQUIRE( scheduler.GetStats().queueDepth == 5 );
+	const uint32_t expectedOrder[] = { 3, 1, 4, 0, 2 };
+	for( uint32_t index : expectedOrder )
+	{
+		ae::TerrainJob* job = scheduler.RunNext();
+		REQUIRE( job == testJobs.jobs[ index ] );
+		REQUIRE( job->IsPendingFinish() );
+		REQUIRE( !job->IsCancelled() );
+		job->Finish();
+	}
+	REQUIRE( !scheduler.RunNext() );
+	REQUIRE( scheduler.IsIdle() );
+	const ae::TerrainScheduler::Stats stats = scheduler.GetStats();
+	REQUIRE( stats.submitCount == 5 );
+	REQUIRE( stats.completeCount == 5 );
+	REQUIRE( stats.cancelCount == 0 );
+	REQUIRE( stats.maxQueueDepth == 5 );
+}
+
+TEST_CASE( "TerrainScheduler Reprioritize reorders queued jobs", "[ae::TerrainScheduler]" )
+{
+	TestJobs testJobs( 4 );
+	ae::TerrainScheduler scheduler;
+	scheduler.Initialize( 0 );
+	for( uint32_t i = 0; i < 4; i++ )
+	{
+		scheduler.Submit( testJobs.Start( i ), (float)i );
+	}
+	// Reverse the order, as if the terrain center moved to the other side
+	scheduler.Reprioritize( []( const ae::TerrainJob* job ) { return -(float)job->GetChunk()->m_pos.x; } );
+	for( int32_t i = 3; i >= 0; i-- )
+	{
+		ae::TerrainJob* job = scheduler.RunNext();
+		REQUIRE( job == testJobs.jobs[ i ] );
+		job->Finish();
+	}
+	REQUIRE( scheduler.IsIdle() );
+}
+
+TEST_CASE( "TerrainScheduler Cancel", "[ae::TerrainScheduler]" )
+{
+	TestJobs testJobs( 3 );
+	ae::TerrainScheduler scheduler;
+	scheduler.Initialize( 0 );
+	for( uint32_t i = 0; i < 3; i++ )
+	{
+		scheduler.Submit( testJobs.Start( i ), (float)i );
+	}
+
+	SECTION( "Queued jobs are removed and left pending finish" )
+	{
+		ae::TerrainJob* job = testJobs.jobs[ 0 ];
+		scheduler.Cancel( job );
+		REQUIRE( job->IsPendingFinish() );
+		REQUIRE( job->IsCancelled() );
+		REQUIRE( scheduler.GetStats().queueDepth == 2 );
+		REQUIRE( scheduler.RunNext() == testJobs.jobs[ 1 ] );
+		REQUIRE( scheduler.RunNext() == testJobs.jobs[ 2 ] );
+		REQUIRE( !scheduler.RunNext() );
+		const ae::TerrainScheduler::Stats stats = scheduler.GetStats();
+		REQUIRE( stats.completeCount == 2 );
+		REQUIRE( stats.cancelCount == 1 );
+	}
+
+	SECTION( "Jobs asked to cancel while running stop early" )
+	{
+		// Cancel() on the job itself is what the scheduler does to running jobs
+		testJobs.jobs[ 0 ]->Cancel();
+		REQUIRE( testJobs.jobs[ 0 ]->IsCancelRequested() );
+		REQUIRE( !testJobs.jobs[ 0 ]->IsPendingFinish() );
+		REQUIRE( scheduler.RunNext() == testJobs.jobs[ 0 ] );
+		REQUIRE( testJobs.jobs[ 0 ]->IsPendingFinish() );
+		REQUIRE( testJobs.jobs[ 0 ]->IsCancelled() );
+		REQUIRE( scheduler.GetStats().cancelCount == 1 );
+		REQUIRE( scheduler.GetStats().completeCount == 0 );
+	}
+
+	SECTION( "Terminate cancels queued jobs" )
+	{
+		scheduler.Terminate();
+		for( ae::TerrainJob* job : testJobs.jobs )
+		{
+			REQUIRE( job->IsPendingFinish() );
+			REQUIRE( job->IsCancelled() );
+		}
+		REQUIRE( scheduler.IsIdle() );
+	}
+}
+
+TEST_CASE( "TerrainScheduler workers share one queue", "[ae::TerrainScheduler]" )
+{
+	TestJobs testJobs( 8 );
+	ae::TerrainScheduler scheduler;
+	scheduler.Initialize( 3 );
+	REQUIRE( scheduler.GetWorkerCount() == 3 );
+	for( uint32_t i = 0; i < testJobs.jobs.Length(); i++ )
+	{
+		scheduler.Submit( testJobs.Start( i ), (float)i );
+	}
+	const double start = ae::GetTime();
+	while( !scheduler.IsIdle() && ae::GetTime() - start < 30.0 )
+	{
+		std::this_thread::yield();
+	}
+	REQUIRE( scheduler.IsIdle() );
+	for( ae::TerrainJob* job : testJobs.jobs )
+	{
+		REQUIRE( job->IsPendingFinish() );
+		REQUIRE( !job->IsCancelled() );
+	}
+	const ae::TerrainScheduler::Stats stats = scheduler.GetStats();
+	REQUIRE( stats.submitCount == 8 );
+	REQUIRE( stats.completeCount == 8 );
+	REQUIRE( stats.runningCount == 0 );
+	REQUIRE( stats.queueDepth == 0 );
+	scheduler.Terminate();
+}
+
+//------------------------------------------------------------------------------
+// ae::TerrainJob chunk cache tests
+//------------------------------------------------------------------------------
+TEST_CASE( "TerrainJob chunk cache", "[ae::TerrainJob]" )
+{
+	ae::FileSystem fs;
+	fs.Initialize( "", "ae", "TerrainTest" );
+	ae::Str256 cacheDir;
+	if( !fs.GetRootDir( ae::FileSystem::Root::Cache, &cacheDir ) )
+	{
+		SKIP( "No cache directory on this platform" );
+	}
+	std::error_code error;
+	std::filesystem::remove_all( std::filesystem::path( cacheDir.c_str() ) / "terrain", error );
+	REQUIRE( GetChunkCacheFiles( fs ).Length() == 0 );
+
+	TestBox testBox;
+	ae::TerrainParams params;
+	params.vfs = &fs;
+	ae::Array< ae::TerrainVertex > vertices = TAG_TERRAIN_TEST;
+	ae::Array< ae::TerrainIndex > indices = TAG_TERRAIN_TEST;
+	REQUIRE( GenerateChunk( params, &vertices, &indices ) );
+	REQUIRE( vertices.Length() );
+	REQUIRE( indices.Length() );
+
+	const ae::Array< ae::Str256 > files = GetChunkCacheFiles( fs );
+	REQUIRE( files.Length() == 1 );
+	const char* filePath = files[ 0 ].c_str();
+	const ae::Array< uint8_t > fileData = ReadCacheFile( fs, filePath );
+	// Magic, vertex count, index count, vertices, indices, then the chunk's own version
+	const uint32_t kVertexOffset = 3 * sizeof(uint32_t);
+	const uint32_t kChunkVersionOffset = kVertexOffset + vertices.Length() * sizeof(ae::TerrainVertex) + indices.Length() * sizeof(ae::TerrainIndex);
+	REQUIRE( fileData.Length() > kChunkVersionOffset + sizeof(uint32_t) );
+	
+	ae::Array< ae::TerrainVertex > vertices2 = TAG_TERRAIN_TEST;
+	ae::Array< ae::TerrainIndex > indices2 = TAG_TERRAIN_TEST;
+	auto RequireRegenerated = [&]()
+	{
+		REQUIRE( GenerateChunk( params, &vertices2, &indices2 ) );
+		REQUIRE( IsArrayDataEqual( vertices2, vertices ) );
+		REQUIRE( IsArrayDataEqual( indices2, indices ) );
+		// The invalid file is replaced
+		REQUIRE( GetChunkCacheFiles( fs ).Length() == 1 );
+		REQUIRE( IsArrayDataEqual( ReadCacheFile( fs, filePath ), fileData ) );
+	};
+
+	SECTION( "Round trip" )
+	{
+		REQUIRE( GenerateChunk( params, &vertices2, &indices2 ) );
+		REQUIRE( IsArrayDataEqual( vertices2, vertices ) );
+		REQUIRE( IsArrayDataEqual( indices2, indices ) );
+		
+		// Modify a vertex in the file to check that it is actually being loaded
+		ae::Array< uint8_t > modified = fileData;
+		const float x = 1234.5f;
+		memcpy( &modified[ kVertexOffset ], &x, sizeof(x) );
+		WriteCacheFile( fs, filePath, modified );
+		REQUIRE( GenerateChunk( params, &vertices2, &indices2 ) );
+		REQUIRE( vertices2.Length() == vertices.Length() );
+		REQUIRE( vertices2[ 0 ].position.x == x );
+		REQUIRE( IsArrayDataEqual( ReadCacheFile( fs, filePath ), modified ) );
+	}
+
+	SECTION( "Bad magic number" )
+	{
+		ae::Array< uint8_t > modified = fileData;
+		modified[ 0 ] ^= 0xFF;
+		WriteCacheFile( fs, filePath, modified );
+		RequireRegenerated();
+	}
+
+	SECTION( "Vertex count out of range" )
+	{
+		ae::Array< uint8_t > modified = fileData;
+		const uint32_t vertexCount = ae::MaxValue< uint32_t >() - 8;
+		memcpy( &modified[ sizeof(uint32_t) ], &vertexCount, sizeof(vertexCount) );
+		WriteCacheFile( fs, filePath, modified );
+		RequireRegenerated();
+	}
+
+	SECTION( "Chunk version mismatch" )
+	{
+		ae::Array< uint8_t > modified = fileData;
+		modified[ kChunkVersionOffset ]++;
+		WriteCacheFile( fs, filePath, modified );
+		RequireRegenerated();
+	}
+
+	SECTION( "Truncated file" )
+	{
+		for( uint32_t length : { 2u, kVertexOffset + 5, kChunkVersionOffset + 2, fileData.Length() - 1 } )
+		{
+			ae::Array< uint8_t > truncated = TAG_TERRAIN_TEST;
+			truncated.AppendArray( fileData.Data(), length );
+			WriteCacheFile( fs, filePath, truncated );
+			RequireRegenerated();
+		}
+	}
+
+	SECTION( "Trailing data" )
+	{
+		ae::Array< uint8_t > modified = fileData;
+		modified.Append( 0 );
+		WriteCacheFile( fs, filePath, modified );
+		RequireRegenerated();
+	}
+	
+	std::filesystem::remove_all( std::filesystem::path( cacheDir.c_str() ) / "terrain", error );
+}
+
+//------------------------------------------------------------------------------
+// ae::TerrainSdf tests
+//------------------------------------------------------------------------------
+TEST_CASE( "TerrainSdf GetShapes matches a linear scan", "[ae::TerrainSdf]" )
+{
+	ae::TerrainSdf* sdf = GetTestSdf();
+	REQUIRE( sdf->GetShapeCount() == 0 );
+	uint64_t seed = 1;
+	ae::Array< ae::Sdf* > shapes = TAG_TERRAIN_TEST;
+	for( uint32_t i = 0; i < 300; i++ )
+	{
+		ae::Sdf* shape = sdf->CreateSdf< ae::SdfBox >();
+		SetRandomTransform( shape, &seed );
+		shapes.Append( shape );
+	}
+	sdf->UpdatePending();
+	REQUIRE( sdf->GetShapeCount() == 300 );
+	RequireGetShapesMatchesLinear( sdf, &seed );
+
+	// Moved shapes are refit, and eventually rebuilt after many moves
+	for( uint32_t round = 0; round < 8; round++ )
+	{
+		for( uint32_t i = round; i < shapes.Length(); i += 5 )
+		{
+			SetRandomTransform( shapes[ i ], &seed );
+			shapes[ i ]->Dirty();
+		}
+		sdf->UpdateDirty();
+		RequireGetShapesMatchesLinear( sdf, &seed );
+	}
+
+	// Destroy and create shapes
+	for( uint32_t i = 0; i < shapes.Length(); i += 3 )
+	{
+		sdf->DestroySdf( shapes[ i ] );
+		shapes[ i ] = sdf->CreateSdf< ae::SdfBox >();
+		SetRandomTransform( shapes[ i ], &seed );
+	}
+	sdf->UpdatePending();
+	RequireGetShapesMatchesLinear( sdf, &seed );
+	for( uint32_t i = 1; i < shapes.Length(); i += 4 )
+	{
+		SetRandomTransform( shapes[ i ], &seed );
+		shapes[ i ]->Dirty();
+	}
+	sdf->UpdateDirty();
+	RequireGetShapesMatchesLinear( sdf, &seed );
+
+	for( ae::Sdf* shape : shapes )
+	{
+		sdf->DestroySdf( shape );
+	}
+	sdf->UpdatePending();
+	REQUIRE( sdf->GetShapeCount() == 0 );
+}
+
+//------------------------------------------------------------------------------
+// ae::TerrainVoxelGrid tests
+//------------------------------------------------------------------------------
+TEST_CASE( "TerrainVoxelGrid palette grows from 0 to 16 bits", "[ae::TerrainVoxelGrid]" )
+{
+	const uint32_t kDense = ae::TerrainVoxelGrid< float >::kDenseBits;
+	RequireVoxelGridRoundTrip< float >( 1, 0 );
+	RequireVoxelGridRoundTrip< float >( 2, 1 );
+	RequireVoxelGridRoundTrip< float >( 3, 2 );
+	RequireVoxelGridRoundTrip< float >( 4, 2 );
+	RequireVoxelGridRoundTrip< float >( 5, 4 );
+	RequireVoxelGridRoundTrip< float >( 16, 4 );
+	RequireVoxelGridRoundTrip< float >( 17, 8 );
+	RequireVoxelGridRoundTrip< float >( 256, 8 );
+	RequireVoxelGridRoundTrip< float >( 257, 16 );
+	RequireVoxelGridRoundTrip< float >( 6911, 16 );
+	// Palette and indices would be as large as the values themselves
+	RequireVoxelGridRoundTrip< float >( 6912, kDense );
+	RequireVoxelGridRoundTrip< float >( ae::TerrainVoxelGrid< float >::kCount, kDense );
+}
+
+TEST_CASE( "TerrainVoxelGrid byte grids are dense instead of using 8 bit indices", "[ae::TerrainVoxelGrid]" )
+{
+	const uint32_t kDense = ae::TerrainVoxelGrid< uint8_t >::kDenseBits;
+	RequireVoxelGridRoundTrip< uint8_t >( 1, 0 );
+	RequireVoxelGridRoundTrip< uint8_t >( 2, 1 );
+	RequireVoxelGridRoundTrip< uint8_t >( 16, 4 );
+	RequireVoxelGridRoundTrip< uint8_t >( 17, kDense );
+	RequireVoxelGridRoundTrip< uint8_t >( 256, kDense );
+}
+
+TEST_CASE( "TerrainVoxelGrid Serialize rejects invalid grids", "[ae::TerrainVoxelGrid]" )
+{
+	typedef ae::TerrainVoxelGrid< float > Grid;
+	auto RequireInvalid = []( uint32_t paletteSize, uint32_t bitsPerIndex )
+	{
+		ae::Array< uint8_t > data = TAG_TERRAIN_TEST;
+		ae::BinaryWriter wStream( &data );
+		wStream.SerializeUInt32( paletteSize );
+		wStream.SerializeUInt32( bitsPerIndex );
+		data.Append( 0, Grid::kCount * sizeof(float) + Grid::kCount * 2 );
+		Grid grid( 1.0f );
+		ae::BinaryReader rStream( data.Data(), data.Length() );
+		rStream.SerializeObject( grid );
+		REQUIRE( !rStream.IsValid() );
+		REQUIRE( grid.IsUniform() );
+	};
+	RequireInvalid( 0, 0 );
+	RequireInvalid( 5, 8 );
+	RequireInvalid( 100, Grid::kDenseBits );
+	RequireInvalid( Grid::kCount + 1, Grid::kDenseBits );
+
+	// Indices past the end of the palette
+	Grid grid;
+	Grid::Dense* values = (Grid::Dense*)ae::Allocate( TAG_TERRAIN_TEST, sizeof(Grid::Dense), alignof(float) );
+	for( uint32_t i = 0; i < Grid::kCount; i++ ) { ( &(*values)[ 0 ][ 0 ][ 0 ] )[ i ] = (float)( i % 3 ); }
+	grid.Set( *values );
+	ae::Free( values );
+	REQUIRE( grid.GetBitsPerIndex() == 2 );
+	ae::Array< uint8_t > data = TAG_TERRAIN_TEST;
+	ae::BinaryWriter wStream( &data );
+	wStream.SerializeObject( grid );
+	data[ data.Length() - 1 ] = 0xFF; // Index 3 is past the 3 palette entries
+	Grid grid2;
+	ae::BinaryReader rStream( data.Data(), data.Length() );
+	rStream.SerializeObject( grid2 );
+	REQUIRE( !rStream.IsValid() );
+	REQUIRE( grid2.IsUniform() );
+}
+
+//------------------------------------------------------------------------------
+// ae::TerrainLight tests
+//------------------------------------------------------------------------------
+TEST_CASE( "Terrain light is added and removed across chunk borders", "[ae::TerrainLight]" )
+{
+	// A cave inside a solid box that crosses the chunk border at x=24. A shaft
+	// from the top of the box (z is up) lets sky light into the cave.
+	const ae::Vec3 center( 24.0f, 12.0f, 36.0f );
+	const float radius = 72.0f;
+	const ae::Int3 underShaft( 16, 12, 12 );
+	const ae::Int3 acrossBorder( 28, 12, 12 );
+	const ae::Int3 acrossBorderFar( 30, 12, 12 );
+	const uint32_t threadCounts[] = { 0, 2 };
+	for( uint32_t threadCount : threadCounts )
+	{
+		INFO( "threadCount: " << threadCount );
+		ae::Terrain* terrain = ae::New< ae::Terrain >( TAG_TERRAIN_TEST );
+		terrain->Initialize( threadCount, false );
+		ae::Sdf* solid = terrain->sdf.CreateSdf< ae::SdfBox >();
+		solid->SetTransform( ae::Matrix4::Scaling( 120.0f ) );
+		ae::Sdf* cave = terrain->sdf.CreateSdf< ae::SdfBox >();
+		cave->type = ae::Sdf::Type::Subtraction;
+		cave->order = 1;
+		cave->SetTransform( ae::Matrix4::Translation( 24.0f, 12.0f, 12.0f ) * ae::Matrix4::Scaling( 24.0f, 12.0f, 12.0f ) );
+		UpdateTerrainUntilIdle( terrain, center, radius );
+		REQUIRE( terrain->GetChunk( ae::Int3( 0, 0, 0 ) ) );
+		REQUIRE( terrain->GetChunk( ae::Int3( 1, 0, 0 ) ) );
+		REQUIRE( terrain->GetVoxel( underShaft.x, underShaft.y, underShaft.z ) == ae::Block::Exterior );
+		REQUIRE( terrain->GetVoxel( acrossBorder.x, acrossBorder.y, acrossBorder.z ) == ae::Block::Exterior );
+		REQUIRE( terrain->GetLight( underShaft.x, underShaft.y, underShaft.z ) == 0.0f );
+		REQUIRE( terrain->GetLight( acrossBorder.x, acrossBorder.y, acrossBorder.z ) == 0.0f );
+
+		// Sky light falls down the shaft without losing brightness, then spreads
+		// sideways through the cave and into the next chunk
+		ae::Sdf* shaft = terrain->sdf.CreateSdf< ae::SdfBox >();
+		shaft->type = ae::Sdf::Type::Subtraction;
+		shaft->order = 1;
+		shaft->SetTransform( ae::Matrix4::Translation( 16.0f, 12.0f, 40.0f ) * ae::Matrix4::Scaling( 4.0f, 4.0f, 48.0f ) );
+		UpdateTerrainUntilIdle( terrain, center, radius );
+		REQUIRE( terrain->GetLight( underShaft.x, underShaft.y, underShaft.z ) == ae::kSkyBrightness );
+		const float lightAcross = terrain->GetLight( acrossBorder.x, acrossBorder.y, acrossBorder.z );
+		REQUIRE( lightAcross > 0.0f );
+		REQUIRE( lightAcross < ae::kSkyBrightness );
+		REQUIRE( terrain->GetLight( acrossBorderFar.x, acrossBorderFar.y, acrossBorderFar.z ) == lightAcross - 2.0f * ae::kLightFalloff );
+
+		// Closing the shaft darkens the cave on both sides of the border again
+		terrain->sdf.DestroySdf( shaft );
+		UpdateTerrainUntilIdle( terrain, center, radius );
+		REQUIRE( terrain->GetLight( underShaft.x, underShaft.y, underShaft.z ) == 0.0f );
+		REQUIRE( terrain->GetLight( acrossBorder.x, acrossBorder.y, acrossBorder.z ) == 0.0f );
+		REQUIRE( terrain->GetLight( acrossBorderFar.x, acrossBorderFar.y, acrossBorderFar.z ) == 0.0f );
+
+		terrain->Terminate();
+		ae::Delete( terrain );
+	}
+}
+
+//------------------------------------------------------------------------------
+// ae::Terrain raycast tests
+//------------------------------------------------------------------------------
+TEST_CASE( "Terrain batched VoxelRaycast matches single rays", "[ae::Terrain]" )
+{
+	ae::Terrain* terrain = ae::New< ae::Terrain >( TAG_TERRAIN_TEST );
+	terrain->Initialize( 0, false );
+	uint64_t seed = 1;
+	for( uint32_t i = 0; i < 12; i++ )
+	{
+		ae::Sdf* box = terrain->sdf.CreateSdf< ae::SdfBox >();
+		const ae::Vec3 pos( ae::Random( 0.0f, 48.0f, &seed ), ae::Random( 0.0f, 48.0f, &seed ), ae::Random( 0.0f, 48.0f, &seed ) );
+		const ae::Vec3 scale( ae::Random( 2.0f, 16.0f, &seed ), ae::Random( 2.0f, 16.0f, &seed ), ae::Random( 2.0f, 16.0f, &seed ) );
+		box->SetTransform( ae::Matrix4::Translation( pos ) * ae::Matrix4::Scaling( scale ) );
+	}
+	UpdateTerrainUntilIdle( terrain, ae::Vec3( 24.0f ), 48.0f );
+
+	// @NOTE: Rays stay at positive coordinates because the single ray version
+	// clamps its end bounds at -1
+	ae::Array< ae::Vec3 > starts = TAG_TERRAIN_TEST;
+	ae::Array< ae::Vec3 > rays = TAG_TERRAIN_TEST;
+	const auto randomPoint = [ &seed ]() { return ae::Vec3( ae::Random( 0.5f, 47.5f, &seed ), ae::Random( 0.5f, 47.5f, &seed ), ae::Random( 0.5f, 47.5f, &seed ) ); };
+	for( uint32_t i = 0; i < 4000; i++ )
+	{
+		const ae::Vec3 start = randomPoint();
+		starts.Append( start );
+		rays.Append( randomPoint() - start );
+	}
+	// Rays that pass exactly through voxel edges and corners, or along an axis
+	for( uint32_t i = 0; i < 1000; i++ )
+	{
+		const ae::Vec3 start( ae::Random( 21, 28, &seed ), ae::Random( 21, 28, &seed ), ae::Random( 21, 28, &seed ) + 0.5f * ( i % 2 ) );
+		const ae::Vec3 dir( ae::Random( -1, 2, &seed ), ae::Random( -1, 2, &seed ), ae::Random( -1, 2, &seed ) );
+		if( dir == ae::Vec3( 0.0f ) )
+		{
+			continue;
+		}
+		starts.Append( start );
+		rays.Append( dir * ae::Random( 1.0f, 20.0f, &seed ) );
+	}
+
+	ae::Array< ae::TerrainRaycastResult > results = TAG_TERRAIN_TEST;
+	results.Append( {}, starts.Length() );
+	terrain->VoxelRaycast( starts.Data(), rays.Data(), starts.Length(), results.Data() );
+	uint32_t hitCount = 0;
+	for( uint32_t i = 0; i < starts.Length(); i++ )
+	{
+		INFO( "ray: " << i << " start: " << starts[ i ] << " ray: " << rays[ i ] );
+		const ae::TerrainRaycastResult& result = results[ i ];
+		REQUIRE( result.hit == terrain->VoxelRaycast( starts[ i ], rays[ i ], 0 ) );
+		if( result.hit )
+		{
+			hitCount++;
+			REQUIRE( terrain->GetCollision( result.posi.x, result.posi.y, result.posi.z ) );
+			REQUIRE( result.distance >= 0.0f );
+			REQUIRE( result.distance <= rays[ i ].Length() + 0.001f );
+			// Nothing is hit before the returned distance
+			if( result.distance > 0.01f )
+			{
+				const ae::Vec3 dir = rays[ i ].SafeNormalizeCopy();
+				REQUIRE( !terrain->VoxelRaycast( starts[ i ], dir * ( result.distance - 0.001f ), 0 ) );
+			}
+		}
+	}
+	REQUIRE( hitCount > starts.Length() / 4 );
+	REQUIRE( hitCount < starts.Length() );
+
+	terrain->Terminate();
+	ae::Delete( terrain );
+}